@@ -0,0 +1,617 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc. All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#include "../../utf8Main.h"
+
+//
+//  rvbench
+//
+//  Headless playback benchmark. Loads a session (or a list of sources)
+//  the same way rvio does, turns on caching and plays the view through
+//  once at a target frame rate, rendering each frame into an
+//  OSMesaVideoDevice. Nothing is written: at the end it reports
+//  achieved FPS, dropped frames, buffering stalls, per-stage display
+//  latencies (from the session and graph profiling records), cache
+//  fill rate (from FBCache::CacheStats) and peak memory. Exits with 2
+//  if any frames were dropped so scripts can flag regressions.
+//
+
+#include <RvCommon/RvConsoleApplication.h>
+#include <QTBundle/QTBundle.h>
+#include <UICommands.h>
+#include <IOproxy/IOproxy.h>
+#include <MovieProxy/MovieProxy.h>
+#include <ImfThreading.h>
+#include <MuTwkApp/MuInterface.h>
+#include <PyTwkApp/PyInterface.h>
+#include <RvApp/CommandsModule.h>
+#include <RvApp/Options.h>
+#include <RvApp/RvSession.h>
+#include <RvApp/FormatIPNode.h>
+#include <IPCore/Application.h>
+#include <IPCore/AudioRenderer.h>
+#include <IPCore/ImageRenderer.h>
+#include <IPCore/IPGraph.h>
+#include <IPCore/GroupIPNode.h>
+#include <IPCore/ShaderFunction.h>
+#include <IPBaseNodes/SourceIPNode.h>
+#include <MovieFB/MovieFB.h>
+#include <MovieProcedural/MovieProcedural.h>
+#include <TwkMovie/MovieIO.h>
+#include <TwkMovie/MovieNullIO.h>
+#include <TwkDeploy/Deploy.h>
+#include <TwkExc/TwkExcException.h>
+#include <TwkFB/IO.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <TwkGLFMesa/OSMesaVideoDevice.h>
+#include <TwkUtil/File.h>
+#include <TwkUtil/FrameUtils.h>
+#include <TwkUtil/SystemInfo.h>
+#include <TwkUtil/ThreadName.h>
+#include <TwkUtil/Timer.h>
+#include <TwkUtil/Trace.h>
+#include <arg.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <QtGui/QGuiApplication>
+#include <QtCore/QtCore>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace TwkFB;
+using namespace TwkUtil;
+
+namespace
+{
+
+    vector<string> inputFiles;
+    float fps = 0;
+    int inFrame = 0;
+    int outFrame = 0;
+    int haveRange = 0;
+    int xsize = 0;
+    int ysize = 0;
+    float warmup = 0;
+    int showVersion = 0;
+    char* view = 0;
+    char* samplesFile = 0;
+    char* initscript = 0;
+
+    int parseInFiles(int argc, char* argv[])
+    {
+        Rv::Options& opts = Rv::Options::sharedOptions();
+
+        for (int i = 0; i < argc; i++)
+        {
+            opts.inputFiles.push_back(IPCore::Application::mapFromVar(argv[i]));
+        }
+
+        return 0;
+    }
+
+    void setEnvVar(const string& var, const string& val)
+    {
+#ifdef PLATFORM_WINDOWS
+        _putenv_s(var.c_str(), val.c_str());
+#else
+        setenv(var.c_str(), val.c_str(), 1);
+#endif
+    }
+
+    //
+    //  Latency samples for one stage of the display path. Reported as
+    //  percentiles plus a power-of-two histogram in milliseconds.
+    //
+
+    struct Latency
+    {
+        Latency(const char* n)
+            : name(n)
+        {
+        }
+
+        void add(double seconds)
+        {
+            if (seconds > 0)
+                samples.push_back(seconds * 1000.0);
+        }
+
+        double percentile(double p) const
+        {
+            return sorted[min(sorted.size() - 1, size_t(p * double(sorted.size() - 1) + 0.5))];
+        }
+
+        void report(ostream& out)
+        {
+            if (samples.empty())
+            {
+                out << "  " << setw(10) << left << name << right << " no samples" << endl;
+                return;
+            }
+
+            sorted = samples;
+            sort(sorted.begin(), sorted.end());
+
+            out << "  " << setw(10) << left << name << right << fixed << setprecision(2) << " n=" << setw(6) << sorted.size()
+                << "  p50=" << setw(8) << percentile(0.5) << "  p95=" << setw(8) << percentile(0.95) << "  p99=" << setw(8)
+                << percentile(0.99) << "  max=" << setw(8) << sorted.back() << " ms" << endl;
+
+            //
+            //  Buckets: <1, 1-2, 2-4, ... 256+ ms
+            //
+
+            const size_t nbuckets = 10;
+            size_t buckets[nbuckets] = {0};
+
+            for (size_t i = 0; i < sorted.size(); i++)
+            {
+                size_t b = 0;
+                for (double limit = 1.0; b < nbuckets - 1 && sorted[i] >= limit; limit *= 2.0)
+                    b++;
+                buckets[b]++;
+            }
+
+            out << "  " << setw(10) << " ";
+
+            for (size_t b = 0; b < nbuckets; b++)
+            {
+                if (b == 0)
+                    out << " <1:";
+                else if (b == nbuckets - 1)
+                    out << " " << (1 << (b - 1)) << "+:";
+                else
+                    out << " " << (1 << (b - 1)) << "-" << (1 << b) << ":";
+
+                out << buckets[b];
+            }
+
+            out << endl;
+        }
+
+        const char* name;
+        vector<double> samples;
+        vector<double> sorted;
+    };
+
+    size_t cachedFrameCount(const IPCore::FBCache::FrameRangeVector& ranges)
+    {
+        size_t n = 0;
+        for (size_t i = 0; i < ranges.size(); i++)
+            n += ranges[i].second - ranges[i].first + 1;
+        return n;
+    }
+
+    size_t peakResidentBytes()
+    {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return size_t(usage.ru_maxrss) * 1024; // KB on linux
+    }
+
+} // namespace
+
+//----------------------------------------------------------------------
+
+int utf8Main(int argc, char* argv[])
+{
+    setEnvVar("LANG", "C");
+    setEnvVar("LC_ALL", "C");
+    TwkFB::ThreadPool::initialize();
+
+    TwkGLF::OSMesaVideoDevice* dummyDev = new TwkGLF::OSMesaVideoDevice(0, 10, 10, true);
+    FrameBuffer* dummyFB = new FrameBuffer(10, 10, 4, FrameBuffer::FLOAT);
+    dummyDev->makeCurrent(dummyFB);
+    IPCore::ImageRenderer::queryGL();
+    const char* glVersion = (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION);
+    IPCore::Shader::Function::useShadingLanguageVersion(glVersion);
+
+    struct rlimit rlim;
+    getrlimit(RLIMIT_NOFILE, &rlim);
+    rlim.rlim_cur = rlim.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rlim);
+
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication qapp(argc, argv);
+    TwkApp::QTBundle bundle("rv", MAJOR_VERSION, MINOR_VERSION, REVISION_NUMBER);
+
+    qapp.setOrganizationName(INTERNAL_ORGANIZATION_NAME);
+    qapp.setOrganizationDomain(INTERNAL_ORGANIZATION_DOMAIN);
+
+    Rv::Options& opts = Rv::Options::sharedOptions();
+
+    opts.exrcpus = SystemInfo::numCPUs();
+    Rv::Options::manglePerSourceArgs(argv, argc);
+    Imf::staticInitialize();
+    IPCore::Application::cacheEnvVars();
+
+    TwkFB::GenericIO::init();
+    TwkMovie::GenericIO::init();
+
+    IPCore::AudioRenderer::setNoAudio(true);
+
+    TWK_DEPLOY_APP_OBJECT dobj(MAJOR_VERSION, MINOR_VERSION, REVISION_NUMBER, argc, argv, RELEASE_DESCRIPTION, "HEAD=" GIT_HEAD);
+
+    //
+    //  Look-ahead caching unless told otherwise, like RV
+    //
+
+    opts.useLCache = 1;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strcmp("--help", argv[i]))
+        {
+            strcpy(argv[i], "-help");
+            break;
+        }
+    }
+
+    if (arg_parse(argc, argv, "", "\nUsage: rvbench headless playback benchmark", "", "",
+                  "  Look-ahead cache:     rvbench in.#.exr", "", "  Region cache, 24fps:  rvbench -c -fps 24 in.#.dpx", "",
+                  "  Session, frames:      rvbench -t 1001 1100 review.rv", "", "", RV_ARG_SEQUENCE_HELP, "", "",
+                  RV_ARG_SOURCE_OPTIONS(opts), "", "", "", "Global arguments", "", "", "", ARG_SUBR(parseInFiles),
+                  "Input sequence patterns, images, movies, directories or a session file", "-fps %f", &fps,
+                  "Target playback FPS (default=session FPS)", "-t %d %d", &inFrame, &outFrame, "In and out frames to play (inclusive)",
+                  "-view %S", &view, "View to play (default=defaultSequence or current view in RV file)", "-outres %d %d", &xsize,
+                  &ysize, "Render target resolution (default=largest source)", "-c", ARG_FLAG(&opts.useCache), "Use region frame cache",
+                  "-l", ARG_FLAG(&opts.useLCache), "Use look-ahead cache (default)", "-nc", ARG_FLAG(&opts.useNoCache), "Use no caching",
+                  "-cram %f", &opts.maxcram, "Maximum region cache RAM usage (GB)", "-lram %f", &opts.maxlram,
+                  "Maximum look-ahead cache RAM usage (GB)", "-rthreads %d", &opts.readerThreads, "Number of reader threads",
+                  "-warmup %f", &warmup, "Seconds to let the cache fill before playing (default=0)", "-samples %S", &samplesFile,
+                  "Write the raw profiling samples to this file", "-init %S", &initscript, "Override init script", "-debug", ARG_SUBR(&Rv::parseDebugKeyWords), "Debug category",
+                  "-flags", ARG_SUBR(&Rv::parseMuFlags), "Arbitrary flags (flag, or 'name=value') for Mu", "-version",
+                  ARG_FLAG(&showVersion), "Show version number", NULL)
+        < 0)
+    {
+        exit(-1);
+    }
+
+    haveRange = inFrame != 0 || outFrame != 0;
+    opts.delaySessionLoading = 0;
+    opts.progressiveSourceLoading = 0;
+    opts.exportIOEnvVars();
+
+    if (!opts.initializeAfterParsing(0))
+    {
+        cerr << "ERROR: failed to initialize options" << endl;
+        exit(-1);
+    }
+
+    inputFiles = opts.inputFiles;
+
+    if (showVersion)
+    {
+        cout << MAJOR_VERSION << "." << MINOR_VERSION << "." << REVISION_NUMBER << endl;
+        exit(0);
+    }
+
+    if (inputFiles.empty())
+    {
+        cerr << "ERROR: no input files specified" << endl;
+        exit(-1);
+    }
+
+    TWK_DEPLOY_SHOW_PROGRAM_BANNER(cout);
+    TWK_DEPLOY_SHOW_COPYRIGHT_BANNER(cout);
+
+    if (opts.exrcpus > 1)
+        Imf::setGlobalThreadCount(opts.exrcpus);
+
+    string initPath = bundle.rcfile("rviorc", "mu", "RVIO_INIT");
+    bundle.addPathToEnvVar("OIIO_LIBRARY_PATH", bundle.appPluginPath("OIIO"));
+    if (initscript)
+        initPath = initscript;
+
+    try
+    {
+        TwkFB::loadProxyPlugins("TWK_FB_PLUGIN_PATH");
+        TwkMovie::loadProxyPlugins("TWK_MOVIE_PLUGIN_PATH");
+    }
+    catch (...)
+    {
+        cerr << "WARNING: a problem occured while loading image plugins." << endl;
+        cerr << "         some plugins may not have been loaded." << endl;
+    }
+
+    TwkMovie::GenericIO::addPlugin(new MovieFBIO());
+    TwkMovie::GenericIO::addPlugin(new MovieProceduralIO());
+    TwkMovie::GenericIO::addPlugin(new TwkMovie::MovieNullIO());
+    TwkFB::GenericIO::compileExtensionSet(predicateFileExtensions());
+
+    Rv::RvConsoleApplication app;
+
+    try
+    {
+        TwkApp::initMu(0);
+        TwkApp::initPython();
+        RVIO::initUICommands(TwkApp::muContext());
+        Rv::initCommands(TwkApp::muContext());
+    }
+    catch (const exception& e)
+    {
+        cerr << "ERROR: during initialization: " << e.what() << endl;
+        exit(-1);
+    }
+
+    TwkUtil::setThreadName("rvbench Main");
+
+    //
+    //  The profiling clock is handed to the graph when the session is
+    //  constructed so this has to be on before that.
+    //
+
+    IPCore::debugProfile = true;
+
+    int exitCode = 0;
+
+    try
+    {
+        Rv::RvSession* session = new Rv::RvSession();
+        session->setBatchMode(true);
+
+        if (inputFiles.size() == 1 && extension(inputFiles.front()) == "rv")
+        {
+            session->read(inputFiles.front().c_str(), IPCore::Session::ReadRequest());
+        }
+        else
+        {
+            session->readUnorganizedFileList(inputFiles);
+
+            if (session->sources().size() == 1 && !view)
+            {
+                session->setViewNode(session->sources()[0]->group()->name());
+            }
+        }
+
+        if (view && !session->setViewNode(view))
+        {
+            cerr << "ERROR: view not found \"" << view << "\"" << endl;
+            exit(-1);
+        }
+
+        TwkApp::initWithFile(TwkApp::muContext(), TwkApp::muProcess(), TwkApp::muModuleList(), initPath.c_str());
+
+        session->setSessionStateFromNode(session->graph().viewNode());
+        session->makeActive();
+        session->postInitialize();
+        session->setRendererType("Composite");
+
+        TwkMath::Vec2i size = session->maxSize();
+        const int w = xsize > 0 ? xsize : size[0];
+        const int h = ysize > 0 ? ysize : size[1];
+
+        FrameBuffer* fb = new FrameBuffer(w, h, 4, FrameBuffer::FLOAT);
+        TwkGLF::OSMesaVideoDevice* device = new TwkGLF::OSMesaVideoDevice(0, w, h, true);
+        device->makeCurrent(fb);
+        session->setControlVideoDevice(device);
+        session->setOutputVideoDevice(device);
+
+        if (haveRange)
+        {
+            session->setInPoint(inFrame);
+            session->setOutPoint(outFrame + 1);
+        }
+
+        if (fps > 0)
+            session->setFPS(fps);
+
+        const double targetFPS = session->fps();
+        const int firstFrame = session->inPoint();
+        const int lastFrame = session->outPoint() - 1;
+
+        IPCore::Session::CachingMode cacheMode = IPCore::Session::NeverCache;
+        if (opts.useCache)
+            cacheMode = IPCore::Session::GreedyCache;
+        else if (opts.useLCache && !opts.useNoCache)
+            cacheMode = IPCore::Session::BufferCache;
+
+        cout << "INFO: playing frames " << firstFrame << "-" << lastFrame << " at " << targetFPS << " fps, " << w << "x" << h
+             << ", cache "
+             << (cacheMode == IPCore::Session::GreedyCache ? "region"
+                                                            : (cacheMode == IPCore::Session::BufferCache ? "look-ahead" : "off"))
+             << endl;
+
+        session->setFrame(firstFrame);
+        session->setPlayMode(IPCore::Session::PlayOnce);
+        session->setRealtime(true);
+
+        Timer wall;
+        wall.start();
+
+        //
+        //  The cache fill rate is measured from the moment caching starts
+        //  until the cache stops growing.
+        //
+
+        session->setCaching(cacheMode);
+
+        size_t peakCacheUsed = 0;
+        double peakCacheTime = 0;
+        size_t peakCachedFrames = 0;
+
+        auto sampleCache = [&]()
+        {
+            const IPCore::Session::CacheStats& stats = session->cacheStats();
+
+            if (stats.used > peakCacheUsed)
+            {
+                peakCacheUsed = stats.used;
+                peakCacheTime = wall.elapsed();
+                peakCachedFrames = cachedFrameCount(stats.cachedRanges);
+            }
+        };
+
+        while (wall.elapsed() < warmup)
+        {
+            qapp.processEvents();
+            sampleCache();
+            usleep(10000);
+        }
+
+        const double playStart = wall.elapsed();
+        int renders = 0;
+        int dropped = 0;
+        int stalls = 0;
+        bool buffering = false;
+
+        session->play();
+
+        while (session->isPlaying() || session->isBuffering())
+        {
+            qapp.processEvents();
+
+            IPCore::Session::ProfilingRecord& record = session->beginProfilingSample();
+            record.renderStart = session->profilingElapsedTime();
+
+            device->makeCurrent(fb);
+            session->render();
+            glFinish();
+
+            record.renderEnd = session->profilingElapsedTime();
+            record.swapStart = record.renderEnd;
+            record.swapEnd = record.renderEnd;
+            session->endProfilingSample();
+
+            renders++;
+            dropped += max(0, session->skipped());
+
+            if (session->isBuffering() && !buffering)
+                stalls++;
+            buffering = session->isBuffering();
+
+            sampleCache();
+
+            //
+            //  Wait for the next frame time rather than spinning: the
+            //  session picks the frame from its own clock.
+            //
+
+            const double period = 1.0 / targetFPS;
+            const double spent = record.renderEnd - record.renderStart;
+            if (spent < period)
+                usleep(useconds_t((period - spent) * 1e6 * 0.5));
+        }
+
+        const double playTime = wall.elapsed() - playStart;
+        const int frames = lastFrame - firstFrame + 1;
+
+        session->stop();
+
+        //
+        //  Per stage latencies. The graph record only exists for frames
+        //  the session evaluated, and io only when the display had to
+        //  read the frame itself (a cache miss).
+        //
+
+        const IPCore::Session::ProfilingRecordVector& records = session->profilingSamples();
+        const IPCore::IPGraph::ProfilingVector& graphRecords = session->graph().profilingSamples();
+
+        Latency total("frame");
+        Latency evaluate("evaluate");
+        Latency io("io");
+        Latency cacheEval("cacheEval");
+        Latency upload("upload");
+        Latency render("render");
+        size_t displayMisses = 0;
+
+        for (size_t i = 0; i < records.size(); i++)
+        {
+            const IPCore::Session::ProfilingRecord& r = records[i];
+
+            total.add(r.renderEnd - r.renderStart);
+            evaluate.add(r.evaluateEnd - r.evaluateStart);
+            upload.add(r.renderUploadPlaneTotal + r.prefetchUploadPlaneTotal);
+            render.add(r.internalRenderEnd - r.internalRenderStart);
+
+            if (i < graphRecords.size())
+            {
+                const IPCore::IPGraph::EvalProfilingRecord& g = graphRecords[i];
+
+                if (g.ioEnd > g.ioStart)
+                {
+                    io.add(g.ioEnd - g.ioStart);
+                    displayMisses++;
+                }
+
+                cacheEval.add(g.cacheEvalEnd - g.cacheEvalStart);
+            }
+        }
+
+        if (samplesFile)
+        {
+            ofstream file(samplesFile);
+            session->dumpProfilingToFile(file);
+        }
+
+        cout << endl << "Playback" << endl;
+        cout << fixed << setprecision(2);
+        cout << "  target fps       " << targetFPS << endl;
+        cout << "  achieved fps     " << (playTime > 0 ? double(frames - dropped) / playTime : 0.0) << endl;
+        cout << "  frames           " << frames << " (" << renders << " renders)" << endl;
+        cout << "  dropped frames   " << dropped << endl;
+        cout << "  buffering stalls " << stalls << endl;
+        cout << "  display misses   " << displayMisses << endl;
+        cout << "  play time        " << playTime << " s" << endl;
+
+        cout << endl << "Latency (display thread)" << endl;
+        total.report(cout);
+        evaluate.report(cout);
+        io.report(cout);
+        cacheEval.report(cout);
+        upload.report(cout);
+        render.report(cout);
+
+        cout << endl << "Cache" << endl;
+        cout << "  peak used        " << double(peakCacheUsed) / (1024.0 * 1024.0) << " MB (" << peakCachedFrames << " frames)" << endl;
+
+        if (peakCacheTime > 0)
+        {
+            cout << "  fill rate        " << double(peakCacheUsed) / (1024.0 * 1024.0) / peakCacheTime << " MB/s, "
+                 << double(peakCachedFrames) / peakCacheTime << " frames/s" << endl;
+        }
+
+        cout << endl << "Memory" << endl;
+        cout << "  peak resident    " << double(peakResidentBytes()) / (1024.0 * 1024.0) << " MB" << endl;
+
+        if (dropped > 0)
+            exitCode = 2;
+    }
+    catch (TwkExc::Exception& exc)
+    {
+        cerr << exc << endl;
+        exit(-1);
+    }
+    catch (exception& exc)
+    {
+        cerr << "ERROR: " << exc.what() << endl;
+        exit(-1);
+    }
+
+    TwkMovie::GenericIO::shutdown();
+    TwkFB::GenericIO::shutdown();
+    TwkFB::ThreadPool::shutdown();
+
+    //
+    //  See rvio: skip the exit handlers to avoid the libglvnd shutdown
+    //  race. The trace file has to be finished by hand as a result.
+    //
+
+    TwkUtil::Trace::finish();
+    std::_Exit(exitCode);
+}
@@ -0,0 +1,6 @@
+//
+// Copyright (C) 2023  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "../../utf8Main.cpp"
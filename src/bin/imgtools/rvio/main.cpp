@@ -68,6 +68,7 @@
 #include <TwkUtil/Daemon.h>
 #include <TwkUtil/File.h>
 #include <TwkUtil/ThreadName.h>
+#include <TwkUtil/Trace.h>
 #include <TwkQtBase/QtUtil.h>
 #include <RvApp/RvSession.h>
 #include <RvApp/FormatIPNode.h>
@@ -1812,8 +1813,10 @@ int utf8Main(int argc, char* argv[])
     //  This is safe here: by this point rvio's own shutdown is complete
     //  (the output movie is closed, MovieRV/GenericIO/ThreadPool have all
     //  been torn down), so there is no remaining cleanup that the exit
-    //  handlers would have done for us.
+    //  handlers would have done for us. The trace (if any) is closed
+    //  by an exit handler so finish it here.
     //
+    TwkUtil::Trace::finish();
     std::_Exit(0);
 #endif
 
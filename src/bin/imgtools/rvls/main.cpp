@@ -27,8 +27,10 @@
 #include <TwkDeploy/Deploy.h>
 #include <TwkMovie/MovieIO.h>
 #include <TwkContainer/GTOReader.h>
+#include <TwkUtil/DirectoryScanner.h>
 #include <TwkUtil/File.h>
 #include <TwkUtil/FrameUtils.h>
+#include <TwkUtil/SequenceIndex.h>
 #include <algorithm>
 #include <arg.h>
 #include <iomanip>
@@ -733,6 +735,14 @@ int utf8Main(int argc, char** argv)
     try
     {
         vector<string> allfiles;
+        vector<string> dirs;
+        vector<size_t> dirPositions;
+
+        //
+        //  Directories are listed together (in parallel) once all the
+        //  arguments are known; their entries go where the directory
+        //  was on the command line.
+        //
 
         for (int i = 0; i < inputFiles.size(); i++)
         {
@@ -742,23 +752,14 @@ int utf8Main(int argc, char** argv)
             {
                 if (path[path.size() - 1] != '/')
                     path.append("/");
-                vector<string> files;
-
-                if (filesInDirectory(path.c_str(), files))
-                {
-                    for (int q = 0; q < files.size(); q++)
-                    {
-                        if (files[q].size() && files[q][0] == '.' && !a)
-                            continue;
-                        string file = path;
-                        file += files[q];
-                        allfiles.push_back(file);
-                    }
-                }
+                dirs.push_back(path);
+                dirPositions.push_back(allfiles.size());
             }
             else if (path.size() > 2 && path.substr(path.size() - 3, path.size() - 1) == ".rv")
             {
                 allfiles = readSession(path);
+                dirs.clear();
+                dirPositions.clear();
             }
             else
             {
@@ -766,18 +767,44 @@ int utf8Main(int argc, char** argv)
             }
         }
 
-        SequenceNameList seqs;
+        DirectoryScanner scanner;
+        DirectoryScanner::Listings listings;
+        scanner.scan(dirs, listings);
+
+        for (size_t i = listings.size(); i-- > 0;)
+        {
+            const DirectoryScanner::Listing& listing = listings[i];
+            vector<string> files;
+
+            for (int q = 0; q < listing.files.size(); q++)
+            {
+                if (listing.files[q].size() && listing.files[q][0] == '.' && !a)
+                    continue;
+                files.push_back(listing.path + listing.files[q]);
+            }
+
+            allfiles.insert(allfiles.begin() + dirPositions[i], files.begin(), files.end());
+        }
+
+        SequenceIndex::Sequences seqs;
 
         if (ns)
         {
-            seqs = allfiles;
+            seqs.resize(allfiles.size());
+
+            for (size_t i = 0; i < allfiles.size(); i++)
+                seqs[i].name = seqs[i].file = allfiles[i];
         }
         else
         {
             SequencePredicate sPred = (bruteForce) ? AnySequencePredicate : GlobalExtensionPredicate;
-            seqs = sequencesInFileList(allfiles, sPred, nonmatching, showranges, minseq);
+            SequenceIndex index(sPred, nonmatching, showranges, minseq);
+            index.add(allfiles);
+            seqs = index.sequences();
         }
-        std::sort(seqs.begin(), seqs.end());
+
+        std::sort(seqs.begin(), seqs.end(),
+                  [](const SequenceIndex::Sequence& x, const SequenceIndex::Sequence& y) { return x.name < y.name; });
 
         if (l)
         {
@@ -791,9 +818,33 @@ int utf8Main(int argc, char** argv)
             listing.front().push_back("#ach");
             listing.front().push_back("file");
 
+            //
+            //  Each sequence is opened in parallel; the results are
+            //  cached against its first frame (see DirectoryScanner).
+            //
+
+            vector<string> keys(seqs.size());
+            vector<string> files(seqs.size());
+            vector<DirectoryScanner::ProbeResult> results;
+
             for (int i = 0; i < seqs.size(); i++)
             {
-                lsLong(seqs[i], listing[i + 1]);
+                keys[i] = string(bruteForce ? "rvls -b -l " : "rvls -l ") + seqs[i].name;
+                files[i] = seqs[i].file;
+            }
+
+            scanner.probe(keys, files,
+                          [&seqs](size_t i)
+                          {
+                              vector<string> parts;
+                              lsLong(seqs[i].name, parts);
+                              return parts;
+                          },
+                          results);
+
+            for (int i = 0; i < seqs.size(); i++)
+            {
+                listing[i + 1].swap(results[i]);
             }
 
             out << lsAlignedLongOuput(listing);
@@ -802,12 +853,15 @@ int utf8Main(int argc, char** argv)
         {
             for (int i = 0; i < seqs.size(); i++)
             {
-                out << lsExtended(seqs[i], yaml);
+                out << lsExtended(seqs[i].name, yaml);
             }
         }
         else
         {
-            copy(seqs.begin(), seqs.end(), ostream_iterator<string>(out, "\n"));
+            for (int i = 0; i < seqs.size(); i++)
+            {
+                out << seqs[i].name << endl;
+            }
         }
     }
     catch (std::exception& exc)
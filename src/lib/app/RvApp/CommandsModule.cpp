@@ -689,8 +689,20 @@ namespace Rv
 
                             IPGraph::GraphEdit edit(s->graph());
 
-                            node->insertPixels(pe->view(), pe->layer(), pe->frame(), pe->x(), pe->y(), pe->width(), pe->height(),
-                                               pe->pixels(), pe->size());
+                            const PixelBlockTransferEvent::Blocks& pblocks = pe->blocks();
+                            ImageSourceIPNode::PixelBlocks blocks(pblocks.size());
+
+                            for (size_t q = 0; q < pblocks.size(); q++)
+                            {
+                                blocks[q].x = pblocks[q].x;
+                                blocks[q].y = pblocks[q].y;
+                                blocks[q].w = int(pblocks[q].width);
+                                blocks[q].h = int(pblocks[q].height);
+                                blocks[q].pixels = pblocks[q].pixels;
+                                blocks[q].size = pblocks[q].size;
+                            }
+
+                            node->insertPixelBlocks(pe->view(), pe->layer(), pe->frame(), blocks);
                         }
                         catch (PixelBlockSizeMismatchExc& exc)
                         {
@@ -1965,6 +1977,12 @@ namespace Rv
                                            0)); // cached frame ranges
         context->tupleType(types);
 
+        types.clear();                         // memoryPoolInfo() return tuple
+        types.push_back(context->int64Type()); // pixel allocs recycled
+        types.push_back(context->int64Type()); // pixel allocs not recycled
+        types.push_back(context->int64Type()); // bytes held for recycling
+        context->tupleType(types);
+
         types.clear(); // edl commands use (int,int,int)
         types.push_back(context->intType());
         types.push_back(context->intType());
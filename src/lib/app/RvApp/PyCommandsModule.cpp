@@ -64,8 +64,20 @@ namespace Rv
                     {
                         try
                         {
-                            node->insertPixels(pe->view(), pe->layer(), pe->frame(), pe->x(), pe->y(), pe->width(), pe->height(),
-                                               pe->pixels(), pe->size());
+                            const PixelBlockTransferEvent::Blocks& pblocks = pe->blocks();
+                            ImageSourceIPNode::PixelBlocks blocks(pblocks.size());
+
+                            for (size_t q = 0; q < pblocks.size(); q++)
+                            {
+                                blocks[q].x = pblocks[q].x;
+                                blocks[q].y = pblocks[q].y;
+                                blocks[q].w = int(pblocks[q].width);
+                                blocks[q].h = int(pblocks[q].height);
+                                blocks[q].pixels = pblocks[q].pixels;
+                                blocks[q].size = pblocks[q].size;
+                            }
+
+                            node->insertPixelBlocks(pe->view(), pe->layer(), pe->frame(), blocks);
                         }
                         catch (PixelBlockSizeMismatchExc& exc)
                         {
@@ -12,6 +12,7 @@
 #include <TwkMovie/MovieIO.h>
 #include <TwkFB/IO.h>
 #include <TwkUtil/FrameUtils.h>
+#include <TwkUtil/SequenceIndex.h>
 #include <TwkUtil/sgcHop.h>
 #include <QtWidgets/QFileIconProvider>
 #include <TwkQtCoreUtil/QtConvert.h>
@@ -266,7 +267,7 @@ namespace Rv
                 //  There needs to be a more robust way to do this: in
                 //  order to identify directories, add a / onto the end of
                 //  the file name. the GlobalExtensionPredicate will force
-                //  sequencesInFileList to ignore those when grouping
+                //  SequenceIndex to ignore those when grouping
                 //  names together.
                 //
 
@@ -277,7 +278,9 @@ namespace Rv
                 ifiles.push_back(fname.toUtf8().data());
             }
 
-            SequenceNameList seqs = sequencesInFileList(ifiles, GlobalExtensionPredicate);
+            SequenceIndex index(GlobalExtensionPredicate);
+            index.add(ifiles);
+            SequenceNameList seqs = index.sequenceNames();
             DB("    found sequences: " << seqs.size());
 
             //
@@ -17,6 +17,7 @@
 #include <TwkQtChat/Client.h>
 #include <TwkQtChat/Connection.h>
 #include <IPCore/Session.h>
+#include <IPCore/PixelTileBatch.h>
 #include <RvApp/Options.h>
 #include <TwkQtCoreUtil/QtConvert.h>
 #include <stl_ext/string_algo.h>
@@ -765,7 +766,11 @@ namespace Rv
         if (!s)
             return;
 
-        if (interp.startsWith("PIXELTILE"))
+        if (interp.startsWith("PIXELTILES"))
+        {
+            s->pixelBlockBatchEvent("pixel-block", interp.toUtf8().constData(), data.constData(), data.size());
+        }
+        else if (interp.startsWith("PIXELTILE"))
         {
             s->pixelBlockEvent("pixel-block", interp.toUtf8().constData(), data.constData(), data.size());
         }
@@ -818,7 +823,12 @@ namespace Rv
             string ename = eventName.toUtf8().data();
             string contents = message.toUtf8().data();
 
-            string r = s->userGenericEvent(ename, contents, senderName);
+            //
+            //  Clients ask which pixel tile transports we have before
+            //  using PIXELTILES (older versions just return "").
+            //
+
+            string r = ename == "pixel-tile-caps" ? PixelTileBatch::capabilities() : s->userGenericEvent(ename, contents, senderName);
             if (isReturnEvent)
             {
                 m_client->sendMessage(sender, QString("RETURN %1").arg(r.c_str()));
@@ -532,6 +532,10 @@ namespace TwkApp
     /// about the rest of the image (its actual size, channels, etc)
     /// should already be known by the receiver.
     ///
+    /// A batched event carries several blocks of the same image; x(),
+    /// y(), width(), height(), pixels() and size() are those of the
+    /// first one and blocks() has them all.
+    ///
 
     class PixelBlockTransferEvent : public Event
     {
@@ -552,6 +556,37 @@ namespace TwkApp
             , m_frame(frame)
             , m_pixels(pixels)
             , m_size(size)
+        {
+            Block b = {x, y, w, h, pixels, size};
+            m_blocks.push_back(b);
+        }
+
+        struct Block
+        {
+            int x;
+            int y;
+            size_t width;
+            size_t height;
+            const void* pixels;
+            size_t size;
+        };
+
+        typedef std::vector<Block> Blocks;
+
+        PixelBlockTransferEvent(const std::string& name, const EventNode* sender, const std::string& media, const std::string& layer,
+                                const std::string& view, int frame, const Blocks& blocks, void* data)
+            : Event(name, sender, data)
+            , m_media(media)
+            , m_layer(layer)
+            , m_view(view)
+            , m_x(blocks.empty() ? 0 : blocks.front().x)
+            , m_y(blocks.empty() ? 0 : blocks.front().y)
+            , m_w(blocks.empty() ? 0 : blocks.front().width)
+            , m_h(blocks.empty() ? 0 : blocks.front().height)
+            , m_frame(frame)
+            , m_pixels(blocks.empty() ? 0 : blocks.front().pixels)
+            , m_size(blocks.empty() ? 0 : blocks.front().size)
+            , m_blocks(blocks)
         {
         }
 
@@ -575,6 +610,8 @@ namespace TwkApp
 
         size_t size() const { return m_size; }
 
+        const Blocks& blocks() const { return m_blocks; }
+
     private:
         std::string m_media;
         std::string m_layer;
@@ -586,6 +623,7 @@ namespace TwkApp
         size_t m_w;
         size_t m_h;
         int m_frame;
+        Blocks m_blocks;
     };
 
     //----------------------------------------------------------------------
@@ -117,6 +117,7 @@ all_mu_commands = [
     "setInc",
     "sourceMediaInfo",
     "cacheInfo",
+    "memoryPoolInfo",
     "loadCount",
     "getCurrentNodesOfType",
     "prefTabWidget",
@@ -9,7 +9,10 @@
 #include <TwkAudio/AudioCache.h>
 #include <TwkUtil/MemPool.h>
 #include <TwkUtil/Macros.h>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <thread>
 #include <assert.h>
 #include <string.h>
 #include <stl_ext/replace_alloc.h>
@@ -18,13 +21,36 @@ namespace TwkAudio
 {
     using namespace std;
 
+    namespace
+    {
+
+        //
+        //  Negative packet numbers are interleaved with the positive ones
+        //  so the directory stays dense around 0.
+        //
+
+        inline size_t directoryIndex(SampleTime segment) { return segment >= 0 ? size_t(segment) * 2 : size_t(-segment) * 2 - 1; }
+
+    } // namespace
+
+    AudioCache::Directory::Directory(size_t n)
+        : size(n)
+        , segments(new std::atomic<Segment*>[n])
+    {
+        for (size_t i = 0; i < n; i++)
+            segments[i].store(0, memory_order_relaxed);
+    }
+
+    AudioCache::Directory::~Directory() { delete[] segments; }
+
     AudioCache::AudioCache()
         : m_packetSize(TWEAK_AUDIO_DEFAULT_PACKET_SIZE)
         , m_packetLayout(TwkAudio::Stereo_2)
-        , m_count(0)
         , m_packetRate(0)
+        , m_directory(new Directory(64))
+        , m_count(0)
         , m_totalSecondsCached(0)
-        , m_cachedRangesStatFrameRate(0.0)
+        , m_readers(0)
     {
         pthread_mutex_init(&m_lock, 0);
     }
@@ -32,129 +58,231 @@ namespace TwkAudio
     AudioCache::~AudioCache()
     {
         clear();
+
+        Directory* d = m_directory.load(memory_order_relaxed);
+
+        for (size_t i = 0; i < d->size; i++)
+            delete d->segments[i].load(memory_order_relaxed);
+
+        delete d;
+
+        for (size_t i = 0; i < m_retiredDirectories.size(); i++)
+            delete m_retiredDirectories[i];
+
         pthread_mutex_destroy(&m_lock);
     }
 
-    void AudioCache::clear()
+    AudioCache::Slot* AudioCache::slot(SampleTime packetNum) const
     {
-        for (PacketMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
+        const Directory* d = m_directory.load(memory_order_acquire);
+        const size_t i = directoryIndex(packetNum >> SegmentShift);
+
+        if (i >= d->size)
+            return 0;
+
+        Segment* segment = d->segments[i].load(memory_order_acquire);
+        return segment ? &segment->slots[packetNum & (SegmentSize - 1)] : 0;
+    }
+
+    AudioCache::Slot* AudioCache::slotForWrite(SampleTime packetNum)
+    {
+        Directory* d = m_directory.load(memory_order_relaxed);
+        const size_t i = directoryIndex(packetNum >> SegmentShift);
+
+        if (i >= d->size)
         {
-            // delete [] i->second;
-            TwkUtil::MemPool::dealloc(i->second);
+            //
+            //  Readers may still be looking at the old directory so it's
+            //  kept around until the cache is destroyed. They're only an
+            //  array of pointers and the size doubles each time.
+            //
+
+            Directory* nd = new Directory(max(d->size * 2, i + 1));
+
+            for (size_t q = 0; q < d->size; q++)
+                nd->segments[q].store(d->segments[q].load(memory_order_relaxed), memory_order_relaxed);
+
+            m_directory.store(nd, memory_order_release);
+            m_retiredDirectories.push_back(d);
+            d = nd;
         }
 
-        for (size_t i = 0; i < m_freePackets.size(); i++)
+        Segment* segment = d->segments[i].load(memory_order_relaxed);
+
+        if (!segment)
         {
-            TwkUtil::MemPool::dealloc(m_freePackets[i]);
+            segment = new Segment;
+            d->segments[i].store(segment, memory_order_release);
         }
 
-        m_freePackets.clear();
-        m_map.clear();
-        m_count = 0;
-        m_totalSecondsCached = 0;
-        m_cachedRangesStat.clear();
+        return &segment->slots[packetNum & (SegmentSize - 1)];
     }
 
-    void AudioCache::clearBefore(Time t)
+    void AudioCache::publish(Slot* s, Packet p)
+    {
+        //
+        //  The sequence number is odd while the slot changes. A reader
+        //  which sees a different sequence number after it's done copying
+        //  discards what it copied.
+        //
+
+        const unsigned int seq = s->seq.load(memory_order_relaxed);
+        s->seq.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        s->packet.store(p, memory_order_relaxed);
+        s->seq.store(seq + 2, memory_order_release);
+    }
+
+    void AudioCache::waitForReaders() const
     {
-        size_t s = sampleAtTime(t);
+        atomic_thread_fence(memory_order_seq_cst);
 
-        PacketMap::iterator a = m_map.end();
-        PacketMap::iterator b = a;
+        while (m_readers.load(memory_order_acquire) != 0)
+            std::this_thread::yield();
+    }
 
-        for (PacketMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
+    void AudioCache::updateTotal() { m_totalSecondsCached.store(Time(m_count) * Time(m_packetSize) / m_packetRate, memory_order_relaxed); }
+
+    void AudioCache::insertRun(SampleTime n)
+    {
+        RunMap::iterator next = m_runs.upper_bound(n);
+
+        if (next != m_runs.begin())
         {
-            if (i->first < s)
-            {
-                m_freePackets.push_back(i->second);
-                m_count--;
-                i->second = 0;
-                if (a == m_map.end())
-                    a = i;
-            }
-            else if (i->first >= s)
+            RunMap::iterator prev = next;
+            --prev;
+
+            if (prev->second == n)
             {
-                b = i;
-                break;
+                prev->second = n + 1;
+
+                if (next != m_runs.end() && next->first == n + 1)
+                {
+                    prev->second = next->second;
+                    m_runs.erase(next);
+                }
+
+                return;
             }
         }
 
-        if (a != b && a != m_map.end())
+        if (next != m_runs.end() && next->first == n + 1)
         {
-            m_map.erase(a, b);
-            m_cachedRangesStat.clear();
+            const SampleTime last = next->second;
+            m_runs.erase(next);
+            m_runs[n] = last;
+        }
+        else
+        {
+            m_runs[n] = n + 1;
         }
-
-        m_totalSecondsCached = Time(m_count) * Time(m_packetSize) / m_packetRate;
     }
 
-    void AudioCache::clearAfter(Time t)
+    void AudioCache::removeRange(SampleTime first, SampleTime last)
     {
-        SampleTime s = sampleAtTime(t);
+        if (first >= last)
+            return;
 
-        PacketMap::iterator a = m_map.end();
-        PacketMap::iterator b = a;
+        RunMap::iterator i = m_runs.upper_bound(first);
+        if (i != m_runs.begin())
+            --i;
 
-        vector<Packet> tbd;
-
-        for (PacketMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
+        while (i != m_runs.end() && i->first < last)
         {
-            if (i->first > s)
+            const SampleTime a = i->first;
+            const SampleTime b = i->second;
+
+            if (b <= first)
             {
-                m_freePackets.push_back(i->second);
+                ++i;
+                continue;
+            }
+
+            for (SampleTime n = max(a, first), e = min(b, last); n < e; n++)
+            {
+                Slot* s = slot(n);
+                m_freePackets.push_back(s->packet.load(memory_order_relaxed));
+                publish(s, 0);
                 m_count--;
-                i->second = 0;
-                if (a == m_map.end())
-                    a = i;
             }
-        }
 
-        if (a != b && a != m_map.end())
-        {
-            m_map.erase(a, b);
-            m_cachedRangesStat.clear();
+            m_runs.erase(i++);
+
+            if (a < first)
+                m_runs[a] = first;
+
+            if (b > last)
+            {
+                m_runs[last] = b;
+                break;
+            }
         }
 
-        m_totalSecondsCached = Time(m_count) * Time(m_packetSize) / m_packetRate;
+        updateTotal();
     }
 
-    void AudioCache::clear(Time time0, Time time1)
+    void AudioCache::clear()
     {
-        SampleTime s0 = sampleAtTime(time0);
-        SampleTime s1 = sampleAtTime(time1);
-
-        PacketMap::iterator a = m_map.end();
-        PacketMap::iterator b = a;
+        PacketVector dead;
+        dead.swap(m_freePackets);
 
-        vector<Packet> tbd;
-
-        for (PacketMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
+        for (RunMap::iterator i = m_runs.begin(); i != m_runs.end(); ++i)
         {
-            if (i->first > s0)
+            for (SampleTime n = i->first; n < i->second; n++)
             {
-                if (i->first < s1)
-                {
-                    m_freePackets.push_back(i->second);
-                    m_count--;
-                    i->second = 0;
-                    if (a == m_map.end())
-                        a = i;
-                }
-                else
-                {
-                    b = i;
-                    break;
-                }
+                Slot* s = slot(n);
+                dead.push_back(s->packet.load(memory_order_relaxed));
+                publish(s, 0);
             }
         }
 
-        if (a != b && a != m_map.end())
+        m_runs.clear();
+        m_count = 0;
+        m_totalSecondsCached.store(0, memory_order_relaxed);
+
+        //
+        //  Nothing can find the packets anymore, but a reader may still be
+        //  copying one.
+        //
+
+        waitForReaders();
+
+        for (size_t i = 0; i < dead.size(); i++)
         {
-            m_map.erase(a, b);
-            m_cachedRangesStat.clear();
+            // delete [] dead[i];
+            TwkUtil::MemPool::dealloc(dead[i]);
         }
+    }
+
+    void AudioCache::clearBefore(Time t)
+    {
+        //
+        //  Frees packets which start before t
+        //
+
+        const SampleTime s = sampleAtTime(t);
+        const SampleTime n = packetNumber(s);
+        removeRange(numeric_limits<SampleTime>::min(), packetOffset(s) ? n + 1 : n);
+    }
+
+    void AudioCache::clearAfter(Time t)
+    {
+        //
+        //  Frees packets which start after t
+        //
+
+        removeRange(packetNumber(sampleAtTime(t)) + 1, numeric_limits<SampleTime>::max());
+    }
+
+    void AudioCache::clear(Time time0, Time time1)
+    {
+        //
+        //  Frees packets which start after time0 and before time1
+        //
 
-        m_totalSecondsCached = Time(m_count) * Time(m_packetSize) / m_packetRate;
+        const SampleTime s1 = sampleAtTime(time1);
+        const SampleTime n1 = packetNumber(s1);
+        removeRange(packetNumber(sampleAtTime(time0)) + 1, packetOffset(s1) ? n1 + 1 : n1);
     }
 
     void AudioCache::configurePacket(size_t samples, TwkAudio::Layout layout, Time rate)
@@ -168,20 +296,10 @@ namespace TwkAudio
         }
     }
 
-    const AudioCache::Packet AudioCache::find(SampleTime s) const
+    bool AudioCache::exists(SampleTime s) const
     {
-        s -= packetOffset(s);
-
-        PacketMap::const_iterator i = m_map.find(s);
-
-        if (i != m_map.end())
-        {
-            return i->second;
-        }
-        else
-        {
-            return 0;
-        }
+        const Slot* p = slot(packetNumber(s));
+        return p && p->packet.load(memory_order_acquire) != 0;
     }
 
     void AudioCache::add(const AudioBuffer& buffer)
@@ -207,13 +325,15 @@ namespace TwkAudio
         assert(buffer.channels() == channels());
         assert(buffer.rate() == m_packetRate);
 
-        if (!find(s))
+        const SampleTime n = packetNumber(s);
+
+        if (!exists(s))
         {
-            unlock();
             Packet p = 0;
 
             if (m_freePackets.empty())
             {
+                unlock();
                 int numChannels = TwkAudio::channelsCount(m_packetLayout);
                 p = (float*)TwkUtil::MemPool::alloc(sizeof(float) * m_packetSize * numChannels);
             }
@@ -221,15 +341,24 @@ namespace TwkAudio
             {
                 p = m_freePackets.back();
                 m_freePackets.pop_back();
+                unlock();
             }
 
             memcpy(p, buffer.pointer(), buffer.sizeInBytes());
             lock();
 
-            m_map[s] = p;
+            Slot* slot = slotForWrite(n);
+
+            if (slot->packet.load(memory_order_relaxed))
+            {
+                m_freePackets.push_back(p);
+                return;
+            }
+
+            publish(slot, p);
+            insertRun(n);
             m_count++;
-            m_totalSecondsCached = Time(m_count) * Time(m_packetSize) / m_packetRate;
-            m_cachedRangesStat.clear();
+            updateTotal();
         }
         else
         {
@@ -237,79 +366,62 @@ namespace TwkAudio
         }
     }
 
-    bool AudioCache::fillBuffer(AudioBuffer& buffer) const
+    bool AudioCache::copyPacket(SampleTime packetNum, SampleTime offset, float* out, SampleTime samples, int numChannels) const
     {
-        const SampleTime s0 = sampleAtTime(buffer.startTime());
-        const SampleTime d0 = sampleAtTime(buffer.duration());
-        const SampleTime e0 = s0 + d0 - 1;
-        int numChannels = TwkAudio::channelsCount(m_packetLayout);
+        const Slot* s = slot(packetNum);
 
-        // assert(d0 == m_packetSize);
+        if (!s)
+            return false;
 
-        if (d0 <= m_packetSize)
-        {
-            const Packet p0 = find(s0);
-            const Packet p1 = find(e0);
-
-            if (p0 && p0 == p1)
-            {
-                //
-                //  This should be the most common case: the buffer range is
-                //  completely contained inside one packet.
-                //
+        const unsigned int seq = s->seq.load(memory_order_acquire);
 
-                memcpy(buffer.pointer(), p0 + packetOffset(s0) * numChannels, buffer.sizeInBytes());
+        if (seq & 1)
+            return false;
 
-                return true;
-            }
-            else if (p0 && p1)
-            {
-                //
-                //  Straddles two packets
-                //
+        const float* p = s->packet.load(memory_order_relaxed);
 
-                const SampleTime n0 = SampleTime(m_packetSize) - packetOffset(s0);
-                const SampleTime n1 = packetOffset(e0) + 1;
+        if (!p)
+            return false;
 
-                memcpy(buffer.pointer(), p0 + packetOffset(s0) * numChannels, n0 * sizeof(float) * numChannels);
+        memcpy(out, p + offset * numChannels, samples * sizeof(float) * numChannels);
+        atomic_thread_fence(memory_order_acquire);
 
-                memcpy(buffer.pointer() + n0 * numChannels, p1, n1 * sizeof(float) * numChannels);
-
-                return true;
-            }
-        }
-        else
-        {
-            const SampleTime total = buffer.size();
-            const SampleTime n = total / SampleTime(m_packetSize);
-            const SampleTime r = total % SampleTime(m_packetSize);
+        return s->seq.load(memory_order_relaxed) == seq;
+    }
 
-            for (size_t i = 0; i < n; i++)
-            {
-                size_t offset = i * m_packetSize;
+    bool AudioCache::fillBuffer(AudioBuffer& buffer) const
+    {
+        const SampleTime packetSize = SampleTime(m_packetSize);
+        const int numChannels = TwkAudio::channelsCount(m_packetLayout);
 
-                AudioBuffer newBuffer(buffer.pointer() + offset * buffer.numChannels(), buffer.channels(), m_packetSize,
-                                      buffer.startTime() + double(i * m_packetSize) / m_packetRate, m_packetRate);
+        SampleTime s = sampleAtTime(buffer.startTime());
+        SampleTime remaining = buffer.size();
+        float* out = buffer.pointer();
+        bool filled = true;
 
-                if (!fillBuffer(newBuffer))
-                    return false;
-            }
+        //
+        //  Registering as a reader only keeps clear() from returning
+        //  packet memory while it's being copied.
+        //
 
-            if (r)
-            {
-                SampleTime offset = n * SampleTime(m_packetSize);
+        m_readers.fetch_add(1);
 
-                AudioBuffer newBuffer(buffer.pointer() + offset * buffer.numChannels(), buffer.channels(), r,
-                                      buffer.startTime() + double(n * m_packetSize) / m_packetRate, m_packetRate);
+        while (filled && remaining > 0)
+        {
+            const SampleTime n = packetNumber(s);
+            const SampleTime offset = s - n * packetSize;
+            const SampleTime count = min(packetSize - offset, remaining);
 
-                if (!fillBuffer(newBuffer))
-                    return false;
-            }
+            filled = copyPacket(n, offset, out, count, numChannels);
 
-            return true;
+            out += count * numChannels;
+            s += count;
+            remaining -= count;
         }
 
-        return false;
+        m_readers.fetch_sub(1, memory_order_release);
+
+        return filled;
     }
 
     //------------------------------------------------------------------------------
@@ -318,28 +430,16 @@ namespace TwkAudio
     {
         lock();
 
-        if (frameRate != m_cachedRangesStatFrameRate)
-        {
-            m_cachedRangesStatFrameRate = frameRate;
-            m_cachedRangesStat.clear();
-        }
+        array.clear();
 
-        if (m_cachedRangesStat.empty())
+        for (RunMap::const_iterator i = m_runs.begin(); i != m_runs.end(); ++i)
         {
-            for (PacketMap::iterator i = m_map.begin(); i != m_map.end(); ++i)
-            {
-                const SampleTime s = i->first;
-                const Time t = samplesToTime(s, m_packetRate);
-                const Time duration = Time(m_packetSize) / m_packetRate;
-                const int startFrame = ROUND(t * frameRate);
-                const int endFrame = ROUND((t + duration) * frameRate);
+            const Time t0 = samplesToTime(i->first * SampleTime(m_packetSize), m_packetRate);
+            const Time t1 = samplesToTime(i->second * SampleTime(m_packetSize), m_packetRate);
 
-                m_cachedRangesStat.push_back(make_pair(startFrame, endFrame));
-            }
+            array.push_back(make_pair(ROUND(t0 * frameRate), ROUND(t1 * frameRate)));
         }
 
-        array = m_cachedRangesStat;
-
         unlock();
     }
 
@@ -0,0 +1,530 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#include <TwkAudio/PolyphaseResampler.h>
+#include <algorithm>
+#include <map>
+#include <math.h>
+#include <mutex>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TWKAUDIO_SSE
+#include <emmintrin.h>
+#endif
+
+namespace TwkAudio
+{
+    using namespace std;
+
+    //
+    //  Zero crossings of the sinc on each side, the cutoff as a fraction
+    //  of the lower of the two Nyquist frequencies and the Kaiser window
+    //  beta. Together they give about 80dB of attenuation from the
+    //  Nyquist frequency up, with the passband flat to ~0.85 of it.
+    //
+
+    static const double Pi = 3.14159265358979323846;
+    static const double ZeroCrossings = 32.0;
+    static const double Rolloff = 0.925;
+    static const double KaiserBeta = 7.9;
+    static const int InterpolatedPhases = 256;
+
+    struct PolyphaseResampler::FilterBank
+    {
+        int phases;
+        size_t taps; // per phase, a multiple of 4
+        vector<float> coefficients;
+
+        //
+        //  Phase p (0 <= p <= phases) is the filter for an output
+        //  sample p / phases of the way between two input samples. The
+        //  extra phase is phase 0 shifted by one sample, so
+        //  interpolating between p and p + 1 never needs to wrap.
+        //
+
+        const float* phase(size_t p) const { return &coefficients[p * taps]; }
+    };
+
+    static double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        const double q = x * x / 4.0;
+
+        for (int k = 1; k < 64 && term > sum * 1e-12; k++)
+        {
+            term *= q / double(k * k);
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    //
+    //  Finds L / M close enough to factor (a float factor like
+    //  48000.0f / 44100.0f should still be taken to be 160 / 147) from
+    //  the continued fraction convergents.
+    //
+
+    static bool exactRatio(double factor, uint64_t& L, uint64_t& M)
+    {
+        double x = factor;
+        uint64_t h0 = 0, h1 = 1;
+        uint64_t k0 = 1, k1 = 0;
+
+        for (int i = 0; i < 32; i++)
+        {
+            const double a = floor(x);
+            const uint64_t h2 = uint64_t(a) * h1 + h0;
+            const uint64_t k2 = uint64_t(a) * k1 + k0;
+
+            if (h2 > uint64_t(PolyphaseResampler::maxPhases()) || k2 > (uint64_t(1) << 24))
+                break;
+
+            h0 = h1;
+            h1 = h2;
+            k0 = k1;
+            k1 = k2;
+
+            if (fabs(double(h1) / double(k1) - factor) <= factor * 1e-6)
+            {
+                L = h1;
+                M = k1;
+                return true;
+            }
+
+            const double r = x - a;
+            if (r < 1e-12)
+                break;
+            x = 1.0 / r;
+        }
+
+        return false;
+    }
+
+    shared_ptr<const PolyphaseResampler::FilterBank> PolyphaseResampler::filterBank(int phases, double scale)
+    {
+        typedef map<pair<int, double>, shared_ptr<const FilterBank>> BankMap;
+
+        static mutex bankMutex;
+        static BankMap banks;
+
+        lock_guard<mutex> lock(bankMutex);
+        BankMap::iterator i = banks.find(make_pair(phases, scale));
+
+        if (i != banks.end())
+            return i->second;
+
+        //
+        //  The impulse response is in input sample units. When
+        //  downsampling (scale < 1) the cutoff drops with the output
+        //  Nyquist frequency and the filter gets proportionally longer.
+        //
+
+        const double cutoff = 0.5 * Rolloff * scale;
+        const size_t taps = (size_t(2.0 * ceil(ZeroCrossings / (2.0 * cutoff))) + 3) & ~size_t(3);
+        const double halfWidth = double(taps) / 2.0;
+        const double i0beta = besselI0(KaiserBeta);
+
+        FilterBank* bank = new FilterBank();
+        bank->phases = phases;
+        bank->taps = taps;
+        bank->coefficients.resize((phases + 1) * taps);
+
+        for (int p = 0; p <= phases; p++)
+        {
+            float* h = &bank->coefficients[p * taps];
+            const double frac = double(p) / double(phases);
+            double sum = 0.0;
+
+            for (size_t k = 0; k < taps; k++)
+            {
+                const double t = frac + halfWidth - 1.0 - double(k);
+                const double x = 2.0 * cutoff * t;
+                const double sinc = x == 0.0 ? 1.0 : sin(Pi * x) / (Pi * x);
+                const double w = t / halfWidth;
+                const double window = fabs(w) < 1.0 ? besselI0(KaiserBeta * sqrt(1.0 - w * w)) / i0beta : 0.0;
+                const double v = sinc * window;
+
+                h[k] = float(v);
+                sum += v;
+            }
+
+            //
+            //  Normalize each phase to unity gain at DC, otherwise the
+            //  small differences between phases show up as noise at
+            //  the phase rate.
+            //
+
+            for (size_t k = 0; k < taps; k++)
+                h[k] = float(double(h[k]) / sum);
+        }
+
+        shared_ptr<const FilterBank> b(bank);
+        banks[make_pair(phases, scale)] = b;
+        return b;
+    }
+
+    //
+    //  Compute one output sample (all channels) from taps input samples
+    //  starting at x. On x86 the channels are filtered four at a time;
+    //  mono and stereo are vectorized across taps instead.
+    //
+
+    static inline void filterSample(const float* h, const float* x, size_t taps, size_t channels, float* out)
+    {
+#ifdef TWKAUDIO_SSE
+        if (channels == 1)
+        {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            size_t k = 0;
+
+            for (; k + 8 <= taps; k += 8)
+            {
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(h + k), _mm_loadu_ps(x + k)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(h + k + 4), _mm_loadu_ps(x + k + 4)));
+            }
+
+            if (k < taps)
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(h + k), _mm_loadu_ps(x + k)));
+
+            __m128 s = _mm_add_ps(acc0, acc1);
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+            _mm_store_ss(out, s);
+            return;
+        }
+        else if (channels == 2)
+        {
+            __m128 acc0 = _mm_setzero_ps();
+            __m128 acc1 = _mm_setzero_ps();
+            __m128 acc2 = _mm_setzero_ps();
+            __m128 acc3 = _mm_setzero_ps();
+            size_t k = 0;
+
+            for (; k + 8 <= taps; k += 8)
+            {
+                const __m128 h0 = _mm_loadu_ps(h + k);
+                const __m128 h1 = _mm_loadu_ps(h + k + 4);
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_unpacklo_ps(h0, h0), _mm_loadu_ps(x + k * 2)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_unpackhi_ps(h0, h0), _mm_loadu_ps(x + k * 2 + 4)));
+                acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_unpacklo_ps(h1, h1), _mm_loadu_ps(x + k * 2 + 8)));
+                acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_unpackhi_ps(h1, h1), _mm_loadu_ps(x + k * 2 + 12)));
+            }
+
+            if (k < taps)
+            {
+                const __m128 h0 = _mm_loadu_ps(h + k);
+                acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_unpacklo_ps(h0, h0), _mm_loadu_ps(x + k * 2)));
+                acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_unpackhi_ps(h0, h0), _mm_loadu_ps(x + k * 2 + 4)));
+            }
+
+            __m128 s = _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3));
+            s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+            _mm_storel_pi((__m64*)out, s);
+            return;
+        }
+        else if (channels >= 4)
+        {
+            //
+            //  Channels are done eight at a time, then whatever is left
+            //  as one or two blocks of four ending on the last channel.
+            //  When channels isn't a multiple of 4 that last block
+            //  overlaps the one before it; the overlapping channels are
+            //  just written twice with the same values.
+            //
+
+            size_t c = 0;
+
+            while (c < channels)
+            {
+                const size_t left = channels - c;
+                const size_t c0 = left >= 8 ? c : (left > 4 ? c : channels - 4);
+                const size_t c1 = left >= 8 ? c + 4 : channels - 4;
+                const float* xp = x;
+                __m128 acc0 = _mm_setzero_ps();
+                __m128 acc1 = _mm_setzero_ps();
+                __m128 acc2 = _mm_setzero_ps();
+                __m128 acc3 = _mm_setzero_ps();
+
+                //
+                //  taps is a multiple of 4; the taps are split between
+                //  two sets of accumulators so the adds can overlap.
+                //
+
+                if (left > 4)
+                {
+                    for (size_t k = 0; k < taps; k += 2, xp += 2 * channels)
+                    {
+                        const __m128 h0 = _mm_set1_ps(h[k]);
+                        const __m128 h1 = _mm_set1_ps(h[k + 1]);
+                        acc0 = _mm_add_ps(acc0, _mm_mul_ps(h0, _mm_loadu_ps(xp + c0)));
+                        acc1 = _mm_add_ps(acc1, _mm_mul_ps(h0, _mm_loadu_ps(xp + c1)));
+                        acc2 = _mm_add_ps(acc2, _mm_mul_ps(h1, _mm_loadu_ps(xp + channels + c0)));
+                        acc3 = _mm_add_ps(acc3, _mm_mul_ps(h1, _mm_loadu_ps(xp + channels + c1)));
+                    }
+
+                    _mm_storeu_ps(out + c0, _mm_add_ps(acc0, acc2));
+                    _mm_storeu_ps(out + c1, _mm_add_ps(acc1, acc3));
+                }
+                else
+                {
+                    const size_t stride = channels;
+
+                    for (size_t k = 0; k < taps; k += 4, xp += 4 * stride)
+                    {
+                        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_set1_ps(h[k]), _mm_loadu_ps(xp + c0)));
+                        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_set1_ps(h[k + 1]), _mm_loadu_ps(xp + stride + c0)));
+                        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_set1_ps(h[k + 2]), _mm_loadu_ps(xp + 2 * stride + c0)));
+                        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_set1_ps(h[k + 3]), _mm_loadu_ps(xp + 3 * stride + c0)));
+                    }
+
+                    _mm_storeu_ps(out + c0, _mm_add_ps(_mm_add_ps(acc0, acc1), _mm_add_ps(acc2, acc3)));
+                }
+
+                c += min(left, size_t(8));
+            }
+
+            return;
+        }
+#endif
+
+        for (size_t c = 0; c < channels; c++)
+            out[c] = 0.0f;
+
+        for (size_t k = 0; k < taps; k++, x += channels)
+        {
+            const float hk = h[k];
+            for (size_t c = 0; c < channels; c++)
+                out[c] += hk * x[c];
+        }
+    }
+
+    //----------------------------------------------------------------------
+
+    PolyphaseResampler::PolyphaseResampler(int numChannels, double factor, size_t blocksize)
+        : m_factor(factor)
+        , m_blocksize(blocksize)
+        , m_channels(numChannels)
+        , m_interpolate(false)
+        , m_frames(0)
+        , m_start(0)
+        , m_phase(0)
+        , m_denominator(1)
+        , m_step(1)
+        , m_historyStart(0)
+        , m_inputEnd(-1)
+    {
+        uint64_t L = 0;
+        uint64_t M = 0;
+        const double scale = min(1.0, factor);
+
+        if (exactRatio(factor, L, M))
+        {
+            m_bank = filterBank(int(L), scale);
+            m_denominator = L;
+            m_step = M;
+        }
+        else
+        {
+            m_bank = filterBank(InterpolatedPhases, scale);
+            m_interpolate = true;
+            m_denominator = uint64_t(1) << 32;
+            m_step = uint64_t(double(m_denominator) / factor + 0.5);
+            m_coefficients.resize(m_bank->taps);
+        }
+
+        reset();
+    }
+
+    PolyphaseResampler::~PolyphaseResampler() {}
+
+    void PolyphaseResampler::close()
+    {
+        m_bank.reset();
+        m_history.clear();
+        m_frames = 0;
+        m_start = 0;
+    }
+
+    size_t PolyphaseResampler::filterWidth() const { return m_bank ? m_bank->taps : 0; }
+
+    void PolyphaseResampler::reset()
+    {
+        if (!m_bank)
+            return;
+
+        //
+        //  The first output sample is centered on the first input
+        //  sample, so the window starts out half full of silence.
+        //
+
+        const size_t lead = m_bank->taps / 2 - 1;
+
+        m_history.assign(lead * m_channels, 0.0f);
+        m_frames = lead;
+        m_start = 0;
+        m_phase = 0;
+        m_historyStart = -int64_t(lead);
+        m_inputEnd = -1;
+    }
+
+    void PolyphaseResampler::append(const float* in, size_t inSize, bool endFlag)
+    {
+        if (m_inputEnd >= 0)
+            reset();
+
+        const size_t pad = endFlag ? m_bank->taps / 2 : 0;
+        const size_t n = m_frames * m_channels;
+
+        m_history.resize((m_frames + inSize + pad) * m_channels);
+        if (inSize)
+            memcpy(&m_history[n], in, inSize * m_channels * sizeof(float));
+        if (pad)
+            fill(m_history.begin() + n + inSize * m_channels, m_history.end(), 0.0f);
+
+        if (endFlag)
+            m_inputEnd = m_historyStart + int64_t(m_frames + inSize);
+
+        m_frames += inSize + pad;
+    }
+
+    size_t PolyphaseResampler::available() const
+    {
+        const size_t taps = m_bank->taps;
+
+        if (m_start + taps > m_frames)
+            return 0;
+
+        //
+        //  Output k can be made if its window fits in the history, i.e.
+        //  if (m_phase + k * m_step) / m_denominator <= R.
+        //
+
+        const uint64_t R = m_frames - taps - m_start;
+        return size_t(((R + 1) * m_denominator - m_phase + m_step - 1) / m_step);
+    }
+
+    template <bool Interpolate> size_t PolyphaseResampler::generate(float* out, size_t outSize)
+    {
+        const FilterBank& bank = *m_bank;
+        const size_t taps = bank.taps;
+        const int64_t center = int64_t(taps / 2) - 1;
+        const size_t stepWhole = size_t(m_step / m_denominator);
+        const uint64_t stepFrac = m_step % m_denominator;
+        size_t n = 0;
+
+        for (; n < outSize && m_start + taps <= m_frames; n++)
+        {
+            if (m_inputEnd >= 0 && m_historyStart + int64_t(m_start) + center >= m_inputEnd)
+                break;
+
+            const float* h;
+
+            if (Interpolate)
+            {
+                const uint64_t p = m_phase * uint64_t(bank.phases);
+                const float t = float(p & 0xffffffff) * (1.0f / 4294967296.0f);
+                const float* h0 = bank.phase(p >> 32);
+                const float* h1 = h0 + taps;
+                float* hi = &m_coefficients.front();
+
+                for (size_t k = 0; k < taps; k++)
+                    hi[k] = h0[k] + t * (h1[k] - h0[k]);
+
+                h = hi;
+            }
+            else
+            {
+                h = bank.phase(m_phase);
+            }
+
+            filterSample(h, &m_history[m_start * m_channels], taps, m_channels, out + n * m_channels);
+
+            m_start += stepWhole;
+            m_phase += stepFrac;
+
+            if (m_phase >= m_denominator)
+            {
+                m_phase -= m_denominator;
+                m_start++;
+            }
+        }
+
+        return n;
+    }
+
+    void PolyphaseResampler::compact()
+    {
+        const size_t drop = min(m_start, m_frames);
+
+        if (drop)
+        {
+            m_history.erase(m_history.begin(), m_history.begin() + drop * m_channels);
+            m_frames -= drop;
+            m_start -= drop;
+            m_historyStart += int64_t(drop);
+        }
+    }
+
+    static void clampSamples(float* data, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            data[i] = min(1.0f, max(-1.0f, data[i]));
+    }
+
+    size_t PolyphaseResampler::process(const float* in, size_t inSize, float* out, size_t outSize, bool endFlag, bool enableClamp)
+    {
+        if (!m_bank)
+            return 0;
+
+        append(in, inSize, endFlag);
+
+        const size_t n = m_interpolate ? generate<true>(out, outSize) : generate<false>(out, outSize);
+
+        compact();
+
+        if (enableClamp)
+            clampSamples(out, n * m_channels);
+
+        return n;
+    }
+
+    size_t PolyphaseResampler::process(AudioBuffer& buffer, bool endFlag, bool enableClamp)
+    {
+        if (!m_bank)
+            return 0;
+
+        assert(buffer.numChannels() == m_channels);
+
+        //
+        //  The input is copied into the history first, so the buffer's
+        //  own memory can be reused for the output.
+        //
+
+        append(buffer.pointerIncludingMargin(), buffer.sizeIncludingMargin(), endFlag);
+
+        const size_t capacity = available();
+        buffer.reconfigure(capacity, buffer.channels(), buffer.rate() * m_factor, buffer.startTime());
+
+        const size_t n = m_interpolate ? generate<true>(buffer.pointer(), capacity) : generate<false>(buffer.pointer(), capacity);
+
+        compact();
+
+        if (n != capacity)
+            buffer.resize(n);
+
+        if (enableClamp)
+            clampSamples(buffer.pointer(), n * m_channels);
+
+        return n;
+    }
+
+} // namespace TwkAudio
@@ -6,13 +6,14 @@
 //
 //
 #include <TwkAudio/ScaleTime.h>
-#include <TwkMath/Function.h>
+#include <TwkAudio/TimeStretcher.h>
+#include <algorithm>
 #include <string.h>
+#include <vector>
 
 namespace TwkAudio
 {
     using namespace std;
-    using namespace TwkMath;
 
     void scaleTime(const AudioBuffer& inbuffer, AudioBuffer& outbuffer)
     {
@@ -23,32 +24,54 @@ namespace TwkAudio
         if (insize == outsize)
         {
             memcpy(outbuffer.pointer(), inbuffer.pointer(), inbuffer.sizeInBytes());
+            return;
         }
-        else if (insize > outsize)
+
+        if (!outsize)
+            return;
+
+        if (!insize || inbuffer.numChannels() != ch)
         {
-            if (ch == 1)
-            {
+            outbuffer.zero();
+            return;
+        }
+
+        //
+        //  Stretch the whole buffer, reading zeros before and after it.
+        //  The grain before the first one is processed (and thrown
+        //  away) so the output doesn't fade in.
+        //
 
-                size_t index = 0;
-                double s = outbuffer.size();
-                float* o = outbuffer.pointer();
+        TimeStretcher stretcher(ch, outbuffer.rate());
+        const double factor = double(insize) / double(outsize);
+        const size_t hop = stretcher.hopSize();
+        const size_t gsize = stretcher.grainInputSize();
+        const float* in = inbuffer.pointer();
+        float* out = outbuffer.pointer();
+        vector<float> grain(gsize * ch);
+        vector<float> block(hop * ch);
 
-                for (const float *i = inbuffer.pointer(), *e = i + outbuffer.size(); i < e; i++, index++)
-                {
-                    *o = *i * smoothstep(1.0 - double(index) / s);
-                }
+        for (SampleTime k = -1, o = 0; o < SampleTime(outsize); k++)
+        {
+            const SampleTime s0 = stretcher.grainInputStart(k, factor);
+            const SampleTime a = max(SampleTime(0), -s0);
+            const SampleTime b = min(SampleTime(gsize), SampleTime(insize) - s0);
 
-                index = 0;
-                o = outbuffer.pointer();
+            fill(grain.begin(), grain.end(), 0.0f);
 
-                for (const float *i = inbuffer.pointer() + (insize - outsize), *e = i + outbuffer.size(); i < e; i++, index++)
-                {
-                    *o = *i * smoothstep(double(index) / s);
-                }
-            }
-            else if (ch == 2)
+            if (a < b)
             {
+                memcpy(&grain[a * ch], in + (s0 + a) * ch, (b - a) * ch * sizeof(float));
             }
+
+            stretcher.process(&grain.front(), &block.front());
+
+            if (k < 0)
+                continue;
+
+            const size_t n = min(hop, outsize - size_t(o));
+            memcpy(out + o * ch, &block.front(), n * ch * sizeof(float));
+            o += n;
         }
     }
 
@@ -0,0 +1,271 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#include <TwkAudio/TimeStretcher.h>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TWKAUDIO_SSE
+#include <emmintrin.h>
+#endif
+
+namespace TwkAudio
+{
+    using namespace std;
+
+    //
+    //  The alignment search first tries every CoarseStep'th offset then
+    //  every offset within CoarseStep of the best of those.
+    //
+
+    static const double Pi = 3.14159265358979323846;
+    static const size_t CoarseStep = 4;
+
+    static float dot(const float* a, const float* b, size_t n)
+    {
+        size_t i = 0;
+        float sum = 0.0f;
+
+#ifdef TWKAUDIO_SSE
+        __m128 s0 = _mm_setzero_ps();
+        __m128 s1 = _mm_setzero_ps();
+
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm_add_ps(s0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            s1 = _mm_add_ps(s1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+
+        float r[4];
+        _mm_storeu_ps(r, _mm_add_ps(s0, s1));
+        sum = (r[0] + r[1]) + (r[2] + r[3]);
+#endif
+
+        for (; i < n; i++)
+            sum += a[i] * b[i];
+        return sum;
+    }
+
+    TimeStretcher::TimeStretcher(int numChannels, Time rate, Time windowDuration, Time searchDuration)
+        : m_channels(numChannels)
+        , m_rate(rate)
+        , m_hop(max(SampleTime(16), timeToSamples(windowDuration / 2.0, rate)))
+        , m_search(max(SampleTime(0), timeToSamples(searchDuration, rate)))
+        , m_primed(false)
+    {
+        //
+        //  A periodic Hann window: the second half of one grain and the
+        //  first half of the next always sum to one.
+        //
+
+        const size_t n = windowSize();
+        m_window.resize(n);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            m_window[i] = float(0.5 - 0.5 * cos(2.0 * Pi * double(i) / double(n)));
+        }
+
+        m_overlap.resize(m_hop * m_channels);
+        m_reference.resize(m_hop);
+        m_mono.resize(grainInputSize());
+        m_energy.resize(grainInputSize() + 1);
+
+        reset();
+    }
+
+    TimeStretcher::~TimeStretcher() {}
+
+    void TimeStretcher::reset()
+    {
+        fill(m_overlap.begin(), m_overlap.end(), 0.0f);
+        m_primed = false;
+    }
+
+    SampleTime TimeStretcher::grainInputStart(SampleTime grain, double factor) const
+    {
+        const double center = double(grain * SampleTime(m_hop) + SampleTime(m_hop)) * factor;
+        return SampleTime(floor(center + 0.5)) - SampleTime(m_hop + m_search);
+    }
+
+    //
+    //  Returns the offset into in (0 to 2 * searchSize()) of the grain
+    //  which best continues the previous one: the one whose first half
+    //  has the highest normalized correlation with m_reference.
+    //
+
+    size_t TimeStretcher::bestOffset(const float* in)
+    {
+        const size_t ch = m_channels;
+        const size_t n = grainInputSize();
+        float* mono = &m_mono.front();
+
+        if (ch == 1)
+        {
+            memcpy(mono, in, n * sizeof(float));
+        }
+        else
+        {
+            for (size_t i = 0; i < n; i++, in += ch)
+            {
+                float s = in[0];
+                for (size_t c = 1; c < ch; c++)
+                    s += in[c];
+                mono[i] = s;
+            }
+        }
+
+        if (!m_primed || m_search == 0)
+            return m_search;
+
+        const float* ref = &m_reference.front();
+        const double refEnergy = dot(ref, ref, m_hop);
+        if (refEnergy < 1e-12)
+            return m_search;
+
+        m_energy[0] = 0.0;
+        for (size_t i = 0; i < n; i++)
+            m_energy[i + 1] = m_energy[i] + double(mono[i]) * double(mono[i]);
+
+        const size_t last = 2 * m_search;
+        size_t best = m_search;
+        double bestScore = -1.0;
+
+        //
+        //  Compares score^2 (keeping the sign) to avoid the square root
+        //
+
+        for (size_t pass = 0; pass < 2; pass++)
+        {
+            const size_t step = pass == 0 ? CoarseStep : 1;
+            const size_t d0 = pass == 0 ? 0 : (best > CoarseStep ? best - CoarseStep + 1 : 0);
+            const size_t d1 = pass == 0 ? last : min(last, best + CoarseStep - 1);
+
+            for (size_t d = d0; d <= d1; d += step)
+            {
+                if (pass == 1 && (d % CoarseStep) == 0)
+                    continue;
+
+                const double c = dot(ref, mono + d, m_hop);
+                const double e = m_energy[d + m_hop] - m_energy[d] + 1e-12;
+                const double score = (c < 0 ? -c * c : c * c) / e;
+
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = d;
+                }
+            }
+        }
+
+        return best;
+    }
+
+    void TimeStretcher::process(const float* in, float* out)
+    {
+        const size_t ch = m_channels;
+        const size_t hop = m_hop;
+        const size_t d = bestOffset(in);
+        const float* g = in + d * ch;
+        const float* w0 = &m_window.front();
+        const float* w1 = w0 + hop;
+        float* overlap = &m_overlap.front();
+
+        for (size_t i = 0; i < hop; i++)
+        {
+            const float a = w0[i];
+            const float b = w1[i];
+            const float* g0 = g + i * ch;
+            const float* g1 = g0 + hop * ch;
+            float* o = out + i * ch;
+            float* t = overlap + i * ch;
+
+            for (size_t c = 0; c < ch; c++)
+            {
+                o[c] = t[c] + a * g0[c];
+                t[c] = b * g1[c];
+            }
+        }
+
+        //
+        //  The next grain should line up with what follows this one in
+        //  the input
+        //
+
+        memcpy(&m_reference.front(), &m_mono[d + hop], hop * sizeof(float));
+        m_primed = true;
+    }
+
+    //----------------------------------------------------------------------
+
+    TimeStretchStream::TimeStretchStream(int numChannels, Time rate, Time windowDuration, Time searchDuration)
+        : m_stretcher(numChannels, rate, windowDuration, searchDuration)
+        , m_factor(0)
+        , m_grain(0)
+        , m_start(0)
+    {
+        m_input.resize(m_stretcher.grainInputSize() * m_stretcher.size());
+    }
+
+    TimeStretchStream::~TimeStretchStream() {}
+
+    void TimeStretchStream::reset()
+    {
+        m_factor = 0;
+        m_ready.clear();
+    }
+
+    void TimeStretchStream::readGrain(Source& source, SampleTime grain)
+    {
+        std::fill(m_input.begin(), m_input.end(), 0.0f);
+        source.read(m_stretcher.grainInputStart(grain, m_factor), m_stretcher.grainInputSize(), &m_input.front());
+    }
+
+    void TimeStretchStream::fill(Source& source, double factor, SampleTime start, size_t n, float* out)
+    {
+        const size_t ch = m_stretcher.size();
+        const SampleTime hop = m_stretcher.hopSize();
+        const SampleTime ready = m_ready.size() / ch;
+
+        if (factor != m_factor || start < m_start || start > m_start + ready)
+        {
+            const SampleTime g = (start >= 0 ? start : start - hop + 1) / hop;
+
+            m_stretcher.reset();
+            m_factor = factor;
+            m_grain = g;
+            m_start = g * hop;
+            m_ready.resize(hop * ch);
+
+            readGrain(source, g - 1);
+            m_stretcher.process(&m_input.front(), &m_ready.front());
+            m_ready.clear();
+        }
+
+        while (m_start + SampleTime(m_ready.size() / ch) < start + SampleTime(n))
+        {
+            const size_t o = m_ready.size();
+            readGrain(source, m_grain);
+            m_ready.resize(o + hop * ch);
+            m_stretcher.process(&m_input.front(), &m_ready[o]);
+            m_grain++;
+        }
+
+        const size_t offset = (start - m_start) * ch;
+        memcpy(out, &m_ready[offset], n * ch * sizeof(float));
+
+        //
+        //  Keep what's left for the next fill()
+        //
+
+        m_ready.erase(m_ready.begin(), m_ready.begin() + offset + n * ch);
+        m_start = start + SampleTime(n);
+    }
+
+} // namespace TwkAudio
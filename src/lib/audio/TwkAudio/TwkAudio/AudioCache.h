@@ -10,6 +10,7 @@
 #include <TwkAudio/Audio.h>
 #include <TwkAudio/AudioFormats.h>
 #include <TwkAudio/dll_defs.h>
+#include <atomic>
 #include <map>
 #include <pthread.h>
 #include <utility>
@@ -27,12 +28,20 @@ namespace TwkAudio
     /// packet size. For example, you can evaluate 1k packets to minimize
     /// file system hits and lookup 128k regions after the fact.
     ///
+    /// Packets are found arithmetically by packet number in a segmented
+    /// index: segments of slots are allocated as the cached range grows
+    /// and are never moved or freed while the cache is in use. Each slot
+    /// has a sequence number which is odd while the slot is being
+    /// changed. This lets fillBuffer() and exists() run without the lock
+    /// (and without allocating) on the audio callback thread: a packet
+    /// which changes while it is being copied is treated as a miss.
+    /// Everything else still requires the lock.
+    ///
 
     class TWKAUDIO_EXPORT AudioCache
     {
     public:
         typedef float* Packet;
-        typedef std::map<SampleTime, Packet> PacketMap;
         typedef std::vector<Packet> PacketVector;
         typedef std::pair<int, int> FrameRange;
         typedef std::vector<FrameRange> FrameRangeVector;
@@ -79,7 +88,8 @@ namespace TwkAudio
 
         void clear(Time time0, Time time1);
 
-        /// A lock is requred before public API calls
+        /// A lock is requred before public API calls other than
+        /// fillBuffer(), exists() and totalSecondsCached()
 
         void lock() { pthread_mutex_lock(&m_lock); }
 
@@ -111,6 +121,7 @@ namespace TwkAudio
         /// possible. Returns true if the entire buffer was filled. The
         /// input buffer rate and channels should match the packet
         /// configuration, but the duration and start can be anything.
+        /// Does not require the lock, never blocks and never allocates.
         ///
 
         bool fillBuffer(AudioBuffer&) const;
@@ -120,13 +131,13 @@ namespace TwkAudio
         /// that SampleTime is sample offset so it could be negative.
         ///
 
-        bool exists(SampleTime packet) const { return find(packet) != 0; }
+        bool exists(SampleTime packet) const;
 
         ///
         /// Returns the total number of seconds of cached audio
         ///
 
-        Time totalSecondsCached() const { return m_totalSecondsCached; }
+        Time totalSecondsCached() const { return m_totalSecondsCached.load(std::memory_order_relaxed); }
 
         ///
         /// Computes the cached range stat
@@ -137,21 +148,76 @@ namespace TwkAudio
     protected:
         SampleTime sampleAtTime(Time t) const { return timeToSamples(t, m_packetRate); }
 
-        SampleTime packetOffset(SampleTime s) const { return s % m_packetSize; }
+        SampleTime packetNumber(SampleTime s) const
+        {
+            const SampleTime n = s / SampleTime(m_packetSize);
+            return n * SampleTime(m_packetSize) > s ? n - 1 : n;
+        }
+
+        SampleTime packetOffset(SampleTime s) const { return s - packetNumber(s) * SampleTime(m_packetSize); }
+
+    private:
+        enum
+        {
+            SegmentShift = 8,
+            SegmentSize = 1 << SegmentShift
+        };
+
+        struct Slot
+        {
+            Slot()
+                : seq(0)
+                , packet(0)
+            {
+            }
+
+            std::atomic<unsigned int> seq;
+            std::atomic<float*> packet;
+        };
+
+        struct Segment
+        {
+            Slot slots[SegmentSize];
+        };
+
+        struct Directory
+        {
+            Directory(size_t n);
+            ~Directory();
+
+            size_t size;
+            std::atomic<Segment*>* segments;
+        };
+
+        ///
+        /// Cached packet numbers as [first, last) runs keyed by first.
+        /// Only touched with the lock held.
+        ///
+
+        typedef std::map<SampleTime, SampleTime> RunMap;
+
+        Slot* slot(SampleTime packetNum) const;
+        Slot* slotForWrite(SampleTime packetNum);
+        void publish(Slot*, Packet);
+        void removeRange(SampleTime first, SampleTime last);
+        void insertRun(SampleTime packetNum);
+        void waitForReaders() const;
+        void updateTotal();
 
-        const Packet find(SampleTime) const;
+        bool copyPacket(SampleTime packetNum, SampleTime offset, float* out, SampleTime samples, int numChannels) const;
 
     private:
         size_t m_packetSize;
         TwkAudio::Layout m_packetLayout;
         Time m_packetRate;
-        PacketMap m_map;
+        std::atomic<Directory*> m_directory;
+        std::vector<Directory*> m_retiredDirectories;
+        RunMap m_runs;
         int m_count;
         pthread_mutex_t m_lock;
-        Time m_totalSecondsCached;
+        std::atomic<Time> m_totalSecondsCached;
+        mutable std::atomic<int> m_readers;
         PacketVector m_freePackets;
-        FrameRangeVector m_cachedRangesStat;
-        double m_cachedRangesStatFrameRate;
     };
 
 } // namespace TwkAudio
@@ -0,0 +1,124 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkAudio__PolyphaseResampler__h__
+#define __TwkAudio__PolyphaseResampler__h__
+#include <TwkAudio/Audio.h>
+#include <TwkAudio/dll_defs.h>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace TwkAudio
+{
+
+    /// Resample an interleaved n-channel stream with a polyphase filter
+
+    ///
+    /// PolyphaseResampler is a drop in replacement for MultiResampler
+    /// which works directly on interleaved samples: there's no
+    /// deinterlacing into per channel buffers and every channel of a
+    /// sample is filtered together (vectorized across channels).
+    ///
+    /// The factor is the output rate divided by the input rate. When it
+    /// is (close to) a ratio L/M with L <= maxPhases() -- which covers
+    /// conversions between all the usual rates -- there is one filter
+    /// phase per output position and no interpolation. Otherwise the
+    /// filter is interpolated between 256 phases.
+    ///
+    /// The filter banks (a Kaiser windowed sinc) are computed once per
+    /// ratio and shared by all the resamplers which use it.
+    ///
+
+    class TWKAUDIO_EXPORT PolyphaseResampler
+    {
+    public:
+        PolyphaseResampler(int numChannels, double factor, size_t blocksize = 64);
+        ~PolyphaseResampler();
+
+        ///
+        /// Releases the filter bank and the history. The resampler
+        /// can't be used after this.
+        ///
+
+        void close();
+
+        ///
+        /// The blocksize is only kept for compatibility with
+        /// MultiResampler; input is always filtered in one pass.
+        ///
+
+        size_t blocksize() const { return m_blocksize; }
+
+        double factor() const { return m_factor; }
+
+        size_t size() const { return m_channels; }
+
+        ///
+        /// Number of input samples each output sample is computed
+        /// from. Output lags input by half of this.
+        ///
+
+        size_t filterWidth() const;
+
+        size_t outputSize(size_t inputSize) const { return size_t(m_factor * double(inputSize)); }
+
+        ///
+        /// Same as MultiResampler::process(). All of the input is
+        /// consumed; the return value is the number of samples written
+        /// to out, which can be less than outSize. If endFlag is true
+        /// the input is taken to end here and the filter is flushed.
+        ///
+
+        size_t process(const float* in, size_t inSize, float* out, size_t outSize, bool endFlag, bool enableClamp);
+
+        ///
+        /// Resamples buffer (including its margin) in place. On return
+        /// it holds the output samples, has no margin and its rate is
+        /// multiplied by the factor.
+        ///
+
+        size_t process(AudioBuffer& buffer, bool endFlag, bool enableClamp);
+
+        void reset();
+
+        ///
+        /// Largest number of phases used for an exact ratio
+        ///
+
+        static int maxPhases() { return 1024; }
+
+    private:
+        struct FilterBank;
+
+        static std::shared_ptr<const FilterBank> filterBank(int phases, double scale);
+
+        void append(const float* in, size_t inSize, bool endFlag);
+        size_t available() const;
+        template <bool Interpolate> size_t generate(float* out, size_t outSize);
+        void compact();
+
+    private:
+        double m_factor;
+        size_t m_blocksize;
+        size_t m_channels;
+        bool m_interpolate;
+        std::shared_ptr<const FilterBank> m_bank;
+        std::vector<float> m_history;      // interleaved input not yet consumed
+        std::vector<float> m_coefficients; // interpolated phase
+        size_t m_frames;                   // frames in m_history
+        size_t m_start;                    // first frame of the next output's window
+        uint64_t m_phase;                  // position between frames in 1 / m_denominator
+        uint64_t m_denominator;
+        uint64_t m_step;        // input advance per output in 1 / m_denominator
+        int64_t m_historyStart; // input frame number of m_history[0]
+        int64_t m_inputEnd;     // total input frames once flushed, or -1
+    };
+
+} // namespace TwkAudio
+
+#endif // __TwkAudio__PolyphaseResampler__h__
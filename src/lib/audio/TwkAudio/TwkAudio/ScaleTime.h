@@ -14,6 +14,11 @@
 namespace TwkAudio
 {
 
+    //
+    //  Stretches (or squeezes) all of in into out without changing its
+    //  pitch. in and out must have the same channels.
+    //
+
     TWKAUDIO_EXPORT void scaleTime(const AudioBuffer& in, AudioBuffer& out);
 
 } // namespace TwkAudio
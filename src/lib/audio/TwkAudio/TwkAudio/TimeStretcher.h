@@ -0,0 +1,166 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkAudio__TimeStretcher__h__
+#define __TwkAudio__TimeStretcher__h__
+#include <TwkAudio/Audio.h>
+#include <TwkAudio/dll_defs.h>
+#include <vector>
+
+namespace TwkAudio
+{
+
+    /// Change the speed of an interleaved n-channel stream without changing its pitch
+
+    ///
+    /// TimeStretcher is a WSOLA (waveform similarity overlap-add)
+    /// time stretcher. Output is built from Hann windowed grains of
+    /// windowSize() samples spaced hopSize() apart. Each grain is read
+    /// from near the input position which corresponds to it, shifted by
+    /// up to searchSize() samples so that it lines up with the input
+    /// which naturally follows the previous grain. Because the grains
+    /// are aligned on the waveform there's no phasing or flanging and
+    /// pitch is preserved at any speed.
+    ///
+    /// The alignment is found on a mono mix of the channels with a
+    /// coarse search refined around the best match, so the cost per
+    /// grain is nearly independent of the channel count. All of the
+    /// channels are windowed and added together.
+    ///
+    /// The caller supplies the input, grain by grain: for grain k it
+    /// reads grainInputSize() samples starting at grainInputStart(k,
+    /// factor) (the factor is the input duration over the output
+    /// duration, e.g. 2 when playing twice as fast) and process()
+    /// returns output samples k * hopSize() to (k + 1) * hopSize().
+    /// Grains must be processed in order; call reset() before starting
+    /// somewhere else.
+    ///
+
+    class TWKAUDIO_EXPORT TimeStretcher
+    {
+    public:
+        TimeStretcher(int numChannels, Time rate, Time windowDuration = 0.040, Time searchDuration = 0.012);
+        ~TimeStretcher();
+
+        size_t size() const { return m_channels; }
+
+        Time rate() const { return m_rate; }
+
+        size_t windowSize() const { return m_hop * 2; }
+
+        size_t hopSize() const { return m_hop; }
+
+        size_t searchSize() const { return m_search; }
+
+        ///
+        /// Number of input samples process() reads for each grain
+        ///
+
+        size_t grainInputSize() const { return windowSize() + 2 * m_search; }
+
+        ///
+        /// First input sample for grain k (may be negative). The
+        /// grain's window is centered on the input sample which
+        /// corresponds to the center of its output.
+        ///
+
+        SampleTime grainInputStart(SampleTime grain, double factor) const;
+
+        ///
+        /// Adds the grain in in (grainInputSize() interleaved samples)
+        /// and writes the hopSize() samples it completes to out.
+        ///
+
+        void process(const float* in, float* out);
+
+        ///
+        /// Forgets the previous grain. The next one is not aligned and
+        /// its output fades in.
+        ///
+
+        void reset();
+
+    private:
+        size_t bestOffset(const float* in);
+
+    private:
+        size_t m_channels;
+        Time m_rate;
+        size_t m_hop;
+        size_t m_search;
+        bool m_primed;
+        std::vector<float> m_window;    // windowSize() Hann window
+        std::vector<float> m_overlap;   // interleaved tail of the previous grain
+        std::vector<float> m_reference; // mono input following the previous grain
+        std::vector<float> m_mono;      // mono mix of the search region
+        std::vector<double> m_energy;   // running sum of m_mono squared
+    };
+
+    /// Plays a stream through a TimeStretcher one buffer at a time
+
+    ///
+    /// TimeStretchStream makes output sample s from around input sample
+    /// s * factor. Grains are only read (from a Source) and processed
+    /// when the output they complete is needed, and output left over
+    /// from one fill() is kept for the next. So filling consecutive
+    /// ranges carries on from where the last one finished. Any other
+    /// range, or a new factor, starts over with the grain before the
+    /// first one needed so the output doesn't fade in.
+    ///
+
+    class TWKAUDIO_EXPORT TimeStretchStream
+    {
+    public:
+        class Source
+        {
+        public:
+            virtual ~Source() {}
+
+            ///
+            /// Reads input samples start to start + n (start may be
+            /// negative) into out, which holds n interleaved samples
+            /// and is zeroed. Anything the source doesn't have can be
+            /// left as silence.
+            ///
+
+            virtual void read(SampleTime start, size_t n, float* out) = 0;
+        };
+
+        TimeStretchStream(int numChannels, Time rate, Time windowDuration = 0.040, Time searchDuration = 0.012);
+        ~TimeStretchStream();
+
+        const TimeStretcher& stretcher() const { return m_stretcher; }
+
+        ///
+        /// Writes output samples start to start + n (interleaved) to
+        /// out.
+        ///
+
+        void fill(Source& source, double factor, SampleTime start, size_t n, float* out);
+
+        ///
+        /// Forgets the output kept from the last fill(). Call it when
+        /// the source changes.
+        ///
+
+        void reset();
+
+    private:
+        void readGrain(Source& source, SampleTime grain);
+
+    private:
+        TimeStretcher m_stretcher;
+        double m_factor;
+        SampleTime m_grain;         // next grain to process
+        SampleTime m_start;         // output sample of m_ready[0]
+        std::vector<float> m_ready; // processed but not returned yet
+        std::vector<float> m_input; // input of the current grain
+    };
+
+} // namespace TwkAudio
+
+#endif // __TwkAudio__TimeStretcher__h__
@@ -0,0 +1,571 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+
+#include <TwkUtil/DirectoryScanner.h>
+#include <TwkUtil/EnvVar.h>
+#include <TwkUtil/FNV1a.h>
+#include <TwkUtil/TaskPool.h>
+#include <atomic>
+#include <filesystem>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+
+#ifdef _MSC_VER
+#include <process.h>
+#include <windows.h>
+#define getpid _getpid
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#endif
+
+namespace TwkUtil
+{
+    using namespace std;
+
+    static ENVVAR_STRING(evDirScanCacheDir, "RV_DIR_SCAN_CACHE_DIR", "");
+
+    namespace
+    {
+
+        const uint32_t ListingMagic = 0x53445652; // "RVDS"
+        const uint32_t ProbeMagic = 0x50445652;   // "RVDP"
+        const uint32_t CacheVersion = 1;
+
+        //
+        //  Anything modified more recently than this isn't cached: a
+        //  change within the file system's timestamp resolution wouldn't
+        //  show.
+        //
+
+        const int64_t RacySeconds = 2;
+
+        //
+        //  Untyped entries are stat'd in chunks of this many per task
+        //
+
+        const size_t StatChunkSize = 256;
+
+        struct Stamp
+        {
+            uint64_t device;
+            uint64_t inode;
+            uint64_t size;
+            int64_t mtimeSec;
+            int64_t mtimeNsec;
+
+            bool operator==(const Stamp& s) const
+            {
+                return device == s.device && inode == s.inode && size == s.size && mtimeSec == s.mtimeSec && mtimeNsec == s.mtimeNsec;
+            }
+        };
+
+        bool stamp(const string& path, Stamp& s)
+        {
+#ifdef _MSC_VER
+            struct _stat64 sb;
+#else
+            struct stat sb;
+#endif
+            if (TwkUtil::stat(path.c_str(), &sb) != 0)
+                return false;
+
+            s.device = uint64_t(sb.st_dev);
+            s.inode = uint64_t(sb.st_ino);
+            s.size = uint64_t(sb.st_size);
+            s.mtimeSec = int64_t(sb.st_mtime);
+#if defined(PLATFORM_LINUX)
+            s.mtimeNsec = int64_t(sb.st_mtim.tv_nsec);
+#elif defined(PLATFORM_DARWIN)
+            s.mtimeNsec = int64_t(sb.st_mtimespec.tv_nsec);
+#else
+            s.mtimeNsec = 0;
+#endif
+            return true;
+        }
+
+        bool racy(const Stamp& s) { return int64_t(time(0)) - s.mtimeSec < RacySeconds; }
+
+        //
+        //  Cache files are native endian: they're only ever read on the
+        //  machine which wrote them.
+        //
+
+        class CacheWriter
+        {
+        public:
+            template <typename T> void put(const T& v) { m_data.append((const char*)&v, sizeof(T)); }
+
+            void putString(const string& s)
+            {
+                put(uint32_t(s.size()));
+                m_data.append(s);
+            }
+
+            const string& data() const { return m_data; }
+
+        private:
+            string m_data;
+        };
+
+        class CacheReader
+        {
+        public:
+            CacheReader(const string& data)
+                : m_data(data)
+                , m_pos(0)
+            {
+            }
+
+            template <typename T> bool get(T& v)
+            {
+                if (m_data.size() - m_pos < sizeof(T))
+                    return false;
+                memcpy(&v, m_data.data() + m_pos, sizeof(T));
+                m_pos += sizeof(T);
+                return true;
+            }
+
+            bool getString(string& s)
+            {
+                uint32_t n;
+                if (!get(n) || m_data.size() - m_pos < n)
+                    return false;
+                s.assign(m_data, m_pos, n);
+                m_pos += n;
+                return true;
+            }
+
+            bool atEnd() const { return m_pos == m_data.size(); }
+
+            //
+            //  True if what's left could hold count strings. Checked
+            //  before sizing anything from a count read out of the file.
+            //
+
+            bool fits(uint32_t count) const { return (m_data.size() - m_pos) / sizeof(uint32_t) >= count; }
+
+        private:
+            const string& m_data;
+            size_t m_pos;
+        };
+
+        //
+        //  Probe results are also named by the representative file's
+        //  inode so relative keys from different directories don't keep
+        //  replacing each other.
+        //
+
+        string cacheFile(const string& cacheDir, char kind, const string& key, const Stamp* file = 0)
+        {
+            string id = key;
+
+            if (file)
+                id.append((const char*)&file->device, sizeof(file->device) + sizeof(file->inode));
+
+            ostringstream str;
+            str << cacheDir << "/" << kind << hex << uint64_t(FNV1a64(id.data(), id.size()));
+            return str.str();
+        }
+
+        bool readCacheFile(const string& file, string& data)
+        {
+            FILE* fp = TwkUtil::fopen(file.c_str(), "rb");
+            if (!fp)
+                return false;
+
+            char buffer[64 * 1024];
+            size_t n;
+            data.clear();
+
+            while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+                data.append(buffer, n);
+
+            fclose(fp);
+            return true;
+        }
+
+        //
+        //  Written to a temporary file and renamed so concurrent readers
+        //  (other rvls processes) never see a partial file.
+        //
+
+        void writeCacheFile(const string& cacheDir, const string& file, const string& data)
+        {
+            error_code ec;
+            filesystem::create_directories(filesystem::u8path(cacheDir), ec);
+
+            static atomic<unsigned int> counter(0);
+            ostringstream tmp;
+            tmp << file << "." << getpid() << "." << counter++ << ".tmp";
+
+            FILE* fp = TwkUtil::fopen(tmp.str().c_str(), "wb");
+            if (!fp)
+                return;
+
+            const bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+
+            if (fclose(fp) != 0 || !ok)
+            {
+                filesystem::remove(filesystem::u8path(tmp.str()), ec);
+                return;
+            }
+
+            filesystem::rename(filesystem::u8path(tmp.str()), filesystem::u8path(file), ec);
+            if (ec)
+                filesystem::remove(filesystem::u8path(tmp.str()), ec);
+        }
+
+        string absolutePath(const string& dir)
+        {
+            error_code ec;
+            filesystem::path p = filesystem::absolute(filesystem::u8path(dir), ec);
+            string s = ec ? dir : p.lexically_normal().u8string();
+
+            while (s.size() > 1 && (s.back() == '/' || s.back() == '\\'))
+                s.pop_back();
+
+            return s;
+        }
+
+        //
+        //  Reads the directory. Directory entries get a trailing "/".
+        //
+
+        bool readDirectory(const string& dir, FileNameList& files)
+        {
+            files.clear();
+
+#if defined(_MSC_VER)
+            WIN32_FIND_DATAW data;
+            wstring mask = to_wstring(dir.c_str()) + L"/*";
+            HANDLE h = FindFirstFileExW(mask.c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+            if (h == INVALID_HANDLE_VALUE)
+                return false;
+
+            do
+            {
+                if (!wcscmp(data.cFileName, L".") || !wcscmp(data.cFileName, L".."))
+                    continue;
+
+                files.push_back(to_utf8(data.cFileName));
+                if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+                    files.back() += "/";
+            } while (FindNextFileW(h, &data));
+
+            FindClose(h);
+            return true;
+#else
+            vector<size_t> untyped;
+
+#if defined(PLATFORM_LINUX)
+            int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0)
+                return false;
+
+            //
+            //  linux_dirent64 as the kernel returns it. glibc only has a
+            //  getdents64() wrapper from 2.30 on.
+            //
+
+            struct KernelDirent
+            {
+                uint64_t d_ino;
+                int64_t d_off;
+                unsigned short d_reclen;
+                unsigned char d_type;
+                char d_name[1];
+            };
+
+            vector<uint64_t> buffer(256 * 1024 / sizeof(uint64_t));
+
+            for (;;)
+            {
+                long n = syscall(SYS_getdents64, fd, buffer.data(), buffer.size() * sizeof(uint64_t));
+
+                if (n < 0)
+                {
+                    close(fd);
+                    return false;
+                }
+
+                if (n == 0)
+                    break;
+
+                const char* p = (const char*)buffer.data();
+
+                for (long offset = 0; offset < n;)
+                {
+                    const KernelDirent* d = (const KernelDirent*)(p + offset);
+                    offset += d->d_reclen;
+
+                    if (!strcmp(d->d_name, ".") || !strcmp(d->d_name, ".."))
+                        continue;
+
+                    files.push_back(d->d_name);
+
+                    if (d->d_type == DT_DIR)
+                        files.back() += "/";
+                    else if (d->d_type == DT_UNKNOWN)
+                        untyped.push_back(files.size() - 1);
+                }
+            }
+#else
+            DIR* dp = opendir(dir.c_str());
+            if (!dp)
+                return false;
+
+            int fd = dirfd(dp);
+
+            while (dirent* d = readdir(dp))
+            {
+                if (!strcmp(d->d_name, ".") || !strcmp(d->d_name, ".."))
+                    continue;
+
+                files.push_back(d->d_name);
+
+                if (d->d_type == DT_DIR)
+                    files.back() += "/";
+                else if (d->d_type == DT_UNKNOWN)
+                    untyped.push_back(files.size() - 1);
+            }
+#endif
+
+            //
+            //  Entries the file system didn't type are stat'd (without
+            //  following links, like the types it does give).
+            //
+
+            if (!untyped.empty())
+            {
+                TaskPool::Group group(untyped.size() > StatChunkSize ? TaskPool::globalPool() : 0);
+
+                for (size_t begin = 0; begin < untyped.size(); begin += StatChunkSize)
+                {
+                    const size_t end = min(untyped.size(), begin + StatChunkSize);
+
+                    group.run(
+                        [&, begin, end]()
+                        {
+                            for (size_t i = begin; i < end; i++)
+                            {
+                                string& name = files[untyped[i]];
+                                struct stat sb;
+
+                                if (fstatat(fd, name.c_str(), &sb, AT_SYMLINK_NOFOLLOW) == 0 && S_ISDIR(sb.st_mode))
+                                    name += "/";
+                            }
+                        });
+                }
+
+                group.wait();
+            }
+
+#if defined(PLATFORM_LINUX)
+            close(fd);
+#else
+            closedir(dp);
+#endif
+            return true;
+#endif
+        }
+
+    } // namespace
+
+    DirectoryScanner::DirectoryScanner()
+        : m_cacheDir(evDirScanCacheDir.getValue())
+    {
+    }
+
+    DirectoryScanner::DirectoryScanner(const string& cacheDir)
+        : m_cacheDir(cacheDir)
+    {
+    }
+
+    void DirectoryScanner::scan(const vector<string>& dirs, Listings& listings, bool showDirs) const
+    {
+        listings.resize(dirs.size());
+
+        {
+            TaskPool::Group group(dirs.size() > 1 ? TaskPool::globalPool() : 0);
+
+            for (size_t i = 0; i < dirs.size(); i++)
+            {
+                Listing& listing = listings[i];
+                listing.path = dirs[i];
+                group.run([this, &listing]() { scanOne(listing); });
+            }
+
+            group.wait();
+        }
+
+        if (!showDirs)
+        {
+            for (size_t i = 0; i < listings.size(); i++)
+            {
+                FileNameList& files = listings[i].files;
+                size_t n = 0;
+
+                for (size_t q = 0; q < files.size(); q++)
+                {
+                    if (files[q].empty() || files[q].back() != '/')
+                        files[n++].swap(files[q]);
+                }
+
+                files.resize(n);
+            }
+        }
+    }
+
+    bool DirectoryScanner::scan(const string& dir, FileNameList& files, bool showDirs) const
+    {
+        Listings listings;
+        scan(vector<string>(1, dir), listings, showDirs);
+        files.swap(listings.front().files);
+        return listings.front().ok;
+    }
+
+    void DirectoryScanner::scanOne(Listing& listing) const
+    {
+        listing.ok = false;
+        listing.cached = false;
+        listing.files.clear();
+
+        Stamp dirStamp;
+        const bool useCache = !m_cacheDir.empty() && stamp(listing.path, dirStamp);
+        const string path = useCache ? absolutePath(listing.path) : string();
+        const string file = useCache ? cacheFile(m_cacheDir, 'd', path) : string();
+
+        if (useCache)
+        {
+            string data;
+
+            if (readCacheFile(file, data))
+            {
+                CacheReader reader(data);
+                uint32_t magic, version, count;
+                Stamp cachedStamp;
+                string cachedPath;
+
+                if (reader.get(magic) && magic == ListingMagic && reader.get(version) && version == CacheVersion
+                    && reader.get(cachedStamp) && cachedStamp == dirStamp && reader.getString(cachedPath) && cachedPath == path
+                    && reader.get(count) && reader.fits(count))
+                {
+                    listing.files.resize(count);
+                    bool ok = true;
+
+                    for (size_t i = 0; ok && i < count; i++)
+                        ok = reader.getString(listing.files[i]);
+
+                    if (ok && reader.atEnd())
+                    {
+                        listing.ok = true;
+                        listing.cached = true;
+                        return;
+                    }
+
+                    listing.files.clear();
+                }
+            }
+        }
+
+        listing.ok = readDirectory(listing.path, listing.files);
+
+        if (listing.ok && useCache && !racy(dirStamp))
+        {
+            CacheWriter writer;
+            writer.put(ListingMagic);
+            writer.put(CacheVersion);
+            writer.put(dirStamp);
+            writer.putString(path);
+            writer.put(uint32_t(listing.files.size()));
+
+            for (size_t i = 0; i < listing.files.size(); i++)
+                writer.putString(listing.files[i]);
+
+            writeCacheFile(m_cacheDir, file, writer.data());
+        }
+    }
+
+    void DirectoryScanner::probe(const vector<string>& keys, const vector<string>& files, const ProbeFunction& fn,
+                                 vector<ProbeResult>& results) const
+    {
+        results.assign(keys.size(), ProbeResult());
+
+        TaskPool::Group group(keys.size() > 1 ? TaskPool::globalPool() : 0);
+
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            group.run(
+                [&, i]()
+                {
+                    const string& key = keys[i];
+                    ProbeResult& result = results[i];
+                    Stamp fileStamp;
+                    const bool useCache = !m_cacheDir.empty() && i < files.size() && stamp(files[i], fileStamp);
+                    const string file = useCache ? cacheFile(m_cacheDir, 'p', key, &fileStamp) : string();
+                    string data;
+
+                    if (useCache && readCacheFile(file, data))
+                    {
+                        CacheReader reader(data);
+                        uint32_t magic, version, count;
+                        Stamp cachedStamp;
+                        string cachedKey;
+
+                        if (reader.get(magic) && magic == ProbeMagic && reader.get(version) && version == CacheVersion
+                            && reader.get(cachedStamp) && cachedStamp == fileStamp && reader.getString(cachedKey) && cachedKey == key
+                            && reader.get(count) && reader.fits(count))
+                        {
+                            result.resize(count);
+                            bool ok = true;
+
+                            for (size_t q = 0; ok && q < count; q++)
+                                ok = reader.getString(result[q]);
+
+                            if (ok && reader.atEnd())
+                                return;
+
+                            result.clear();
+                        }
+                    }
+
+                    result = fn(i);
+
+                    if (useCache && !racy(fileStamp))
+                    {
+                        CacheWriter writer;
+                        writer.put(ProbeMagic);
+                        writer.put(CacheVersion);
+                        writer.put(fileStamp);
+                        writer.putString(key);
+                        writer.put(uint32_t(result.size()));
+
+                        for (size_t q = 0; q < result.size(); q++)
+                            writer.putString(result[q]);
+
+                        writeCacheFile(m_cacheDir, file, writer.data());
+                    }
+                });
+        }
+
+        group.wait();
+    }
+
+} // namespace TwkUtil
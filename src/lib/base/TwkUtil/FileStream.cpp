@@ -11,6 +11,7 @@
 #include <TwkUtil/File.h>
 #include <TwkUtil/Timer.h>
 #include <TwkUtil/MemPool.h>
+#include <TwkUtil/EnvVar.h>
 // #include <TwkUtil/Interrupt.h>
 #include <pthread.h>
 #include <iostream>
@@ -33,6 +34,23 @@
 #include <stl_ext/replace_alloc.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
+#include <ctype.h>
+#include <deque>
+#include <iomanip>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#if defined(PLATFORM_LINUX)
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define TWK_HAVE_IO_URING
+#endif
+#endif
 
 #if defined(PLATFORM_APPLE_MACH_BSD)
 //
@@ -590,7 +608,722 @@ namespace TwkUtil
 #endif //  PLATFORM_LINUX
 #endif //  _POSIX_ASYNCHRONOUS_IO
 
+    //
+    //  Whole files read ahead of time (by FileStream::readAhead() or the
+    //  io_uring sequence read-ahead) wait here for the next FileStream of
+    //  the same file. Files are claimed while they're being read so the
+    //  same file is never read twice at once: a FileStream that finds its
+    //  file being read ahead waits for that read, and read-ahead skips
+    //  files that a FileStream is already reading. Buffers nobody picks
+    //  up are dropped oldest first beyond RV_READAHEAD_MEMORY (MB).
+    //
+
+    static ENVVAR_INT(evReadAheadMemory, "RV_READAHEAD_MEMORY", 1024);
+
+    class ReadAheadTable
+    {
+    public:
+        ReadAheadTable()
+            : m_used(0)
+            , m_capacity(size_t(max(evReadAheadMemory.getValue(), 0)) * 1024 * 1024)
+            , m_active(false)
+        {
+        }
+
+        //
+        //  False until the first read-ahead. Lets FileStreams skip the
+        //  table entirely when read-ahead isn't used.
+        //
+
+        bool active() const { return m_active; }
+
+        //
+        //  Returns the buffer read ahead for the file or 0. If 0 is
+        //  returned and claimed is true the caller holds the claim on the
+        //  file and must release() it once it's done reading.
+        //
+
+        void* take(const string& filename, const struct stat& sb, bool& claimed);
+
+        //
+        //  Returns false if the file is already in the table or being
+        //  read. Otherwise the caller must add() or release() it.
+        //
+
+        bool claimForReadAhead(const string& filename);
+
+        void release(const string& filename);
+        void add(const string& filename, void* data, const struct stat& sb);
+        void setCapacity(size_t bytes);
+
+    private:
+        enum ClaimType
+        {
+            ReaderClaim,
+            ReadAheadClaim
+        };
+
+        struct Entry
+        {
+            string filename;
+            void* data;
+            off_t size;
+            time_t mtime;
+        };
+
+        typedef std::deque<Entry> Entries;
+        typedef std::map<string, ClaimType> Claims;
+
+        void evict();
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_released;
+        Entries m_entries;
+        Claims m_claims;
+        size_t m_used;
+        size_t m_capacity;
+        std::atomic<bool> m_active;
+    };
+
+    void* ReadAheadTable::take(const string& filename, const struct stat& sb, bool& claimed)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        claimed = false;
+
+        for (Claims::iterator c = m_claims.find(filename); c != m_claims.end(); c = m_claims.find(filename))
+        {
+            if (c->second != ReadAheadClaim)
+                return 0;
+            m_released.wait(lock);
+        }
+
+        for (Entries::iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+        {
+            if (i->filename == filename)
+            {
+                void* data = i->data;
+                const bool stale = i->size != sb.st_size || i->mtime != sb.st_mtime;
+                m_used -= i->size;
+                m_entries.erase(i);
+
+                if (!stale)
+                    return data;
+
+                MemPool::dealloc(data);
+                break;
+            }
+        }
+
+        m_claims[filename] = ReaderClaim;
+        claimed = true;
+        return 0;
+    }
+
+    bool ReadAheadTable::claimForReadAhead(const string& filename)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_capacity || m_claims.count(filename))
+            return false;
+
+        for (Entries::iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+        {
+            if (i->filename == filename)
+                return false;
+        }
+
+        m_claims[filename] = ReadAheadClaim;
+        m_active = true;
+        return true;
+    }
+
+    void ReadAheadTable::release(const string& filename)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_claims.erase(filename);
+        m_released.notify_all();
+    }
+
+    void ReadAheadTable::add(const string& filename, void* data, const struct stat& sb)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_claims.erase(filename);
+        m_released.notify_all();
+
+        if (size_t(sb.st_size) > m_capacity)
+        {
+            MemPool::dealloc(data);
+            return;
+        }
+
+        Entry e;
+        e.filename = filename;
+        e.data = data;
+        e.size = sb.st_size;
+        e.mtime = sb.st_mtime;
+        m_entries.push_back(e);
+        m_used += e.size;
+
+        evict();
+    }
+
+    void ReadAheadTable::setCapacity(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = bytes;
+        evict();
+    }
+
+    void ReadAheadTable::evict()
+    {
+        while (m_used > m_capacity && !m_entries.empty())
+        {
+            m_used -= m_entries.front().size;
+            MemPool::dealloc(m_entries.front().data);
+            m_entries.pop_front();
+        }
+    }
+
+    //
+    //  Never deleted: reader threads may still be running during static
+    //  destruction.
+    //
+
+    static ReadAheadTable* readAheadTable = new ReadAheadTable();
+
+    //
+    //  Set while FileStream::readAhead() is reading so the stream it makes
+    //  doesn't wait on its own claim.
+    //
+
+    static thread_local bool readingAhead = false;
+
+    struct ReadAheadClaimRelease
+    {
+        ReadAheadClaimRelease(const string& f)
+            : filename(f)
+            , claimed(false)
+        {
+        }
+
+        ~ReadAheadClaimRelease()
+        {
+            if (claimed)
+                readAheadTable->release(filename);
+        }
+
+        const string& filename;
+        bool claimed;
+    };
+
+#ifdef TWK_HAVE_IO_URING
+
+    //
+    //  io_uring
+    //
+    //  The ring is driven with the raw system calls so there's no
+    //  dependency on liburing. Every chunk of a read, including the
+    //  chunks of any read-ahead files, goes into the same submission
+    //  queue so a single io_uring_enter() keeps the device busy. Reader
+    //  threads stream one file after another so each thread keeps its
+    //  own ring around.
+    //
+
+    static ENVVAR_INT(evIOUringReadAhead, "RV_IOURING_READAHEAD", 0);
+
+#define IOURING_ENTRIES 256
+#define IOURING_BLOCK_SIZE 4096
+
+    class IOUringQueue
+    {
+    public:
+        struct Target
+        {
+            Target(int f, void* b, size_t o, size_t s, size_t r)
+                : fd(f)
+                , buffer((char*)b)
+                , fileOffset(o)
+                , size(s)
+                , readSize(r)
+                , requested(0)
+                , error(0)
+            {
+            }
+
+            int fd;
+            char* buffer;
+            size_t fileOffset; //  Offset of buffer[0] in the file
+            size_t size;       //  Bytes that must be read
+            size_t readSize;   //  Bytes to request (size rounded up for O_DIRECT)
+            size_t requested;  //  Bytes queued so far
+            int error;         //  errno of the first failed request
+        };
+
+        typedef std::vector<Target> Targets;
+
+        IOUringQueue(unsigned entries);
+        ~IOUringQueue();
+
+        bool valid() const { return m_ring != -1; }
+
+        //
+        //  Read all targets to completion. A failed read is recorded in
+        //  its Target::error, a failure of the ring itself throws.
+        //
+
+        void read(Targets& targets, size_t chunkSize, int maxInFlight);
+
+    private:
+        struct Request
+        {
+            size_t target;
+            size_t offset; //  Offset into the target
+            size_t length;
+            size_t done;
+            struct iovec iov;
+        };
+
+        void release();
+        void queue(Request* req, const Target& target);
+        void enter(unsigned minComplete);
+
+    private:
+        int m_ring;
+        unsigned m_entries;
+        unsigned m_toSubmit;
+        void* m_sqRing;
+        size_t m_sqRingSize;
+        void* m_cqRing;
+        size_t m_cqRingSize;
+        struct io_uring_sqe* m_sqes;
+        size_t m_sqesSize;
+        unsigned* m_sqTail;
+        unsigned* m_sqMask;
+        unsigned* m_sqArray;
+        unsigned* m_cqHead;
+        unsigned* m_cqTail;
+        unsigned* m_cqMask;
+        struct io_uring_cqe* m_cqes;
+    };
+
+    static void* mapRing(size_t size, int fd, off_t offset)
+    {
+        void* p = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return p == MAP_FAILED ? 0 : p;
+    }
+
+    IOUringQueue::IOUringQueue(unsigned entries)
+        : m_ring(-1)
+        , m_entries(0)
+        , m_toSubmit(0)
+        , m_sqRing(0)
+        , m_sqRingSize(0)
+        , m_cqRing(0)
+        , m_cqRingSize(0)
+        , m_sqes(0)
+        , m_sqesSize(0)
+    {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+
+        int fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+            return;
+
+        m_ring = fd;
+        m_entries = params.sq_entries;
+        m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+        const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap)
+            m_sqRingSize = m_cqRingSize = max(m_sqRingSize, m_cqRingSize);
+
+        m_sqRing = mapRing(m_sqRingSize, fd, IORING_OFF_SQ_RING);
+        m_cqRing = singleMap ? m_sqRing : mapRing(m_cqRingSize, fd, IORING_OFF_CQ_RING);
+        m_sqes = (struct io_uring_sqe*)mapRing(m_sqesSize, fd, IORING_OFF_SQES);
+
+        if (!m_sqRing || !m_cqRing || !m_sqes)
+        {
+            release();
+            return;
+        }
+
+        char* sq = (char*)m_sqRing;
+        m_sqTail = (unsigned*)(sq + params.sq_off.tail);
+        m_sqMask = (unsigned*)(sq + params.sq_off.ring_mask);
+        m_sqArray = (unsigned*)(sq + params.sq_off.array);
+
+        char* cq = (char*)m_cqRing;
+        m_cqHead = (unsigned*)(cq + params.cq_off.head);
+        m_cqTail = (unsigned*)(cq + params.cq_off.tail);
+        m_cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+        m_cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    }
+
+    IOUringQueue::~IOUringQueue() { release(); }
+
+    void IOUringQueue::release()
+    {
+        if (m_sqes)
+            munmap(m_sqes, m_sqesSize);
+        if (m_cqRing && m_cqRing != m_sqRing)
+            munmap(m_cqRing, m_cqRingSize);
+        if (m_sqRing)
+            munmap(m_sqRing, m_sqRingSize);
+        if (m_ring != -1)
+            close(m_ring);
+
+        m_sqes = 0;
+        m_sqRing = 0;
+        m_cqRing = 0;
+        m_ring = -1;
+    }
+
+    void IOUringQueue::queue(Request* req, const Target& target)
+    {
+        //
+        //  We're the only producer so the tail can be read without a
+        //  barrier. The release store publishes the sqe to the kernel.
+        //
+
+        unsigned tail = *m_sqTail;
+        unsigned index = tail & *m_sqMask;
+        struct io_uring_sqe* sqe = m_sqes + index;
+
+        req->iov.iov_base = target.buffer + req->offset + req->done;
+        req->iov.iov_len = req->length - req->done;
+
+        memset(sqe, 0, sizeof(struct io_uring_sqe));
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = target.fd;
+        sqe->addr = (unsigned long)&req->iov;
+        sqe->len = 1;
+        sqe->off = target.fileOffset + req->offset + req->done;
+        sqe->user_data = (unsigned long)req;
+
+        m_sqArray[index] = index;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+        ++m_toSubmit;
+    }
+
+    void IOUringQueue::enter(unsigned minComplete)
+    {
+        for (;;)
+        {
+            int n = syscall(__NR_io_uring_enter, m_ring, m_toSubmit, minComplete, IORING_ENTER_GETEVENTS, NULL, 0);
+
+            if (n >= 0)
+            {
+                m_toSubmit -= n;
+                return;
+            }
+            else if (errno == EAGAIN || errno == EBUSY)
+            {
+                //
+                //  Out of kernel resources or the completion queue is
+                //  full, reap what we have and try again.
+                //
+                return;
+            }
+            else if (errno != EINTR)
+            {
+                TWK_THROW_EXC_STREAM("io_uring_enter failed: " << strerror(errno) << ". io_uring unavailable");
+            }
+        }
+    }
+
+    void IOUringQueue::read(Targets& targets, size_t chunkSize, int maxInFlight)
+    {
+        const unsigned limit = min(m_entries, unsigned(max(maxInFlight, 1) * targets.size()));
+
+        vector<Request> requests(limit);
+        vector<Request*> freeRequests(limit);
+        deque<Request*> retries;
+
+        for (unsigned i = 0; i < limit; ++i)
+            freeRequests[i] = &requests[i];
+
+        size_t next = 0;
+        unsigned inFlight = 0;
+
+        for (;;)
+        {
+            //
+            //  Fill the submission queue, short reads first then new
+            //  chunks in target order.
+            //
+
+            while (inFlight < limit)
+            {
+                Request* req = 0;
+
+                if (!retries.empty())
+                {
+                    req = retries.front();
+                    retries.pop_front();
+                }
+                else
+                {
+                    while (next < targets.size() && (targets[next].error || targets[next].requested == targets[next].readSize))
+                    {
+                        ++next;
+                    }
+
+                    if (next == targets.size())
+                        break;
+
+                    Target& t = targets[next];
+                    req = freeRequests.back();
+                    freeRequests.pop_back();
+
+                    req->target = next;
+                    req->offset = t.requested;
+                    req->length = min(chunkSize, t.readSize - t.requested);
+                    req->done = 0;
+                    t.requested += req->length;
+                }
+
+                queue(req, targets[req->target]);
+                ++inFlight;
+            }
+
+            if (!inFlight)
+                break;
+
+            enter(1);
+
+            //
+            //  Reap completions
+            //
+
+            unsigned head = *m_cqHead;
+            unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+            for (; head != tail; ++head)
+            {
+                struct io_uring_cqe* cqe = m_cqes + (head & *m_cqMask);
+                Request* req = (Request*)cqe->user_data;
+                Target& t = targets[req->target];
+                int res = cqe->res;
+                bool finished = true;
+
+                --inFlight;
+
+                if (res == -EINTR || res == -EAGAIN)
+                {
+                    finished = false;
+                }
+                else if (res < 0)
+                {
+                    if (!t.error)
+                        t.error = -res;
+                }
+                else if (res == 0)
+                {
+                    //
+                    //  EOF. Expected when an O_DIRECT read was rounded up
+                    //  past the end of the file.
+                    //
+                    if (req->offset + req->done < t.size && !t.error)
+                        t.error = EIO;
+                }
+                else
+                {
+                    req->done += res;
+                    finished = req->done == req->length || req->offset + req->done >= t.size;
+                }
+
+                if (finished)
+                    freeRequests.push_back(req);
+                else
+                    retries.push_back(req);
+            }
+
+            __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    static std::atomic<bool> ioUringUnavailable(false);
+
+    static IOUringQueue* threadIOUringQueue()
+    {
+        static thread_local std::unique_ptr<IOUringQueue> queue;
+
+        if (!queue && !ioUringUnavailable)
+        {
+            queue.reset(new IOUringQueue(IOURING_ENTRIES));
+
+            if (!queue->valid())
+            {
+                //
+                //  Kernel too old or io_uring disabled (sysctl, seccomp
+                //  in containers, etc).
+                //
+                queue.reset();
+                ioUringUnavailable = true;
+            }
+        }
+
+        return queue.get();
+    }
+
+    //
+    //  Returns filename with its last number offset by the given amount,
+    //  keeping the zero padding. Returns an empty string if the filename
+    //  has no number.
+    //
+
+    static string sequenceNeighbor(const string& filename, int offset)
+    {
+        size_t slash = filename.rfind('/');
+        size_t start = slash == string::npos ? 0 : slash + 1;
+        size_t end = filename.find_last_of("0123456789");
+
+        if (end == string::npos || end < start)
+            return string();
+
+        size_t begin = end;
+        while (begin > start && isdigit(filename[begin - 1]))
+            --begin;
+
+        size_t width = end - begin + 1;
+        if (width > 18)
+            return string();
+
+        long long frame = atoll(filename.substr(begin, width).c_str()) + offset;
+        if (frame < 0)
+            return string();
+
+        ostringstream str;
+        str << setw(width) << setfill('0') << frame;
+        return filename.substr(0, begin) + str.str() + filename.substr(end + 1);
+    }
+
+    static size_t roundToBlock(size_t n) { return (n + IOURING_BLOCK_SIZE - 1) / IOURING_BLOCK_SIZE * IOURING_BLOCK_SIZE; }
+
+    //
+    //  Read size bytes at offset from fd with the calling thread's ring.
+    //  bytesRead is set to the number of bytes that came off the disk
+    //  (including any read-ahead files).
+    //
+
+    static void* ioUringStream(const string& filename, int fd, size_t offset, size_t size, bool direct, bool wholeFile,
+                               size_t chunkSize, int maxInFlight, size_t& bytesRead)
+    {
+        IOUringQueue* queue = threadIOUringQueue();
+        const size_t readAhead = wholeFile ? max(evIOUringReadAhead.getValue(), 0) : 0;
+
+        //
+        //  O_DIRECT requests must be block aligned in memory (MemPool
+        //  memory is page aligned), in the file, and in length. The last
+        //  request may run past EOF which just comes back short.
+        //
+
+        chunkSize = max(size_t(IOURING_BLOCK_SIZE), chunkSize / IOURING_BLOCK_SIZE * IOURING_BLOCK_SIZE);
+        size_t readSize = direct ? roundToBlock(size) : size;
+
+        void* data = MemPool::alloc(readSize);
+        if (!data)
+            TWK_THROW_EXC_STREAM("Out of memory");
+
+        IOUringQueue::Targets targets;
+        vector<string> names;
+        vector<struct stat> stats;
+
+        targets.push_back(IOUringQueue::Target(fd, data, offset, size, readSize));
+
+        for (size_t i = 1; i <= readAhead; ++i)
+        {
+            string name = sequenceNeighbor(filename, i);
+            if (name.empty())
+                break;
+
+            struct stat nsb;
+            if (::stat(name.c_str(), &nsb) != 0 || !S_ISREG(nsb.st_mode) || nsb.st_size == 0)
+                continue;
+            if (!readAheadTable->claimForReadAhead(name))
+                continue;
+
+            size_t nsize = nsb.st_size;
+            int nfd = direct ? TwkUtil::open(name.c_str(), O_RDONLY | O_DIRECT) : -1;
+            size_t nreadSize = roundToBlock(nsize);
+
+            if (nfd == -1)
+            {
+                nfd = TwkUtil::open(name.c_str(), O_RDONLY);
+                nreadSize = nsize;
+            }
+
+            void* ndata = nfd == -1 ? 0 : MemPool::alloc(nreadSize);
+
+            if (!ndata)
+            {
+                if (nfd != -1)
+                    close(nfd);
+                readAheadTable->release(name);
+                continue;
+            }
+
+            targets.push_back(IOUringQueue::Target(nfd, ndata, 0, nsize, nreadSize));
+            names.push_back(name);
+            stats.push_back(nsb);
+        }
+
+        try
+        {
+            queue->read(targets, chunkSize, maxInFlight);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                if (i)
+                {
+                    close(targets[i].fd);
+                    readAheadTable->release(names[i - 1]);
+                }
+                MemPool::dealloc(targets[i].buffer);
+            }
+
+            throw;
+        }
+
+        bytesRead = size;
+
+        for (size_t i = 1; i < targets.size(); ++i)
+        {
+            IOUringQueue::Target& t = targets[i];
+            close(t.fd);
+
+            if (t.error)
+            {
+                MemPool::dealloc(t.buffer);
+                readAheadTable->release(names[i - 1]);
+            }
+            else
+            {
+                readAheadTable->add(names[i - 1], t.buffer, stats[i - 1]);
+                bytesRead += t.size;
+            }
+        }
+
+        if (int error = targets.front().error)
+        {
+            MemPool::dealloc(data);
+            TWK_THROW_EXC_STREAM("io_uring read: " << strerror(error) << ": " << filename);
+        }
+
+        return data;
+    }
+
+#endif //  TWK_HAVE_IO_URING
+
     static int bufferingMessageCount = 0;
+    static int ioUringMessageCount = 0;
 
     FileStream::FileStream(const string& filename, Type type, size_t size, int maxInFlight, bool deleteOnDestruction)
         : m_filename(filename)
@@ -633,6 +1366,22 @@ namespace TwkUtil
             m_type = ASyncNonBuffering;
         }
 
+        if (m_type == IOUring)
+        {
+#ifdef TWK_HAVE_IO_URING
+            if (!threadIOUringQueue())
+#endif
+            {
+                if (ioUringMessageCount++ < 1)
+                {
+                    cerr << "WARNING: io_uring is not available, falling back to "
+                            "direct (unbuffered) reads."
+                         << endl;
+                }
+                m_type = NonBuffering;
+            }
+        }
+
         /*
         cerr << "FileStream, size " << m_chunkSize <<
                 " m_type " << m_type <<
@@ -646,7 +1395,13 @@ namespace TwkUtil
         //  Open the file
         //
 
-        int direct = (m_type == ASyncNonBuffering || m_type == NonBuffering) ? O_DIRECT : 0;
+        //
+        //  io_uring reads whole blocks so the start offset must be block
+        //  aligned to use O_DIRECT.
+        //
+
+        const bool ioUringDirect = m_type == IOUring && (m_startOffset % 4096) == 0;
+        int direct = (m_type == ASyncNonBuffering || m_type == NonBuffering || ioUringDirect) ? O_DIRECT : 0;
         m_file = TwkUtil::open(m_filename.c_str(), O_RDONLY | direct);
 
         if (m_file == -1)
@@ -660,7 +1415,8 @@ namespace TwkUtil
                          << endl;
                 }
                 direct = 0;
-                m_type = Buffering;
+                if (m_type != IOUring)
+                    m_type = Buffering;
                 m_file = TwkUtil::open(m_filename.c_str(), O_RDONLY);
             }
 
@@ -685,6 +1441,25 @@ namespace TwkUtil
         if (m_readSize)
             m_fileSize = std::min(m_readSize, size_t(m_fileSize));
 
+        //
+        //  Take the buffer if this file was read ahead. Otherwise claim
+        //  the file while it's read so read-ahead leaves it alone.
+        //
+
+        ReadAheadClaimRelease claim(m_filename);
+        struct stat sb;
+
+        if (m_type != MemoryMap && m_startOffset == 0 && m_readSize == 0 && !readingAhead && readAheadTable->active()
+            && fstat(m_file, &sb) == 0)
+        {
+            if (void* data = readAheadTable->take(m_filename, sb, claim.claimed))
+            {
+                close(m_file);
+                m_rawdata = data;
+                return;
+            }
+        }
+
         /*
         fprintf (stderr, "%p FileStream type %d request for %d byte file\n",
         pthread_self(), m_type, m_fileSize); fflush (stderr);
@@ -696,7 +1471,7 @@ namespace TwkUtil
         //  counts !
         //
 
-        if (direct && m_chunkSize % 512)
+        if (direct && m_type != IOUring && m_chunkSize % 512)
         {
             m_chunkSize = max(size_t(512), 512 * (m_chunkSize / 512));
         }
@@ -704,12 +1479,14 @@ namespace TwkUtil
         //
         //  We can't read non-multiple-of-512-sized files with
         //  O_DIRECT, so read in two steps.  First the multiple of
-        //  512, then whatever's left over.
+        //  512, then whatever's left over. (io_uring reads past the
+        //  end of the file instead.)
         //
 
         size_t leftOverSize = 0;
         size_t readableSize = m_fileSize;
-        if (direct)
+        size_t bytesRead = m_fileSize;
+        if (direct && m_type != IOUring)
         {
             leftOverSize = m_fileSize % 512;
             readableSize = m_fileSize - leftOverSize;
@@ -758,6 +1535,22 @@ namespace TwkUtil
                 TWK_THROW_EXC_STREAM("MMap: " << strerror(errno) << ": " << m_filename);
             }
         }
+#ifdef TWK_HAVE_IO_URING
+        else if (m_type == IOUring)
+        {
+            try
+            {
+                m_rawdata = ioUringStream(m_filename, m_file, m_startOffset, m_fileSize, direct != 0, m_startOffset == 0 && m_readSize == 0,
+                                          m_chunkSize, m_maxInFlight, bytesRead);
+            }
+            catch (...)
+            {
+                close(m_file);
+                throw;
+            }
+            close(m_file);
+        }
+#endif
 
         //
         //  If we had to split the read, read the leftover part now.
@@ -774,9 +1567,68 @@ namespace TwkUtil
             close(m_file);
         }
 
-        mon.setBytes(m_fileSize);
+        mon.setBytes(bytesRead);
     }
 
+    bool FileStream::readAhead(const string& filename, Type type, size_t chunkSize, int maxInFlight)
+    {
+        if (type == MemoryMap)
+        {
+            readAheadToPageCache(filename);
+            return true;
+        }
+
+        if (!readAheadTable->claimForReadAhead(filename))
+            return false;
+
+        readingAhead = true;
+
+        try
+        {
+            FileStream stream(filename, type, chunkSize, maxInFlight, false);
+            struct stat sb;
+            readingAhead = false;
+
+            if (::stat(filename.c_str(), &sb) == 0 && sb.st_size == stream.size())
+            {
+                readAheadTable->add(filename, stream.data(), sb);
+                return true;
+            }
+
+            deleteDataPointer(stream.data());
+        }
+        catch (...)
+        {
+            readingAhead = false;
+        }
+
+        readAheadTable->release(filename);
+        return false;
+    }
+
+    void FileStream::readAheadToPageCache(const string& filename)
+    {
+        int file = TwkUtil::open(filename.c_str(), O_RDONLY);
+        if (file == -1)
+            return;
+
+        posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+        //
+        //  Read it rather than just advising WILLNEED so the caller is
+        //  paced by the disk.
+        //
+
+        static const size_t scratchSize = 1024 * 1024;
+        vector<char> scratch(scratchSize);
+        while (read(file, &scratch.front(), scratchSize) > 0)
+            ;
+
+        close(file);
+    }
+
+    void FileStream::setReadAheadMemoryLimit(size_t bytes) { readAheadTable->setCapacity(bytes); }
+
     FileStream::~FileStream()
     {
         if (m_type == MemoryMap)
@@ -897,6 +1749,14 @@ namespace TwkUtil
         WinStreamPrivate* imp = new WinStreamPrivate;
         m_private = imp;
 
+        if (m_type == IOUring)
+        {
+            //
+            //  No io_uring on windows, overlapped io is the closest thing.
+            //
+            m_type = ASyncNonBuffering;
+        }
+
         // if (getenv("TWEAK_ASYNC_PACKET_SIZE"))
         //{
         // imp->m_requestSize = atoi(getenv("TWEAK_ASYNC_PACKET_SIZE"));
@@ -1128,6 +1988,12 @@ namespace TwkUtil
 
     void FileStream::deleteDataPointer(void* p) { MemPool::dealloc(p); }
 
+    bool FileStream::readAhead(const string& filename, Type type, size_t chunkSize, int maxInFlight) { return false; }
+
+    void FileStream::readAheadToPageCache(const string& filename) {}
+
+    void FileStream::setReadAheadMemoryLimit(size_t bytes) {}
+
 #endif
 
 } // namespace TwkUtil
@@ -266,8 +266,7 @@ struct LexinumericCompare
     static string cachedNoSequencePattern;
     static unique_ptr<RegEx> noSequencePatternRe;
 
-    SequenceNameList sequencesInFileList(const FileNameList& infiles, SequencePredicate P, bool includeNonMatching, bool frameRanges,
-                                         int minSequenceSize)
+    int defaultMinimumSequenceSize()
     {
         if (defaultMinSequenceSize == -2)
         {
@@ -286,9 +285,12 @@ struct LexinumericCompare
             else
                 defaultMinSequenceSize = 5;
         }
-        if (minSequenceSize == -1)
-            minSequenceSize = defaultMinSequenceSize;
 
+        return defaultMinSequenceSize;
+    }
+
+    const RegEx* noSequencePattern()
+    {
         const char* envVar = getenv("RV_NO_SEQUENCE_PATTERN");
         if (envVar && *envVar)
         {
@@ -312,6 +314,57 @@ struct LexinumericCompare
             noSequencePatternRe.reset();
         }
 
+        return noSequencePatternRe.get();
+    }
+
+    string sequenceTimeStr(const FrameList& frames, int pad, bool frameRanges)
+    {
+        // Determine the shake-like time range & padding strings
+        string timeStr = frameRanges ? frameStr(frames) : "";
+        //
+        //  Giant strings of range,range,range, etc are not useful, and
+        //  on windows they crash the qt file browser code because the
+        //  columns need to be so wide, and then reconsitiuting the
+        //  frame list with pcre/RegEx causes a crash there, so fall
+        //  back to a simple range here.
+        //
+        if (timeStr.size() > 40)
+        {
+            ostringstream rangeStr;
+            int smallest = numeric_limits<int>::max();
+            int largest = -numeric_limits<int>::max();
+            for (int i = 0; i < frames.size(); ++i)
+            {
+                if (frames[i] < smallest)
+                    smallest = frames[i];
+                if (frames[i] > largest)
+                    largest = frames[i];
+            }
+            rangeStr << smallest << "-" << largest;
+            timeStr = rangeStr.str();
+        }
+
+        if (pad == 4)
+        {
+            timeStr += "#";
+        }
+        else
+        {
+            for (int i = 0; i < pad; ++i)
+                timeStr += "@";
+        }
+
+        return timeStr;
+    }
+
+    SequenceNameList sequencesInFileList(const FileNameList& infiles, SequencePredicate P, bool includeNonMatching, bool frameRanges,
+                                         int minSequenceSize)
+    {
+        if (minSequenceSize == -1)
+            minSequenceSize = defaultMinimumSequenceSize();
+
+        noSequencePattern();
+
         //
         //  NOTE: this function needs to maintain as much order as
         //  possible in the in input file list.
@@ -518,41 +571,7 @@ struct LexinumericCompare
                     }
                 }
 
-                // Determine the shake-like time range & padding strings
-                string timeStr = frameRanges ? frameStr(frames) : "";
-                //
-                //  Giant strings of range,range,range, etc are not useful, and
-                //  on windows they crash the qt file browser code because the
-                //  columns need to be so wide, and then reconsitiuting the
-                //  frame list with pcre/RegEx causes a crash there, so fall
-                //  back to a simple range here.
-                //
-                if (timeStr.size() > 40)
-                {
-                    ostringstream rangeStr;
-                    int smallest = numeric_limits<int>::max();
-                    int largest = -numeric_limits<int>::max();
-                    for (int i = 0; i < frames.size(); ++i)
-                    {
-                        if (frames[i] < smallest)
-                            smallest = frames[i];
-                        if (frames[i] > largest)
-                            largest = frames[i];
-                    }
-                    rangeStr << smallest << "-" << largest;
-                    timeStr = rangeStr.str();
-                }
-
-                if (pad == 4)
-                {
-                    timeStr += "#";
-                }
-                else
-                {
-                    for (int i = 0; i < pad; ++i)
-                        timeStr += "@";
-                }
-
+                string timeStr = sequenceTimeStr(frames, pad, frameRanges);
                 string frameSeq = bestPattern.replace(bestPattern.find(DIGIT_REGEX), strlen(DIGIT_REGEX), timeStr);
                 frameSequences.push_back(frameSeq);
             }
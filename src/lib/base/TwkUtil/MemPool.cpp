@@ -12,6 +12,16 @@
 #include <string.h>
 #include <stl_ext/replace_alloc.h>
 #include <algorithm>
+#include <atomic>
+#include <vector>
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+#ifdef PLATFORM_LINUX
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#endif
 
 namespace TwkUtil
 {
@@ -20,22 +30,198 @@ namespace TwkUtil
 #define MP_POOL_SIZE (500 * 1024 * 1024)
 #define MP_ALLOC_SLOP 0.1
 #define MP_MIN_ELEM_SIZE (3 * 1024 * 1024)
+#define MP_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define MP_MAX_NUMA_NODES 64
 
     namespace
     {
 
         MemPool* globalMemPool = 0;
 
-    };
+#ifndef WIN32
+        //
+        //  Regions adopted via adoptMappedBlock(). The count lets
+        //  dealloc() skip the lock entirely when nothing is mapped.
+        //
+
+        typedef std::map<const void*, size_t> MappedMap;
+
+        boost::mutex mappedMutex;
+        MappedMap mappedBlocks;
+        std::atomic<size_t> mappedCount(0);
+
+        bool unmapIfMapped(void* ptr)
+        {
+            if (mappedCount.load() == 0)
+                return false;
+
+            size_t size = 0;
+
+            {
+                boost::lock_guard<boost::mutex> lg(mappedMutex);
+                MappedMap::iterator i = mappedBlocks.find(ptr);
+                if (i == mappedBlocks.end())
+                    return false;
+                size = i->second;
+                mappedBlocks.erase(i);
+                --mappedCount;
+            }
+
+            munmap(ptr, size);
+            return true;
+        }
+#endif
+
+        //
+        //  NUMA topology. Only Linux exposes it cheaply (sysfs for the
+        //  cpu -> node map and sched_getcpu() for the current cpu);
+        //  elsewhere everything is node 0.
+        //
+
+        std::vector<int> cpuToNode;
+        int numNodes = 1;
+
+#ifdef PLATFORM_LINUX
+        void readNUMATopology()
+        {
+            for (int node = 0; node < MP_MAX_NUMA_NODES; node++)
+            {
+                char path[128];
+                snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+
+                FILE* file = fopen(path, "r");
+                if (!file)
+                    continue;
+
+                char list[4096];
+                if (fgets(list, sizeof(list), file))
+                {
+                    //
+                    //  Format is "0-7,16-23"
+                    //
+
+                    for (char* p = list; *p && *p != '\n';)
+                    {
+                        char* end = 0;
+                        const long first = strtol(p, &end, 10);
+                        if (end == p)
+                            break;
+                        long last = first;
+                        p = end;
+                        if (*p == '-')
+                        {
+                            last = strtol(p + 1, &end, 10);
+                            p = end;
+                        }
+                        if (*p == ',')
+                            p++;
+
+                        for (long cpu = first; cpu <= last && cpu < 65536; cpu++)
+                        {
+                            if (size_t(cpu) >= cpuToNode.size())
+                                cpuToNode.resize(cpu + 1, 0);
+                            cpuToNode[cpu] = node;
+                        }
+                    }
+
+                    numNodes = max(numNodes, node + 1);
+                }
+
+                fclose(file);
+            }
+        }
+
+        int currentNode()
+        {
+            if (numNodes == 1)
+                return 0;
+            const int cpu = sched_getcpu();
+            return (cpu >= 0 && size_t(cpu) < cpuToNode.size()) ? cpuToNode[cpu] : 0;
+        }
+#else
+        void readNUMATopology() {}
+
+        int currentNode() { return 0; }
+#endif
+
+        //
+        //  Large blocks are anonymous mappings on Linux. The start is
+        //  aligned to the huge page size so that (with transparent huge
+        //  pages) every whole 2MB span of the block can be backed by a
+        //  single huge page. The mapping is only rounded to the normal
+        //  page size so nothing is wasted at the end.
+        //
+
+        void* allocateBlock(size_t size, bool hugePages, size_t& mapSize)
+        {
+            mapSize = 0;
+
+#ifdef PLATFORM_LINUX
+            if (hugePages)
+            {
+                const size_t page = 4096;
+                const size_t length = (size + page - 1) & ~(page - 1);
+                const size_t padded = length + MP_HUGE_PAGE_SIZE;
+
+                void* p = mmap(0, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (p != MAP_FAILED)
+                {
+                    const uintptr_t start = uintptr_t(p);
+                    const uintptr_t aligned = (start + MP_HUGE_PAGE_SIZE - 1) & ~uintptr_t(MP_HUGE_PAGE_SIZE - 1);
+                    const uintptr_t end = start + padded;
+
+                    if (aligned > start)
+                        munmap(p, aligned - start);
+                    if (end > aligned + length)
+                        munmap((void*)(aligned + length), end - (aligned + length));
+
+#ifdef MADV_HUGEPAGE
+                    madvise((void*)aligned, length, MADV_HUGEPAGE);
+#endif
+                    mapSize = length;
+                    return (void*)aligned;
+                }
+            }
+#endif
+
+            return TWK_ALLOCATE_ARRAY_PAGE_ALIGNED(unsigned char, size);
+        }
+
+        void deallocateBlock(void* ptr, size_t mapSize)
+        {
+#ifndef WIN32
+            if (mapSize)
+            {
+                munmap(ptr, mapSize);
+                return;
+            }
+#endif
+            TWK_DEALLOCATE(ptr);
+        }
+
+    }; // namespace
+
+    //
+    //  A PoolElem is on two lists while it's free: the pool wide LRU list
+    //  (used to pick what to really free) and the list for its size and
+    //  NUMA node (used to find a block to reuse). Both are intrusive so
+    //  all the list operations are O(1). The node is the one the block
+    //  was first allocated (and so most likely first touched) on.
+    //
 
     struct MemPool::PoolElem
     {
-        PoolElem(MemPool& mp, void* p, size_t s)
+        PoolElem(MemPool& mp, void* p, size_t s, size_t ms)
             : memPool(mp)
             , ptr(p)
             , size(s)
+            , mapSize(ms)
+            , node(0)
             , next(0)
-            , prev(0) {};
+            , prev(0)
+            , bucketNext(0)
+            , bucketPrev(0) {};
 
         ~PoolElem() { memPool.m_elemMap.erase(ptr); }
 
@@ -43,14 +229,37 @@ namespace TwkUtil
 
         void* ptr;
         size_t size;
+        size_t mapSize;
+        int node;
         PoolElem* next;
         PoolElem* prev;
+        PoolElem* bucketNext;
+        PoolElem* bucketPrev;
 
         MemPool& memPool;
     };
 
     struct MemPool::FreeList
     {
+        //
+        //  Free elems of one size, most recently freed first, one list
+        //  per NUMA node.
+        //
+
+        struct Bucket
+        {
+            Bucket()
+                : heads(numNodes, (PoolElem*)0)
+                , count(0)
+            {
+            }
+
+            std::vector<PoolElem*> heads;
+            size_t count;
+        };
+
+        typedef std::map<size_t, Bucket> BucketMap;
+
         FreeList(size_t sz, float slop)
             : head(0)
             , tail(0)
@@ -60,7 +269,10 @@ namespace TwkUtil
             , allocSlop(slop) {};
 
         void addElem(PoolElem* elem);
-        void* findAndUseElem(size_t size);
+        PoolElem* findAndUseElem(size_t size, int node);
+
+        void removeElem(PoolElem* elem);
+        PoolElem* popFromBucket(Bucket& bucket, int node);
 
         PoolElem* head;
         PoolElem* tail;
@@ -68,6 +280,7 @@ namespace TwkUtil
         size_t totalCount;
         size_t poolSize;
         float allocSlop;
+        BucketMap buckets;
     };
 
     MemPool::MemPool(size_t poolSize, size_t minElemSize, float allocSlop)
@@ -76,6 +289,7 @@ namespace TwkUtil
         , m_allocSlop(allocSlop)
         , m_shortCircuit(false)
         , m_debugOutput(false)
+        , m_hugePages(true)
     {
         m_freeList = new FreeList(m_poolSize, m_allocSlop);
     }
@@ -93,17 +307,23 @@ namespace TwkUtil
         if (getenv("TWK_MEM_POOL_ALLOC_SLOP"))
             allocSlop = atof(getenv("TWK_MEM_POOL_ALLOC_SLOP"));
 
+        readNUMATopology();
+
         globalMemPool = new MemPool(poolSize, minElemSize, allocSlop);
 
         globalMemPool->m_shortCircuit = (getenv("TWK_MEM_POOL_DISABLE") != 0);
 
+        if (const char* hp = getenv("TWK_MEM_POOL_HUGE_PAGES"))
+            globalMemPool->m_hugePages = atoi(hp) != 0;
+
         if (getenv("TWK_MEM_POOL_DEBUG"))
             globalMemPool->m_debugOutput = true;
 
         if (globalMemPool->m_debugOutput)
         {
             cerr << "MP: size " << poolSize / (1024 * 1024) << "MB, minElemSize " << float(minElemSize) / (1024.0 * 1024.0) << ", slop "
-                 << allocSlop << ", shortCircuit " << globalMemPool->m_shortCircuit << endl;
+                 << allocSlop << ", shortCircuit " << globalMemPool->m_shortCircuit << ", hugePages " << globalMemPool->m_hugePages
+                 << ", numaNodes " << numNodes << endl;
         }
     }
 
@@ -120,30 +340,55 @@ namespace TwkUtil
         DebugTimer tmr(mp.m_debugOutput, true);
         bool hit = false;
 
-        LockGuard lg(mp.m_mutex);
+        if (size < mp.m_minElemSize || mp.m_shortCircuit)
+        {
+            return TWK_ALLOCATE_ARRAY_PAGE_ALIGNED(unsigned char, size);
+        }
 
+        const int node = currentNode();
         void* ptr = 0;
-        if (size < mp.m_minElemSize || mp.m_shortCircuit)
+
         {
-            ptr = TWK_ALLOCATE_ARRAY_PAGE_ALIGNED(unsigned char, size);
+            LockGuard lg(mp.m_mutex);
+
+            if (PoolElem* elem = mp.m_freeList->findAndUseElem(size, node))
+            {
+                ptr = elem->ptr;
+                hit = true;
+                mp.m_stats.hits++;
+                if (elem->node != node)
+                    mp.m_stats.remoteHits++;
+                mp.m_stats.liveBytes += elem->size;
+            }
         }
-        else
+
+        if (!ptr)
         {
-            ptr = mp.m_freeList->findAndUseElem(size);
-            if (!ptr)
+            //
+            //  The real alloc (and page mapping) happens outside the lock.
+            //
+
+            size_t mapSize = 0;
+            ptr = allocateBlock(size, mp.m_hugePages, mapSize);
+
+            if (ptr)
             {
-                ptr = TWK_ALLOCATE_ARRAY_PAGE_ALIGNED(unsigned char, size);
+                LockGuard lg(mp.m_mutex);
+
                 if (mp.m_debugOutput && mp.m_elemMap.count(ptr) != 0)
                 {
                     cerr << "ERROR: ptr already in map! " << ptr << endl;
                 }
-                if (ptr)
-                    mp.m_elemMap[ptr] = new PoolElem(mp, ptr, size);
+
+                PoolElem* elem = new PoolElem(mp, ptr, size, mapSize);
+                elem->node = node;
+                mp.m_elemMap[ptr] = elem;
+                mp.m_stats.misses++;
+                mp.m_stats.liveBytes += size;
             }
-            else
-                hit = true;
         }
-        if (mp.m_debugOutput && size >= mp.m_minElemSize)
+
+        if (mp.m_debugOutput)
         {
             cerr << "MP: alloc " << size / (1024 * 1024) << "MB " << ((hit) ? "hit, " : "miss, ") << 1000.0 * tmr.stop() << "ms" << endl;
         }
@@ -153,6 +398,11 @@ namespace TwkUtil
 
     void MemPool::dealloc(void* ptr)
     {
+#ifndef WIN32
+        if (unmapIfMapped(ptr))
+            return;
+#endif
+
         //  If not initialized, fallback to original behavior
         //
         if (!globalMemPool || globalMemPool->m_shortCircuit)
@@ -172,10 +422,95 @@ namespace TwkUtil
         }
         else
         {
-            mp.m_freeList->addElem(i->second);
+            PoolElem* elem = i->second;
+            mp.m_stats.liveBytes -= elem->size;
+            mp.m_freeList->addElem(elem);
+            mp.m_stats.residentBytes = mp.m_freeList->totalSize;
+            mp.m_stats.residentBlocks = mp.m_freeList->totalCount;
         }
     }
 
+    MemPool::Stats MemPool::stats()
+    {
+        if (!globalMemPool)
+            return Stats();
+
+        MemPool& mp(*globalMemPool);
+        LockGuard lg(mp.m_mutex);
+        Stats s = mp.m_stats;
+        s.residentBytes = mp.m_freeList->totalSize;
+        s.residentBlocks = mp.m_freeList->totalCount;
+        return s;
+    }
+
+#ifndef WIN32
+    void MemPool::adoptMappedBlock(void* ptr, size_t size)
+    {
+        boost::lock_guard<boost::mutex> lg(mappedMutex);
+        mappedBlocks[ptr] = size;
+        ++mappedCount;
+    }
+#endif
+
+    void MemPool::FreeList::removeElem(PoolElem* elem)
+    {
+        //
+        //  Unlink from the LRU list
+        //
+
+        if (elem->prev)
+            elem->prev->next = elem->next;
+        if (elem->next)
+            elem->next->prev = elem->prev;
+        if (elem == head)
+            head = elem->next;
+        if (elem == tail)
+            tail = elem->prev;
+        elem->prev = elem->next = 0;
+
+        //
+        //  Unlink from its bucket
+        //
+
+        BucketMap::iterator b = buckets.find(elem->size);
+
+        if (b != buckets.end())
+        {
+            Bucket& bucket = b->second;
+
+            if (elem->bucketPrev)
+                elem->bucketPrev->bucketNext = elem->bucketNext;
+            if (elem->bucketNext)
+                elem->bucketNext->bucketPrev = elem->bucketPrev;
+            if (bucket.heads[elem->node] == elem)
+                bucket.heads[elem->node] = elem->bucketNext;
+
+            if (--bucket.count == 0)
+                buckets.erase(b);
+        }
+
+        elem->bucketPrev = elem->bucketNext = 0;
+
+        //
+        //  Adjust metadata
+        //
+
+        totalSize -= elem->size;
+        --totalCount;
+    }
+
+    MemPool::PoolElem* MemPool::FreeList::popFromBucket(Bucket& bucket, int node)
+    {
+        PoolElem* elem = bucket.heads[node];
+
+        for (int n = 0; !elem && n < numNodes; n++)
+            elem = bucket.heads[n];
+
+        if (elem)
+            removeElem(elem);
+        return elem;
+    }
+
     void MemPool::FreeList::addElem(PoolElem* elem)
     {
         while (tail && (totalSize + elem->size > poolSize))
@@ -184,22 +519,12 @@ namespace TwkUtil
             //  Chop off Tail
             //
             PoolElem* discard = tail;
-            tail = discard->prev;
-            if (tail)
-                tail->next = 0;
-            else
-                head = 0;
-
-            //
-            //  Adjust metadata
-            //
-            totalSize -= discard->size;
-            --totalCount;
+            removeElem(discard);
 
             //
             //  Dealloc for reals
             //
-            TWK_DEALLOCATE(discard->ptr);
+            deallocateBlock(discard->ptr, discard->mapSize);
 
             //
             //  Delete elem, which removes it from map
@@ -218,6 +543,15 @@ namespace TwkUtil
         if (!tail)
             tail = elem;
 
+        Bucket& bucket = buckets[elem->size];
+        PoolElem*& bhead = bucket.heads[elem->node];
+        elem->bucketNext = bhead;
+        elem->bucketPrev = 0;
+        if (bhead)
+            bhead->bucketPrev = elem;
+        bhead = elem;
+        bucket.count++;
+
         //
         //  Adjust metadata
         //
@@ -227,65 +561,31 @@ namespace TwkUtil
         if (globalMemPool->m_debugOutput)
         {
             cerr << "MP: freelist total " << totalCount << " elems, " << totalSize / (1024 * 1024) << "MB out of "
-                 << poolSize / (1024 * 1024) << "MB" << endl;
+                 << poolSize / (1024 * 1024) << "MB, " << buckets.size() << " sizes" << endl;
         }
     }
 
-    void* MemPool::FreeList::findAndUseElem(size_t size)
+    MemPool::PoolElem* MemPool::FreeList::findAndUseElem(size_t size, int node)
     {
-        PoolElem* candidate = 0;
-
-        int count = 0;
-        for (PoolElem* i = head; i; i = i->next)
-        {
-            //
-            //  Always use an exact match
-            //
-            if (i->size == size)
-            {
-                candidate = i;
-                break;
-            }
-            else if (i->size > size)
-            {
-                //
-                //  If we have nothing and this one is within slop allowance,
-                //  use it.  If we already have something, use this candidate if
-                //  it has less slop.
-                //
-                if ((!candidate && i->slop(size) < allocSlop) || (candidate && i->slop(size) < candidate->slop(size)))
-                {
-                    candidate = i;
-                }
-            }
-        }
-
-        if (candidate)
-        {
-            //
-            //  Remove candidate from free list
-            //
-
-            if (candidate->prev)
-                candidate->prev->next = candidate->next;
-            if (candidate->next)
-                candidate->next->prev = candidate->prev;
-
-            if (candidate == head)
-                head = candidate->next;
-            if (candidate == tail)
-                tail = candidate->prev;
-
-            candidate->prev = candidate->next = 0;
+        //
+        //  Always use an exact match
+        //
 
-            //
-            //  Adjust metadata
-            //
+        BucketMap::iterator i = buckets.find(size);
+        if (i != buckets.end())
+            return popFromBucket(i->second, node);
 
-            --totalCount;
-            totalSize -= candidate->size;
+        //
+        //  Otherwise the smallest larger block within the slop
+        //  allowance. The buckets are sorted by size so the first one
+        //  out of range ends the search.
+        //
 
-            return candidate->ptr;
+        for (i = buckets.upper_bound(size); i != buckets.end(); ++i)
+        {
+            if (float(i->first - size) / float(i->first) >= allocSlop)
+                break;
+            return popFromBucket(i->second, node);
         }
 
         return 0;
@@ -18,9 +18,15 @@ namespace TwkUtil
 
     bool pathIsURL(const std::string& path)
     {
-        RegEx regEx("^[a-z]*://");
-        Match m(regEx, path);
-        return m.foundMatch();
+        //
+        //  Same as matching "^[a-z]*://" but this is called for every
+        //  file of a directory listing, so don't use a regex.
+        //
+
+        size_t i = 0;
+        while (i < path.size() && path[i] >= 'a' && path[i] <= 'z')
+            i++;
+        return path.compare(i, 3, "://") == 0;
     }
 
     string pathConform(const std::string& path)
@@ -0,0 +1,399 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+
+#include <TwkUtil/SequenceIndex.h>
+#include <TwkUtil/FNV1a.h>
+#include <TwkUtil/File.h>
+#include <TwkUtil/PathConform.h>
+#include <TwkUtil/TwkRegEx.h>
+#include <algorithm>
+#include <limits.h>
+#include <stdint.h>
+
+namespace TwkUtil
+{
+    using namespace std;
+
+    //
+    //  These mirror patternize() in FrameUtils.cpp: a run of digits
+    //  between two dots can be up to 11 characters long, any other run
+    //  up to 9 (both counting a leading '-').
+    //
+
+    static const size_t MaxDotRunLength = 11;
+    static const size_t MaxRunLength = 9;
+
+    static inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    static int parseFrame(const string& s, size_t start, size_t length)
+    {
+        const bool negative = s[start] == '-';
+        int64_t v = 0;
+
+        for (size_t i = negative ? start + 1 : start, end = start + length; i < end && v <= INT_MAX; i++)
+            v = v * 10 + (s[i] - '0');
+
+        return int(negative ? max(int64_t(INT_MIN), -v) : min(int64_t(INT_MAX), v));
+    }
+
+    static string withoutEscapes(string s)
+    {
+        s.erase(remove(s.begin(), s.end(), '\\'), s.end());
+        return s;
+    }
+
+    SequenceIndex::SequenceIndex(SequencePredicate P, bool includeNonMatching, bool frameRanges, int minSequenceSize)
+        : m_predicate(P)
+        , m_includeNonMatching(includeNonMatching)
+        , m_frameRanges(frameRanges)
+        , m_minSequenceSize(minSequenceSize == -1 ? defaultMinimumSequenceSize() : minSequenceSize)
+    {
+    }
+
+    void SequenceIndex::clear()
+    {
+        m_files.clear();
+        m_runs.clear();
+        m_buckets.clear();
+        m_bucketMap.clear();
+    }
+
+    void SequenceIndex::add(const FileNameList& files)
+    {
+        m_files.reserve(m_files.size() + files.size());
+        for (size_t i = 0; i < files.size(); i++)
+            add(files[i]);
+    }
+
+    void SequenceIndex::add(const string& name)
+    {
+        m_files.resize(m_files.size() + 1);
+        File& file = m_files.back();
+        file.name = pathConform(name);
+        file.firstRun = m_runs.size();
+        file.numRuns = 0;
+        addRuns(file);
+    }
+
+    void SequenceIndex::addRuns(File& file)
+    {
+        const string& s = file.name;
+        const size_t n = s.size();
+        size_t slash = s.rfind('/');
+        const size_t base = slash == string::npos ? 0 : slash + 1;
+
+        //
+        //  Frame numbers are only looked for in the basename. The first
+        //  pass finds the ".N." runs, the second every other run of
+        //  digits; a '-' right after a run which is a candidate is a
+        //  separator (bar.10-001.foo has two runs), not a sign.
+        //
+
+        vector<Run> runs;
+        vector<bool> inDotRun(n, false);
+
+        for (size_t i = base; i < n; i++)
+        {
+            if (s[i] != '.')
+                continue;
+
+            size_t j = i + 1;
+            if (j < n && s[j] == '-')
+                j++;
+            size_t k = j;
+            while (k < n && isDigit(s[k]))
+                k++;
+
+            if (k == j || k >= n || s[k] != '.')
+                continue;
+
+            if (k - (i + 1) <= MaxDotRunLength)
+            {
+                Run run;
+                run.start = i + 1;
+                run.length = k - (i + 1);
+                run.candidate = true;
+                run.hasDot = true;
+                runs.push_back(run);
+                fill(inDotRun.begin() + run.start, inDotRun.begin() + k, true);
+            }
+
+            i = k - 1;
+        }
+
+        size_t lastEnd = string::npos;
+
+        for (size_t i = base; i < n;)
+        {
+            if (inDotRun[i] || !(isDigit(s[i]) || (s[i] == '-' && i + 1 < n && isDigit(s[i + 1]) && !inDotRun[i + 1])))
+            {
+                i++;
+                continue;
+            }
+
+            size_t j = s[i] == '-' ? i + 1 : i;
+            while (j < n && isDigit(s[j]) && !inDotRun[j])
+                j++;
+
+            Run run;
+            run.start = i;
+            run.length = j - i;
+            run.candidate = run.length <= MaxRunLength;
+
+            if (run.candidate && i == lastEnd)
+            {
+                run.start++;
+                run.length--;
+            }
+
+            run.hasDot = run.start > 0 && s[run.start - 1] == '.';
+            runs.push_back(run);
+            lastEnd = run.candidate ? j : string::npos;
+            i = j;
+        }
+
+        //
+        //  A '-' in front of a run can be read as a sign or as part of
+        //  the name ("x-0022.tif" matches both x(-?[0-9]+).tif and
+        //  x-(-?[0-9]+).tif), so the run is also indexed the other way.
+        //
+
+        for (size_t i = 0, count = runs.size(); i < count; i++)
+        {
+            Run alias = runs[i];
+            alias.candidate = false;
+
+            if (s[alias.start] == '-')
+            {
+                alias.start++;
+                alias.length--;
+            }
+            else if (alias.start > base && s[alias.start - 1] == '-')
+            {
+                alias.start--;
+                alias.length++;
+            }
+            else
+            {
+                continue;
+            }
+
+            alias.hasDot = alias.start > 0 && s[alias.start - 1] == '.';
+            runs.push_back(alias);
+        }
+
+        sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.start < b.start; });
+
+        //
+        //  Every run, candidate or not, goes in its bucket: a file's
+        //  too-long run can still match another file's candidate.
+        //
+
+        const size_t fileIndex = &file - &m_files.front();
+
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            Run& run = runs[i];
+            run.frame = parseFrame(s, run.start, run.length);
+            run.bucket = bucket(s, run);
+
+            Member m;
+            m.file = fileIndex;
+            m.run = m_runs.size();
+            m_buckets[run.bucket].push_back(m);
+            m_runs.push_back(run);
+        }
+
+        file.numRuns = runs.size();
+    }
+
+    //
+    //  Buckets are found by a hash of the name around the run. The first
+    //  member of a bucket is compared to make sure it's the same name; if
+    //  not (a collision) the next hash value is tried.
+    //
+
+    size_t SequenceIndex::bucket(const string& s, const Run& run)
+    {
+        const size_t end = run.start + run.length;
+        const size_t suffixLength = s.size() - end;
+        uint64_t hash = uint64_t(FNV1a64(s.data(), run.start)) * 31 + uint64_t(FNV1a64(s.data() + end, suffixLength));
+
+        for (;; hash++)
+        {
+            pair<BucketMap::iterator, bool> r = m_bucketMap.insert(make_pair(hash, m_buckets.size()));
+
+            if (r.second)
+            {
+                m_buckets.resize(m_buckets.size() + 1);
+                return r.first->second;
+            }
+
+            const Member& m = m_buckets[r.first->second].front();
+            const string& other = m_files[m.file].name;
+            const Run& otherRun = m_runs[m.run];
+            const size_t otherEnd = otherRun.start + otherRun.length;
+
+            if (otherRun.start == run.start && other.size() - otherEnd == suffixLength && other.compare(0, run.start, s, 0, run.start) == 0
+                && other.compare(otherEnd, suffixLength, s, end, suffixLength) == 0)
+            {
+                return r.first->second;
+            }
+        }
+    }
+
+    SequenceIndex::Sequences SequenceIndex::sequences() const
+    {
+        Sequences seqs;
+        vector<bool> used(m_files.size(), false);
+        vector<int> frames;
+        const RegEx* noSequenceRe = noSequencePattern();
+
+        for (size_t fi = 0; fi < m_files.size(); fi++)
+        {
+            if (used[fi])
+                continue;
+
+            const File& file = m_files[fi];
+            Sequence seq;
+            seq.name = withoutEscapes(file.name);
+            seq.file = file.name;
+
+            //
+            //  As in sequencesInFileList() the predicate is only asked
+            //  about files which start a group (it can be expensive).
+            //
+
+            if ((m_predicate && !m_predicate(file.name)) || (noSequenceRe && noSequenceRe->matches(basename(file.name))))
+            {
+                seqs.push_back(seq);
+                used[fi] = true;
+                continue;
+            }
+
+            //
+            //  Pick the candidate which gathers the most frames, looking
+            //  from the last one to the first, with the same preferences
+            //  as sequencesInFileList().
+            //
+
+            const Run* best = 0;
+            size_t bestCount = 0;
+            int bestLongestRun = 0;
+            bool bestHasDot = false;
+
+            for (size_t ri = file.numRuns; ri-- > 0;)
+            {
+                const Run& run = m_runs[file.firstRun + ri];
+                if (!run.candidate)
+                    continue;
+
+                const Bucket& bucket = m_buckets[run.bucket];
+                frames.clear();
+
+                for (size_t i = 0; i < bucket.size(); i++)
+                {
+                    if (!used[bucket[i].file])
+                        frames.push_back(m_runs[bucket[i].run].frame);
+                }
+
+                sort(frames.begin(), frames.end());
+
+                int contiguous = 0;
+                int longestRun = 0;
+
+                for (size_t i = 1; i < frames.size(); i++)
+                {
+                    if (frames[i] == frames[i - 1] + 1)
+                        contiguous++;
+                    else
+                        contiguous = 0;
+
+                    if (contiguous > longestRun)
+                        longestRun = contiguous;
+                }
+
+                const size_t count = frames.size();
+
+                if ((count > bestCount && longestRun >= bestLongestRun) || (bestLongestRun == 0 && longestRun >= m_minSequenceSize)
+                    || (count == bestCount && run.hasDot && !bestHasDot))
+                {
+                    best = &run;
+                    bestCount = count;
+                    bestLongestRun = longestRun;
+                    bestHasDot = run.hasDot;
+                }
+            }
+
+            if (!best)
+            {
+                // No frame numbers at all in this filename
+                if (m_includeNonMatching)
+                    seqs.push_back(seq);
+                used[fi] = true;
+                continue;
+            }
+
+            const Bucket& bucket = m_buckets[best->bucket];
+
+            if (int(bestCount) < m_minSequenceSize)
+            {
+                for (size_t i = 0; i < bucket.size(); i++)
+                {
+                    const size_t f = bucket[i].file;
+                    if (used[f])
+                        continue;
+
+                    if (m_includeNonMatching)
+                    {
+                        seq.name = withoutEscapes(m_files[f].name);
+                        seq.file = m_files[f].name;
+                        seqs.push_back(seq);
+                    }
+                    used[f] = true;
+                }
+
+                continue;
+            }
+
+            FrameList seqFrames;
+            int pad = 1000;
+
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                const size_t f = bucket[i].file;
+                if (used[f])
+                    continue;
+
+                const Run& run = m_runs[bucket[i].run];
+                seqFrames.push_back(run.frame);
+                pad = min(pad, int(run.length));
+                used[f] = true;
+            }
+
+            const string& name = file.name;
+            seq.name = withoutEscapes(name.substr(0, best->start) + sequenceTimeStr(seqFrames, pad, m_frameRanges)
+                                      + name.substr(best->start + best->length));
+            seqs.push_back(seq);
+        }
+
+        return seqs;
+    }
+
+    SequenceNameList SequenceIndex::sequenceNames() const
+    {
+        Sequences seqs = sequences();
+        SequenceNameList names(seqs.size());
+
+        for (size_t i = 0; i < seqs.size(); i++)
+            names[i] = seqs[i].name;
+
+        return names;
+    }
+
+} // namespace TwkUtil
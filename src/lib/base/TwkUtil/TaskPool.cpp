@@ -0,0 +1,297 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+
+#include <TwkUtil/TaskPool.h>
+#include <TwkUtil/EnvVar.h>
+#include <TwkUtil/ThreadName.h>
+#include <iterator>
+#include <sstream>
+
+namespace TwkUtil
+{
+    using namespace std;
+
+    static ENVVAR_INT(evTaskPoolThreads, "RV_TASK_POOL_THREADS", -1);
+
+    namespace
+    {
+
+        thread_local const TaskPool* currentPool = 0;
+        thread_local size_t currentIndex = 0;
+
+    } // namespace
+
+    //----------------------------------------------------------------------
+    //
+    //  TaskPool::Group
+    //
+
+    TaskPool::Group::Group(TaskPool* pool)
+        : m_pool(pool)
+        , m_pending(0)
+    {
+    }
+
+    TaskPool::Group::~Group()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void TaskPool::Group::run(const Task& task)
+    {
+        m_pending++;
+
+        if (m_pool)
+        {
+            Item item;
+            item.task = task;
+            item.group = this;
+            m_pool->push(item);
+        }
+        else
+        {
+            try
+            {
+                task();
+                taskDone(exception_ptr());
+            }
+            catch (...)
+            {
+                taskDone(current_exception());
+            }
+        }
+    }
+
+    void TaskPool::Group::taskDone(exception_ptr error)
+    {
+        //
+        //  The count is dropped with the mutex held so wait() can't return
+        //  (and the group go away) before this is done with it.
+        //
+
+        lock_guard<mutex> lock(m_mutex);
+        if (error && !m_error)
+            m_error = error;
+        if (--m_pending == 0)
+            m_done.notify_all();
+    }
+
+    void TaskPool::Group::wait()
+    {
+        if (m_pool)
+        {
+            const int self = m_pool->currentWorker();
+            const size_t index = self >= 0 ? size_t(self) : m_pool->numWorkers();
+
+            //
+            //  Only this group's tasks are taken: the waiting thread may
+            //  be the display thread and mustn't get stuck running
+            //  someone else's (possibly much longer) work.
+            //
+
+            while (m_pending.load() != 0)
+            {
+                Item item;
+
+                if (m_pool->pop(item, index, this))
+                {
+                    m_pool->execute(item);
+                }
+                else
+                {
+                    //
+                    //  Nothing left to help with: the rest of this
+                    //  group's tasks are running on other threads.
+                    //
+
+                    unique_lock<mutex> lock(m_mutex);
+                    m_done.wait(lock, [this] { return m_pending.load() == 0; });
+                }
+            }
+        }
+
+        exception_ptr error;
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            swap(error, m_error);
+        }
+
+        if (error)
+            rethrow_exception(error);
+    }
+
+    //----------------------------------------------------------------------
+    //
+    //  TaskPool
+    //
+
+    TaskPool::TaskPool(size_t numWorkers)
+        : m_nextWorker(0)
+        , m_queued(0)
+        , m_shutdown(false)
+    {
+        for (size_t i = 0; i < numWorkers; i++)
+            m_workers.push_back(new Worker);
+
+        for (size_t i = 0; i < numWorkers; i++)
+            m_workers[i]->thread = thread(&TaskPool::workerMain, this, i);
+    }
+
+    TaskPool::~TaskPool()
+    {
+        {
+            lock_guard<mutex> lock(m_sleepMutex);
+            m_shutdown = true;
+        }
+
+        m_wake.notify_all();
+
+        for (size_t i = 0; i < m_workers.size(); i++)
+        {
+            m_workers[i]->thread.join();
+            delete m_workers[i];
+        }
+    }
+
+    TaskPool* TaskPool::globalPool()
+    {
+        //
+        //  Never destroyed: the workers may still be needed by other
+        //  static destructors and joining them at exit isn't worth it.
+        //
+
+        static TaskPool* pool = 0;
+        static once_flag once;
+
+        call_once(once,
+                  []
+                  {
+                      int n = evTaskPoolThreads.getValue();
+
+                      if (n < 0)
+                          n = int(thread::hardware_concurrency()) - 1;
+
+                      if (n > 0)
+                          pool = new TaskPool(size_t(n));
+                  });
+
+        return pool;
+    }
+
+    int TaskPool::currentWorker() const { return currentPool == this ? int(currentIndex) : -1; }
+
+    void TaskPool::push(const Item& item)
+    {
+        const int self = currentWorker();
+        const size_t n = m_workers.size();
+        const size_t index = self >= 0 ? size_t(self) : m_nextWorker++ % n;
+
+        m_queued++;
+
+        {
+            Worker* w = m_workers[index];
+            lock_guard<mutex> lock(w->mutex);
+            w->items.push_back(item);
+        }
+
+        {
+            lock_guard<mutex> lock(m_sleepMutex);
+        }
+
+        m_wake.notify_one();
+    }
+
+    bool TaskPool::pop(Item& item, size_t self, const Group* group)
+    {
+        const size_t n = m_workers.size();
+
+        if (self < n)
+        {
+            Worker* w = m_workers[self];
+            lock_guard<mutex> lock(w->mutex);
+
+            for (deque<Item>::reverse_iterator i = w->items.rbegin(); i != w->items.rend(); ++i)
+            {
+                if (!group || i->group == group)
+                {
+                    item = *i;
+                    w->items.erase(next(i).base());
+                    m_queued--;
+                    return true;
+                }
+            }
+        }
+
+        for (size_t k = 1; k <= n; k++)
+        {
+            Worker* w = m_workers[(self + k) % n];
+            lock_guard<mutex> lock(w->mutex);
+
+            for (deque<Item>::iterator i = w->items.begin(); i != w->items.end(); ++i)
+            {
+                if (!group || i->group == group)
+                {
+                    item = *i;
+                    w->items.erase(i);
+                    m_queued--;
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void TaskPool::execute(Item& item)
+    {
+        try
+        {
+            item.task();
+            item.group->taskDone(exception_ptr());
+        }
+        catch (...)
+        {
+            item.group->taskDone(current_exception());
+        }
+    }
+
+    void TaskPool::workerMain(size_t index)
+    {
+        currentPool = this;
+        currentIndex = index;
+
+        ostringstream name;
+        name << "TaskPool " << index;
+        setThreadName(name.str());
+
+        while (true)
+        {
+            Item item;
+
+            if (pop(item, index))
+            {
+                execute(item);
+                continue;
+            }
+
+            unique_lock<mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this] { return m_shutdown || m_queued.load() != 0; });
+
+            if (m_shutdown && m_queued.load() == 0)
+                break;
+        }
+    }
+
+} // namespace TwkUtil
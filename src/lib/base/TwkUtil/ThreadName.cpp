@@ -10,6 +10,7 @@
 #include <sys/prctl.h>
 #endif
 #include <TwkUtil/ThreadName.h>
+#include <TwkUtil/Trace.h>
 
 namespace TwkUtil
 {
@@ -24,6 +25,8 @@ namespace TwkUtil
 #if defined(PLATFORM_LINUX)
         prctl(PR_SET_NAME, (unsigned long)(name.c_str()), 0, 0, 0);
 #endif
+
+        Trace::setThreadName(name);
     }
 
     string getThreadName()
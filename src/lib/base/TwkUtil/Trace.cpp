@@ -0,0 +1,340 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+
+#include <TwkUtil/Trace.h>
+#include <TwkUtil/EnvVar.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+#ifdef PLATFORM_WINDOWS
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace TwkUtil
+{
+    using namespace std;
+
+    static ENVVAR_STRING(evTraceFile, "RV_TRACE_FILE", "");
+
+    namespace
+    {
+
+        //
+        //  Events are written out whenever a thread's buffer reaches this
+        //  size.
+        //
+
+        const size_t FlushThreshold = 4096;
+
+        struct Event
+        {
+            char phase; // 'X' complete, 'i' instant, 'C' counter, 'M' metadata
+            const char* category;
+            const char* name;
+            string dynamicName;
+            double ts;
+            double dur;
+            const char* argName;
+            int64_t argValue;
+        };
+
+        struct ThreadBuffer
+        {
+            mutex lock;
+            vector<Event> events;
+            int tid;
+        };
+
+        typedef chrono::steady_clock Clock;
+
+        mutex fileLock;
+        FILE* file = 0;
+        bool firstEvent = true;
+        Clock::time_point origin;
+        int pid = 0;
+
+        mutex buffersLock;
+        vector<ThreadBuffer*> buffers;
+        atomic<int> nextTid(1);
+
+        thread_local ThreadBuffer* currentBuffer = 0;
+
+        ThreadBuffer* threadBuffer()
+        {
+            //
+            //  Buffers are never freed: an event may still be queued in
+            //  one after its thread is gone.
+            //
+
+            if (!currentBuffer)
+            {
+                currentBuffer = new ThreadBuffer;
+                currentBuffer->tid = nextTid++;
+                currentBuffer->events.reserve(FlushThreshold);
+
+                lock_guard<mutex> guard(buffersLock);
+                buffers.push_back(currentBuffer);
+            }
+
+            return currentBuffer;
+        }
+
+        void writeString(FILE* f, const char* s)
+        {
+            fputc('"', f);
+
+            for (; *s; s++)
+            {
+                const unsigned char c = *s;
+
+                if (c == '"' || c == '\\')
+                {
+                    fputc('\\', f);
+                    fputc(c, f);
+                }
+                else if (c < 0x20)
+                {
+                    fprintf(f, "\\u%04x", c);
+                }
+                else
+                {
+                    fputc(c, f);
+                }
+            }
+
+            fputc('"', f);
+        }
+
+        void writeEvent(FILE* f, int tid, const Event& e)
+        {
+            const char* name = e.name ? e.name : e.dynamicName.c_str();
+
+            fputs(firstEvent ? "\n" : ",\n", f);
+            firstEvent = false;
+
+            if (e.phase == 'M')
+            {
+                fprintf(f, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":", pid, tid);
+                writeString(f, name);
+                fputs("}}", f);
+                return;
+            }
+
+            fprintf(f, "{\"ph\":\"%c\",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"cat\":", e.phase, pid, tid, e.ts);
+            writeString(f, e.category);
+            fputs(",\"name\":", f);
+            writeString(f, name);
+
+            if (e.phase == 'X')
+                fprintf(f, ",\"dur\":%.3f", e.dur);
+            else if (e.phase == 'i')
+                fputs(",\"s\":\"t\"", f);
+
+            if (e.phase == 'C')
+            {
+                fputs(",\"args\":{", f);
+                writeString(f, name);
+                fprintf(f, ":%lld}", (long long)e.argValue);
+            }
+            else if (e.argName)
+            {
+                fputs(",\"args\":{", f);
+                writeString(f, e.argName);
+                fprintf(f, ":%lld}", (long long)e.argValue);
+            }
+
+            fputc('}', f);
+        }
+
+        //
+        //  Called with the buffer locked
+        //
+
+        void flushBuffer(ThreadBuffer* b)
+        {
+            lock_guard<mutex> guard(fileLock);
+
+            if (file)
+            {
+                for (size_t i = 0; i < b->events.size(); i++)
+                    writeEvent(file, b->tid, b->events[i]);
+            }
+
+            b->events.clear();
+        }
+
+        void record(Event& e)
+        {
+            ThreadBuffer* b = threadBuffer();
+            lock_guard<mutex> guard(b->lock);
+
+            b->events.push_back(std::move(e));
+
+            if (b->events.size() >= FlushThreshold)
+                flushBuffer(b);
+        }
+
+        Event makeEvent(char phase, const char* category, const char* name)
+        {
+            Event e;
+            e.phase = phase;
+            e.category = category;
+            e.name = name;
+            e.ts = 0;
+            e.dur = 0;
+            e.argName = 0;
+            e.argValue = 0;
+            return e;
+        }
+
+        void finishAtExit() { Trace::finish(); }
+
+        struct StartFromEnvironment
+        {
+            StartFromEnvironment()
+            {
+                const string filename = evTraceFile.getValue();
+                if (!filename.empty())
+                    Trace::start(filename);
+            }
+        };
+
+    } // namespace
+
+    atomic<bool> Trace::m_enabled(false);
+
+    bool Trace::start(const string& filename)
+    {
+        lock_guard<mutex> guard(fileLock);
+
+        if (file)
+            return true;
+
+        file = fopen(filename.c_str(), "w");
+
+        if (!file)
+        {
+            cerr << "WARNING: trace: cannot open " << filename << endl;
+            return false;
+        }
+
+        fputs("[", file);
+        firstEvent = true;
+        origin = Clock::now();
+        pid = int(getpid());
+
+        static bool registered = false;
+
+        if (!registered)
+        {
+            atexit(finishAtExit);
+            registered = true;
+        }
+
+        m_enabled.store(true);
+        cout << "INFO: tracing to " << filename << endl;
+        return true;
+    }
+
+    void Trace::finish()
+    {
+        if (!m_enabled.exchange(false))
+            return;
+
+        vector<ThreadBuffer*> all;
+
+        {
+            lock_guard<mutex> guard(buffersLock);
+            all = buffers;
+        }
+
+        for (size_t i = 0; i < all.size(); i++)
+        {
+            lock_guard<mutex> guard(all[i]->lock);
+            flushBuffer(all[i]);
+        }
+
+        lock_guard<mutex> guard(fileLock);
+        fputs("\n]\n", file);
+        fclose(file);
+        file = 0;
+    }
+
+    double Trace::now() { return chrono::duration<double, micro>(Clock::now() - origin).count(); }
+
+    void Trace::setThreadName(const string& name)
+    {
+        if (!enabled())
+            return;
+
+        Event e = makeEvent('M', "", 0);
+        e.dynamicName = name;
+        record(e);
+    }
+
+    void Trace::complete(const char* category, const char* name, double start, double end, const char* argName, int64_t argValue)
+    {
+        if (!enabled())
+            return;
+
+        Event e = makeEvent('X', category, name);
+        e.ts = start;
+        e.dur = end - start;
+        e.argName = argName;
+        e.argValue = argValue;
+        record(e);
+    }
+
+    void Trace::complete(const char* category, const string& name, double start, double end, const char* argName,
+                         int64_t argValue)
+    {
+        if (!enabled())
+            return;
+
+        Event e = makeEvent('X', category, 0);
+        e.dynamicName = name;
+        e.ts = start;
+        e.dur = end - start;
+        e.argName = argName;
+        e.argValue = argValue;
+        record(e);
+    }
+
+    void Trace::instant(const char* category, const char* name, const char* argName, int64_t argValue)
+    {
+        if (!enabled())
+            return;
+
+        Event e = makeEvent('i', category, name);
+        e.ts = now();
+        e.argName = argName;
+        e.argValue = argValue;
+        record(e);
+    }
+
+    void Trace::counter(const char* category, const char* name, int64_t value)
+    {
+        if (!enabled())
+            return;
+
+        Event e = makeEvent('C', category, name);
+        e.ts = now();
+        e.argValue = value;
+        record(e);
+    }
+
+    static StartFromEnvironment startFromEnvironment;
+
+} // namespace TwkUtil
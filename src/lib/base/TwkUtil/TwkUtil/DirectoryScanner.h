@@ -0,0 +1,94 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkUtil__DirectoryScanner__h__
+#define __TwkUtil__DirectoryScanner__h__
+#include <TwkUtil/dll_defs.h>
+#include <TwkUtil/File.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace TwkUtil
+{
+
+    //
+    //  DirectoryScanner
+    //
+    //  Lists directories for rvls and the media browser. Directories are
+    //  read in parallel on the global TaskPool. On Linux each one is read
+    //  with large getdents64() batches and entry types come from the
+    //  directory itself; only entries the file system doesn't type (some
+    //  NFS and FUSE mounts) are stat'd, in parallel.
+    //
+    //  If RV_DIR_SCAN_CACHE_DIR names a directory (it's created if
+    //  needed) listings are kept there between runs, one file per
+    //  directory. A cached listing is used as long as the directory's
+    //  modification time, inode and device haven't changed, so listing an
+    //  unchanged directory costs a single stat. Directories modified in
+    //  the last few seconds aren't cached since their mtime could still
+    //  change within its resolution.
+    //
+    //  probe() runs a function (typically reading an image header) for
+    //  a set of keys in parallel and caches its results the same way,
+    //  validated against the size and modification time of a
+    //  representative file for each key.
+    //
+
+    class TWKUTIL_EXPORT DirectoryScanner
+    {
+    public:
+        struct Listing
+        {
+            std::string path;
+            FileNameList files; // entry names, directories end in "/"
+            bool ok;            // false if the directory couldn't be read
+            bool cached;        // true if it came from the cache
+        };
+
+        typedef std::vector<Listing> Listings;
+        typedef std::vector<std::string> ProbeResult;
+        typedef std::function<ProbeResult(size_t index)> ProbeFunction;
+
+        //
+        //  With no cacheDir RV_DIR_SCAN_CACHE_DIR is used. An empty one
+        //  turns the cache off.
+        //
+
+        DirectoryScanner();
+        explicit DirectoryScanner(const std::string& cacheDir);
+
+        const std::string& cacheDir() const { return m_cacheDir; }
+
+        //
+        //  Lists each of dirs. "." and ".." are never included;
+        //  directories are only included if showDirs is true.
+        //
+
+        void scan(const std::vector<std::string>& dirs, Listings& listings, bool showDirs = false) const;
+        bool scan(const std::string& dir, FileNameList& files, bool showDirs = false) const;
+
+        //
+        //  Sets results[i] to fn(i) for each key (in parallel, in no
+        //  particular order) unless the cache has a result for keys[i]
+        //  made from the current version of files[i]. fn must be thread
+        //  safe.
+        //
+
+        void probe(const std::vector<std::string>& keys, const std::vector<std::string>& files, const ProbeFunction& fn,
+                   std::vector<ProbeResult>& results) const;
+
+    private:
+        void scanOne(Listing&) const;
+
+    private:
+        std::string m_cacheDir;
+    };
+
+} // namespace TwkUtil
+
+#endif // __TwkUtil__DirectoryScanner__h__
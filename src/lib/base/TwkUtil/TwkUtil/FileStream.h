@@ -32,6 +32,15 @@ namespace TwkUtil
     /// If deleteOnDestruction is false: you need to use the macro
     /// TWK_DEALLOCATE to free the memory returned by data();
     ///
+    /// IOUring (Linux only) queues every chunk of the read into a single
+    /// io_uring submission queue using O_DIRECT when the filesystem
+    /// allows it. If RV_IOURING_READAHEAD is set to N, whole file reads
+    /// also queue the next N files of the sequence (found by incrementing
+    /// the last number in the filename) into the same submission and hand
+    /// their buffers to later FileStreams of those files. On other
+    /// platforms, or kernels without io_uring, it behaves like
+    /// NonBuffering (ASyncNonBuffering on Windows).
+    ///
 
     class TWKUTIL_EXPORT FileStream
     {
@@ -42,7 +51,8 @@ namespace TwkUtil
             NonBuffering,
             MemoryMap,
             ASyncBuffering,
-            ASyncNonBuffering
+            ASyncNonBuffering,
+            IOUring
         };
 
         FileStream(const std::string& filename, size_t startOffset, size_t readSize, Type type = Buffering, size_t chunkSize = 61440,
@@ -70,6 +80,29 @@ namespace TwkUtil
         static double mbps();
         static void resetMbps();
 
+        //
+        //  Read the whole file now, on the calling thread, so that the
+        //  next FileStream of it (of any type except MemoryMap) gets the
+        //  data without touching the disk. A FileStream created while
+        //  the read is in progress waits for it. Returns false if the
+        //  file is already in memory, being read, or can't be read.
+        //  MemoryMap reads ahead into the page cache instead. Read-ahead
+        //  buffers that are never used are dropped oldest first once
+        //  they exceed the memory limit (RV_READAHEAD_MEMORY in MB,
+        //  default 1024). Not implemented on Windows.
+        //
+
+        static bool readAhead(const std::string& filename, Type type = Buffering, size_t chunkSize = 61440, int maxInFlight = 16);
+
+        //
+        //  Pull the file into the OS page cache, for readers that don't
+        //  use FileStream or use MemoryMap.
+        //
+
+        static void readAheadToPageCache(const std::string& filename);
+
+        static void setReadAheadMemoryLimit(size_t bytes);
+
     private:
         void initialize();
 
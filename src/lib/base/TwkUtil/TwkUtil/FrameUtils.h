@@ -16,6 +16,7 @@
 
 namespace TwkUtil
 {
+    class RegEx;
 
     //
     //  Types
@@ -65,6 +66,23 @@ namespace TwkUtil
 
     TWKUTIL_EXPORT SequencePredicateExtensionSet& predicateFileExtensions();
 
+    //
+    //  The minimum sequence size used when none is given
+    //  (TWK_MIN_SEQUENCE_SIZE, default 5) and the RV_NO_SEQUENCE_PATTERN
+    //  regex for file names which are never part of a sequence (NULL if
+    //  it isn't set).
+    //
+
+    TWKUTIL_EXPORT int defaultMinimumSequenceSize();
+    TWKUTIL_EXPORT const RegEx* noSequencePattern();
+
+    //
+    //  The frame part of a sequence name sequencesInFileList() makes
+    //  from its frames and padding, e.g. "1-100#" or "1-10,20-30@@@".
+    //
+
+    TWKUTIL_EXPORT std::string sequenceTimeStr(const FrameList& frames, int pad, bool frameRanges = true);
+
     //
     //  Returns all the SequenceNames in a list of files
     //
@@ -17,6 +17,7 @@
 #include <boost/thread/lock_guard.hpp>
 
 #include <map>
+#include <unordered_map>
 
 namespace TwkUtil
 {
@@ -30,14 +31,22 @@ namespace TwkUtil
     //  oldest (least-recently freed) blocks in the list are freed and removed
     //  from the list until there is room for the incoming block.
     //
-    //  When a new large block is requested, the free list is checked first and
-    //  if an appropriately-sized (relative size difference is < AllocSlop)
-    //  block is found, that block is returned.  If not we do a "real" alloc.
+    //  The free list is bucketed by exact block size, so the planes of a
+    //  homogeneous sequence are recycled in constant time. If there is no
+    //  block of the exact size, the smallest larger block whose relative
+    //  size difference is < AllocSlop is used. If there is none of those
+    //  either we do a "real" alloc.
     //
-    //  We assume that the target pool size and minimum element size is such
-    //  that the pool will have a small number of elements (< 100).
+    //  Each bucket keeps a separate list per NUMA node (on Linux). Pages
+    //  end up on the node of the thread that first touches them, so a
+    //  block is preferably handed back to a thread running on the node
+    //  it was freed on.
+    //
+    //  On Linux the large blocks are anonymous mappings aligned to the
+    //  huge page size and advised for transparent huge pages, which cuts
+    //  the number of page faults (and TLB misses) when a new block is
+    //  first filled. TWK_MEM_POOL_HUGE_PAGES=0 turns this off.
     //
-
     class TWKUTIL_EXPORT MemPool
     {
     public:
@@ -54,15 +63,50 @@ namespace TwkUtil
         //
         static void dealloc(void* ptr);
 
+#ifndef WIN32
+        //  Hand a region obtained from mmap() over to the pool. A later
+        //  dealloc() of ptr will munmap() the region instead of freeing
+        //  it, so file-backed pixels can be owned by a FrameBuffer like
+        //  any other large block.
+        //
+        static void adoptMappedBlock(void* ptr, size_t size);
+#endif
+
         static void initialize();
 
+        struct Stats
+        {
+            size_t hits;           /// large allocs served from the free list
+            size_t remoteHits;     /// hits using a block from another NUMA node
+            size_t misses;         /// large allocs that needed a real alloc
+            size_t residentBytes;  /// bytes held in the free list
+            size_t residentBlocks; /// blocks held in the free list
+            size_t liveBytes;      /// bytes of large blocks currently in use
+
+            Stats()
+                : hits(0)
+                , remoteHits(0)
+                , misses(0)
+                , residentBytes(0)
+                , residentBlocks(0)
+                , liveBytes(0)
+            {
+            }
+        };
+
+        //
+        //  Returns zeros if the pool was never initialized.
+        //
+
+        static Stats stats();
+
     private:
         class FreeList;
         class PoolElem;
 
         typedef boost::mutex Mutex;
         typedef boost::lock_guard<Mutex> LockGuard;
-        typedef std::map<const void*, PoolElem*> ElemMap;
+        typedef std::unordered_map<const void*, PoolElem*> ElemMap;
 
         size_t m_poolSize;    //  Max total size (bytes) of mem pool
         size_t m_minElemSize; //  Minimum pool element size (bytes)
@@ -70,9 +114,11 @@ namespace TwkUtil
 
         bool m_shortCircuit; //  Fallback to former behavior
         bool m_debugOutput;
+        bool m_hugePages; //  Back large blocks with huge pages if possible
 
         FreeList* m_freeList; //  List of blocks available for re-use
         ElemMap m_elemMap;    //  Map of ptrs to all PoolElems (free or in-use)
+        Stats m_stats;
 
         Mutex m_mutex;
     };
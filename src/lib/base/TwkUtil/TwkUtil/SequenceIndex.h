@@ -0,0 +1,112 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkUtil__SequenceIndex__h__
+#define __TwkUtil__SequenceIndex__h__
+#include <TwkUtil/dll_defs.h>
+#include <TwkUtil/FrameUtils.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TwkUtil
+{
+
+    //
+    //  SequenceIndex
+    //
+    //  Groups file names into sequences the way sequencesInFileList()
+    //  does -- same candidate frame numbers, same preference between
+    //  them, same output names and order -- without its regex scan of
+    //  the whole list for every candidate.
+    //
+    //  As files are added each candidate frame number in the file's
+    //  basename is indexed under the name with that number taken out
+    //  (e.g. "shot.0001.exr" under "shot." + ".exr"), so the files a
+    //  candidate would gather are the ones in its bucket. add() can be
+    //  called as directory listings arrive; sequences() can be called at
+    //  any point and doesn't change the index.
+    //
+    //  The two can disagree on pathological names (a frame number of
+    //  more than 9 digits next to one which isn't, for example). They
+    //  also disagree where sequencesInFileList() treats a '.' in a name
+    //  as a regex wildcard: it will put "shot_0002.exr" in the sequence
+    //  of "shot.0001.exr", SequenceIndex won't.
+    //
+
+    class TWKUTIL_EXPORT SequenceIndex
+    {
+    public:
+        struct Sequence
+        {
+            SequenceName name; // e.g. "shot.1-100#.exr", or a file name
+            std::string file;  // the first file of the sequence
+        };
+
+        typedef std::vector<Sequence> Sequences;
+
+        //
+        //  The arguments have the same meaning as sequencesInFileList()'s
+        //
+
+        SequenceIndex(SequencePredicate P = NULL, bool includeNonMatching = true, bool frameRanges = true, int minSequenceSize = -1);
+
+        void add(const std::string& file);
+        void add(const FileNameList& files);
+
+        size_t size() const { return m_files.size(); }
+
+        void clear();
+
+        Sequences sequences() const;
+        SequenceNameList sequenceNames() const;
+
+    private:
+        struct Run
+        {
+            size_t start;
+            size_t length;
+            size_t bucket;
+            int frame;
+            bool candidate : 1;
+            bool hasDot : 1;
+        };
+
+        struct File
+        {
+            std::string name;
+            size_t firstRun;
+            size_t numRuns;
+        };
+
+        struct Member
+        {
+            size_t file;
+            size_t run;
+        };
+
+        typedef std::vector<Member> Bucket;
+        typedef std::unordered_map<uint64_t, size_t> BucketMap;
+
+        void addRuns(File&);
+        size_t bucket(const std::string&, const Run&);
+
+    private:
+        SequencePredicate m_predicate;
+        bool m_includeNonMatching;
+        bool m_frameRanges;
+        int m_minSequenceSize;
+        std::vector<File> m_files;
+        std::vector<Run> m_runs;
+        std::vector<Bucket> m_buckets;
+        BucketMap m_bucketMap;
+    };
+
+} // namespace TwkUtil
+
+#endif // __TwkUtil__SequenceIndex__h__
@@ -0,0 +1,124 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkUtil__TaskPool__h__
+#define __TwkUtil__TaskPool__h__
+#include <TwkUtil/dll_defs.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace TwkUtil
+{
+
+    //
+    //  TaskPool
+    //
+    //  A fixed set of worker threads which run small tasks. Each worker
+    //  has its own deque: tasks queued from a worker go on the back of
+    //  its own deque and are taken from there LIFO (so nested work stays
+    //  on the same core), idle workers steal from the front of the other
+    //  deques. Tasks queued from outside the pool are spread over the
+    //  workers round robin.
+    //
+    //  Tasks are queued through a TaskPool::Group. Group::wait() doesn't
+    //  just block: the waiting thread runs the group's own queued tasks
+    //  until the group is done, so a thread which splits its work into
+    //  tasks is never idle and nested groups can't deadlock the pool. It
+    //  never runs other groups' tasks.
+    //
+    //  globalPool() is shared by the whole process. It has one worker per
+    //  core minus one unless RV_TASK_POOL_THREADS says otherwise; with 0
+    //  workers (or on a single core machine) it is NULL and callers are
+    //  expected to do the work themselves.
+    //
+
+    class TWKUTIL_EXPORT TaskPool
+    {
+    public:
+        typedef std::function<void()> Task;
+
+        class TWKUTIL_EXPORT Group
+        {
+        public:
+            Group(TaskPool*);
+            ~Group();
+
+            //
+            //  Queue a task. If the group has no pool the task is run
+            //  immediately.
+            //
+
+            void run(const Task&);
+
+            //
+            //  Returns once every task queued on the group has finished.
+            //  If any of them threw, the first exception is rethrown here.
+            //
+
+            void wait();
+
+        private:
+            Group(const Group&);
+            Group& operator=(const Group&);
+
+            friend class TaskPool;
+
+            void taskDone(std::exception_ptr);
+
+        private:
+            TaskPool* m_pool;
+            std::atomic<int> m_pending;
+            std::exception_ptr m_error;
+            std::mutex m_mutex;
+            std::condition_variable m_done;
+        };
+
+        explicit TaskPool(size_t numWorkers);
+        ~TaskPool();
+
+        size_t numWorkers() const { return m_workers.size(); }
+
+        static TaskPool* globalPool();
+
+    private:
+        struct Item
+        {
+            Task task;
+            Group* group;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<Item> items;
+            std::thread thread;
+        };
+
+        void push(const Item&);
+        bool pop(Item&, size_t preferred, const Group* group = 0);
+        void execute(Item&);
+        void workerMain(size_t index);
+        int currentWorker() const;
+
+    private:
+        std::vector<Worker*> m_workers;
+        std::atomic<size_t> m_nextWorker;
+        std::atomic<size_t> m_queued;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+        bool m_shutdown;
+    };
+
+} // namespace TwkUtil
+
+#endif // __TwkUtil__TaskPool__h__
@@ -0,0 +1,180 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkUtil__Trace__h__
+#define __TwkUtil__Trace__h__
+#include <TwkUtil/dll_defs.h>
+#include <atomic>
+#include <string>
+#include <stdint.h>
+
+namespace TwkUtil
+{
+
+    //
+    //  Trace
+    //
+    //  Process wide event tracing written as a Chrome trace event file
+    //  (JSON array format) which chrome://tracing, Perfetto and
+    //  speedscope all load. Turned on by setting RV_TRACE_FILE to the
+    //  output path or by calling start().
+    //
+    //  Each thread appends to its own buffer; a buffer is only written
+    //  out when it fills up or when the trace is finished, so the cost of
+    //  an event is a clock read and an append. When tracing is off the
+    //  macros below cost a single relaxed load.
+    //
+    //  The file is valid even if finish() is never called (the array
+    //  format allows the closing bracket to be missing) but events still
+    //  sitting in the thread buffers are lost, so applications which
+    //  leave through _Exit() should call finish() first.
+    //
+    //  The HOP_PROF(), HOP_PROF_FUNC() and HOP_PROF_DYN_NAME() zones in
+    //  sgcHop.h are routed here when HOP itself is not compiled in.
+    //
+
+    class TWKUTIL_EXPORT Trace
+    {
+    public:
+        static bool enabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+        //
+        //  Open the output file and start recording. Returns false if the
+        //  file can't be opened. finish() flushes everything and closes
+        //  it (also done at exit).
+        //
+
+        static bool start(const std::string& filename);
+        static void finish();
+
+        //
+        //  Microseconds since start()
+        //
+
+        static double now();
+
+        //
+        //  Names the calling thread in the trace. Called by
+        //  TwkUtil::setThreadName().
+        //
+
+        static void setThreadName(const std::string&);
+
+        //
+        //  Raw events. name and category must be string literals (or
+        //  otherwise live until the trace is finished) except for the
+        //  std::string overloads which copy. arg is an optional integer
+        //  argument attached to the event (e.g. a byte count).
+        //
+
+        static void complete(const char* category, const char* name, double start, double end, const char* argName = 0,
+                             int64_t argValue = 0);
+        static void complete(const char* category, const std::string& name, double start, double end, const char* argName = 0,
+                             int64_t argValue = 0);
+        static void instant(const char* category, const char* name, const char* argName = 0, int64_t argValue = 0);
+        static void counter(const char* category, const char* name, int64_t value);
+
+    private:
+        static std::atomic<bool> m_enabled;
+    };
+
+    //
+    //  Records a complete event covering its lifetime.
+    //
+
+    class TWKUTIL_EXPORT TraceScope
+    {
+    public:
+        struct CopyName
+        {
+        };
+
+        TraceScope(const char* category, const char* name)
+            : m_category(category)
+            , m_name(name)
+            , m_start(Trace::enabled() ? Trace::now() : -1.0)
+            , m_argName(0)
+            , m_argValue(0)
+        {
+        }
+
+        //
+        //  Copies name, which only has to live as long as the call. Pass
+        //  NULL (not "") when tracing is off to avoid building the name;
+        //  see TWK_TRACE_SCOPE_DYNAMIC.
+        //
+
+        TraceScope(const char* category, const char* name, CopyName)
+            : m_category(category)
+            , m_name(0)
+            , m_start(name ? Trace::now() : -1.0)
+            , m_argName(0)
+            , m_argValue(0)
+        {
+            if (name)
+                m_dynamicName = name;
+        }
+
+        ~TraceScope()
+        {
+            if (m_start >= 0.0)
+            {
+                if (m_name)
+                    Trace::complete(m_category, m_name, m_start, Trace::now(), m_argName, m_argValue);
+                else
+                    Trace::complete(m_category, m_dynamicName, m_start, Trace::now(), m_argName, m_argValue);
+            }
+        }
+
+        void setArg(const char* name, int64_t value)
+        {
+            m_argName = name;
+            m_argValue = value;
+        }
+
+    private:
+        TraceScope(const TraceScope&);
+        TraceScope& operator=(const TraceScope&);
+
+        const char* m_category;
+        const char* m_name;
+        std::string m_dynamicName;
+        double m_start;
+        const char* m_argName;
+        int64_t m_argValue;
+    };
+
+} // namespace TwkUtil
+
+#define TWK_TRACE_CONCAT2(a, b) a##b
+#define TWK_TRACE_CONCAT(a, b) TWK_TRACE_CONCAT2(a, b)
+
+#define TWK_TRACE_SCOPE(category, name) TwkUtil::TraceScope TWK_TRACE_CONCAT(twkTraceScope, __LINE__)(category, name)
+
+//
+//  The name expression is only evaluated when tracing is on
+//
+
+#define TWK_TRACE_SCOPE_DYNAMIC(category, name) \
+    TwkUtil::TraceScope TWK_TRACE_CONCAT(twkTraceScope, __LINE__)(category, TwkUtil::Trace::enabled() ? (name) : 0, \
+                                                                  TwkUtil::TraceScope::CopyName())
+
+#define TWK_TRACE_INSTANT(category, name, argName, argValue) \
+    do                                                       \
+    {                                                        \
+        if (TwkUtil::Trace::enabled())                       \
+            TwkUtil::Trace::instant(category, name, argName, argValue); \
+    } while (0)
+
+#define TWK_TRACE_COUNTER(category, name, value)             \
+    do                                                       \
+    {                                                        \
+        if (TwkUtil::Trace::enabled())                       \
+            TwkUtil::Trace::counter(category, name, value);  \
+    } while (0)
+
+#endif // __TwkUtil__Trace__h__
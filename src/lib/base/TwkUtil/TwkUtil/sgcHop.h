@@ -31,12 +31,19 @@ For more information, please refer to <http://unlicense.org/>
 // to false
 #if !defined( HOP_ENABLED )
 
-// Stubbing all profiling macros so they are disabled
-// when HOP_ENABLED is false
+// Without HOP the plain zones go to TwkUtil::Trace (which costs a
+// relaxed load unless RV_TRACE_FILE is set); everything else is stubbed
+#if defined( __cplusplus )
+#include <TwkUtil/Trace.h>
+#define HOP_PROF( x ) TWK_TRACE_SCOPE( "hop", x )
+#define HOP_PROF_FUNC() TWK_TRACE_SCOPE( "hop", __FUNCTION__ )
+#define HOP_PROF_DYN_NAME( x ) TWK_TRACE_SCOPE_DYNAMIC( "hop", x )
+#else
 #define HOP_PROF( x )
 #define HOP_PROF_FUNC()
-#define HOP_PROF_SPLIT( x )
 #define HOP_PROF_DYN_NAME( x )
+#endif
+#define HOP_PROF_SPLIT( x )
 #define HOP_PROF_MUTEX_LOCK( x )
 #define HOP_PROF_MUTEX_UNLOCK( x )
 #define HOP_ZONE( x )
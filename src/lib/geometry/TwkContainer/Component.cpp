@@ -40,6 +40,7 @@ namespace TwkContainer
         }
 
         m_components.clear();
+        PropertyContainer::structureChanged();
     }
 
     void Component::remove(Property* p)
@@ -47,6 +48,7 @@ namespace TwkContainer
         stl_ext::remove(m_properties, p);
         p->setComponent(0);
         p->unref();
+        PropertyContainer::structureChanged();
     }
 
     void Component::remove(const std::string& name)
@@ -73,6 +75,7 @@ namespace TwkContainer
         m_properties.push_back(p);
 
         p->setComponent(this);
+        PropertyContainer::structureChanged();
     }
 
     bool Component::hasProperty(const Property* p) const
@@ -394,6 +397,7 @@ namespace TwkContainer
 
         m_components.push_back(c);
         c->m_container = m_container;
+        PropertyContainer::structureChanged();
     }
 
     void Component::remove(Component* c)
@@ -403,6 +407,7 @@ namespace TwkContainer
         if (i != m_components.end())
         {
             m_components.erase(i);
+            PropertyContainer::structureChanged();
         }
     }
 
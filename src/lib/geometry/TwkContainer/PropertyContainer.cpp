@@ -21,6 +21,8 @@ namespace TwkContainer
     using namespace stl_ext;
     using namespace boost;
 
+    std::atomic<uint64_t> PropertyContainer::m_structureGeneration(1);
+
     PropertyContainer::PropertyContainer()
         : m_protocolVersion(1)
     {
@@ -31,10 +33,22 @@ namespace TwkContainer
     {
         delete_contents(m_components);
         m_components.clear();
+        structureChanged();
     }
 
     void PropertyContainer::parseFullName(const string& fullname, StringVector& parts)
     {
+        //
+        //  Most lookups inside a component are of a single name; skip
+        //  the split for those.
+        //
+
+        if (fullname.find('.') == string::npos)
+        {
+            parts.assign(1, fullname);
+            return;
+        }
+
         algorithm::split(parts, fullname, is_any_of(string(".")));
     }
 
@@ -144,6 +158,7 @@ namespace TwkContainer
 
         m_components.push_back(c);
         c->m_container = this;
+        structureChanged();
     }
 
     void PropertyContainer::remove(Component* c)
@@ -153,6 +168,7 @@ namespace TwkContainer
         if (i != m_components.end())
         {
             m_components.erase(i);
+            structureChanged();
         }
     }
 
@@ -299,6 +315,10 @@ namespace TwkContainer
         return find(parts.begin(), parts.end());
     }
 
+    Property* PropertyContainer::find(const PropertyName& name) { return find(name.begin(), name.end()); }
+
+    const Property* PropertyContainer::find(const PropertyName& name) const { return find(name.begin(), name.end()); }
+
     Property* PropertyContainer::find(const std::string& comp, const std::string& name)
     {
         if (Component* c = component(comp))
@@ -0,0 +1,59 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+
+#include <TwkContainer/PropertyName.h>
+#include <TwkContainer/PropertyContainer.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace TwkContainer
+{
+    using namespace std;
+
+    typedef unordered_map<string, PropertyName::Entry*> EntryMap;
+
+    static mutex entryMapMutex;
+
+    static EntryMap& entryMap()
+    {
+        static EntryMap* map = new EntryMap();
+        return *map;
+    }
+
+    const PropertyName::Entry* PropertyName::intern(const string& fullname)
+    {
+        lock_guard<mutex> lock(entryMapMutex);
+        EntryMap& map = entryMap();
+        EntryMap::const_iterator i = map.find(fullname);
+
+        if (i != map.end())
+            return i->second;
+
+        Entry* e = new Entry();
+        e->fullname = fullname;
+        PropertyContainer::parseFullName(fullname, e->parts);
+        map[fullname] = e;
+        return e;
+    }
+
+    PropertyName::PropertyName()
+        : m_entry(intern(""))
+    {
+    }
+
+    PropertyName::PropertyName(const string& fullname)
+        : m_entry(intern(fullname))
+    {
+    }
+
+    PropertyName::PropertyName(const char* fullname)
+        : m_entry(intern(fullname ? fullname : ""))
+    {
+    }
+
+} // namespace TwkContainer
@@ -10,6 +10,9 @@
 #include <TwkContainer/Properties.h>
 #include <TwkContainer/Component.h>
 #include <TwkContainer/Exception.h>
+#include <TwkContainer/PropertyName.h>
+#include <atomic>
+#include <stdint.h>
 
 namespace TwkContainer
 {
@@ -112,6 +115,9 @@ namespace TwkContainer
         Property* find(const std::string& fullname);
         const Property* find(const std::string& fullname) const;
 
+        Property* find(const PropertyName&);
+        const Property* find(const PropertyName&) const;
+
         template <class T> T* property(const std::string& comp, const std::string& name);
 
         template <class T> const T* property(const std::string& comp, const std::string& name) const;
@@ -120,6 +126,10 @@ namespace TwkContainer
 
         template <class T> const T* property(const std::string& fullname) const;
 
+        template <class T> T* property(const PropertyName&);
+
+        template <class T> const T* property(const PropertyName&) const;
+
         //
         //  All properties flattened into a map
         //
@@ -162,6 +172,9 @@ namespace TwkContainer
         template <typename T>
         typename T::value_type propertyValue(const std::string& fullname, const typename T::value_type& defaultValue) const;
 
+        template <typename T>
+        typename T::value_type propertyValue(const PropertyName& name, const typename T::value_type& defaultValue) const;
+
         template <typename T> typename T::container_type& propertyContainer(const std::string& fullname);
 
         template <typename T> const typename T::container_type& propertyContainer(const std::string& fullname) const;
@@ -237,6 +250,18 @@ namespace TwkContainer
 
         static void parseFullName(const std::string& fullname, StringVector& parts);
 
+        //
+        //  The structure generation changes whenever a component or
+        //  property is added to or removed from any container or
+        //  component (or one is destroyed). Values of properties don't
+        //  affect it. PropertyHandle uses it to know when a resolved
+        //  Property* may no longer be valid.
+        //
+
+        static uint64_t structureGeneration() { return m_structureGeneration.load(std::memory_order_acquire); }
+
+        static void structureChanged() { m_structureGeneration.fetch_add(1, std::memory_order_acq_rel); }
+
     protected:
         virtual PropertyContainer* emptyContainer() const;
         bool propertyPathInternal(const Property*, ConstComponents&) const;
@@ -246,6 +271,7 @@ namespace TwkContainer
         std::string m_protocol;
         unsigned int m_protocolVersion;
         Components m_components;
+        static std::atomic<uint64_t> m_structureGeneration;
     };
 
     // Forward declaration of some "utility" functions
@@ -310,6 +336,32 @@ namespace TwkContainer
         return 0;
     }
 
+    template <class T> T* PropertyContainer::property(const PropertyName& name)
+    {
+        if (name.parts().empty())
+            return 0;
+
+        if (Component* c = component(name.begin(), name.end() - 1))
+        {
+            return dynamic_cast<T*>(c->find(name.end() - 1, name.end()));
+        }
+
+        return 0;
+    }
+
+    template <class T> const T* PropertyContainer::property(const PropertyName& name) const
+    {
+        if (name.parts().empty())
+            return 0;
+
+        if (const Component* c = component(name.begin(), name.end() - 1))
+        {
+            return dynamic_cast<const T*>(c->find(name.end() - 1, name.end()));
+        }
+
+        return 0;
+    }
+
     template <class T> T* PropertyContainer::createProperty(const std::string& comp, const std::string& name)
     {
         StringVector parts;
@@ -487,6 +539,12 @@ namespace TwkContainer
         return defaultValue;
     }
 
+    template <typename T>
+    typename T::value_type PropertyContainer::propertyValue(const PropertyName& name, const typename T::value_type& defaultValue) const
+    {
+        return propertyValue<T>(property<T>(name), defaultValue);
+    }
+
     template <typename T>
     typename T::value_type PropertyContainer::propertyValue(const T* p, const typename T::value_type& defaultValue) const
     {
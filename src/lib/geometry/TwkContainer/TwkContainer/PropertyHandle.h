@@ -0,0 +1,161 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkContainer__PropertyHandle__h__
+#define __TwkContainer__PropertyHandle__h__
+#include <TwkContainer/PropertyContainer.h>
+#include <TwkContainer/PropertyName.h>
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+namespace TwkContainer
+{
+
+    //
+    //  class PropertyHandle<T>
+    //
+    //  A property of one container looked up by name once and then
+    //  remembered. get() returns the cached pointer as long as
+    //  PropertyContainer::structureGeneration() hasn't changed since it
+    //  was resolved; otherwise (something somewhere was added or
+    //  removed) the name is looked up again. get() returns 0 if the
+    //  property doesn't exist or isn't a T.
+    //
+    //  This is meant for properties which are read often but which the
+    //  owner doesn't create itself (so can't just keep the pointer
+    //  declareProperty() returns), e.g. as a member of an IPNode bound
+    //  to the node. get() may be called from several threads at once;
+    //  only resolving takes a lock.
+    //
+
+    template <class T> class PropertyHandle
+    {
+    public:
+        PropertyHandle()
+            : m_container(0)
+            , m_sequence(0)
+            , m_generation(0)
+            , m_property(0)
+        {
+        }
+
+        PropertyHandle(PropertyContainer* c, const PropertyName& name)
+            : m_container(c)
+            , m_name(name)
+            , m_sequence(0)
+            , m_generation(0)
+            , m_property(0)
+        {
+        }
+
+        PropertyHandle(PropertyContainer* c, const std::string& fullname)
+            : m_container(c)
+            , m_name(fullname)
+            , m_sequence(0)
+            , m_generation(0)
+            , m_property(0)
+        {
+        }
+
+        PropertyHandle(const PropertyHandle& other)
+            : m_container(other.m_container)
+            , m_name(other.m_name)
+            , m_sequence(0)
+            , m_generation(0)
+            , m_property(0)
+        {
+        }
+
+        PropertyHandle& operator=(const PropertyHandle& other)
+        {
+            bind(other.m_container, other.m_name);
+            return *this;
+        }
+
+        //
+        //  bind() can't be called while other threads are using the
+        //  handle
+        //
+
+        void bind(PropertyContainer* c, const PropertyName& name)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_container = c;
+            m_name = name;
+            publish(0, 0);
+        }
+
+        PropertyContainer* container() const { return m_container; }
+
+        const PropertyName& name() const { return m_name; }
+
+        T* get() const
+        {
+            const uint64_t g = PropertyContainer::structureGeneration();
+
+            //
+            //  The generation and pointer are published together under a
+            //  sequence number (odd while they're being written) so a
+            //  reader never pairs one resolution's pointer with another's
+            //  generation.
+            //
+
+            const uint64_t s = m_sequence.load(std::memory_order_acquire);
+
+            if (!(s & 1))
+            {
+                const uint64_t generation = m_generation.load(std::memory_order_relaxed);
+                T* p = m_property.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (generation == g && m_sequence.load(std::memory_order_relaxed) == s)
+                    return p;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            T* p = m_container ? m_container->template property<T>(m_name) : 0;
+            publish(g, p);
+            return p;
+        }
+
+        T* operator->() const { return get(); }
+
+        typename T::value_type value(const typename T::value_type& defaultValue) const
+        {
+            const T* p = get();
+            return p && p->size() == 1 ? p->front() : defaultValue;
+        }
+
+    private:
+        //
+        //  Call with m_mutex held
+        //
+
+        void publish(uint64_t generation, T* p) const
+        {
+            const uint64_t s = m_sequence.load(std::memory_order_relaxed);
+            m_sequence.store(s + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            m_generation.store(generation, std::memory_order_relaxed);
+            m_property.store(p, std::memory_order_relaxed);
+            m_sequence.store(s + 2, std::memory_order_release);
+        }
+
+    private:
+        PropertyContainer* m_container;
+        PropertyName m_name;
+        mutable std::mutex m_mutex;
+        mutable std::atomic<uint64_t> m_sequence;
+        mutable std::atomic<uint64_t> m_generation;
+        mutable std::atomic<T*> m_property;
+    };
+
+} // namespace TwkContainer
+
+#endif // __TwkContainer__PropertyHandle__h__
@@ -0,0 +1,68 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkContainer__PropertyName__h__
+#define __TwkContainer__PropertyName__h__
+#include <string>
+#include <vector>
+
+namespace TwkContainer
+{
+
+    //
+    //  class PropertyName
+    //
+    //  An interned property path like "color.exposure". The name is split
+    //  into its components once, when it's first seen; after that a
+    //  PropertyName is just a pointer to the shared entry, so it's cheap
+    //  to copy and compare and can be passed to PropertyContainer::find()
+    //  and property<T>() without the name being parsed again.
+    //
+    //  Entries are never freed. Don't intern names made up on the fly
+    //  from unbounded input.
+    //
+
+    class PropertyName
+    {
+    public:
+        typedef std::vector<std::string> StringVector;
+        typedef StringVector::const_iterator NameIterator;
+
+        struct Entry
+        {
+            std::string fullname;
+            StringVector parts;
+        };
+
+        PropertyName();
+        explicit PropertyName(const std::string& fullname);
+        explicit PropertyName(const char* fullname);
+
+        const std::string& fullname() const { return m_entry->fullname; }
+
+        const StringVector& parts() const { return m_entry->parts; }
+
+        NameIterator begin() const { return m_entry->parts.begin(); }
+
+        NameIterator end() const { return m_entry->parts.end(); }
+
+        bool empty() const { return m_entry->fullname.empty(); }
+
+        bool operator==(const PropertyName& other) const { return m_entry == other.m_entry; }
+
+        bool operator!=(const PropertyName& other) const { return m_entry != other.m_entry; }
+
+    private:
+        static const Entry* intern(const std::string&);
+
+    private:
+        const Entry* m_entry;
+    };
+
+} // namespace TwkContainer
+
+#endif // __TwkContainer__PropertyName__h__
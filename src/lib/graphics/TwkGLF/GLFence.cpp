@@ -7,6 +7,7 @@
 //
 #include <TwkGLF/GL.h>
 #include <TwkUtil/Timer.h>
+#include <TwkUtil/Trace.h>
 #include <TwkGLF/GLFence.h>
 
 namespace TwkGLF
@@ -139,6 +140,8 @@ namespace TwkGLF
 
     void GLFence::wait(bool client) const
     {
+        TWK_TRACE_SCOPE("gpu", "GLFence::wait");
+
         if (hasARB)
         {
 #if defined(HAVE_ARB_SYNC_API)
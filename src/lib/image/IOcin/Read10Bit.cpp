@@ -6,6 +6,7 @@
 //******************************************************************************
 #include <IOcin/Read10Bit.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/FastMemcpy.h>
 #include <TwkFB/Operations.h>
 #include <TwkMath/Iostream.h>
 #include <TwkMath/Color.h>
@@ -755,12 +756,8 @@ namespace TwkFB
 
         if (swap)
         {
-            Timer t;
-            t.start();
-            TwkUtil::swapWords(fb.pixels<char>(), w * h);
-            // cout << "READ10: swapped time = "
-            //<< t.elapsed()
-            //<< endl;
+            U32* p = fb.pixels<U32>();
+            swap_bytes_32bit_MP(w, h, p, p);
         }
     }
 
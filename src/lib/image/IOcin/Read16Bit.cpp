@@ -6,6 +6,7 @@
 //******************************************************************************
 #include <IOcin/Read16Bit.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/FastMemcpy.h>
 #include <TwkFB/Operations.h>
 #include <TwkMath/Iostream.h>
 #include <TwkUtil/Timer.h>
@@ -58,10 +59,8 @@ namespace TwkFB
 
             if (swap)
             {
-                Timer t;
-                t.start();
-                swapShorts(fb.pixels<unsigned short>(), w * h * 3);
-                // cout << "READ16: swapped in " << t.elapsed() << endl;
+                unsigned short* p = fb.pixels<unsigned short>();
+                swap_bytes_16bit_MP(size_t(w) * 3, h, p, p);
             }
         }
         else
@@ -138,10 +137,8 @@ namespace TwkFB
 
                 if (swap)
                 {
-                    Timer t;
-                    t.start();
-                    swapShorts(fb.pixels<unsigned short>(), w * h * 4);
-                    // cout << "READ16: swapped in " << t.elapsed() << endl;
+                    unsigned short* p = fb.pixels<unsigned short>();
+                    swap_bytes_16bit_MP(size_t(w) * 4, h, p, p);
                 }
             }
             else
@@ -420,6 +420,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
         : StreamingFrameBufferIO("IOdpx", "m5", type, chunksize, maxAsync)
         , m_format(format)
         , m_useChromaticities(useChromaticies)
+        , m_zeroCopy(false)
     {
         init();
     }
@@ -427,6 +428,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
     IOdpx::IOdpx(const std::string& format, bool useChromaticies, IOType type, size_t chunksize, int maxAsync)
         : StreamingFrameBufferIO("IOdpx", "m5", type, chunksize, maxAsync)
         , m_useChromaticities(useChromaticies)
+        , m_zeroCopy(false)
     {
         if (format == "RGB8")
             m_format = RGB8;
@@ -523,6 +525,8 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
     {
         if (name == "useChromaticies")
             return m_useChromaticities;
+        if (name == "zeroCopy")
+            return m_zeroCopy;
         return StreamingFrameBufferIO::getBoolAttribute(name);
     }
 
@@ -530,6 +534,8 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
     {
         if (name == "useChromaticies")
             m_useChromaticities = value;
+        if (name == "zeroCopy")
+            m_zeroCopy = value;
         StreamingFrameBufferIO::setBoolAttribute(name, value);
     }
 
@@ -1259,7 +1265,15 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                     }
                     else
                     {
-                        switch (m_format)
+                        //
+                        //  In zero copy mode filled RGB data is always
+                        //  read as RGB10_A2, which is the file layout.
+                        //
+
+                        const StorageFormat format =
+                            m_zeroCopy && !alpha && packing == IOdpx::DPX_PAD_LSB_WORD ? RGB10_A2 : m_format;
+
+                        switch (format)
                         {
                         default:
                         case RGB8:
@@ -1377,6 +1391,16 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                     {
                         Read12Bit::readNoPaddingRGB16(filename, data, fb, w, h, maxData, swap);
                     }
+                    else if (m_zeroCopy && !alpha && canUseRaw && size_t(w * h * 6) <= maxData)
+                    {
+                        //
+                        //  LSB padded 12 bit is just 16 bit data with
+                        //  the bottom 4 bits clear
+                        //
+
+                        didUseRaw = true;
+                        Read16Bit::readRGB16(filename, data, fb, w, h, maxData, swap, didUseRaw, (unsigned char*)fstream.data());
+                    }
                     else
                     {
                         switch (m_format)
@@ -1427,7 +1451,7 @@ static const char* read(IOdpx::DPXHeader& h, const char* p)
                     {
                         const bool partial = (w * h * 6) > maxData;
 
-                        if (m_format == RGB16 && canUseRaw && !partial)
+                        if ((m_format == RGB16 || m_zeroCopy) && canUseRaw && !partial)
                         {
                             didUseRaw = true;
                             Read16Bit::readRGB16(filename, data, fb, w, h, maxData, swap, didUseRaw, (unsigned char*)fstream.data());
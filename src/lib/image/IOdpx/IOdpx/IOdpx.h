@@ -359,6 +359,16 @@ namespace TwkFB
 
         void format(StorageFormat f) { m_format = f; }
 
+        //
+        //  Zero copy: 10, 12 and 16 bit RGB files are handed over in
+        //  their file layout (PACKED_R10_G10_B10_X2 or USHORT RGB) using
+        //  the read buffer as the FrameBuffer's pixels when it's aligned,
+        //  regardless of format. Only the byte order is fixed up (in
+        //  place) if needed. Also the bool attribute "zeroCopy".
+        //
+
+        void zeroCopy(bool b) { m_zeroCopy = b; }
+
         //
         //  FrameBufferIO API
         //
@@ -378,6 +388,7 @@ namespace TwkFB
     private:
         bool m_useChromaticities;
         StorageFormat m_format;
+        bool m_zeroCopy;
     };
 
 } // namespace TwkFB
@@ -87,7 +87,8 @@ namespace TwkFB
     void IOexr::readMultiPartChannelList(const std::string& filename, const std::string& view, FrameBuffer& fb,
                                          Imf::MultiPartInputFile& file, vector<MultiPartChannel>& channelsRead, bool convertYRYBY,
                                          bool planar3channel, bool allChannels, bool inheritChannels, bool noOneChannelPlanes,
-                                         bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window)
+                                         bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                         const ReadRequest& request)
     {
         // Move the outfb setup and attributes to
         // a new function.
@@ -98,6 +99,34 @@ namespace TwkFB
         FrameBuffer* outfb = &fb;
         Imath::Box2i dspWin = file.header(partNum).displayWindow();
         Imath::Box2i datWin = file.header(partNum).dataWindow();
+
+        //
+        //  If only a region and/or a lower level was requested read just
+        //  that. A region is returned like a data window (with the
+        //  uncrop set) so it lands in the right place on the display.
+        //
+
+        PartialRead partial;
+
+        {
+            set<int> parts;
+            for (int i = 0; i < channelsRead.size(); ++i)
+                parts.insert(channelsRead[i].partNumber);
+            partialReadWindows(file, parts, request, false, partial);
+        }
+
+        if (partial.active)
+        {
+            datWin = partial.dataWindow;
+            dspWin = partial.displayWindow;
+
+            if (partial.region)
+            {
+                window = IOexr::DataWindow;
+                readWindowIsDisplayWindow = false;
+            }
+        }
+
         Imath::Box2i unionWin;
         unionWin.extendBy(datWin);
         unionWin.extendBy(dspWin);
@@ -669,6 +698,20 @@ namespace TwkFB
             outfb->newAttribute("IOexr/ReadWindow", string(rw));
         }
 
+        if (partial.region)
+        {
+            ostringstream str;
+            str << datWin.min.x << " " << datWin.min.y << " " << datWin.max.x << " " << datWin.max.y;
+            outfb->newAttribute("IOexr/Region", str.str());
+        }
+
+        if (partial.levelX != 0 || partial.levelY != 0)
+        {
+            ostringstream str;
+            str << partial.levelX << " " << partial.levelY;
+            outfb->newAttribute("IOexr/Level", str.str());
+        }
+
         //
         //  Initialze unused pixels -- this could be optimized by
         //  carefully setting only the unused portions instead of the
@@ -829,13 +872,9 @@ namespace TwkFB
 #ifdef DEBUG_IOEXR
             LOG.log("Reading part %d into framebuffer %d... ", (*it), i);
 #endif
-            // From set of parts
-            Imf::InputPart inpart(file, (*it));
-            inpart.setFrameBuffer(exrFrameBuffer[*it]);
-
             try
             {
-                inpart.readPixels(datWin.min.y, datWin.max.y);
+                readPartPixels(file, *it, exrFrameBuffer[*it], partial, datWin);
             }
             catch (...)
             {
@@ -1026,7 +1065,7 @@ namespace TwkFB
 
     void IOexr::readImagesFromMultiPartFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                             const string& requestedView, const string& requestedLayer, const string& requestedChannel,
-                                            const bool requestedAllChannels) const
+                                            const bool requestedAllChannels, const ReadRequest& request) const
     {
 #ifdef DEBUG_IOEXR
         LOG.log("Reading multipart exr with %d parts.", file.parts());
@@ -1181,7 +1220,7 @@ namespace TwkFB
 
         readMultiPartChannelList(filename, requestedView, *fbs.back(), file, requestedMPChannelList, m_convertYRYBY, m_planar3channel,
                                  requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha, m_readWindowIsDisplayWindow,
-                                 m_readWindow);
+                                 m_readWindow, request);
 
         if (!requestedChannel.empty())
         {
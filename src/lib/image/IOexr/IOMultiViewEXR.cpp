@@ -53,11 +53,34 @@ namespace TwkFB
     void IOexr::readMultiViewChannelList(const std::string& filename, const std::string& layer, const std::string& view, FrameBuffer& fb,
                                          Imf::MultiPartInputFile& file, int partNum, Imf::ChannelList& cl, bool useRGBAReader,
                                          bool convertYRYBY, bool planar3channel, bool allChannels, bool inheritChannels,
-                                         bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window)
+                                         bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                         const ReadRequest& request)
     {
         FrameBuffer* outfb = &fb;
         Imath::Box2i dspWin = file.header(partNum).displayWindow();
         Imath::Box2i datWin = file.header(partNum).dataWindow();
+
+        //
+        //  Only the scanlines of a requested region are read here: the
+        //  RGBA reader (which may be picked below) can't read tiles or
+        //  levels so neither path does.
+        //
+
+        PartialRead partial;
+
+        {
+            set<int> parts;
+            parts.insert(partNum);
+            partialReadWindows(file, parts, request, true, partial);
+        }
+
+        if (partial.active)
+        {
+            datWin = partial.dataWindow;
+            dspWin = partial.displayWindow;
+            window = IOexr::DataWindow;
+            readWindowIsDisplayWindow = false;
+        }
         Imath::Box2i unionWin;
         unionWin.extendBy(datWin);
         unionWin.extendBy(dspWin);
@@ -491,6 +514,13 @@ namespace TwkFB
         outfb->newAttribute("ChannelsRead", stl_ext::wrap(cch));
         outfb->newAttribute("IOexr/ReadWindow", string(rw));
 
+        if (partial.region)
+        {
+            ostringstream str;
+            str << datWin.min.x << " " << datWin.min.y << " " << datWin.max.x << " " << datWin.max.y;
+            outfb->newAttribute("IOexr/Region", str.str());
+        }
+
         //
         //  Initialze unused pixels -- this could be optimized by
         //  carefully setting only the unused portions instead of the
@@ -733,7 +763,7 @@ namespace TwkFB
     void IOexr::readImagesFromMultiViewFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const string& filename,
                                             const string& requestedView, const string& requestedLayer, const string& requestedChannel,
                                             const bool requestedAllChannels, const int partNum, const ViewNames& views,
-                                            bool requestedViewIsDefaultView) const
+                                            bool requestedViewIsDefaultView, const ReadRequest& request) const
     {
 #ifdef DEBUG_IOEXR
         LOG.log("Reading multiview exr with views:");
@@ -819,7 +849,7 @@ namespace TwkFB
         {
             readMultiViewChannelList(filename, requestedLayer, requestedView, *fbs.back(), file, partNum, cl, m_rgbaOnly, m_convertYRYBY,
                                      m_planar3channel, requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha,
-                                     m_readWindowIsDisplayWindow, m_readWindow);
+                                     m_readWindowIsDisplayWindow, m_readWindow, request);
         }
         else
         {
@@ -839,7 +869,7 @@ namespace TwkFB
 
             readMultiViewChannelList(filename, requestedLayer, requestedView, *fbs.back(), file, partNum, ncl, m_rgbaOnly, m_convertYRYBY,
                                      m_planar3channel, requestedAllChannels, m_inheritChannels, m_noOneChannelPlanes, stripAlpha,
-                                     m_readWindowIsDisplayWindow, m_readWindow);
+                                     m_readWindowIsDisplayWindow, m_readWindow, request);
         }
 
         if (!requestedChannel.empty())
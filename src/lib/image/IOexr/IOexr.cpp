@@ -20,6 +20,8 @@
 #include <ImfTileDescriptionAttribute.h>
 #include <ImfMultiPartInputFile.h>
 #include <ImfInputPart.h>
+#include <ImfTiledInputPart.h>
+#include <ImfPartType.h>
 #include <ImfInputFile.h>
 #include <ImfRgbaFile.h>
 #include <ImfIntAttribute.h>
@@ -42,6 +44,7 @@
 #include <TwkFB/Exception.h>
 #include <TwkFB/Operations.h>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iterator>
 #include <sstream>
@@ -605,7 +608,8 @@ namespace TwkFB
         , m_readWindow(readWindow)
         , m_writeMethod(writeMethod)
     {
-        unsigned int cap = ImageRead | ImageWrite | BruteForceIO | PlanarRead | PlanarWrite | Float16Capable | Float32Capable;
+        unsigned int cap = ImageRead | ImageWrite | BruteForceIO | PlanarRead | PlanarWrite | Float16Capable | Float32Capable | CropRead
+                           | MultiResolution;
 
         StringPairVector codecs;
         codecs.push_back(StringPair("PIZ", "piz-based wavelet compression"));
@@ -1146,6 +1150,173 @@ namespace TwkFB
         }
     }
 
+    //
+    //  Floor division (the level windows are computed relative to the
+    //  data window origin which may be negative).
+    //
+
+    static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    void IOexr::partialReadWindows(Imf::MultiPartInputFile& file, const set<int>& parts, const ReadRequest& request, bool scanlinesOnly,
+                                   PartialRead& partial)
+    {
+        partial = PartialRead();
+
+        if (parts.empty() || (!request.hasRegion() && !request.hasLevel()))
+            return;
+
+        const int partNum = *parts.begin();
+        const Imf::Header& header = file.header(partNum);
+        const Imath::Box2i datWin = header.dataWindow();
+        const Imath::Box2i dspWin = header.displayWindow();
+
+        //
+        //  Only do this when all of the parts can be read the same way:
+        //  no deep data, no subsampled channels and the same data window
+        //  and tiling everywhere. Otherwise just read the whole thing.
+        //
+
+        for (set<int>::const_iterator i = parts.begin(); i != parts.end(); ++i)
+        {
+            const Imf::Header& h = file.header(*i);
+
+            if (h.hasType() && Imf::isDeepData(h.type()))
+                return;
+            if (h.dataWindow() != datWin || h.hasTileDescription() != header.hasTileDescription())
+                return;
+            if (h.hasTileDescription() && !(h.tileDescription() == header.tileDescription()))
+                return;
+
+            for (Imf::ChannelList::ConstIterator c = h.channels().begin(); c != h.channels().end(); ++c)
+            {
+                if (c.channel().xSampling != 1 || c.channel().ySampling != 1)
+                    return;
+            }
+        }
+
+        const bool tiled = header.hasTileDescription() && !scanlinesOnly;
+        int lx = 0;
+        int ly = 0;
+        Imath::Box2i levelWin = datWin;
+
+        if (tiled && header.tileDescription().mode != Imf::ONE_LEVEL)
+        {
+            lx = request.levelX;
+            ly = request.levelY;
+
+            if (lx == 0 && ly == 0 && request.resolution > 0.0f && request.resolution < 1.0f)
+            {
+                lx = ly = int(std::floor(std::log2(1.0 / request.resolution)));
+            }
+
+            Imf::TiledInputPart tpart(file, partNum);
+
+            if (header.tileDescription().mode == Imf::MIPMAP_LEVELS)
+            {
+                lx = ly = std::max(0, std::min(std::max(lx, ly), tpart.numLevels() - 1));
+            }
+            else
+            {
+                lx = std::max(0, std::min(lx, tpart.numXLevels() - 1));
+                ly = std::max(0, std::min(ly, tpart.numYLevels() - 1));
+            }
+
+            levelWin = tpart.dataWindowForLevel(lx, ly);
+        }
+
+        const int sx = 1 << lx;
+        const int sy = 1 << ly;
+
+        Imath::Box2i levelDspWin;
+        levelDspWin.min.x = datWin.min.x + floorDiv(dspWin.min.x - datWin.min.x, sx);
+        levelDspWin.min.y = datWin.min.y + floorDiv(dspWin.min.y - datWin.min.y, sy);
+        levelDspWin.max.x = datWin.min.x + floorDiv(dspWin.max.x - datWin.min.x, sx);
+        levelDspWin.max.y = datWin.min.y + floorDiv(dspWin.max.y - datWin.min.y, sy);
+
+        //
+        //  The region is relative to the display window origin in full
+        //  resolution pixels. Take it to the level and clip it to the
+        //  data window. If nothing is left the whole level is read.
+        //
+
+        Imath::Box2i regionWin = levelWin;
+        bool region = false;
+
+        if (request.hasRegion())
+        {
+            Imath::Box2i r;
+            r.min.x = std::max(levelWin.min.x, datWin.min.x + floorDiv(dspWin.min.x + request.x0 - datWin.min.x, sx));
+            r.min.y = std::max(levelWin.min.y, datWin.min.y + floorDiv(dspWin.min.y + request.y0 - datWin.min.y, sy));
+            r.max.x = std::min(levelWin.max.x, datWin.min.x + floorDiv(dspWin.min.x + request.x1 - datWin.min.x, sx));
+            r.max.y = std::min(levelWin.max.y, datWin.min.y + floorDiv(dspWin.min.y + request.y1 - datWin.min.y, sy));
+
+            if (r.min.x <= r.max.x && r.min.y <= r.max.y && r != levelWin)
+            {
+                region = true;
+
+                if (tiled)
+                {
+                    //
+                    //  readTiles() writes whole tiles so the buffer has
+                    //  to cover them.
+                    //
+
+                    const int tw = header.tileDescription().xSize;
+                    const int th = header.tileDescription().ySize;
+
+                    regionWin.min.x = levelWin.min.x + (r.min.x - levelWin.min.x) / tw * tw;
+                    regionWin.min.y = levelWin.min.y + (r.min.y - levelWin.min.y) / th * th;
+                    regionWin.max.x = std::min(levelWin.max.x, levelWin.min.x + ((r.max.x - levelWin.min.x) / tw + 1) * tw - 1);
+                    regionWin.max.y = std::min(levelWin.max.y, levelWin.min.y + ((r.max.y - levelWin.min.y) / th + 1) * th - 1);
+                }
+                else
+                {
+                    //
+                    //  Scanline files are read a whole line at a time
+                    //
+
+                    regionWin.min.y = r.min.y;
+                    regionWin.max.y = r.max.y;
+                    region = regionWin != levelWin;
+                }
+            }
+        }
+
+        if (!region && lx == 0 && ly == 0)
+            return;
+
+        partial.active = true;
+        partial.region = region;
+        partial.tiled = tiled;
+        partial.levelX = lx;
+        partial.levelY = ly;
+        partial.dataWindow = regionWin;
+        partial.displayWindow = levelDspWin;
+    }
+
+    void IOexr::readPartPixels(Imf::MultiPartInputFile& file, int partNum, const Imf::FrameBuffer& frameBuffer, const PartialRead& partial,
+                               const Imath::Box2i& datWin)
+    {
+        if (partial.active && partial.tiled)
+        {
+            Imf::TiledInputPart inpart(file, partNum);
+            inpart.setFrameBuffer(frameBuffer);
+
+            const Imath::Box2i levelWin = inpart.dataWindowForLevel(partial.levelX, partial.levelY);
+            const int tw = inpart.tileXSize();
+            const int th = inpart.tileYSize();
+
+            inpart.readTiles((datWin.min.x - levelWin.min.x) / tw, (datWin.max.x - levelWin.min.x) / tw, (datWin.min.y - levelWin.min.y) / th,
+                             (datWin.max.y - levelWin.min.y) / th, partial.levelX, partial.levelY);
+        }
+        else
+        {
+            Imf::InputPart inpart(file, partNum);
+            inpart.setFrameBuffer(frameBuffer);
+            inpart.readPixels(datWin.min.y, datWin.max.y);
+        }
+    }
+
     void IOexr::readImages(FrameBufferVector& fbs, const std::string& filename, const ReadRequest& request) const
     {
         if (m_iotype == StandardIO)
@@ -1218,7 +1389,8 @@ namespace TwkFB
             }
 
             // Implies read a MultiPart file
-            readImagesFromMultiPartFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels);
+            readImagesFromMultiPartFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels,
+                                        request);
         }
         else
         {
@@ -1252,7 +1424,7 @@ namespace TwkFB
             }
 
             readImagesFromMultiViewFile(file, fbs, filename, requestedView, requestedLayer, requestedChannel, request.allChannels, partNum,
-                                        views, (requestedView == defaultView));
+                                        views, (requestedView == defaultView), request);
         }
     }
 
@@ -118,12 +118,13 @@ namespace TwkFB
 
         void readImagesFromMultiPartFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                          const std::string& requestedView, const std::string& requestedLayer,
-                                         const std::string& requestedChannel, const bool requestedAllChannels) const;
+                                         const std::string& requestedChannel, const bool requestedAllChannels,
+                                         const ReadRequest& request) const;
 
         void readImagesFromMultiViewFile(Imf::MultiPartInputFile& file, FrameBufferVector& fbs, const std::string& filename,
                                          const std::string& requestedView, const std::string& requestedLayer,
                                          const std::string& requestedBaseChannel, const bool requestedAllChannels, const int partNum,
-                                         const ViewNames& views, bool requestedViewIsDefaultView) const;
+                                         const ViewNames& views, bool requestedViewIsDefaultView, const ReadRequest& request) const;
 
         void writeImagesToMultiPartFile(const ConstFrameBufferVector& fbs, const std::string& filename, const WriteRequest& request) const;
 
@@ -146,6 +147,40 @@ namespace TwkFB
             Imf::Channel channel;
         } MultiPartChannel;
 
+        //
+        //  The windows to read when the request asks for a region
+        //  and/or a mip/rip level. The data window is the part of the
+        //  (level) data window which will be read and the display window
+        //  is the display window scaled to the level. When tiled is true
+        //  the pixels are read with readTiles() at levelX, levelY.
+        //
+
+        struct PartialRead
+        {
+            PartialRead()
+                : active(false)
+                , region(false)
+                , tiled(false)
+                , levelX(0)
+                , levelY(0)
+            {
+            }
+
+            bool active;
+            bool region;
+            bool tiled;
+            int levelX;
+            int levelY;
+            Imath::Box2i dataWindow;
+            Imath::Box2i displayWindow;
+        };
+
+        static void partialReadWindows(Imf::MultiPartInputFile& file, const std::set<int>& parts, const ReadRequest& request,
+                                       bool scanlinesOnly, PartialRead& partial);
+
+        static void readPartPixels(Imf::MultiPartInputFile& file, int partNum, const Imf::FrameBuffer& frameBuffer,
+                                   const PartialRead& partial, const Imath::Box2i& datWin);
+
         static void addToMultiPartChannelList(std::vector<MultiPartChannel>& rcl, const int partNumber, const std::string& partName,
                                               const std::string& channelName, const Imf::Channel& channel);
 
@@ -221,7 +256,7 @@ namespace TwkFB
                                              FrameBuffer& fb, Imf::MultiPartInputFile& file, int partNum, Imf::ChannelList& cl,
                                              bool useRGBAReader, bool convertYRYBY, bool planar3channel, bool allChannels,
                                              bool inheritChannels, bool noOneChannelPlanes, bool stripAlpha, bool readWindowIsDisplayWindow,
-                                             IOexr::ReadWindow window);
+                                             IOexr::ReadWindow window, const ReadRequest& request);
 
         static void getBiggerFrameBufferAndEXRPixelType(const Imf::Channel& channel, FrameBuffer::DataType& fbDataType,
                                                         Imf::PixelType& exrPixelType);
@@ -229,7 +264,8 @@ namespace TwkFB
         static void readMultiPartChannelList(const std::string& filename, const std::string& view, FrameBuffer& fb,
                                              Imf::MultiPartInputFile& file, std::vector<MultiPartChannel>& channelsRead, bool convertYRYBY,
                                              bool planar3channel, bool allChannels, bool inheritChannels, bool noOneChannelPlanes,
-                                             bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window);
+                                             bool stripAlpha, bool readWindowIsDisplayWindow, IOexr::ReadWindow window,
+                                             const ReadRequest& request);
 
         static bool stripViewFromName(std::string& name, const std::string& view);
 
@@ -21,6 +21,9 @@
 #include <TwkMath/Color.h>
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <openjph/ojph_arg.h>
 #include <openjph/ojph_mem.h>
 #include <openjph/ojph_file.h>
@@ -48,7 +51,7 @@ namespace TwkFB
 
         StringPairVector codecs;
 
-        unsigned int cap = ImageRead;
+        unsigned int cap = ImageRead | CropRead | MultiResolution;
 
         addType("j2c", "J2C Image", cap, codecs);
     }
@@ -104,14 +107,24 @@ namespace TwkFB
         }
     }
 
-    void copyScanLine(ojph::codestream* codestream, ojph::ui32 width, ojph::ui32 channels, ojph::ui32 row, ojph::ui32 component,
-                      FrameBuffer::DataType dtype, int bit_offset, FrameBuffer* fb)
+    void copyScanLine(ojph::codestream* codestream, ojph::ui32 x0, ojph::ui32 width, ojph::ui32 channels, ojph::ui32 row,
+                      ojph::ui32 component, FrameBuffer::DataType dtype, int bit_offset, FrameBuffer* fb)
     {
 
         ojph::ui32 comp_num;
         ojph::line_buf* line = codestream->pull(comp_num);
-        const ojph::si32* sp = line->i32;
         assert(comp_num == component);
+
+        //
+        //  The line has to be pulled either way; rows outside the region
+        //  aren't copied.
+        //
+
+        if (!fb)
+            return;
+
+        const ojph::si32* sp = line->i32 + x0;
+
         if (dtype == FrameBuffer::UCHAR)
         {
             unsigned char* dout = fb->scanline<unsigned char>(row);
@@ -133,7 +146,7 @@ namespace TwkFB
         }
     }
 
-    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb)
+    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb, const FrameBufferIO::ReadRequest* request)
     {
         ojph::codestream codestream;
         codestream.read_headers(infile);
@@ -141,6 +154,32 @@ namespace TwkFB
         // codestream.enable_resilience();
         ojph::param_siz siz = codestream.access_siz();
         ojph::param_nlt nlt = codestream.access_nlt();
+
+        //
+        //  A reduced resolution is decoded by skipping the highest
+        //  resolution levels of the wavelet decomposition: their
+        //  codeblocks aren't read or decoded at all. Each level skipped
+        //  halves the width and height.
+        //
+
+        int skip = 0;
+
+        if (request)
+        {
+            if (request->levelX != 0 || request->levelY != 0)
+            {
+                skip = std::max(request->levelX, request->levelY);
+            }
+            else if (request->resolution > 0.0f && request->resolution < 1.0f)
+            {
+                skip = int(std::floor(std::log2(1.0 / request->resolution)));
+            }
+
+            skip = std::max(0, std::min(skip, int(codestream.access_cod().get_num_decompositions())));
+            if (skip > 0)
+                codestream.restrict_input_resolution(skip, skip);
+        }
+
         codestream.create();
 
         int bit_offset = 0;
@@ -160,6 +199,39 @@ namespace TwkFB
         if (has_nlt)
             TWK_THROW_STREAM(UnsupportedException, "HTJ2K: unsupported notlinear transform in jpeg2000 image");
 
+        //
+        //  The region is in full resolution pixels from the top left;
+        //  take it to the decoded level and clip it. OpenJPH can only
+        //  produce whole lines from the top down, so the region saves
+        //  decoding the lines below it (when the codestream isn't planar)
+        //  and copying everything outside it.
+        //
+
+        int rx0 = 0;
+        int ry0 = 0;
+        int rx1 = w - 1;
+        int ry1 = h - 1;
+
+        if (request && request->hasRegion())
+        {
+            const int x0 = std::max(0, request->x0 >> skip);
+            const int y0 = std::max(0, request->y0 >> skip);
+            const int x1 = std::min(w - 1, request->x1 >> skip);
+            const int y1 = std::min(h - 1, request->y1 >> skip);
+
+            if (x0 <= x1 && y0 <= y1)
+            {
+                rx0 = x0;
+                ry0 = y0;
+                rx1 = x1;
+                ry1 = y1;
+            }
+        }
+
+        const int rw = rx1 - rx0 + 1;
+        const int rh = ry1 - ry0 + 1;
+        const bool region = rw != w || rh != h;
+
         // 4. Wrap the decoded image in a FrameBuffer
         FrameBuffer::DataType dtype = FrameBuffer::USHORT;
 
@@ -183,13 +255,13 @@ namespace TwkFB
         {
             // If no FrameBuffer is provided, create a new one
             // Typically used when called from MovieFFMpeg
-            fb = new FrameBuffer(w, h, ch, dtype);
+            fb = new FrameBuffer(rw, rh, ch, dtype);
             fb->setOrientation(FrameBuffer::BOTTOMLEFT);
         }
         else
         {
             // If a FrameBuffer is provided, restructure it
-            fb->restructure(w, h, 0, ch, dtype);
+            fb->restructure(rw, rh, 0, ch, dtype);
             // I dont really understand why its TOPLEFT here, but BOTTOMLEFT for MovieFFMPEG
             // when the underlying data is the same.
             // I suspect it has to do with the way the FrameBuffer is used in MovieFFMPEG
@@ -197,18 +269,38 @@ namespace TwkFB
             fb->setOrientation(FrameBuffer::TOPLEFT);
         }
         fb->newAttribute("fileBitDepth", siz.get_bit_depth(0));
+
+        if (region)
+        {
+            const int uy = fb->orientation() == FrameBuffer::TOPLEFT ? ry0 : h - 1 - ry1;
+            fb->setUncrop(w, h, rx0, uy);
+
+            ostringstream str;
+            str << rx0 << " " << ry0 << " " << rx1 << " " << ry1;
+            fb->newAttribute("IOhtj2k/Region", str.str());
+        }
+
+        if (skip > 0)
+            fb->newAttribute("IOhtj2k/SkippedResolutions", skip);
+
         if (codestream.is_planar())
         {
             // Its pretty rare for RGB to be planar, possibily the most common case is a single channel image
             for (ojph::ui32 c = 0; c < siz.get_num_components(); ++c)
-                for (ojph::ui32 i = 0; i < h; ++i)
-                    copyScanLine(&codestream, w, ch, i, c, dtype, bit_offset, fb);
+                for (int i = 0; i < h; ++i)
+                {
+                    const bool inside = i >= ry0 && i <= ry1;
+                    copyScanLine(&codestream, rx0, rw, ch, i - ry0, c, dtype, bit_offset, inside ? fb : NULL);
+                }
         }
         else
         {
-            for (ojph::ui32 i = 0; i < h; ++i)
+            for (int i = 0; i <= ry1; ++i)
                 for (ojph::ui32 c = 0; c < siz.get_num_components(); ++c)
-                    copyScanLine(&codestream, w, ch, i, c, dtype, bit_offset, fb);
+                {
+                    const bool inside = i >= ry0;
+                    copyScanLine(&codestream, rx0, rw, ch, i - ry0, c, dtype, bit_offset, inside ? fb : NULL);
+                }
         }
 
         return fb;
@@ -222,7 +314,7 @@ namespace TwkFB
         ojph::j2c_infile j2c_file;
         j2c_file.open(filename.c_str());
 
-        decodeHTJ2K(&j2c_file, &fb);
+        decodeHTJ2K(&j2c_file, &fb, &request);
     }
 
 } // namespace TwkFB
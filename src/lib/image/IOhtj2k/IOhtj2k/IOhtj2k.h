@@ -35,8 +35,11 @@ namespace TwkFB
     /// @brief Decode a HTJ2K file into a FrameBuffer
     /// @param infile ojph::infile_base object that provides the input stream
     /// @param fb if non-NULL, decode into this FrameBuffer, otherwise create a new one
+    /// @param request if non-NULL, its level (or resolution) selects how many
+    ///        resolution levels to skip and its region which part of the image to
+    ///        return; a region comes back with the uncrop set
     /// @return fb
-    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb = NULL);
+    FrameBuffer* decodeHTJ2K(ojph::infile_base* infile, FrameBuffer* fb = NULL, const FrameBufferIO::ReadRequest* request = NULL);
 
 } // namespace TwkFB
 
@@ -14,10 +14,16 @@
 #include <TwkMath/Mat44.h>
 #include <TwkMath/Iostream.h>
 #include <TwkFB/Operations.h>
+#include <TwkFB/TwkFBThreadPool.h>
 #include <TwkUtil/FileStream.h>
 #include <TwkUtil/File.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
+#include <sstream>
+#include <vector>
 
 #if TIFFLIB_VERSION >= 20031226
 #define HAS_TIFFFIELDWITHTAG 1
@@ -177,8 +183,8 @@ namespace TwkFB
         TIFFSetWarningHandler(0);
 
         unsigned int types = Int8Capable | Int16Capable | Float32Capable | PlanarRead /*| PlanarWrite*/;
-        unsigned int capio = ImageRead | ImageWrite | BruteForceIO | types;
-        unsigned int capi = ImageRead | types | BruteForceIO;
+        unsigned int capio = ImageRead | ImageWrite | BruteForceIO | CropRead | MultiResolution | types;
+        unsigned int capi = ImageRead | types | BruteForceIO | CropRead | MultiResolution;
 
         StringPairVector codecs;
         codecs.push_back(StringPair("NONE", "No compression"));
@@ -562,8 +568,6 @@ namespace TwkFB
                 float* fbBuf = img.scanline<float>(flipY);
 
                 storeIntAsNormalizedFloatSamples(bitsPerSample, rowsize, buf, fbBuf);
-
-                memcpy(fbBuf, buf, rowsize);
             }
             else
             {
@@ -631,8 +635,6 @@ namespace TwkFB
                 float* fbBuf = img.scanline<float>(flipY);
 
                 storeIntAsNormalizedFloatSamples(bitsPerSample, rowsize, buf, fbBuf);
-
-                memcpy(fbBuf, buf, rowsize);
             }
             else
             {
@@ -921,8 +923,6 @@ namespace TwkFB
                     float* fbBuf = &fb->pixel<float>(0, flipY);
 
                     storeIntAsNormalizedFloatSamples(bitsPerSample, rowsize, buf, fbBuf);
-
-                    memcpy(fbBuf, buf, rowsize);
                 }
                 else
                 {
@@ -1108,6 +1108,555 @@ namespace TwkFB
         }
     }
 
+    //
+    //  A read position in a FileStream's buffer. Each libtiff handle
+    //  opened on the stream needs its own.
+    //
+
+    struct StreamView
+    {
+        StreamView(char* d = 0, size_t n = 0)
+            : data(d)
+            , size(n)
+            , pos(d)
+        {
+        }
+
+        char* data;
+        size_t size;
+        char* pos;
+    };
+
+    struct StreamData
+    {
+        StreamData(const std::string& filename, FileStream::Type type = FileStream::Buffering, size_t chunkSize = 61440,
+                   int maxInFlight = 16)
+            : stream(filename, type, chunkSize, maxInFlight)
+        {
+            view = StreamView((char*)stream.data(), stream.size());
+        }
+
+        FileStream stream;
+        StreamView view;
+    };
+
+    static tsize_t readproc(thandle_t userdata, tdata_t data, tsize_t size)
+    {
+        StreamView* view = (StreamView*)userdata;
+        memcpy(data, view->pos, size);
+        view->pos += size;
+        return size;
+    }
+
+    static tsize_t writeproc(thandle_t userdata, tdata_t data, tsize_t size)
+    {
+        // dummy -- we don't write using FileStream
+        return size;
+    }
+
+    static toff_t seekproc(thandle_t userdata, toff_t offset, int whence)
+    {
+        StreamView* view = (StreamView*)userdata;
+        switch (whence)
+        {
+        case SEEK_SET:
+            view->pos = view->data;
+            view->pos += offset;
+            break;
+        case SEEK_CUR:
+            view->pos += offset;
+            break;
+        case SEEK_END:
+            view->pos = view->data;
+            view->pos += (offset + toff_t(view->size));
+            break;
+        }
+
+        return toff_t(view->pos - view->data);
+    }
+
+    static int closeproc(thandle_t userdata) { return 0; }
+
+    static toff_t sizeproc(thandle_t userdata)
+    {
+        StreamView* view = (StreamView*)userdata;
+        return toff_t(view->size);
+    }
+
+    //
+    //  Where a file being read came from: either its name, or the
+    //  FileStream it was read into. openTIFF() opens another handle on
+    //  it, positioned on the same directory. With a stream the handle
+    //  reads through view, which has to outlive it.
+    //
+
+    struct TIFFSource
+    {
+        TIFFSource(const string& f, StreamData* s)
+            : filename(f)
+            , stream(s)
+            , directory(0)
+        {
+        }
+
+        string filename;
+        StreamData* stream;
+        tdir_t directory;
+    };
+
+    static TIFF* openTIFF(const TIFFSource& source, StreamView* view)
+    {
+        TIFF* tif = NULL;
+
+        if (!source.stream)
+        {
+#ifdef _MSC_VER
+            tif = TIFFOpenW(UNICODE_C_STR(source.filename.c_str()), "r");
+#else
+            tif = TIFFOpen(UNICODE_C_STR(source.filename.c_str()), "r");
+#endif
+        }
+        else
+        {
+            *view = StreamView(source.stream->view.data, source.stream->view.size);
+            tif = TIFFClientOpen(source.filename.c_str(), "r", (thandle_t)view, readproc, writeproc, seekproc, closeproc, sizeproc,
+                                 NULL, NULL);
+        }
+
+        if (tif && source.directory != 0 && !TIFFSetDirectory(tif, source.directory))
+        {
+            TIFFClose(tif);
+            tif = NULL;
+        }
+
+        return tif;
+    }
+
+    //
+    //  Pyramidal (mip mapped) TIFFs store the reduced resolutions as the
+    //  directories following the full resolution image, each one smaller
+    //  than the last. Finds the requested level (or the smallest there
+    //  is), leaves tif on it and returns its directory. level is set to
+    //  the level found and fullWidth/fullHeight to the size of level 0.
+    //
+
+    static tdir_t selectLevel(TIFF* tif, const FrameBufferIO::ReadRequest& request, int& level, uint32& fullWidth, uint32& fullHeight)
+    {
+        uint32 w = 0;
+        uint32 h = 0;
+        unsigned short spp = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
+        unsigned short bps = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+        TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+        TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+
+        fullWidth = w;
+        fullHeight = h;
+        level = 0;
+
+        int want = 0;
+
+        if (request.levelX != 0 || request.levelY != 0)
+        {
+            want = max(request.levelX, request.levelY);
+        }
+        else if (request.resolution > 0.0f && request.resolution < 1.0f)
+        {
+            want = int(floor(log2(1.0 / request.resolution)));
+        }
+
+        if (want <= 0)
+            return TIFFCurrentDirectory(tif);
+
+        const tdir_t first = TIFFCurrentDirectory(tif);
+        tdir_t dir = first;
+
+        while (level < want && TIFFReadDirectory(tif))
+        {
+            uint32 lw = 0;
+            uint32 lh = 0;
+            uint32 subfileType = 0;
+            unsigned short lspp = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
+            unsigned short lbps = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
+            TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &lw);
+            TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &lh);
+            TIFFGetField(tif, TIFFTAG_SUBFILETYPE, &subfileType);
+            TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &lspp);
+            TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &lbps);
+
+            if ((subfileType & FILETYPE_PAGE) || lw == 0 || lh == 0 || lw >= w || lh >= h || lspp != spp || lbps != bps)
+            {
+                break;
+            }
+
+            w = lw;
+            h = lh;
+            level++;
+            dir = TIFFCurrentDirectory(tif);
+        }
+
+        if (TIFFCurrentDirectory(tif) != dir)
+            TIFFSetDirectory(tif, dir);
+        return dir;
+    }
+
+    //
+    //  Block reading
+    //
+    //  Strips and tiles are compressed independently of each other, so
+    //  they can be decoded at the same time. A libtiff handle can only
+    //  decode one at a time though, so each worker opens its own handle
+    //  on the file and takes blocks from a shared list until there are
+    //  none left. Strips are decoded straight into the FrameBuffer rows
+    //  when the layouts match; otherwise a block is decoded into the
+    //  worker's buffer and the part of it inside the region is copied
+    //  over. Only the blocks which overlap the region are decoded.
+    //
+
+    struct BlockLayout
+    {
+        bool tiled;
+        bool separate;     // one plane per sample in the file
+        bool deinterleave; // contiguous samples into a planar FrameBuffer
+        int samplesPerPixel;
+        int bytesPerSample;
+        int planes;
+        uint32 width;  // of the directory being read
+        uint32 height; //
+        uint32 blockWidth;
+        uint32 blockHeight;
+        uint32 blocksAcross;
+        uint32 blocksPerPlane;
+        int x0; // region in file pixels (inclusive)
+        int y0;
+        int x1;
+        int y1;
+        vector<uint32> blocks;
+        std::atomic<size_t> next;
+        std::atomic<bool> failed;
+    };
+
+    //
+    //  Whether the samples of the directory tif is on can be copied to
+    //  a FrameBuffer as they are. Signed samples are normalized to float
+    //  by the row readers and 1 bit samples aren't expanded; those are
+    //  left to them. (Files which need converting to RGBA have already
+    //  been weeded out.)
+    //
+
+    static bool canReadBlocks(TIFF* tif)
+    {
+        uint32 w = 0;
+        uint32 h = 0;
+        unsigned short spp = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
+        unsigned short bps = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
+        unsigned short sampleFormat = DEFAULT_TIFFTAG_SAMPLEFORMAT_VALUE;
+        uint16 config = PLANARCONFIG_CONTIG;
+
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+        TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+        TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+        TIFFGetField(tif, TIFFTAG_SAMPLEFORMAT, &sampleFormat);
+        TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &config);
+
+        return w != 0 && h != 0 && sampleFormat != SAMPLEFORMAT_INT && (bps == 8 || bps == 16 || bps == 32)
+               && (config == PLANARCONFIG_SEPARATE || spp <= 4);
+    }
+
+    //
+    //  Fills in layout for reading the directory tif is on in blocks,
+    //  or returns false if it can't be. The region, if any, is in full
+    //  resolution pixels from the top left; it's clipped and taken to
+    //  the file's pixels.
+    //
+
+    static bool initBlockLayout(TIFF* tif, const FrameBufferIO::ReadRequest& request, uint32 fullWidth, uint32 fullHeight,
+                                FrameBuffer::DataType dataType, BlockLayout& layout)
+    {
+        if (!canReadBlocks(tif))
+            return false;
+
+        uint32 w = 0;
+        uint32 h = 0;
+        unsigned short spp = DEFAULT_TIFFTAG_SAMPLESPERPIXEL_VALUE;
+        unsigned short bps = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
+        unsigned short orient = ORIENTATION_TOPLEFT;
+        uint16 config = PLANARCONFIG_CONTIG;
+
+        TIFFGetField(tif, TIFFTAG_IMAGEWIDTH, &w);
+        TIFFGetField(tif, TIFFTAG_IMAGELENGTH, &h);
+        TIFFGetField(tif, TIFFTAG_SAMPLESPERPIXEL, &spp);
+        TIFFGetField(tif, TIFFTAG_BITSPERSAMPLE, &bps);
+        TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+        TIFFGetField(tif, TIFFTAG_PLANARCONFIG, &config);
+
+        layout.tiled = TIFFIsTiled(tif) != 0;
+        layout.separate = config == PLANARCONFIG_SEPARATE;
+        layout.samplesPerPixel = spp;
+        layout.bytesPerSample = bps / 8;
+        layout.width = w;
+        layout.height = h;
+
+        //
+        //  Same as the scanline reader: interleaved 16 bit RGB(A) goes
+        //  into planes
+        //
+
+        layout.deinterleave = !layout.tiled && !layout.separate && spp > 1 && dataType == FrameBuffer::USHORT;
+        layout.planes = layout.separate ? min(int(spp), 10) : 1;
+
+        if (layout.tiled)
+        {
+            uint32 tw = 0;
+            uint32 th = 0;
+            TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tw);
+            TIFFGetField(tif, TIFFTAG_TILELENGTH, &th);
+
+            if (tw == 0 || th == 0)
+                return false;
+
+            layout.blockWidth = tw;
+            layout.blockHeight = th;
+        }
+        else
+        {
+            uint32 rowsPerStrip = h;
+            TIFFGetField(tif, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+
+            layout.blockWidth = w;
+            layout.blockHeight = rowsPerStrip == 0 ? h : min(rowsPerStrip, h);
+        }
+
+        layout.blocksAcross = (w + layout.blockWidth - 1) / layout.blockWidth;
+        const uint32 blocksDown = (h + layout.blockHeight - 1) / layout.blockHeight;
+        layout.blocksPerPlane = layout.blocksAcross * blocksDown;
+
+        const uint32 numBlocks = layout.tiled ? TIFFNumberOfTiles(tif) : TIFFNumberOfStrips(tif);
+
+        if (numBlocks != layout.blocksPerPlane * (layout.separate ? spp : 1))
+            return false;
+
+        //
+        //  The region is from the top left of the full resolution image.
+        //  Bottom up files are read as they are (the FrameBuffer is
+        //  NATURAL) so their rows are counted from the bottom. Right to
+        //  left files are always read whole.
+        //
+
+        layout.x0 = 0;
+        layout.y0 = 0;
+        layout.x1 = w - 1;
+        layout.y1 = h - 1;
+
+        const bool flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
+        const bool flop = orient == ORIENTATION_TOPRIGHT || orient == ORIENTATION_BOTRIGHT;
+
+        if (request.hasRegion() && !flop && fullWidth && fullHeight)
+        {
+            //
+            //  Round outwards so a reduced level still covers all of it
+            //
+
+            const int64_t x0 = int64_t(max(0, request.x0)) * w / fullWidth;
+            const int64_t y0 = int64_t(max(0, request.y0)) * h / fullHeight;
+            const int64_t x1 = (int64_t(request.x1 + 1) * w + fullWidth - 1) / fullWidth - 1;
+            const int64_t y1 = (int64_t(request.y1 + 1) * h + fullHeight - 1) / fullHeight - 1;
+
+            const int rx0 = int(min(x0, int64_t(w - 1)));
+            const int ry0 = int(min(y0, int64_t(h - 1)));
+            const int rx1 = int(min(x1, int64_t(w - 1)));
+            const int ry1 = int(min(y1, int64_t(h - 1)));
+
+            if (rx0 <= rx1 && ry0 <= ry1)
+            {
+                layout.x0 = rx0;
+                layout.x1 = rx1;
+                layout.y0 = flip ? ry0 : h - 1 - ry1;
+                layout.y1 = flip ? ry1 : h - 1 - ry0;
+            }
+        }
+
+        const uint32 bx0 = layout.x0 / layout.blockWidth;
+        const uint32 bx1 = layout.x1 / layout.blockWidth;
+        const uint32 by0 = layout.y0 / layout.blockHeight;
+        const uint32 by1 = layout.y1 / layout.blockHeight;
+
+        layout.blocks.clear();
+
+        for (int p = 0; p < layout.planes; p++)
+        {
+            for (uint32 by = by0; by <= by1; by++)
+            {
+                for (uint32 bx = bx0; bx <= bx1; bx++)
+                {
+                    layout.blocks.push_back(p * layout.blocksPerPlane + by * layout.blocksAcross + bx);
+                }
+            }
+        }
+
+        layout.next = 0;
+        layout.failed = false;
+
+        return true;
+    }
+
+    static void copyBlockRow(const BlockLayout& layout, const unsigned char* src, int n, FrameBuffer* fb, int plane, int x, int y)
+    {
+        if (layout.separate)
+        {
+            for (int p = 0; p < plane && fb; p++)
+                fb = fb->nextPlane();
+
+            if (fb)
+                memcpy(&fb->pixel<unsigned char>(x, y), src, size_t(n) * layout.bytesPerSample);
+        }
+        else if (layout.deinterleave)
+        {
+            const int spp = layout.samplesPerPixel;
+
+            for (int c = 0; c < spp && fb; c++, fb = fb->nextPlane())
+            {
+                switch (layout.bytesPerSample)
+                {
+                case 1:
+                    copyScanlineSamples(src + c, &fb->pixel<unsigned char>(x, y), n, 1, spp - 1);
+                    break;
+                case 2:
+                    copyScanlineSamples((const unsigned short*)src + c, &fb->pixel<unsigned short>(x, y), n, 1, spp - 1);
+                    break;
+                case 4:
+                    copyScanlineSamples((const uint32*)src + c, &fb->pixel<uint32>(x, y), n, 1, spp - 1);
+                    break;
+                }
+            }
+        }
+        else
+        {
+            memcpy(&fb->pixel<unsigned char>(x, y), src, size_t(n) * layout.bytesPerSample * layout.samplesPerPixel);
+        }
+    }
+
+    static void decodeBlocks(TIFF* tif, BlockLayout& layout, FrameBuffer& fb)
+    {
+        const size_t pixelBytes = size_t(layout.bytesPerSample) * (layout.separate ? 1 : layout.samplesPerPixel);
+        const size_t blockRowBytes = pixelBytes * layout.blockWidth;
+        const tmsize_t blockSize = layout.tiled ? TIFFTileSize(tif) : TIFFStripSize(tif);
+        vector<unsigned char> buffer;
+
+        for (size_t i; (i = layout.next++) < layout.blocks.size();)
+        {
+            const uint32 block = layout.blocks[i];
+            const int plane = block / layout.blocksPerPlane;
+            const uint32 index = block % layout.blocksPerPlane;
+            const int bx = (index % layout.blocksAcross) * layout.blockWidth;
+            const int by = (index / layout.blocksAcross) * layout.blockHeight;
+            const int bh = min(layout.blockHeight, layout.height - by);
+
+            const int r0 = max(by, layout.y0);
+            const int r1 = min(by + bh - 1, layout.y1);
+            const int c0 = max(bx, layout.x0);
+            const int c1 = min(bx + int(layout.blockWidth) - 1, layout.x1);
+
+            //
+            //  A whole strip of a whole width region goes straight into
+            //  the FrameBuffer if its rows are laid out the same
+            //
+
+            FrameBuffer* dest = &fb;
+
+            for (int p = 0; layout.separate && p < plane && dest; p++)
+                dest = dest->nextPlane();
+
+            if (!dest)
+                continue;
+
+            if (!layout.tiled && !layout.deinterleave && r0 == by && r1 == by + bh - 1 && layout.x0 == 0 && layout.x1 == int(layout.width) - 1
+                && dest->scanlinePaddedSize() == blockRowBytes)
+            {
+                if (TIFFReadEncodedStrip(tif, block, dest->scanline<unsigned char>(by - layout.y0), tmsize_t(bh) * blockRowBytes) < 0)
+                {
+                    layout.failed = true;
+                }
+
+                continue;
+            }
+
+            if (buffer.empty())
+                buffer.resize(blockSize);
+
+            const tmsize_t n = layout.tiled ? TIFFReadEncodedTile(tif, block, &buffer.front(), blockSize)
+                                            : TIFFReadEncodedStrip(tif, block, &buffer.front(), blockSize);
+
+            if (n < 0)
+            {
+                layout.failed = true;
+                continue;
+            }
+
+            for (int y = r0; y <= r1; y++)
+            {
+                const unsigned char* src = &buffer[(y - by) * blockRowBytes + (c0 - bx) * pixelBytes];
+                copyBlockRow(layout, src, c1 - c0 + 1, &fb, plane, c0 - layout.x0, y - layout.y0);
+            }
+        }
+    }
+
+    class DecodeBlocksTask : public ILMTHREAD_NAMESPACE::Task
+    {
+    public:
+        DecodeBlocksTask(ILMTHREAD_NAMESPACE::TaskGroup* group, const TIFFSource& source, BlockLayout& layout, FrameBuffer& fb)
+            : Task(group)
+            , m_source(source)
+            , m_layout(layout)
+            , m_fb(fb)
+        {
+        }
+
+        virtual ~DecodeBlocksTask() {}
+
+        //
+        //  If the file can't be opened again the blocks are left to the
+        //  other workers.
+        //
+
+        virtual void execute()
+        {
+            StreamView view;
+
+            if (TIFF* tif = openTIFF(m_source, &view))
+            {
+                decodeBlocks(tif, m_layout, m_fb);
+                TIFFClose(tif);
+            }
+        }
+
+    private:
+        const TIFFSource& m_source;
+        BlockLayout& m_layout;
+        FrameBuffer& m_fb;
+    };
+
+    static void readBlocks(TIFF* tif, const TIFFSource& source, BlockLayout& layout, FrameBuffer& fb)
+    {
+        const size_t workers = layout.blocks.size() > 1 ? min(ThreadPool::getNumThreads(), layout.blocks.size() - 1) : 0;
+
+        ILMTHREAD_NAMESPACE::TaskGroup group;
+
+        for (size_t i = 0; i < workers; i++)
+        {
+            ThreadPool::addTask(new DecodeBlocksTask(&group, source, layout, fb));
+        }
+
+        //
+        //  This thread decodes too, with the handle it already has. The
+        //  group waits for the workers when it goes out of scope.
+        //
+
+        decodeBlocks(tif, layout, fb);
+    }
+
     void IOtiff::getImageInfo(const std::string& filename, FBInfo& fbi) const
     {
 #ifdef _MSC_VER
@@ -1232,6 +1781,7 @@ namespace TwkFB
         }
 
         bool readAsRGBA = false;
+        BlockLayout layout;
 
         if ((colorspace != PHOTOMETRIC_RGB && colorspace != PHOTOMETRIC_MINISBLACK && colorspace != PHOTOMETRIC_MINISWHITE)
             || (m_addAlphaTo3Channel && samplesPerPixel == 3) || (config == PLANARCONFIG_CONTIG && samplesPerPixel > 4))
@@ -1244,10 +1794,14 @@ namespace TwkFB
             // TIFFReadRGBAImage(tif, width, height, p, 0);
             fbi.orientation = FrameBuffer::NATURAL;
         }
-        else if (TIFFIsTiled(tif))
+        else if (TIFFIsTiled(tif) || initBlockLayout(tif, ReadRequest(), fbi.width, fbi.height, fbi.dataType, layout))
         {
             // readContiguousTiledImage(tif, width, height, fb);
             //  or readPlanarTiledImage(tif, width, height, fb);
+            //  or readBlocks(tif, source, layout, fb);
+            //
+            //  Same test as readImage(): scanline files it can't read
+            //  in blocks go through the scanline readers below.
             bool flip = false;
             bool flop = false;
             flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
@@ -1269,64 +1823,6 @@ namespace TwkFB
         TIFFClose(tif);
     }
 
-    struct StreamData
-    {
-        StreamData(const std::string& filename, FileStream::Type type = FileStream::Buffering, size_t chunkSize = 61440,
-                   int maxInFlight = 16)
-            : stream(filename, type, chunkSize, maxInFlight)
-            , pos(0)
-        {
-            pos = (char*)stream.data();
-        }
-
-        FileStream stream;
-        char* pos;
-    };
-
-    static tsize_t readproc(thandle_t userdata, tdata_t data, tsize_t size)
-    {
-        StreamData* stream = (StreamData*)userdata;
-        memcpy(data, stream->pos, size);
-        stream->pos += size;
-        return size;
-    }
-
-    static tsize_t writeproc(thandle_t userdata, tdata_t data, tsize_t size)
-    {
-        StreamData* stream = (StreamData*)userdata;
-        // dummy -- we don't write using FileStream
-        return size;
-    }
-
-    static toff_t seekproc(thandle_t userdata, toff_t offset, int whence)
-    {
-        StreamData* stream = (StreamData*)userdata;
-        switch (whence)
-        {
-        case SEEK_SET:
-            stream->pos = (char*)stream->stream.data();
-            stream->pos += offset;
-            break;
-        case SEEK_CUR:
-            stream->pos += offset;
-            break;
-        case SEEK_END:
-            stream->pos = (char*)stream->stream.data();
-            stream->pos += (offset + toff_t(stream->stream.size()));
-            break;
-        }
-
-        return toff_t(stream->pos - (char*)(stream->stream.data()));
-    }
-
-    static int closeproc(thandle_t userdata) { return 0; }
-
-    static toff_t sizeproc(thandle_t userdata)
-    {
-        StreamData* stream = (StreamData*)userdata;
-        return toff_t(stream->stream.size());
-    }
-
     void IOtiff::readImage(FrameBuffer& fb, const std::string& filename, const ReadRequest& request) const
     {
         TIFF* tif = NULL;
@@ -1334,27 +1830,25 @@ namespace TwkFB
 
         try
         {
-            if (m_iotype == StandardIO)
-            {
-#ifdef _MSC_VER
-                tif = TIFFOpenW(UNICODE_C_STR(filename.c_str()), "r");
-#else
-                tif = TIFFOpen(UNICODE_C_STR(filename.c_str()), "r");
-#endif
-            }
-            else
+            if (m_iotype != StandardIO)
             {
                 stream = new StreamData(filename, (FileStream::Type)((unsigned int)m_iotype - 1), m_iosize, m_iomaxAsync);
-
-                tif = TIFFClientOpen(filename.c_str(), "r", (thandle_t)stream, readproc, writeproc, seekproc, closeproc, sizeproc, NULL,
-                                     NULL);
             }
 
+            TIFFSource source(filename, stream);
+            StreamView view;
+            tif = openTIFF(source, &view);
+
             if (!tif)
             {
                 TWK_THROW_STREAM(Exception, "TIFF: cannot open \"" << filename << "\"");
             }
 
+            int level = 0;
+            uint32 fullWidth = 0;
+            uint32 fullHeight = 0;
+            source.directory = selectLevel(tif, request, level, fullWidth, fullHeight);
+
             int width;
             int height;
             unsigned short bitsPerSample = DEFAULT_TIFFTAG_BITSPERSAMPLE_VALUE;
@@ -1453,7 +1947,18 @@ namespace TwkFB
                 TWK_THROW_STREAM(UnsupportedException, "TIFF: Unsupported bit depth (" << bitsPerSample << ") trying to read " << filename);
             }
 
-            if (config == PLANARCONFIG_SEPARATE)
+            //
+            //  Strips and tiles are decoded in parallel when the samples
+            //  can go into the FrameBuffer as they are. That's also the
+            //  only way a region is read.
+            //
+
+            BlockLayout layout;
+            const bool blocks = !readAsRGBA && initBlockLayout(tif, request, fullWidth, fullHeight, dataType, layout);
+            const int fbWidth = blocks ? layout.x1 - layout.x0 + 1 : width;
+            const int fbHeight = blocks ? layout.y1 - layout.y0 + 1 : height;
+
+            if (config == PLANARCONFIG_SEPARATE || (blocks && layout.deinterleave))
             {
                 const char* chanNames[] = {"R", "G", "B", "A", "Z", "X", "Y", "P", "D", "Q"};
 
@@ -1464,11 +1969,11 @@ namespace TwkFB
                     planeNames.push_back(string(chanNames[i]));
                 }
 
-                fb.restructurePlanar(width, height, planeNames, dataType, FrameBuffer::NATURAL);
+                fb.restructurePlanar(fbWidth, fbHeight, planeNames, dataType, FrameBuffer::NATURAL);
             }
             else
             {
-                fb.restructure(width, height, 0, min((int)samplesPerPixel, 4),
+                fb.restructure(fbWidth, fbHeight, 0, min((int)samplesPerPixel, 4),
                                dataType); // interleaved, we can only do 4 channels
             }
 
@@ -1489,6 +1994,43 @@ namespace TwkFB
                 }
 #endif
             }
+            else if (blocks)
+            {
+                readBlocks(tif, source, layout, fb);
+
+                //
+                //  The rows are in file order; same orientations as the
+                //  tiled readers
+                //
+
+                unsigned short orient = ORIENTATION_TOPLEFT;
+                TIFFGetField(tif, TIFFTAG_ORIENTATION, &orient);
+                const bool flip = orient == ORIENTATION_TOPLEFT || orient == ORIENTATION_TOPRIGHT;
+                const bool flop = orient == ORIENTATION_TOPRIGHT || orient == ORIENTATION_BOTRIGHT;
+
+                for (FrameBuffer* f = &fb; f; f = f->nextPlane())
+                {
+                    if (flip)
+                        f->setOrientation(flop ? FrameBuffer::TOPRIGHT : FrameBuffer::TOPLEFT);
+                    else
+                        f->setOrientation(flop ? FrameBuffer::BOTTOMRIGHT : FrameBuffer::NATURAL);
+                }
+
+                if (fbWidth != width || fbHeight != height)
+                {
+                    fb.setUncrop(width, height, layout.x0, layout.y0);
+
+                    ostringstream str;
+                    str << layout.x0 << " " << layout.y0 << " " << layout.x1 << " " << layout.y1;
+                    fb.newAttribute("TIFF/Region", str.str());
+                }
+
+                if (layout.failed)
+                    fb.newAttribute("PartialImage", 1.0f);
+
+                string planarConfig = config == PLANARCONFIG_CONTIG ? "Contiguous" : "Separate";
+                fb.newAttribute("TIFF/PlanarConfig", layout.tiled ? "Tiled " + planarConfig : planarConfig);
+            }
             else if (TIFFIsTiled(tif))
             {
                 if (config == PLANARCONFIG_CONTIG)
@@ -1599,16 +2141,15 @@ namespace TwkFB
                 fb.newAttribute("TIFF/YResolution", y_rez);
             }
 
-            readAllTags(tif, fb);
+            if (level != 0)
+                fb.newAttribute("TIFF/Level", level);
 
-            TIFFClose(tif);
+            readAllTags(tif, fb);
 
-#if 0
-        if (isshadow)
-        {
-            TwkFB::normalize(&fb, true, true);
-        }
-#endif
+            //
+            //  extraSamples belongs to the directory, so this has to be
+            //  done before it's closed
+            //
 
             if (numExtra)
             {
@@ -1625,6 +2166,15 @@ namespace TwkFB
                 }
             }
 
+            TIFFClose(tif);
+
+#if 0
+        if (isshadow)
+        {
+            TwkFB::normalize(&fb, true, true);
+        }
+#endif
+
             //
             //  Most cards can't handle RGB or RGBA 16bit int textures.
             //
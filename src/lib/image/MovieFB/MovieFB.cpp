@@ -9,9 +9,11 @@
 #include <MovieFB/MovieFBWriter.h>
 #include <TwkFB/IO.h>
 #include <TwkFB/Exception.h>
+#include <TwkFB/StreamingIO.h>
 #include <TwkMovie/MovieIO.h>
 #include <TwkMovie/Movie.h>
 #include <TwkUtil/File.h>
+#include <TwkUtil/FileStream.h>
 #include <TwkUtil/FrameUtils.h>
 #include <TwkUtil/PathConform.h>
 #include <boost/filesystem/operations.hpp>
@@ -405,6 +407,17 @@ namespace TwkMovie
         return false;
     }
 
+    //
+    //  Only pass a region or level on to readers that can use it.
+    //  Otherwise the whole image is read and the identifier has to stay
+    //  the same as for a whole image.
+    //
+
+    bool MovieFB::supportsPartialReads() const
+    {
+        return m_imgio && m_imgio->supportsExtension(extension(m_imagePattern), FrameBufferIO::CropRead);
+    }
+
     void MovieFB::imagesAtFrame(const ReadRequest& mrequest, FrameBufferVector& fbs)
     {
         updateFrameInfo();
@@ -418,6 +431,19 @@ namespace TwkMovie
         request.channels = mrequest.channels;
         request.parameters = mrequest.parameters;
 
+        const bool partial = supportsPartialReads();
+
+        if (partial)
+        {
+            request.x0 = mrequest.x0;
+            request.y0 = mrequest.y0;
+            request.x1 = mrequest.x1;
+            request.y1 = mrequest.y1;
+            request.resolution = mrequest.resolution;
+            request.levelX = mrequest.levelX;
+            request.levelY = mrequest.levelY;
+        }
+
         //
         //  May throw (which is fine). If the image is missing and it
         //  doesn't throw read whatever we got. (probably a nearby frame)
@@ -434,6 +460,9 @@ namespace TwkMovie
             TWK_THROW_EXC_STREAM("Out of range frame " << mrequest.frame << " in " << basename(m_filename));
         }
 
+        if (partial)
+            idstr << request.partialReadIdentifier();
+
         m_imgio->readImages(fbs, filename, request);
 
         //  We read something, and didn't throw, so update readtime.  Note that
@@ -486,6 +515,39 @@ namespace TwkMovie
         }
     }
 
+    void MovieFB::readAheadAtFrame(const ReadRequest& request)
+    {
+        //
+        //  Never trigger a directory scan from the read-ahead thread,
+        //  and skip missing frames: imagesAtFrame() will deal with them.
+        //
+
+        if (!m_frameInfoValid)
+            return;
+
+        string filename;
+
+        pthread_mutex_lock(&m_frameLock);
+
+        FrameMap::const_iterator i = m_frameMap.find(request.frame);
+        if (i != m_frameMap.end())
+            filename = i->second.fileName;
+
+        pthread_mutex_unlock(&m_frameLock);
+
+        if (filename.empty())
+            return;
+
+        if (const StreamingFrameBufferIO* sio = dynamic_cast<const StreamingFrameBufferIO*>(m_imgio))
+        {
+            sio->readAhead(filename);
+        }
+        else
+        {
+            TwkUtil::FileStream::readAheadToPageCache(filename);
+        }
+    }
+
     void MovieFB::identifiersAtFrame(const ReadRequest& request, IdentifierVector& ids)
     {
         //
@@ -517,6 +579,9 @@ namespace TwkMovie
                 TWK_THROW_EXC_STREAM("id failed");
         }
 
+        if (supportsPartialReads())
+            idstr << request.partialReadIdentifier();
+
         string baseid = idstr.str() + "/";
 
         for (unsigned int i = 0; (i == 0 && request.views.empty()) || i < request.views.size(); i++)
@@ -97,6 +97,7 @@ namespace TwkMovie
 
         virtual void imagesAtFrame(const ReadRequest&, FrameBufferVector&);
         virtual void identifiersAtFrame(const ReadRequest&, IdentifierVector&);
+        virtual void readAheadAtFrame(const ReadRequest&);
 
         virtual Movie* clone() const;
 
@@ -109,6 +110,7 @@ namespace TwkMovie
         bool fileAndIdAtFrame(int& frame, std::string&, std::ostream&, bool);
         void updateFrameInfo();
         bool getImageInfo(const std::string& filename);
+        bool supportsPartialReads() const;
 
     protected:
         std::string m_sequencePattern;
@@ -31,6 +31,9 @@
 #include <set>
 #include <limits>
 #include <cmath>
+#include <deque>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -63,6 +66,8 @@ extern "C"
 #endif
 
 static ENVVAR_BOOL(evUseUploadedMovieForStreaming, "RV_SHOTGRID_USE_UPLOADED_MOVIE_FOR_STREAMING", false);
+static ENVVAR_BOOL(evFFMpegSharedDemux, "RV_FFMPEG_SHARED_DEMUX", true);
+static ENVVAR_INT(evFFMpegDemuxPackets, "RV_FFMPEG_DEMUX_PACKETS", 64);
 
 namespace TwkMovie
 {
@@ -1098,8 +1103,362 @@ namespace TwkMovie
         }
 #endif // defined(RV_FFMPEG_USE_VIDEOTOOLBOX)
 
+        bool isIntraOnlyStream(const AVStream* avStream)
+        {
+            const AVCodecDescriptor* desc = avcodec_descriptor_get(avStream->codecpar->codec_id);
+            return desc && (desc->props & AV_CODEC_PROP_INTRA_ONLY);
+        }
+
     } // namespace
 
+    //
+    //  Shared packet demux for one file.
+    //
+    //  Every clone of a MovieFFMpegReader used to seek and demux the file
+    //  on its own AVFormatContext. For intra-only codecs (ProRes, DNxHR,
+    //  MJPEG, etc) a single packet is a whole frame, so the readers can
+    //  instead take their packets from one demuxer per file and decode
+    //  them in parallel in their own codec contexts. The demuxer keeps a
+    //  window of recently read packets keyed by timestamp so readers
+    //  working on neighbouring frames are served by a single forward
+    //  read. Seeking only happens when a request falls outside of the
+    //  window.
+    //
+    //  The demuxer's format context is opened once. Clones which only
+    //  decode intra-only video take their stream info from it instead of
+    //  opening the file again.
+    //
+    //  Timestamps are relative to the start of their stream.
+    //
+    //  The demuxer is also where per file decode throughput is gathered
+    //  (across all of the readers of the file).
+    //
+
+    class SharedDemux
+    {
+    public:
+        typedef boost::mutex Mutex;
+        typedef boost::lock_guard<Mutex> LockGuard;
+        typedef std::map<int64_t, AVPacket*> PacketMap;
+
+        //
+        //  Readers share a demuxer only if they open the file with the
+        //  same format options.
+        //
+
+        static std::shared_ptr<SharedDemux> acquire(const string& filename, const AVDictionary* options);
+
+        ~SharedDemux();
+
+        AVFormatContext* formatContext() const { return m_avFormatContext; }
+
+        //
+        //  Returns a new reference to the packet of the stream whose
+        //  timestamp is closest to goalTS. The caller frees it. Throws if
+        //  there is no packet within a frame of it.
+        //
+
+        AVPacket* packetAt(int streamIndex, int64_t goalTS, double frameDur);
+
+        void frameDecoded();
+
+        double decodeFPS() const;
+
+    private:
+        SharedDemux(const string& filename);
+
+        bool open(const AVDictionary* options);
+
+        struct StreamPackets
+        {
+            StreamPackets()
+                : start(0)
+                , lastTS(AV_NOPTS_VALUE)
+            {
+            }
+
+            PacketMap packets;
+            int64_t start; // stream start time
+            int64_t lastTS;
+        };
+
+        typedef std::map<int, StreamPackets> StreamMap;
+
+        AVPacket* findPacket(const StreamPackets&, int64_t goalTS, double tolerance) const;
+        void seek(int streamIndex, int64_t goalTS);
+        bool readPacket();
+
+        typedef std::map<string, std::weak_ptr<SharedDemux>> Registry;
+
+        static Mutex m_registryMutex;
+        static Registry m_registry;
+
+        string m_filename;
+        AVFormatContext* m_avFormatContext;
+        StreamMap m_streams;
+        size_t m_maxPackets;
+        Mutex m_mutex;
+        mutable Mutex m_statsMutex;
+        TwkUtil::Timer m_timer;
+        std::deque<double> m_decodeTimes;
+    };
+
+    SharedDemux::Mutex SharedDemux::m_registryMutex;
+    SharedDemux::Registry SharedDemux::m_registry;
+
+    std::shared_ptr<SharedDemux> SharedDemux::acquire(const string& filename, const AVDictionary* options)
+    {
+        ostringstream key;
+        key << filename;
+
+        for (const AVDictionaryEntry* e = av_dict_get(options, "", 0, AV_DICT_IGNORE_SUFFIX); e;
+             e = av_dict_get(options, "", e, AV_DICT_IGNORE_SUFFIX))
+        {
+            key << "\n" << e->key << "=" << e->value;
+        }
+
+        LockGuard lock(m_registryMutex);
+
+        std::shared_ptr<SharedDemux> demux = m_registry[key.str()].lock();
+
+        if (!demux)
+        {
+            demux.reset(new SharedDemux(filename));
+
+            if (!demux->open(options))
+                return std::shared_ptr<SharedDemux>();
+
+            m_registry[key.str()] = demux;
+        }
+
+        //
+        //  Drop registry entries of files nobody reads anymore
+        //
+
+        for (Registry::iterator i = m_registry.begin(); i != m_registry.end();)
+        {
+            if (i->second.expired())
+                m_registry.erase(i++);
+            else
+                ++i;
+        }
+
+        return demux;
+    }
+
+    SharedDemux::SharedDemux(const string& filename)
+        : m_filename(filename)
+        , m_avFormatContext(0)
+        , m_maxPackets(std::max(4, evFFMpegDemuxPackets.getValue()))
+    {
+        m_timer.start();
+    }
+
+    bool SharedDemux::open(const AVDictionary* options)
+    {
+        const string path = TwkUtil::fileExists(m_filename.c_str()) ? "file:" + m_filename : m_filename;
+        AVDictionary* fmtOptions = 0;
+        av_dict_copy(&fmtOptions, options, 0);
+        int ret = avformat_open_input(&m_avFormatContext, path.c_str(), 0, &fmtOptions);
+        av_dict_free(&fmtOptions);
+
+        if (ret == 0)
+        {
+            m_avFormatContext->probesize = TWK_AVFORMAT_PROBESIZE;
+            ret = avformat_find_stream_info(m_avFormatContext, 0);
+        }
+
+        if (ret < 0)
+        {
+            cerr << "WARNING: Failed to open " << m_filename << " for shared demux: " << avErr2Str(ret) << endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    SharedDemux::~SharedDemux()
+    {
+        for (StreamMap::iterator s = m_streams.begin(); s != m_streams.end(); ++s)
+        {
+            for (PacketMap::iterator p = s->second.packets.begin(); p != s->second.packets.end(); ++p)
+            {
+                av_packet_free(&p->second);
+            }
+        }
+
+        if (m_avFormatContext)
+            avformat_close_input(&m_avFormatContext);
+    }
+
+    //
+    //  Timestamps can jitter and aren't always a whole number of frame
+    //  durations apart, so this takes the closest packet as long as it's
+    //  within tolerance of the goal.
+    //
+
+    AVPacket* SharedDemux::findPacket(const StreamPackets& stream, int64_t goalTS, double tolerance) const
+    {
+        PacketMap::const_iterator i = stream.packets.lower_bound(goalTS);
+        PacketMap::const_iterator best = i;
+
+        if (i != stream.packets.begin())
+        {
+            PacketMap::const_iterator before = std::prev(i);
+            if (i == stream.packets.end() || goalTS - before->first < i->first - goalTS)
+                best = before;
+        }
+
+        if (best != stream.packets.end() && std::abs(double(best->first - goalTS)) <= tolerance)
+            return best->second;
+        return 0;
+    }
+
+    void SharedDemux::seek(int streamIndex, int64_t goalTS)
+    {
+        if (av_seek_frame(m_avFormatContext, streamIndex, goalTS + m_streams[streamIndex].start, AVSEEK_FLAG_BACKWARD) < 0)
+        {
+            if (av_seek_frame(m_avFormatContext, -1, m_avFormatContext->start_time, 0) < 0)
+            {
+                TWK_THROW_EXC_STREAM("av_seek_frame failed in shared demux of " << m_filename);
+            }
+        }
+
+        for (StreamMap::iterator s = m_streams.begin(); s != m_streams.end(); ++s)
+        {
+            s->second.lastTS = AV_NOPTS_VALUE;
+        }
+    }
+
+    bool SharedDemux::readPacket()
+    {
+        AVPacket* pkt = av_packet_alloc();
+
+        HOP_PROF("av_read_frame()");
+        if (av_read_frame(m_avFormatContext, pkt) < 0)
+        {
+            av_packet_free(&pkt);
+            return false;
+        }
+
+        StreamMap::iterator s = m_streams.find(pkt->stream_index);
+        int64_t ts = (pkt->pts != AV_NOPTS_VALUE) ? pkt->pts : pkt->dts;
+
+        if (s == m_streams.end() || ts == AV_NOPTS_VALUE)
+        {
+            av_packet_free(&pkt);
+            return true;
+        }
+
+        StreamPackets& stream = s->second;
+        ts -= stream.start;
+        AVPacket*& slot = stream.packets[ts];
+        if (slot)
+            av_packet_free(&slot);
+        slot = pkt;
+        stream.lastTS = ts;
+
+        //
+        //  Trim the oldest packets. Readers move forward so those are the
+        //  least likely to be asked for again.
+        //
+
+        while (stream.packets.size() > m_maxPackets)
+        {
+            av_packet_free(&stream.packets.begin()->second);
+            stream.packets.erase(stream.packets.begin());
+        }
+
+        return true;
+    }
+
+    AVPacket* SharedDemux::packetAt(int streamIndex, int64_t goalTS, double frameDur)
+    {
+        LockGuard lock(m_mutex);
+
+        if (streamIndex < 0 || streamIndex >= int(m_avFormatContext->nb_streams))
+        {
+            TWK_THROW_EXC_STREAM("Bad stream index " << streamIndex << " in shared demux of " << m_filename);
+        }
+
+        StreamMap::iterator s = m_streams.find(streamIndex);
+
+        if (s == m_streams.end())
+        {
+            const int64_t start = m_avFormatContext->streams[streamIndex]->start_time;
+            s = m_streams.insert(StreamMap::value_type(streamIndex, StreamPackets())).first;
+            s->second.start = start != AV_NOPTS_VALUE ? start : 0;
+        }
+
+        StreamPackets& stream = s->second;
+
+        if (AVPacket* pkt = findPacket(stream, goalTS, frameDur * 0.5))
+            return av_packet_clone(pkt);
+
+        //
+        //  Read forward if the goal is just ahead of where the demuxer is,
+        //  otherwise seek.
+        //
+
+        const bool forward = stream.lastTS != AV_NOPTS_VALUE && goalTS > stream.lastTS && goalTS - stream.lastTS <= frameDur * m_maxPackets;
+
+        if (!forward)
+            seek(streamIndex, goalTS);
+
+        //
+        //  Read up to the goal so the packets on both sides of it are
+        //  there to choose from.
+        //
+
+        bool eof = false;
+
+        while (stream.lastTS == AV_NOPTS_VALUE || stream.lastTS < goalTS)
+        {
+            if (!readPacket())
+            {
+                eof = true;
+                break;
+            }
+        }
+
+        if (AVPacket* pkt = findPacket(stream, goalTS, frameDur))
+            return av_packet_clone(pkt);
+
+        //
+        //  Past the end of the stream: hand back the last frame like the
+        //  sequential decode path does.
+        //
+
+        if (eof && !stream.packets.empty() && stream.packets.rbegin()->first <= goalTS)
+        {
+            return av_packet_clone(stream.packets.rbegin()->second);
+        }
+
+        TWK_THROW_EXC_STREAM("No packet at timestamp " << goalTS << " in " << m_filename);
+    }
+
+    void SharedDemux::frameDecoded()
+    {
+        LockGuard lock(m_statsMutex);
+
+        const double now = m_timer.elapsed();
+        m_decodeTimes.push_back(now);
+
+        while (m_decodeTimes.front() < now - 2.0)
+            m_decodeTimes.pop_front();
+    }
+
+    double SharedDemux::decodeFPS() const
+    {
+        LockGuard lock(m_statsMutex);
+
+        if (m_decodeTimes.size() < 2)
+            return 0.0;
+
+        const double span = m_timer.elapsed() - m_decodeTimes.front();
+        return span > 0.0 ? double(m_decodeTimes.size()) / span : 0.0;
+    }
+
     //----------------------------------------------------------------------
     //
     // MovieFFMpegReader Class
@@ -1119,6 +1478,7 @@ namespace TwkMovie
         , m_dblline(0)
         , m_multiTrackAudio(false)
         , m_audioState(0)
+        , m_sharedFormatContext(false)
     {
 
         //
@@ -1183,8 +1543,13 @@ namespace TwkMovie
             //  them
         }
 
-        if (m_avFormatContext)
+        if (m_sharedFormatContext)
+            m_avFormatContext = 0;
+        else if (m_avFormatContext)
             avformat_close_input(&m_avFormatContext);
+
+        m_sharedFormatContext = false;
+        m_sharedDemux.reset();
     }
 
     void MovieFFMpegReader::audioConfigure(const AudioConfiguration& config)
@@ -1254,6 +1619,23 @@ namespace TwkMovie
             mov->m_formatStartFrame = m_formatStartFrame;
             mov->m_subtitleMap = m_subtitleMap;
             mov->m_multiTrackAudio = m_multiTrackAudio;
+
+            //
+            //  If all of the video comes from the shared demuxer the clone
+            //  uses its format context rather than opening the file again.
+            //
+
+            bool shared = m_sharedDemux && !m_videoTracks.empty();
+
+            for (int v = 0; shared && v < m_videoTracks.size(); v++)
+                shared = useSharedDemux(m_videoTracks[v]->number);
+
+            if (shared)
+            {
+                mov->m_sharedDemux = m_sharedDemux;
+                mov->m_avFormatContext = m_sharedDemux->formatContext();
+                mov->m_sharedFormatContext = true;
+            }
         }
         mov->m_cloning = false;
         return mov;
@@ -1295,6 +1677,23 @@ namespace TwkMovie
 #endif
     }
 
+    void MovieFFMpegReader::unshareFormatContext()
+    {
+        //
+        //  Anything which reads or seeks on its own (audio, video which
+        //  doesn't come from the shared demuxer) needs a context of its
+        //  own.
+        //
+
+        if (!m_sharedFormatContext)
+            return;
+
+        m_avFormatContext = 0;
+        m_sharedFormatContext = false;
+        openAVFormat();
+        findStreamInfo();
+    }
+
     bool MovieFFMpegReader::openAVFormat()
     {
         const bool filepathIsURL = TwkUtil::pathIsURL(m_filename);
@@ -1312,9 +1711,21 @@ namespace TwkMovie
             boost::replace_all(safe_path, "#.mp4", "");
         }
 
+        // Open the file
+        AVDictionary* fmtOptions = formatOptions();
+        const int ret = avformat_open_input(&m_avFormatContext, safe_path.c_str(), 0, &fmtOptions);
+        av_dict_free(&fmtOptions);
+        if (ret != 0)
+            TWK_THROW_EXC_STREAM("Failed to open " << m_filename << " for reading: " << avErr2Str(ret));
+
+        return true;
+    }
+
+    AVDictionary* MovieFFMpegReader::formatOptions() const
+    {
         // Check for cookies for streaming links
         AVDictionary* fmtOptions = NULL;
-        if (filepathIsURL)
+        if (TwkUtil::pathIsURL(m_filename))
         {
             for (int i = 0; i < m_request.parameters.size(); i++)
             {
@@ -1337,12 +1748,7 @@ namespace TwkMovie
             }
         }
 
-        // Open the file
-        const int ret = avformat_open_input(&m_avFormatContext, safe_path.c_str(), 0, &fmtOptions);
-        if (ret != 0)
-            TWK_THROW_EXC_STREAM("Failed to open " << m_filename << " for reading: " << avErr2Str(ret));
-
-        return true;
+        return fmtOptions;
     }
 
     void MovieFFMpegReader::trackFromStreamIndex(int index, VideoTrack*& vTrack, AudioTrack*& aTrack)
@@ -1382,6 +1788,13 @@ namespace TwkMovie
             findStreamInfo();
         }
 
+        if (!m_sharedDemux && evFFMpegSharedDemux.getValue() && !TwkUtil::pathIsURL(m_filename))
+        {
+            AVDictionary* fmtOptions = formatOptions();
+            m_sharedDemux = SharedDemux::acquire(m_filename, fmtOptions);
+            av_dict_free(&fmtOptions);
+        }
+
         // Get the codec context
         AVStream* avStream = m_avFormatContext->streams[index];
         if (*avCodecContext != nullptr && avcodec_is_open(*avCodecContext) != 0)
@@ -1448,6 +1861,17 @@ namespace TwkMovie
 
         // Open the codec
         (*avCodecContext)->thread_count = m_io->codecThreads();
+
+        if (avStream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && useSharedDemux(index))
+        {
+            //
+            //  The shared demux readers decode one packet at a time and
+            //  get their parallelism from running side by side. Frame
+            //  threading would only delay each frame.
+            //
+
+            (*avCodecContext)->thread_type = FF_THREAD_SLICE;
+        }
         if (avcodec_open2(*avCodecContext, avCodec, nullptr) < 0)
         {
             std::cerr << "ERROR: MovieFFMpeg: Failed to open codec '" << avCodec->name << "' for " << m_filename << '\n';
@@ -3183,6 +3607,8 @@ namespace TwkMovie
     {
         DBL(DB_AUDIO, "AUDIO_FILL_BUFFER " << m_filename);
 
+        unshareFormatContext();
+
         double sourceRate = m_info.audioSampleRate;
         SampleTime margin = request.startTime == 0 ? 0 : request.margin;
         Time formatStart = m_formatStartFrame / m_info.fps;
@@ -3527,6 +3953,8 @@ namespace TwkMovie
 
         DBL(DB_VIDEO, "seekTarget: " << seekTarget << " last: " << track->lastDecodedVideo << " inMinus1: " << inframe - 1);
 
+        unshareFormatContext();
+
         avcodec_send_packet(track->avCodecContext, nullptr);
 
         int ret;
@@ -3567,6 +3995,8 @@ namespace TwkMovie
 
     bool MovieFFMpegReader::readPacketFromStream(const int inframe, VideoTrack* track)
     {
+        unshareFormatContext();
+
         bool finalPacket = false;
 
         // Loop to make sure we only read from the correct AVStream
@@ -3760,6 +4190,69 @@ namespace TwkMovie
         return true;
     }
 
+    bool MovieFFMpegReader::useSharedDemux(int streamIndex) const
+    {
+        return m_sharedDemux && m_avFormatContext && !m_info.slowRandomAccess && isIntraOnlyStream(m_avFormatContext->streams[streamIndex]);
+    }
+
+    bool MovieFFMpegReader::decodeSharedPacket(int inframe, double frameDur, VideoTrack* track)
+    {
+        //
+        //  The shared demuxer's timestamps start at zero
+        //
+
+        const int64_t goalTS = std::max(int64_t(0), int64_t((inframe - m_formatStartFrame - rv_seek_frame_offset) * frameDur + 0.5));
+
+        AVPacket* pkt = m_sharedDemux->packetAt(track->number, goalTS, frameDur);
+        av_packet_unref(track->videoPacket);
+        av_packet_move_ref(track->videoPacket, pkt);
+        av_packet_free(&pkt);
+
+        //
+        //  Every packet is a whole frame so there is no decoder state to
+        //  carry from one frame to the next.
+        //
+
+        if (track->useOpenJPH || track->useAppleProRes)
+        {
+            // These decode the packet themselves later on
+            track->videoFrame->pts = track->videoPacket->pts;
+            track->videoFrame->pkt_dts = track->videoPacket->dts;
+        }
+        else
+        {
+            sendPacketToDecoder(track);
+
+            HOP_PROF("avcodec_receive_frame()");
+            int ret = avcodec_receive_frame(track->avCodecContext, track->videoFrame);
+
+            if (ret == AVERROR(EAGAIN))
+            {
+                //
+                //  The decoder is holding the frame back (frame threading):
+                //  drain it and reset it for the next packet.
+                //
+
+                avcodec_send_packet(track->avCodecContext, nullptr);
+                ret = avcodec_receive_frame(track->avCodecContext, track->videoFrame);
+                avcodec_flush_buffers(track->avCodecContext);
+            }
+
+            if (ret < 0)
+            {
+                TWK_THROW_EXC_STREAM("Could not decode video: rcv error");
+            }
+        }
+
+        const int64_t pktPTS = track->videoFrame->pts;
+        const int64_t lastTS = (pktPTS == AV_NOPTS_VALUE) ? track->videoFrame->pkt_dts : pktPTS;
+        track->lastDecodedVideo = int(double(lastTS) / frameDur + 1.49);
+
+        DBL(DB_VIDEO, "shared demux goalTS: " << goalTS << " lastTS: " << lastTS << " last: " << track->lastDecodedVideo);
+
+        return true;
+    }
+
     FrameBuffer* MovieFFMpegReader::decodeImageAtFrame(int inframe, VideoTrack* track)
     {
         if (m_mustReadFirstFrame)
@@ -3802,35 +4295,55 @@ namespace TwkMovie
         // videoCodecContext->gop_size because it is initialized by default by
         // FFmpeg with a default value of 12 even for intra-frame compression
         // codecs (such as Apple Pro Res for example).
-        const int nearFrameThreshold = (m_info.slowRandomAccess && videoCodecContext->gop_size != 0) ? videoCodecContext->gop_size : 1;
-        if (track->lastDecodedVideo == -1 || track->lastDecodedVideo >= inframe || track->lastDecodedVideo < (inframe - nearFrameThreshold))
+        //
+        // Intra-only streams get their packet from the shared demux and
+        // never seek on their own.
+        //
+
+        const bool sharedDemux = useSharedDemux(track->number);
+        bool frameFinished = false;
+
+        if (sharedDemux)
         {
-            seekToFrame(inframe, frameDur, videoStream, track);
+#if DB_TIMING & DB_LEVEL
+            m_timingDetails->startTimer("decode");
+#endif
+
+            frameFinished = decodeSharedPacket(inframe, frameDur, track);
         }
+        else
+        {
+            const int nearFrameThreshold = (m_info.slowRandomAccess && videoCodecContext->gop_size != 0) ? videoCodecContext->gop_size : 1;
+            if (track->lastDecodedVideo == -1 || track->lastDecodedVideo >= inframe
+                || track->lastDecodedVideo < (inframe - nearFrameThreshold))
+            {
+                seekToFrame(inframe, frameDur, videoStream, track);
+            }
 
-        //
-        // Find the best suitable frame
-        //
+            //
+            // Find the best suitable frame
+            //
 
 #if DB_TIMING & DB_LEVEL
-        m_timingDetails->startTimer("decode");
+            m_timingDetails->startTimer("decode");
 #endif
 
-        const bool frameFinished = findImageWithBestTimestamp(inframe, frameDur, videoStream, track);
+            frameFinished = findImageWithBestTimestamp(inframe, frameDur, videoStream, track);
 
-        // Remove earlier timestamps
-        int64_t prune = (inframe - 2) * frameDur;
-        set<int64_t>::iterator pruneIT;
-        for (pruneIT = track->tsSet.begin(); pruneIT != track->tsSet.end(); pruneIT++)
-        {
-            if (*pruneIT > prune)
+            // Remove earlier timestamps
+            int64_t prune = (inframe - 2) * frameDur;
+            set<int64_t>::iterator pruneIT;
+            for (pruneIT = track->tsSet.begin(); pruneIT != track->tsSet.end(); pruneIT++)
             {
-                if (pruneIT != track->tsSet.begin())
-                    pruneIT--;
-                break;
+                if (*pruneIT > prune)
+                {
+                    if (pruneIT != track->tsSet.begin())
+                        pruneIT--;
+                    break;
+                }
             }
+            track->tsSet.erase(track->tsSet.begin(), pruneIT);
         }
-        track->tsSet.erase(track->tsSet.begin(), pruneIT);
 
         if (track->useOpenJPH)
         {
@@ -4154,6 +4667,13 @@ namespace TwkMovie
             fbs.push_back(out);
 
             track->fb.appendAttributesAndPrefixTo(out, "");
+
+            if (m_sharedDemux)
+            {
+                m_sharedDemux->frameDecoded();
+                out->newAttribute("VideoDecodeFPS", float(m_sharedDemux->decodeFPS()));
+            }
+
             out->setIdentifier("");
             identifier(inframe, out->idstream());
             out->idstream() << "/" << i;
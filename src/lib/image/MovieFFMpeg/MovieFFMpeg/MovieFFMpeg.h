@@ -10,6 +10,7 @@
 #include <TwkMovie/MovieReader.h>
 #include <TwkMovie/MovieWriter.h>
 #include <TwkMovie/MovieIO.h>
+#include <memory>
 #include <stdint.h>
 extern "C"
 {
@@ -51,6 +52,7 @@ namespace TwkMovie
     class AudioTrack;
     class VideoTrack;
     class ContextPool;
+    class SharedDemux;
     class HardwareContext;
 
     //
@@ -182,6 +184,8 @@ namespace TwkMovie
         void initializeVideo(int height, int width);
         void initializeAudio();
         bool openAVFormat();
+        void unshareFormatContext();
+        AVDictionary* formatOptions() const;
         bool openAVCodec(int index, AVCodecContext** avCodecContext, HardwareContext* hardwareContext = nullptr);
         void findStreamInfo();
 
@@ -249,6 +253,11 @@ namespace TwkMovie
         //      than avcodec_decode_video2().
         bool findImageWithBestTimestamp(int inframe, double frameDur, AVStream* videoStream, VideoTrack* track);
 
+        // True if the stream's packets come from the shared demux (intra-only
+        // codecs). Those are decoded one packet per frame without seeking.
+        bool useSharedDemux(int streamIndex) const;
+        bool decodeSharedPacket(int inframe, double frameDur, VideoTrack* track);
+
         // check if the input format is jpeg_pipe or png_pipe
         bool isImageFormat(const char* iformat);
 
@@ -278,6 +287,8 @@ namespace TwkMovie
         bool m_cloning{false};
         bool m_mustReadFirstFrame{false};
         AVPixelFormat m_pxlFormatOnOpen{AV_PIX_FMT_NONE};
+        std::shared_ptr<SharedDemux> m_sharedDemux;
+        bool m_sharedFormatContext; // m_avFormatContext is m_sharedDemux's
 
         friend class ContextPool;
     };
@@ -190,14 +190,14 @@ namespace TwkFB
             }
         }
 
-        m_map.clear();
+        mapClear();
 
         size_t bytes = 0;
 
         for (size_t i = 0; i < lockedFBs.size(); i++)
         {
             FrameBuffer* fb = lockedFBs[i];
-            m_map[fb->identifier()] = fb;
+            mapInsert(fb);
             bytes += fb->totalImageSize();
         }
         DB("    after clearing, Cache holds " << m_map.size() << " fbs (" << bytes << " bytes)");
@@ -228,7 +228,7 @@ namespace TwkFB
                 if (refcount)
                     fb->m_cacheRef--;
                 m_currentBytes -= deleteFB(fb);
-                m_map.erase(i);
+                mapErase(i);
                 m_full = (m_currentBytes >= m_maxBytes);
                 return true;
             }
@@ -255,11 +255,7 @@ namespace TwkFB
         return false;
     }
 
-    bool Cache::isCached(const IDString& idstring) const
-    {
-        bool b = m_map.find(idstring) != m_map.end();
-        return b;
-    }
+    bool Cache::isCached(const IDString& idstring) const { return m_index.contains(idstring); }
 
     FrameBuffer* Cache::checkOut(const IDString& idstring)
     {
@@ -339,8 +335,8 @@ namespace TwkFB
         while (freedBytes < bytes && (fb = m_trashCan->popOldest()))
         {
             DBL(DB_TCFREE, "freeTrash() freeing bytes " << fb->totalImageSize() << " (" << fb->identifier() << ")");
-            m_map.erase(fb->identifier());
-            const size_t totalImagesize = deleteFB(fb);
+            mapErase(fb->identifier());
+            const size_t totalImagesize = evictFB(fb);
 
             m_currentBytes -= totalImagesize;
             freedBytes += totalImagesize;
@@ -350,6 +346,8 @@ namespace TwkFB
         return (freedBytes >= bytes);
     }
 
+    size_t Cache::evictFB(FrameBuffer* fb) { return deleteFB(fb); }
+
     bool Cache::freeAllTrash() { return freeTrash(m_currentBytes); }
 
     bool Cache::free(size_t bytes)
@@ -385,7 +383,7 @@ namespace TwkFB
                 if (Cache::debug())
                     cout << "CACHE: freeing " << fb->allocSize() << " of needed " << bytes << ", fb = " << fb->identifier() << endl;
 
-                m_map.erase(fb->identifier());
+                mapErase(fb->identifier());
                 fbs.front() = 0;
                 m_currentBytes -= deleteFB(fb);
                 m_full = (m_currentBytes >= m_maxBytes);
@@ -438,7 +436,7 @@ namespace TwkFB
             deleteFB(i->second);
         }
 
-        m_map[fb->identifier()] = fb;
+        mapInsert(fb);
         if (Cache::debug())
             cout << "CACHE: added " << fb->identifier() << endl;
 
@@ -486,6 +484,30 @@ namespace TwkFB
 
     bool Cache::trashContains(FrameBuffer* fb) { return m_trashCan->contains(fb); }
 
+    void Cache::mapInsert(FrameBuffer* fb)
+    {
+        m_map[fb->identifier()] = fb;
+        m_index.insert(fb->identifier());
+    }
+
+    void Cache::mapErase(FBMap::iterator i)
+    {
+        m_index.erase(i->first);
+        m_map.erase(i);
+    }
+
+    void Cache::mapErase(const IDString& id)
+    {
+        m_index.erase(id);
+        m_map.erase(id);
+    }
+
+    void Cache::mapClear()
+    {
+        m_index.clear();
+        m_map.clear();
+    }
+
     // This function handles the presence of "proxy buffers" (FrameBuffer) in
     // the cache. Those buffers have a data pointer that refers to another
     // buffer's data (eg.: tiles). When the cache wants to delete a FrameBuffer,
@@ -526,7 +548,7 @@ namespace TwkFB
                         // been deleted prior the master buffer.
                         if (i != m_map.end())
                         {
-                            m_map.erase(i);
+                            mapErase(i);
                             m_trashCan->remove(proxyBuffer);
                             // Consider the proxy buffers size (including their
                             // sub-planes).
@@ -9,16 +9,19 @@
 #include <TwkFB/FastConversion.h>
 
 #include <TwkFB/TwkFBThreadPool.h>
+#include <TwkFB/SIMD.h>
 #include <TwkUtil/sgcHop.h>
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 using namespace ILMTHREAD_NAMESPACE;
 
 //------------------------------------------------------------------------------
 //
-void convert_ABGR10_to_RGBA10(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint32_t* FASTMEMCPYRESTRICT outBuf)
+static void convert_ABGR10_to_RGBA10_scalar(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                            uint32_t* FASTMEMCPYRESTRICT outBuf)
 {
     uint32_t* FASTMEMCPYRESTRICT p1 = outBuf;
 
@@ -43,6 +46,103 @@ void convert_ABGR10_to_RGBA10(size_t width, size_t height, const uint32_t* FASTM
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  The rows are contiguous so the vector versions treat the buffer as
+//  one long run of pixels. Each 32 bit lane gets the same shifts and
+//  masks as the scalar version.
+//
+
+TWKFB_TARGET_SSE41 static void convert_ABGR10_to_RGBA10_SSE41(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                              uint32_t* FASTMEMCPYRESTRICT outBuf)
+{
+    const __m128i blueMask = _mm_set1_epi32(0x3FF00000);
+    const __m128i greenMask = _mm_set1_epi32(0x000FFC00);
+    const size_t n = width * height;
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf + i));
+        const __m128i r = _mm_or_si128(_mm_or_si128(_mm_srli_epi32(a, 30), _mm_srli_epi32(_mm_and_si128(a, blueMask), 18)),
+                                       _mm_or_si128(_mm_slli_epi32(_mm_and_si128(a, greenMask), 2), _mm_slli_epi32(a, 22)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outBuf + i), r);
+    }
+
+    convert_ABGR10_to_RGBA10_scalar(n - i, 1, inBuf + i, outBuf + i);
+}
+
+TWKFB_TARGET_AVX2 static void convert_ABGR10_to_RGBA10_AVX2(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                            uint32_t* FASTMEMCPYRESTRICT outBuf)
+{
+    const __m256i blueMask = _mm256_set1_epi32(0x3FF00000);
+    const __m256i greenMask = _mm256_set1_epi32(0x000FFC00);
+    const size_t n = width * height;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf + i));
+        const __m256i r =
+            _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(a, 30), _mm256_srli_epi32(_mm256_and_si256(a, blueMask), 18)),
+                            _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(a, greenMask), 2), _mm256_slli_epi32(a, 22)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(outBuf + i), r);
+    }
+
+    convert_ABGR10_to_RGBA10_scalar(n - i, 1, inBuf + i, outBuf + i);
+}
+
+TWKFB_TARGET_AVX512 static void convert_ABGR10_to_RGBA10_AVX512(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                                uint32_t* FASTMEMCPYRESTRICT outBuf)
+{
+    const __m512i blueMask = _mm512_set1_epi32(0x3FF00000);
+    const __m512i greenMask = _mm512_set1_epi32(0x000FFC00);
+    const size_t n = width * height;
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m512i a = _mm512_loadu_si512(inBuf + i);
+        const __m512i r =
+            _mm512_or_si512(_mm512_or_si512(_mm512_srli_epi32(a, 30), _mm512_srli_epi32(_mm512_and_si512(a, blueMask), 18)),
+                            _mm512_or_si512(_mm512_slli_epi32(_mm512_and_si512(a, greenMask), 2), _mm512_slli_epi32(a, 22)));
+        _mm512_storeu_si512(outBuf + i, r);
+    }
+
+    convert_ABGR10_to_RGBA10_scalar(n - i, 1, inBuf + i, outBuf + i);
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void convert_ABGR10_to_RGBA10(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint32_t* FASTMEMCPYRESTRICT outBuf)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX512)
+    {
+        convert_ABGR10_to_RGBA10_AVX512(width, height, inBuf, outBuf);
+        return;
+    }
+    else if (level >= TwkFB::SIMDAVX2)
+    {
+        convert_ABGR10_to_RGBA10_AVX2(width, height, inBuf, outBuf);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        convert_ABGR10_to_RGBA10_SSE41(width, height, inBuf, outBuf);
+        return;
+    }
+#endif
+
+    convert_ABGR10_to_RGBA10_scalar(width, height, inBuf, outBuf);
+}
+
 //------------------------------------------------------------------------------
 //
 class Convert_ABGR10_to_RGBA10_MP_Task : public Task
@@ -223,9 +323,9 @@ void convert_RGB16_to_RGB12_MP(size_t width, size_t height, const void* FASTMEMC
 // per component.
 // See v210 at http://developer.apple.com/library/mac/technotes/tn2162/
 //
-void packedUYVY10_to_planarYUV16(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
-                                 uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
-                                 size_t strideCr)
+static void packedUYVY10_to_planarYUV16_scalar(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                               uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                               uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb, size_t strideCr)
 {
     const size_t nbPixelGroups = width / 16;
     uint16_t* FASTMEMCPYRESTRICT startOutY = outY;
@@ -273,6 +373,143 @@ void packedUYVY10_to_planarYUV16(size_t width, size_t height, const uint32_t* FA
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  Vector versions of the v210 unpack. A 16 byte group (6 pixels) fits
+//  one SSE register (or one AVX2 lane): the three 10 bit fields of the
+//  four words are isolated, narrowed to 16 bits and then shuffled into
+//  6 Y, 3 Cb and 3 Cr samples. The stores are wider than the samples
+//  they carry (the extra samples are overwritten by the next group) so
+//  the last group of each row is always left to the scalar code.
+//
+
+TWKFB_TARGET_SSE41 static inline void unpackV210Group_SSE41(__m128i w, __m128i& y, __m128i& c)
+{
+    const __m128i mask = _mm_set1_epi32(0x3FF);
+    const __m128i c0 = _mm_and_si128(w, mask);
+    const __m128i c1 = _mm_and_si128(_mm_srli_epi32(w, 10), mask);
+    const __m128i c2 = _mm_and_si128(_mm_srli_epi32(w, 20), mask);
+    const __m128i p01 = _mm_packus_epi32(c0, c1);
+    const __m128i p2 = _mm_packus_epi32(c2, c2);
+
+    y = _mm_or_si128(_mm_shuffle_epi8(p01, _mm_setr_epi8(8, 9, 2, 3, -1, -1, 12, 13, 6, 7, -1, -1, -1, -1, -1, -1)),
+                     _mm_shuffle_epi8(p2, _mm_setr_epi8(-1, -1, -1, -1, 2, 3, -1, -1, -1, -1, 6, 7, -1, -1, -1, -1)));
+
+    // Cb in the low 4 samples, Cr in the high 4 samples
+    c = _mm_or_si128(_mm_shuffle_epi8(p01, _mm_setr_epi8(0, 1, 10, 11, -1, -1, -1, -1, -1, -1, 4, 5, 14, 15, -1, -1)),
+                     _mm_shuffle_epi8(p2, _mm_setr_epi8(-1, -1, -1, -1, 4, 5, -1, -1, 0, 1, -1, -1, -1, -1, -1, -1)));
+}
+
+TWKFB_TARGET_SSE41 static void packedUYVY10_to_planarYUV16_SSE41(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                                                 size_t strideCr)
+{
+    const size_t nbPixelGroups = width / 16;
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        uint16_t* FASTMEMCPYRESTRICT y = outY + i * strideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb = outCb + i * strideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr = outCr + i * strideCr / 2;
+        size_t j = 0;
+
+        for (; j + 1 < nbPixelGroups; ++j, inBuf += 4, y += 6, cb += 3, cr += 3)
+        {
+            __m128i vy, vc;
+            unpackV210Group_SSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf)), vy, vc);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y), vy);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cb), vc);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cr), _mm_srli_si128(vc, 8));
+        }
+
+        if (j < nbPixelGroups)
+        {
+            packedUYVY10_to_planarYUV16_scalar(16, 1, inBuf, y, cb, cr, 0, 0, 0);
+            inBuf += 4;
+        }
+    }
+}
+
+TWKFB_TARGET_AVX2 static void packedUYVY10_to_planarYUV16_AVX2(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                               uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                               uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                                               size_t strideCr)
+{
+    const size_t nbPixelGroups = width / 16;
+    const __m256i mask = _mm256_set1_epi32(0x3FF);
+    const __m256i shufY01 = _mm256_setr_epi8(8, 9, 2, 3, -1, -1, 12, 13, 6, 7, -1, -1, -1, -1, -1, -1, 8, 9, 2, 3, -1, -1, 12, 13, 6, 7,
+                                             -1, -1, -1, -1, -1, -1);
+    const __m256i shufY2 = _mm256_setr_epi8(-1, -1, -1, -1, 2, 3, -1, -1, -1, -1, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, 2, 3, -1, -1, -1,
+                                            -1, 6, 7, -1, -1, -1, -1);
+    const __m256i shufC01 = _mm256_setr_epi8(0, 1, 10, 11, -1, -1, -1, -1, -1, -1, 4, 5, 14, 15, -1, -1, 0, 1, 10, 11, -1, -1, -1, -1,
+                                             -1, -1, 4, 5, 14, 15, -1, -1);
+    const __m256i shufC2 = _mm256_setr_epi8(-1, -1, -1, -1, 4, 5, -1, -1, 0, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 4, 5, -1, -1, 0,
+                                            1, -1, -1, -1, -1, -1, -1);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        uint16_t* FASTMEMCPYRESTRICT y = outY + i * strideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb = outCb + i * strideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr = outCr + i * strideCr / 2;
+        size_t j = 0;
+
+        for (; j + 2 < nbPixelGroups; j += 2, inBuf += 8, y += 12, cb += 6, cr += 6)
+        {
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf));
+            const __m256i c0 = _mm256_and_si256(w, mask);
+            const __m256i c1 = _mm256_and_si256(_mm256_srli_epi32(w, 10), mask);
+            const __m256i c2 = _mm256_and_si256(_mm256_srli_epi32(w, 20), mask);
+            const __m256i p01 = _mm256_packus_epi32(c0, c1);
+            const __m256i p2 = _mm256_packus_epi32(c2, c2);
+            const __m256i vy = _mm256_or_si256(_mm256_shuffle_epi8(p01, shufY01), _mm256_shuffle_epi8(p2, shufY2));
+            const __m256i vc = _mm256_or_si256(_mm256_shuffle_epi8(p01, shufC01), _mm256_shuffle_epi8(p2, shufC2));
+            const __m128i vc0 = _mm256_castsi256_si128(vc);
+            const __m128i vc1 = _mm256_extracti128_si256(vc, 1);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y), _mm256_castsi256_si128(vy));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y + 6), _mm256_extracti128_si256(vy, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cb), vc0);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cb + 3), vc1);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cr), _mm_srli_si128(vc0, 8));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cr + 3), _mm_srli_si128(vc1, 8));
+        }
+
+        for (; j < nbPixelGroups; ++j, inBuf += 4, y += 6, cb += 3, cr += 3)
+        {
+            packedUYVY10_to_planarYUV16_scalar(16, 1, inBuf, y, cb, cr, 0, 0, 0);
+        }
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void packedUYVY10_to_planarYUV16(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
+                                 uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                 size_t strideCr)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        packedUYVY10_to_planarYUV16_AVX2(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        packedUYVY10_to_planarYUV16_SSE41(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+        return;
+    }
+#endif
+
+    packedUYVY10_to_planarYUV16_scalar(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+}
+
 //------------------------------------------------------------------------------
 //
 class PackedUYVY10_to_planarYUV16_Task : public Task
@@ -354,9 +591,9 @@ void packedUYVY10_to_planarYUV16_MP(size_t width, size_t height, const uint32_t*
 // per component.
 // See v216 at http://developer.apple.com/library/mac/technotes/tn2162/
 //
-void packedUYVY16_to_planarYUV16(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
-                                 uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
-                                 size_t strideCr)
+static void packedUYVY16_to_planarYUV16_scalar(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inBuf,
+                                               uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                               uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb, size_t strideCr)
 {
     const size_t nbPixelGroups = width / 8;
     uint16_t* FASTMEMCPYRESTRICT startOutY = outY;
@@ -385,6 +622,106 @@ void packedUYVY16_to_planarYUV16(size_t width, size_t height, const uint16_t* FA
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  Vector versions of the v216 unpack. Each register of 4 Cb Y Cr Y
+//  groups is shuffled to Y Y Y Y Cb Cb Cr Cr and two of those are then
+//  interleaved so that every store is a full run of one component.
+//
+
+TWKFB_TARGET_SSE41 static void packedUYVY16_to_planarYUV16_SSE41(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inBuf,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                                                 size_t strideCr)
+{
+    const size_t nbPixelGroups = width / 8;
+    const __m128i shuf = _mm_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, 0, 1, 8, 9, 4, 5, 12, 13);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        uint16_t* FASTMEMCPYRESTRICT y = outY + i * strideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb = outCb + i * strideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr = outCr + i * strideCr / 2;
+        size_t j = 0;
+
+        for (; j + 4 <= nbPixelGroups; j += 4, inBuf += 16, y += 8, cb += 4, cr += 4)
+        {
+            const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf)), shuf);
+            const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf + 8)), shuf);
+            const __m128i c = _mm_unpackhi_epi32(a, b);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y), _mm_unpacklo_epi64(a, b));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cb), c);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cr), _mm_srli_si128(c, 8));
+        }
+
+        packedUYVY16_to_planarYUV16_scalar((nbPixelGroups - j) * 8, 1, inBuf, y, cb, cr, 0, 0, 0);
+        inBuf += (nbPixelGroups - j) * 4;
+    }
+}
+
+TWKFB_TARGET_AVX2 static void packedUYVY16_to_planarYUV16_AVX2(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inBuf,
+                                                               uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                               uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                                               size_t strideCr)
+{
+    const size_t nbPixelGroups = width / 8;
+    const __m256i shuf = _mm256_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, 0, 1, 8, 9, 4, 5, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15, 0, 1, 8, 9, 4,
+                                          5, 12, 13);
+    const __m256i chromaOrder = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        uint16_t* FASTMEMCPYRESTRICT y = outY + i * strideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb = outCb + i * strideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr = outCr + i * strideCr / 2;
+        size_t j = 0;
+
+        for (; j + 8 <= nbPixelGroups; j += 8, inBuf += 32, y += 16, cb += 8, cr += 8)
+        {
+            const __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf)), shuf);
+            const __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf + 16)), shuf);
+            const __m256i vy = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+            const __m256i vc = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi32(a, b), chromaOrder);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(y), vy);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cb), _mm256_castsi256_si128(vc));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cr), _mm256_extracti128_si256(vc, 1));
+        }
+
+        packedUYVY16_to_planarYUV16_scalar((nbPixelGroups - j) * 8, 1, inBuf, y, cb, cr, 0, 0, 0);
+        inBuf += (nbPixelGroups - j) * 4;
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void packedUYVY16_to_planarYUV16(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
+                                 uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, size_t strideY, size_t strideCb,
+                                 size_t strideCr)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        packedUYVY16_to_planarYUV16_AVX2(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        packedUYVY16_to_planarYUV16_SSE41(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+        return;
+    }
+#endif
+
+    packedUYVY16_to_planarYUV16_scalar(width, height, inBuf, outY, outCb, outCr, strideY, strideCb, strideCr);
+}
+
 //------------------------------------------------------------------------------
 //
 class PackedUYVY16_to_planarYUV16_Task : public Task
@@ -463,9 +800,10 @@ void packedUYVY16_to_planarYUV16_MP(size_t width, size_t height, const uint16_t*
 // from packed UVYA 16 bits per component to planar YUVA with 16 bits per
 // component.
 //
-void packedUVYA16_to_planarYUVA16(size_t width, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
-                                  uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, uint16_t* FASTMEMCPYRESTRICT outA,
-                                  size_t strideY, size_t strideCb, size_t strideCr, size_t strideA)
+static void packedUVYA16_to_planarYUVA16_scalar(size_t width, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                                uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                uint16_t* FASTMEMCPYRESTRICT outCr, uint16_t* FASTMEMCPYRESTRICT outA, size_t strideY,
+                                                size_t strideCb, size_t strideCr, size_t strideA)
 {
     const size_t nbPixels = width / 8;
     uint16_t* FASTMEMCPYRESTRICT startOutY = outY;
@@ -493,6 +831,122 @@ void packedUVYA16_to_planarYUVA16(size_t width, size_t height, const uint64_t* F
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  Splits n pixels of 4 interleaved 16 bit components into 4 planes
+//  (c0 is the least significant component of each 64 bit pixel). This
+//  is a 4x4 transpose of 16 bit values done with a byte shuffle and
+//  32/64 bit unpacks. Shared by the UVYA and AYUV converters which have
+//  the same memory layout.
+//
+
+static inline void deinterleave4x16_scalar(const uint16_t* FASTMEMCPYRESTRICT in, size_t n, uint16_t* FASTMEMCPYRESTRICT c0,
+                                           uint16_t* FASTMEMCPYRESTRICT c1, uint16_t* FASTMEMCPYRESTRICT c2,
+                                           uint16_t* FASTMEMCPYRESTRICT c3)
+{
+    for (size_t i = 0; i < n; ++i, in += 4)
+    {
+        c0[i] = in[0];
+        c1[i] = in[1];
+        c2[i] = in[2];
+        c3[i] = in[3];
+    }
+}
+
+TWKFB_TARGET_SSE41 static void deinterleave4x16_SSE41(const uint16_t* FASTMEMCPYRESTRICT in, size_t n, uint16_t* FASTMEMCPYRESTRICT c0,
+                                                      uint16_t* FASTMEMCPYRESTRICT c1, uint16_t* FASTMEMCPYRESTRICT c2,
+                                                      uint16_t* FASTMEMCPYRESTRICT c3)
+{
+    const __m128i shuf = _mm_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8, in += 32)
+    {
+        const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), shuf);
+        const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8)), shuf);
+        const __m128i c = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), shuf);
+        const __m128i d = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 24)), shuf);
+        const __m128i abLo = _mm_unpacklo_epi32(a, b);
+        const __m128i abHi = _mm_unpackhi_epi32(a, b);
+        const __m128i cdLo = _mm_unpacklo_epi32(c, d);
+        const __m128i cdHi = _mm_unpackhi_epi32(c, d);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c0 + i), _mm_unpacklo_epi64(abLo, cdLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c1 + i), _mm_unpackhi_epi64(abLo, cdLo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c2 + i), _mm_unpacklo_epi64(abHi, cdHi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(c3 + i), _mm_unpackhi_epi64(abHi, cdHi));
+    }
+
+    deinterleave4x16_scalar(in, n - i, c0 + i, c1 + i, c2 + i, c3 + i);
+}
+
+TWKFB_TARGET_AVX2 static void deinterleave4x16_AVX2(const uint16_t* FASTMEMCPYRESTRICT in, size_t n, uint16_t* FASTMEMCPYRESTRICT c0,
+                                                    uint16_t* FASTMEMCPYRESTRICT c1, uint16_t* FASTMEMCPYRESTRICT c2,
+                                                    uint16_t* FASTMEMCPYRESTRICT c3)
+{
+    const __m256i shuf = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15, 0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6,
+                                          7, 14, 15);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16, in += 64)
+    {
+        const __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in)), shuf);
+        const __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 16)), shuf);
+        const __m256i c = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 32)), shuf);
+        const __m256i d = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 48)), shuf);
+        const __m256i abLo = _mm256_unpacklo_epi32(a, b);
+        const __m256i abHi = _mm256_unpackhi_epi32(a, b);
+        const __m256i cdLo = _mm256_unpacklo_epi32(c, d);
+        const __m256i cdHi = _mm256_unpackhi_epi32(c, d);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c0 + i), _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(abLo, cdLo), order));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c1 + i), _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(abLo, cdLo), order));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c2 + i), _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(abHi, cdHi), order));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(c3 + i), _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(abHi, cdHi), order));
+    }
+
+    deinterleave4x16_scalar(in, n - i, c0 + i, c1 + i, c2 + i, c3 + i);
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void packedUVYA16_to_planarYUVA16(size_t width, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf, uint16_t* FASTMEMCPYRESTRICT outY,
+                                  uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr, uint16_t* FASTMEMCPYRESTRICT outA,
+                                  size_t strideY, size_t strideCb, size_t strideCr, size_t strideA)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDSSE41)
+    {
+        const size_t nbPixels = width / 8;
+        const uint16_t* FASTMEMCPYRESTRICT in = reinterpret_cast<const uint16_t*>(inBuf);
+
+        for (size_t i = 0; i < height; ++i, in += nbPixels * 4)
+        {
+            uint16_t* FASTMEMCPYRESTRICT y = outY + i * strideY / 2;
+            uint16_t* FASTMEMCPYRESTRICT cb = outCb + i * strideCb / 2;
+            uint16_t* FASTMEMCPYRESTRICT cr = outCr + i * strideCr / 2;
+            uint16_t* FASTMEMCPYRESTRICT a = outA + i * strideA / 2;
+
+            if (level >= TwkFB::SIMDAVX2)
+                deinterleave4x16_AVX2(in, nbPixels, a, y, cb, cr);
+            else
+                deinterleave4x16_SSE41(in, nbPixels, a, y, cb, cr);
+        }
+
+        return;
+    }
+#endif
+
+    packedUVYA16_to_planarYUVA16_scalar(width, height, inBuf, outY, outCb, outCr, outA, strideY, strideCb, strideCr, strideA);
+}
+
 //------------------------------------------------------------------------------
 //
 class PackedUVYA16_to_planarYUVA16_Task : public Task
@@ -644,9 +1098,9 @@ static inline uint16_t denormalizeC16(const float in_val)
 #define U10MASK 0x000FFC00
 #define V10MASK 0x3FF00000
 
-void packedYUV444_10bits_to_P216(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
-                                 uint16_t* FASTMEMCPYRESTRICT outBufY, uint16_t* FASTMEMCPYRESTRICT outBufCbCy, size_t inBufStride,
-                                 size_t outBufStride, bool flip)
+static void packedYUV444_10bits_to_P216_scalar(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                               uint16_t* FASTMEMCPYRESTRICT outBufY, uint16_t* FASTMEMCPYRESTRICT outBufCbCy,
+                                               size_t inBufStride, size_t outBufStride, bool flip)
 {
     const size_t nbPixelsPerLoop = 2;
     const size_t nbPixelGroups = width / nbPixelsPerLoop;
@@ -673,6 +1127,141 @@ void packedYUV444_10bits_to_P216(size_t width, size_t height, const uint32_t* FA
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  Vector versions of normalizeXX() followed by denormalizeXX16(). The
+//  operations (separate multiply and add, clamp, add 0.5 and truncate)
+//  are the same as the scalar ones so the results are bit identical.
+//
+
+TWKFB_TARGET_SSE41 static inline __m128i rescale10to16_SSE41(__m128i v, float inScale, float inOffset, float outScale, float outOffset)
+{
+    __m128 f = _mm_cvtepi32_ps(v);
+    f = _mm_add_ps(_mm_mul_ps(f, _mm_set1_ps(inScale)), _mm_set1_ps(inOffset));
+    f = _mm_add_ps(_mm_mul_ps(f, _mm_set1_ps(outScale)), _mm_set1_ps(outOffset));
+    f = _mm_min_ps(_mm_max_ps(f, _mm_setzero_ps()), _mm_set1_ps(65535.0f));
+    return _mm_cvttps_epi32(_mm_add_ps(f, _mm_set1_ps(0.5f)));
+}
+
+TWKFB_TARGET_AVX2 static inline __m256i rescale10to16_AVX2(__m256i v, float inScale, float inOffset, float outScale, float outOffset)
+{
+    __m256 f = _mm256_cvtepi32_ps(v);
+    f = _mm256_add_ps(_mm256_mul_ps(f, _mm256_set1_ps(inScale)), _mm256_set1_ps(inOffset));
+    f = _mm256_add_ps(_mm256_mul_ps(f, _mm256_set1_ps(outScale)), _mm256_set1_ps(outOffset));
+    f = _mm256_min_ps(_mm256_max_ps(f, _mm256_setzero_ps()), _mm256_set1_ps(65535.0f));
+    return _mm256_cvttps_epi32(_mm256_add_ps(f, _mm256_set1_ps(0.5f)));
+}
+
+#define Y10_TO_Y16_ARGS 1.0f / (940.0f - 64.0f), -64.0f / (940.0f - 64.0f), 60160.0f - 4096.0f, 4096.0f
+#define C10_TO_C16_ARGS 1.0f / (960.0f - 64.0f), -512.0f / (960.0f - 64.0f), 61440.0f - 4096.0f, 32768.0f
+
+TWKFB_TARGET_SSE41 static void packedYUV444_10bits_to_P216_SSE41(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outBufY,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outBufCbCy, size_t inBufStride,
+                                                                 size_t outBufStride, bool flip)
+{
+    const size_t nbPixelGroups = width / 2;
+    const __m128i mask = _mm_set1_epi32(0x3FF);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        size_t input_y = flip ? (height - 1 - y) : y;
+        const uint32_t* inYUV = reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(inBuf) + input_y * inBufStride);
+        uint16_t* outY = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(outBufY) + y * outBufStride);
+        uint16_t* outCbCr = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(outBufCbCy) + y * outBufStride);
+        size_t i = 0;
+
+        for (; i + 4 <= nbPixelGroups; i += 4, inYUV += 8, outY += 8, outCbCr += 8)
+        {
+            const __m128i w0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inYUV));
+            const __m128i w1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inYUV + 4));
+
+            const __m128i y0 = rescale10to16_SSE41(_mm_and_si128(w0, mask), Y10_TO_Y16_ARGS);
+            const __m128i y1 = rescale10to16_SSE41(_mm_and_si128(w1, mask), Y10_TO_Y16_ARGS);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outY), _mm_packus_epi32(y0, y1));
+
+            // Cb Cr of the even pixels only
+            const __m128i cb0 = _mm_and_si128(_mm_srli_epi32(w0, 10), mask);
+            const __m128i cr0 = _mm_and_si128(_mm_srli_epi32(w0, 20), mask);
+            const __m128i cb1 = _mm_and_si128(_mm_srli_epi32(w1, 10), mask);
+            const __m128i cr1 = _mm_and_si128(_mm_srli_epi32(w1, 20), mask);
+            const __m128i c0 = _mm_unpacklo_epi64(_mm_unpacklo_epi32(cb0, cr0), _mm_unpackhi_epi32(cb0, cr0));
+            const __m128i c1 = _mm_unpacklo_epi64(_mm_unpacklo_epi32(cb1, cr1), _mm_unpackhi_epi32(cb1, cr1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outCbCr),
+                             _mm_packus_epi32(rescale10to16_SSE41(c0, C10_TO_C16_ARGS), rescale10to16_SSE41(c1, C10_TO_C16_ARGS)));
+        }
+
+        packedYUV444_10bits_to_P216_scalar((nbPixelGroups - i) * 2, 1, inYUV, outY, outCbCr, 0, 0, false);
+    }
+}
+
+TWKFB_TARGET_AVX2 static void packedYUV444_10bits_to_P216_AVX2(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                                               uint16_t* FASTMEMCPYRESTRICT outBufY, uint16_t* FASTMEMCPYRESTRICT outBufCbCy,
+                                                               size_t inBufStride, size_t outBufStride, bool flip)
+{
+    const size_t nbPixelGroups = width / 2;
+    const __m256i mask = _mm256_set1_epi32(0x3FF);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        size_t input_y = flip ? (height - 1 - y) : y;
+        const uint32_t* inYUV = reinterpret_cast<const uint32_t*>(reinterpret_cast<const uint8_t*>(inBuf) + input_y * inBufStride);
+        uint16_t* outY = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(outBufY) + y * outBufStride);
+        uint16_t* outCbCr = reinterpret_cast<uint16_t*>(reinterpret_cast<uint8_t*>(outBufCbCy) + y * outBufStride);
+        size_t i = 0;
+
+        for (; i + 8 <= nbPixelGroups; i += 8, inYUV += 16, outY += 16, outCbCr += 16)
+        {
+            const __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inYUV));
+            const __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inYUV + 8));
+
+            const __m256i y0 = rescale10to16_AVX2(_mm256_and_si256(w0, mask), Y10_TO_Y16_ARGS);
+            const __m256i y1 = rescale10to16_AVX2(_mm256_and_si256(w1, mask), Y10_TO_Y16_ARGS);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(outY), _mm256_permute4x64_epi64(_mm256_packus_epi32(y0, y1), 0xD8));
+
+            // Cb Cr of the even pixels only
+            const __m256i cb0 = _mm256_and_si256(_mm256_srli_epi32(w0, 10), mask);
+            const __m256i cr0 = _mm256_and_si256(_mm256_srli_epi32(w0, 20), mask);
+            const __m256i cb1 = _mm256_and_si256(_mm256_srli_epi32(w1, 10), mask);
+            const __m256i cr1 = _mm256_and_si256(_mm256_srli_epi32(w1, 20), mask);
+            const __m256i c0 = _mm256_unpacklo_epi64(_mm256_unpacklo_epi32(cb0, cr0), _mm256_unpackhi_epi32(cb0, cr0));
+            const __m256i c1 = _mm256_unpacklo_epi64(_mm256_unpacklo_epi32(cb1, cr1), _mm256_unpackhi_epi32(cb1, cr1));
+            const __m256i c = _mm256_packus_epi32(rescale10to16_AVX2(c0, C10_TO_C16_ARGS), rescale10to16_AVX2(c1, C10_TO_C16_ARGS));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(outCbCr), _mm256_permute4x64_epi64(c, 0xD8));
+        }
+
+        packedYUV444_10bits_to_P216_scalar((nbPixelGroups - i) * 2, 1, inYUV, outY, outCbCr, 0, 0, false);
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void packedYUV444_10bits_to_P216(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
+                                 uint16_t* FASTMEMCPYRESTRICT outBufY, uint16_t* FASTMEMCPYRESTRICT outBufCbCy, size_t inBufStride,
+                                 size_t outBufStride, bool flip)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        packedYUV444_10bits_to_P216_AVX2(width, height, inBuf, outBufY, outBufCbCy, inBufStride, outBufStride, flip);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        packedYUV444_10bits_to_P216_SSE41(width, height, inBuf, outBufY, outBufCbCy, inBufStride, outBufStride, flip);
+        return;
+    }
+#endif
+
+    packedYUV444_10bits_to_P216_scalar(width, height, inBuf, outBufY, outBufCbCy, inBufStride, outBufStride, flip);
+}
+
 //------------------------------------------------------------------------------
 //
 class PackedYUV444_10bits_to_P216_Task : public Task
@@ -752,8 +1341,8 @@ void packedYUV444_10bits_to_P216_MP(size_t width, size_t height, const uint32_t*
 // from packed BGRA with 16 bits BE per component to packed ABGR with 16 bits LE
 // per component.
 //
-void packedBGRA64BE_to_packedABGR64LE(size_t inStride, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
-                                      uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
+static void packedBGRA64BE_to_packedABGR64LE_scalar(size_t inStride, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                                    uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
 {
     // Big endian to little endiant
     const size_t nbPixelsPerRow = std::min(inStride, outStride) / 8;
@@ -771,6 +1360,112 @@ void packedBGRA64BE_to_packedABGR64LE(size_t inStride, size_t height, const uint
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  The byte swap and component reorder above is a fixed permutation of
+//  the 8 bytes of each pixel so it is a single byte shuffle per register.
+//
+
+TWKFB_TARGET_SSE41 static void packedBGRA64BE_to_packedABGR64LE_SSE41(size_t inStride, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                                                      uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
+{
+    const __m128i shuf = _mm_setr_epi8(3, 2, 5, 4, 7, 6, 1, 0, 11, 10, 13, 12, 15, 14, 9, 8);
+    const size_t nbPixelsPerRow = std::min(inStride, outStride) / 8;
+
+    for (size_t line = 0; line < height; line++)
+    {
+        size_t i = 0;
+
+        for (; i + 2 <= nbPixelsPerRow; i += 2)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(outBuf + i), _mm_shuffle_epi8(a, shuf));
+        }
+
+        packedBGRA64BE_to_packedABGR64LE_scalar((nbPixelsPerRow - i) * 8, 1, inBuf + i, outBuf + i, (nbPixelsPerRow - i) * 8);
+        inBuf += (inStride / 8);
+        outBuf += (outStride / 8);
+    }
+}
+
+TWKFB_TARGET_AVX2 static void packedBGRA64BE_to_packedABGR64LE_AVX2(size_t inStride, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                                                    uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
+{
+    const __m256i shuf = _mm256_setr_epi8(3, 2, 5, 4, 7, 6, 1, 0, 11, 10, 13, 12, 15, 14, 9, 8, 3, 2, 5, 4, 7, 6, 1, 0, 11, 10, 13, 12, 15,
+                                          14, 9, 8);
+    const size_t nbPixelsPerRow = std::min(inStride, outStride) / 8;
+
+    for (size_t line = 0; line < height; line++)
+    {
+        size_t i = 0;
+
+        for (; i + 4 <= nbPixelsPerRow; i += 4)
+        {
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(outBuf + i), _mm256_shuffle_epi8(a, shuf));
+        }
+
+        packedBGRA64BE_to_packedABGR64LE_scalar((nbPixelsPerRow - i) * 8, 1, inBuf + i, outBuf + i, (nbPixelsPerRow - i) * 8);
+        inBuf += (inStride / 8);
+        outBuf += (outStride / 8);
+    }
+}
+
+TWKFB_TARGET_AVX512 static void packedBGRA64BE_to_packedABGR64LE_AVX512(size_t inStride, size_t height,
+                                                                        const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                                                        uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
+{
+    const __m512i shuf = _mm512_set4_epi32(0x08090E0F, 0x0C0D0A0B, 0x00010607, 0x04050203);
+    const size_t nbPixelsPerRow = std::min(inStride, outStride) / 8;
+
+    for (size_t line = 0; line < height; line++)
+    {
+        size_t i = 0;
+
+        for (; i + 8 <= nbPixelsPerRow; i += 8)
+        {
+            const __m512i a = _mm512_loadu_si512(inBuf + i);
+            _mm512_storeu_si512(outBuf + i, _mm512_shuffle_epi8(a, shuf));
+        }
+
+        packedBGRA64BE_to_packedABGR64LE_scalar((nbPixelsPerRow - i) * 8, 1, inBuf + i, outBuf + i, (nbPixelsPerRow - i) * 8);
+        inBuf += (inStride / 8);
+        outBuf += (outStride / 8);
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void packedBGRA64BE_to_packedABGR64LE(size_t inStride, size_t height, const uint64_t* FASTMEMCPYRESTRICT inBuf,
+                                      uint64_t* FASTMEMCPYRESTRICT outBuf, size_t outStride)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX512)
+    {
+        packedBGRA64BE_to_packedABGR64LE_AVX512(inStride, height, inBuf, outBuf, outStride);
+        return;
+    }
+    else if (level >= TwkFB::SIMDAVX2)
+    {
+        packedBGRA64BE_to_packedABGR64LE_AVX2(inStride, height, inBuf, outBuf, outStride);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        packedBGRA64BE_to_packedABGR64LE_SSE41(inStride, height, inBuf, outBuf, outStride);
+        return;
+    }
+#endif
+
+    packedBGRA64BE_to_packedABGR64LE_scalar(inStride, height, inBuf, outBuf, outStride);
+}
+
 //------------------------------------------------------------------------------
 //
 class PackedBGRA64BE_to_packedABGR64LETask : public Task
@@ -847,9 +1542,9 @@ void packedBGRA64BE_to_packedABGR64LE_MP(size_t width, size_t height, const uint
 // AV_PIX_FMT_YUV422P16LE - planar YUV 4:2:2, 32bpp, (1 Cr &
 // Cb sample per 2x1 Y samples), little-endian
 //
-void planarP210_to_planarYUV422P16(size_t width, size_t height, const uint16_t* inY, const uint16_t* inCbCr, size_t inStrideY,
-                                   size_t inStrideCbCr, uint16_t* outY, uint16_t* outCb, uint16_t* outCr, size_t outStrideY,
-                                   size_t outStrideCb, size_t outStrideCr)
+static void planarP210_to_planarYUV422P16_scalar(size_t width, size_t height, const uint16_t* inY, const uint16_t* inCbCr,
+                                                 size_t inStrideY, size_t inStrideCbCr, uint16_t* outY, uint16_t* outCb, uint16_t* outCr,
+                                                 size_t outStrideY, size_t outStrideCb, size_t outStrideCr)
 {
     const size_t nbPixelGroups = width / 2;
     const uint16_t* FASTMEMCPYRESTRICT startInY = inY;
@@ -887,6 +1582,124 @@ void planarP210_to_planarYUV422P16(size_t width, size_t height, const uint16_t*
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  The P210 samples are in the top 10 bits of each 16 bit value so a
+//  16 bit shift replaces the mask and shift. The values are widened to
+//  32 bits for the float rescale and narrowed back with a saturating
+//  pack (the rescale already clamps to [0, 65535]).
+//
+
+TWKFB_TARGET_SSE41 static inline __m128i rescaleP210_SSE41(__m128i v)
+{
+    v = _mm_srli_epi16(v, 6);
+    const __m128i lo = rescale10to16_SSE41(_mm_cvtepu16_epi32(v), Y10_TO_Y16_ARGS);
+    const __m128i hi = rescale10to16_SSE41(_mm_cvtepu16_epi32(_mm_srli_si128(v, 8)), Y10_TO_Y16_ARGS);
+    return _mm_packus_epi32(lo, hi);
+}
+
+TWKFB_TARGET_AVX2 static inline __m256i rescaleP210_AVX2(__m256i v)
+{
+    v = _mm256_srli_epi16(v, 6);
+    const __m256i lo = rescale10to16_AVX2(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)), Y10_TO_Y16_ARGS);
+    const __m256i hi = rescale10to16_AVX2(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)), Y10_TO_Y16_ARGS);
+    return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xD8);
+}
+
+TWKFB_TARGET_SSE41 static void planarP210_to_planarYUV422P16_SSE41(size_t width, size_t height, const uint16_t* inY, const uint16_t* inCbCr,
+                                                                   size_t inStrideY, size_t inStrideCbCr, uint16_t* outY, uint16_t* outCb,
+                                                                   uint16_t* outCr, size_t outStrideY, size_t outStrideCb,
+                                                                   size_t outStrideCr)
+{
+    const size_t nbPixelGroups = width / 2;
+    const __m128i split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        const uint16_t* FASTMEMCPYRESTRICT y0 = inY + i * inStrideY / 2;
+        const uint16_t* FASTMEMCPYRESTRICT c0 = inCbCr + i * inStrideCbCr / 2;
+        uint16_t* FASTMEMCPYRESTRICT y1 = outY + i * outStrideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb1 = outCb + i * outStrideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr1 = outCr + i * outStrideCr / 2;
+        size_t j = 0;
+
+        for (; j + 4 <= nbPixelGroups; j += 4, y0 += 8, c0 += 8, y1 += 8, cb1 += 4, cr1 += 4)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y1), rescaleP210_SSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y0))));
+
+            const __m128i c = _mm_shuffle_epi8(rescaleP210_SSE41(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c0))), split);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cb1), c);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(cr1), _mm_srli_si128(c, 8));
+        }
+
+        planarP210_to_planarYUV422P16_scalar((nbPixelGroups - j) * 2, 1, y0, c0, 0, 0, y1, cb1, cr1, 0, 0, 0);
+    }
+}
+
+TWKFB_TARGET_AVX2 static void planarP210_to_planarYUV422P16_AVX2(size_t width, size_t height, const uint16_t* inY, const uint16_t* inCbCr,
+                                                                 size_t inStrideY, size_t inStrideCbCr, uint16_t* outY, uint16_t* outCb,
+                                                                 uint16_t* outCr, size_t outStrideY, size_t outStrideCb,
+                                                                 size_t outStrideCr)
+{
+    const size_t nbPixelGroups = width / 2;
+    const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15, 0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10,
+                                           11, 14, 15);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        const uint16_t* FASTMEMCPYRESTRICT y0 = inY + i * inStrideY / 2;
+        const uint16_t* FASTMEMCPYRESTRICT c0 = inCbCr + i * inStrideCbCr / 2;
+        uint16_t* FASTMEMCPYRESTRICT y1 = outY + i * outStrideY / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb1 = outCb + i * outStrideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr1 = outCr + i * outStrideCr / 2;
+        size_t j = 0;
+
+        for (; j + 8 <= nbPixelGroups; j += 8, y0 += 16, c0 += 16, y1 += 16, cb1 += 8, cr1 += 8)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(y1),
+                                rescaleP210_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(y0))));
+
+            const __m256i c = _mm256_permute4x64_epi64(
+                _mm256_shuffle_epi8(rescaleP210_AVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0))), split), 0xD8);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cb1), _mm256_castsi256_si128(c));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cr1), _mm256_extracti128_si256(c, 1));
+        }
+
+        planarP210_to_planarYUV422P16_scalar((nbPixelGroups - j) * 2, 1, y0, c0, 0, 0, y1, cb1, cr1, 0, 0, 0);
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void planarP210_to_planarYUV422P16(size_t width, size_t height, const uint16_t* inY, const uint16_t* inCbCr, size_t inStrideY,
+                                   size_t inStrideCbCr, uint16_t* outY, uint16_t* outCb, uint16_t* outCr, size_t outStrideY,
+                                   size_t outStrideCb, size_t outStrideCr)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        planarP210_to_planarYUV422P16_AVX2(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY,
+                                           outStrideCb, outStrideCr);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        planarP210_to_planarYUV422P16_SSE41(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY,
+                                            outStrideCb, outStrideCr);
+        return;
+    }
+#endif
+
+    planarP210_to_planarYUV422P16_scalar(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY, outStrideCb,
+                                         outStrideCr);
+}
+
 //------------------------------------------------------------------------------
 // Converts semi-planar format P416 to planar YUV 444 16-bits.
 //
@@ -900,10 +1713,11 @@ void planarP210_to_planarYUV422P16(size_t width, size_t height, const uint16_t*
 // AV_PIX_FMT_YUV444P16LE - planar YUV 4:4:4, 48bpp, (1 Cr & Cb sample per 1x1 Y
 // samples), little-endian
 //
-void planarP416_to_planarYUV444P16(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inY,
-                                   const uint16_t* FASTMEMCPYRESTRICT inCbCr, size_t inStrideY, size_t inStrideCbCr,
-                                   uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
-                                   uint16_t* FASTMEMCPYRESTRICT outCr, size_t outStrideY, size_t outStrideCb, size_t outStrideCr)
+static void planarP416_to_planarYUV444P16_scalar(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inY,
+                                                 const uint16_t* FASTMEMCPYRESTRICT inCbCr, size_t inStrideY, size_t inStrideCbCr,
+                                                 uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                                 uint16_t* FASTMEMCPYRESTRICT outCr, size_t outStrideY, size_t outStrideCb,
+                                                 size_t outStrideCr)
 {
     const size_t nbPixelGroups = width;
     const uint16_t* FASTMEMCPYRESTRICT startInY = inY;
@@ -934,6 +1748,111 @@ void planarP416_to_planarYUV444P16(size_t width, size_t height, const uint16_t*
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  The Y plane is a straight copy, the CbCr plane is split in two with
+//  a byte shuffle (CbCrCbCr... -> CbCb..CrCr..) and 64 bit unpacks.
+//
+
+TWKFB_TARGET_SSE41 static void planarP416_to_planarYUV444P16_SSE41(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inY,
+                                                                   const uint16_t* FASTMEMCPYRESTRICT inCbCr, size_t inStrideY,
+                                                                   size_t inStrideCbCr, uint16_t* FASTMEMCPYRESTRICT outY,
+                                                                   uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr,
+                                                                   size_t outStrideY, size_t outStrideCb, size_t outStrideCr)
+{
+    const __m128i split = _mm_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        const uint16_t* FASTMEMCPYRESTRICT c0 = inCbCr + i * inStrideCbCr / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb1 = outCb + i * outStrideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr1 = outCr + i * outStrideCr / 2;
+        size_t j = 0;
+
+        memcpy(outY + i * outStrideY / 2, inY + i * inStrideY / 2, width * sizeof(uint16_t));
+
+        for (; j + 8 <= width; j += 8, c0 += 16)
+        {
+            const __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c0)), split);
+            const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(c0 + 8)), split);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cb1 + j), _mm_unpacklo_epi64(a, b));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cr1 + j), _mm_unpackhi_epi64(a, b));
+        }
+
+        for (; j < width; ++j, c0 += 2)
+        {
+            cb1[j] = c0[0];
+            cr1[j] = c0[1];
+        }
+    }
+}
+
+TWKFB_TARGET_AVX2 static void planarP416_to_planarYUV444P16_AVX2(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inY,
+                                                                 const uint16_t* FASTMEMCPYRESTRICT inCbCr, size_t inStrideY,
+                                                                 size_t inStrideCbCr, uint16_t* FASTMEMCPYRESTRICT outY,
+                                                                 uint16_t* FASTMEMCPYRESTRICT outCb, uint16_t* FASTMEMCPYRESTRICT outCr,
+                                                                 size_t outStrideY, size_t outStrideCb, size_t outStrideCr)
+{
+    const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15, 0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10,
+                                           11, 14, 15);
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        const uint16_t* FASTMEMCPYRESTRICT c0 = inCbCr + i * inStrideCbCr / 2;
+        uint16_t* FASTMEMCPYRESTRICT cb1 = outCb + i * outStrideCb / 2;
+        uint16_t* FASTMEMCPYRESTRICT cr1 = outCr + i * outStrideCr / 2;
+        size_t j = 0;
+
+        memcpy(outY + i * outStrideY / 2, inY + i * inStrideY / 2, width * sizeof(uint16_t));
+
+        for (; j + 16 <= width; j += 16, c0 += 32)
+        {
+            const __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0)), split);
+            const __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(c0 + 16)), split);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(cb1 + j), _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(cr1 + j), _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8));
+        }
+
+        for (; j < width; ++j, c0 += 2)
+        {
+            cb1[j] = c0[0];
+            cr1[j] = c0[1];
+        }
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void planarP416_to_planarYUV444P16(size_t width, size_t height, const uint16_t* FASTMEMCPYRESTRICT inY,
+                                   const uint16_t* FASTMEMCPYRESTRICT inCbCr, size_t inStrideY, size_t inStrideCbCr,
+                                   uint16_t* FASTMEMCPYRESTRICT outY, uint16_t* FASTMEMCPYRESTRICT outCb,
+                                   uint16_t* FASTMEMCPYRESTRICT outCr, size_t outStrideY, size_t outStrideCb, size_t outStrideCr)
+{
+#if defined(TWKFB_SIMD_X86)
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        planarP416_to_planarYUV444P16_AVX2(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY,
+                                           outStrideCb, outStrideCr);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        planarP416_to_planarYUV444P16_SSE41(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY,
+                                            outStrideCb, outStrideCr);
+        return;
+    }
+#endif
+
+    planarP416_to_planarYUV444P16_scalar(width, height, inY, inCbCr, inStrideY, inStrideCbCr, outY, outCb, outCr, outStrideY, outStrideCb,
+                                         outStrideCr);
+}
+
 //------------------------------------------------------------------------------
 // Converts packed format AYUV 64-bits (16 bits per components) to planar YUVA
 // 4444 16-bits.
@@ -963,9 +1882,28 @@ void packedAYUV64_to_planarYUVA16(std::size_t width, std::size_t height, const u
 
 #pragma pack(pop)
 
+    std::size_t pixelCount = width * height;
+
+#if defined(TWKFB_SIMD_X86)
+    //
+    //  Same memory layout as UVYA (A is the least significant component)
+    //
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX2)
+    {
+        deinterleave4x16_AVX2(reinterpret_cast<const uint16_t*>(inBuf), pixelCount, outA, outY, outCb, outCr);
+        return;
+    }
+    else if (level >= TwkFB::SIMDSSE41)
+    {
+        deinterleave4x16_SSE41(reinterpret_cast<const uint16_t*>(inBuf), pixelCount, outA, outY, outCb, outCr);
+        return;
+    }
+#endif
+
     const auto* pixelsBuf = reinterpret_cast<const components*>(inBuf);
 
-    std::size_t pixelCount = width * height;
     for (std::size_t i = 0; i < pixelCount; ++i)
     {
         outA[i] = pixelsBuf[i].A;
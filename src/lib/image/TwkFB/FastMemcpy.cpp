@@ -16,6 +16,7 @@
 #include <TwkFB/FastMemcpy.h>
 
 #include <TwkFB/TwkFBThreadPool.h>
+#include <TwkFB/SIMD.h>
 #include <TwkUtil/sgcHop.h>
 
 #include <cstring> // for memcpy()
@@ -306,7 +307,8 @@ void* FastMemcpy_MP(void* FASTMEMCPYRESTRICT outBuf, const void* FASTMEMCPYRESTR
 //  interpolating. Not the best way to do this.
 //
 
-void subsample422_8bit_UYVY(size_t width, size_t height, const uint8_t* FASTMEMCPYRESTRICT inBuf, uint8_t* FASTMEMCPYRESTRICT outBuf)
+static void subsample422_8bit_UYVY_scalar(size_t width, size_t height, const uint8_t* FASTMEMCPYRESTRICT inBuf,
+                                          uint8_t* FASTMEMCPYRESTRICT outBuf)
 {
     uint8_t* FASTMEMCPYRESTRICT p1 = outBuf;
 
@@ -350,6 +352,110 @@ void subsample422_8bit_UYVY(size_t width, size_t height, const uint8_t* FASTMEMC
     }
 }
 
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  Vector versions of the width % 6 == 0 case above. Each 6 byte group
+//  (two 444 pixels) becomes 4 bytes so we shuffle 4 groups (24 bytes)
+//  into 16 bytes per SSE iteration and 8 groups into 32 bytes per AVX2
+//  iteration. The two halves of the input are loaded separately so
+//  that no load ever reads past the end of the row.
+//
+
+static inline void subsample422_8bit_UYVY_group(const uint8_t* FASTMEMCPYRESTRICT p0, uint8_t* FASTMEMCPYRESTRICT p1)
+{
+    p1[0] = p0[1];
+    p1[1] = p0[0];
+    p1[2] = p0[2];
+    p1[3] = p0[3];
+}
+
+TWKFB_TARGET_SSE41 static void subsample422_8bit_UYVY_SSE41(size_t width, size_t height, const uint8_t* FASTMEMCPYRESTRICT inBuf,
+                                                            uint8_t* FASTMEMCPYRESTRICT outBuf)
+{
+    const __m128i maskLo = _mm_setr_epi8(1, 0, 2, 3, 7, 6, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i maskHi = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 5, 4, 6, 7, 11, 10, 12, 13);
+    const size_t groups = width / 2;
+
+    uint8_t* FASTMEMCPYRESTRICT p1 = outBuf;
+
+    for (size_t row = 0; row < height; row++)
+    {
+        const uint8_t* FASTMEMCPYRESTRICT p0 = inBuf + row * 3 * width;
+        size_t g = 0;
+
+        for (; g + 4 <= groups; g += 4, p0 += 24, p1 += 16)
+        {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 8));
+            const __m128i out = _mm_or_si128(_mm_shuffle_epi8(lo, maskLo), _mm_shuffle_epi8(hi, maskHi));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p1), out);
+        }
+
+        for (; g < groups; g++, p0 += 6, p1 += 4)
+            subsample422_8bit_UYVY_group(p0, p1);
+    }
+}
+
+TWKFB_TARGET_AVX2 static void subsample422_8bit_UYVY_AVX2(size_t width, size_t height, const uint8_t* FASTMEMCPYRESTRICT inBuf,
+                                                          uint8_t* FASTMEMCPYRESTRICT outBuf)
+{
+    const __m256i maskLo = _mm256_setr_epi8(1, 0, 2, 3, 7, 6, 8, 9, -1, -1, -1, -1, -1, -1, -1, -1, 1, 0, 2, 3, 7, 6, 8, 9, -1, -1, -1, -1,
+                                            -1, -1, -1, -1);
+    const __m256i maskHi = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 5, 4, 6, 7, 11, 10, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1, 5,
+                                            4, 6, 7, 11, 10, 12, 13);
+    const size_t groups = width / 2;
+
+    uint8_t* FASTMEMCPYRESTRICT p1 = outBuf;
+
+    for (size_t row = 0; row < height; row++)
+    {
+        const uint8_t* FASTMEMCPYRESTRICT p0 = inBuf + row * 3 * width;
+        size_t g = 0;
+
+        for (; g + 8 <= groups; g += 8, p0 += 48, p1 += 32)
+        {
+            const __m256i lo = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0))),
+                                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 24)), 1);
+            const __m256i hi = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 8))),
+                                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(p0 + 32)), 1);
+            const __m256i out = _mm256_or_si256(_mm256_shuffle_epi8(lo, maskLo), _mm256_shuffle_epi8(hi, maskHi));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p1), out);
+        }
+
+        for (; g < groups; g++, p0 += 6, p1 += 4)
+            subsample422_8bit_UYVY_group(p0, p1);
+    }
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void subsample422_8bit_UYVY(size_t width, size_t height, const uint8_t* FASTMEMCPYRESTRICT inBuf, uint8_t* FASTMEMCPYRESTRICT outBuf)
+{
+#if defined(TWKFB_SIMD_X86)
+    if (width % 6 == 0)
+    {
+        const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+        if (level >= TwkFB::SIMDAVX2)
+        {
+            subsample422_8bit_UYVY_AVX2(width, height, inBuf, outBuf);
+            return;
+        }
+        else if (level >= TwkFB::SIMDSSE41)
+        {
+            subsample422_8bit_UYVY_SSE41(width, height, inBuf, outBuf);
+            return;
+        }
+    }
+#endif
+
+    subsample422_8bit_UYVY_scalar(width, height, inBuf, outBuf);
+}
+
 //------------------------------------------------------------------------------
 //
 class Subsample422_8bit_UYVY_Task : public Task
@@ -564,19 +670,126 @@ void subsample422_10bit_MP(size_t width, size_t height, const uint32_t* FASTMEMC
 
 //------------------------------------------------------------------------------
 //
-void swap_bytes_32bit(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint32_t* FASTMEMCPYRESTRICT outBuf)
+//  The swap kernels read each word before writing it back so inBuf and
+//  outBuf may be the same buffer; they are not declared restrict.
+//
+static void swap_bytes_32bit_scalar(size_t n, const uint32_t* inBuf, uint32_t* outBuf)
 {
-    uint32_t* FASTMEMCPYRESTRICT p1 = outBuf;
+    for (size_t i = 0; i < n; i++)
+    {
+        const uint32_t a = inBuf[i];
+        outBuf[i] = ((a & 0x000000FF) << 24) | ((a & 0x0000FF00) << 8) | ((a & 0x00FF0000) >> 8) | ((a & 0xFF000000) >> 24);
+    }
+}
 
-    for (size_t row = 0; row < height; row++)
+static void swap_bytes_16bit_scalar(size_t n, const uint16_t* inBuf, uint16_t* outBuf)
+{
+    for (size_t i = 0; i < n; i++)
     {
-        for (const uint32_t *FASTMEMCPYRESTRICT p0 = inBuf + row * width, *FASTMEMCPYRESTRICT e = p0 + width; p0 < e; p0++)
-        {
-            const uint32_t a = *p0;
-            *p1 = ((a & 0x000000FF) << 24) | ((a & 0x0000FF00) << 8) | ((a & 0x00FF0000) >> 8) | ((a & 0xFF000000) >> 24);
-            p1++;
-        }
+        const uint16_t a = inBuf[i];
+        outBuf[i] = uint16_t((a << 8) | (a >> 8));
+    }
+}
+
+#if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+//  The rows are contiguous so the vector versions treat the buffer as
+//  one long run of bytes and shuffle whole registers with the given
+//  16 byte pattern. They return the number of bytes done; the caller
+//  finishes the tail.
+//
+
+static const int8_t swap32Pattern[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+static const int8_t swap16Pattern[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+
+TWKFB_TARGET_SSE41 static size_t shuffle_bytes_SSE41(size_t n, const uint8_t* inBuf, uint8_t* outBuf, const int8_t* pattern)
+{
+    const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16)
+    {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inBuf + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outBuf + i), _mm_shuffle_epi8(a, mask));
+    }
+
+    return i;
+}
+
+TWKFB_TARGET_AVX2 static size_t shuffle_bytes_AVX2(size_t n, const uint8_t* inBuf, uint8_t* outBuf, const int8_t* pattern)
+{
+    const __m256i mask = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern)));
+    size_t i = 0;
+
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inBuf + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(outBuf + i), _mm256_shuffle_epi8(a, mask));
+    }
+
+    return i;
+}
+
+TWKFB_TARGET_AVX512 static size_t shuffle_bytes_AVX512(size_t n, const uint8_t* inBuf, uint8_t* outBuf, const int8_t* pattern)
+{
+    const __m512i mask = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern)));
+    size_t i = 0;
+
+    for (; i + 64 <= n; i += 64)
+    {
+        const __m512i a = _mm512_loadu_si512(inBuf + i);
+        _mm512_storeu_si512(outBuf + i, _mm512_shuffle_epi8(a, mask));
     }
+
+    return i;
+}
+
+static size_t shuffle_bytes(size_t n, const uint8_t* inBuf, uint8_t* outBuf, const int8_t* pattern)
+{
+    const TwkFB::SIMDLevel level = TwkFB::simdLevel();
+
+    if (level >= TwkFB::SIMDAVX512)
+        return shuffle_bytes_AVX512(n, inBuf, outBuf, pattern);
+    else if (level >= TwkFB::SIMDAVX2)
+        return shuffle_bytes_AVX2(n, inBuf, outBuf, pattern);
+    else if (level >= TwkFB::SIMDSSE41)
+        return shuffle_bytes_SSE41(n, inBuf, outBuf, pattern);
+
+    return 0;
+}
+
+#endif // #if defined(TWKFB_SIMD_X86)
+
+//------------------------------------------------------------------------------
+//
+void swap_bytes_32bit(size_t width, size_t height, const uint32_t* inBuf, uint32_t* outBuf)
+{
+    const size_t n = width * height;
+    size_t i = 0;
+
+#if defined(TWKFB_SIMD_X86)
+    i = shuffle_bytes(n * sizeof(uint32_t), reinterpret_cast<const uint8_t*>(inBuf), reinterpret_cast<uint8_t*>(outBuf), swap32Pattern)
+        / sizeof(uint32_t);
+#endif
+
+    swap_bytes_32bit_scalar(n - i, inBuf + i, outBuf + i);
+}
+
+//------------------------------------------------------------------------------
+//
+void swap_bytes_16bit(size_t width, size_t height, const uint16_t* inBuf, uint16_t* outBuf)
+{
+    const size_t n = width * height;
+    size_t i = 0;
+
+#if defined(TWKFB_SIMD_X86)
+    i = shuffle_bytes(n * sizeof(uint16_t), reinterpret_cast<const uint8_t*>(inBuf), reinterpret_cast<uint8_t*>(outBuf), swap16Pattern)
+        / sizeof(uint16_t);
+#endif
+
+    swap_bytes_16bit_scalar(n - i, inBuf + i, outBuf + i);
 }
 
 //------------------------------------------------------------------------------
@@ -584,8 +797,7 @@ void swap_bytes_32bit(size_t width, size_t height, const uint32_t* FASTMEMCPYRES
 class Swap_bytes_32bit_Task : public Task
 {
 public:
-    Swap_bytes_32bit_Task(TaskGroup* group, size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
-                          uint32_t* FASTMEMCPYRESTRICT outBuf)
+    Swap_bytes_32bit_Task(TaskGroup* group, size_t width, size_t height, const uint32_t* inBuf, uint32_t* outBuf)
         : Task(group)
         , _width(width)
         , _height(height)
@@ -600,16 +812,45 @@ public:
 
     const size_t _width;
     const size_t _height;
-    const uint32_t* FASTMEMCPYRESTRICT _inBuf;
-    uint32_t* FASTMEMCPYRESTRICT _outBuf;
+    const uint32_t* _inBuf;
+    uint32_t* _outBuf;
 };
 
 //------------------------------------------------------------------------------
 //
-void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf, uint32_t* FASTMEMCPYRESTRICT outBuf)
+class Swap_bytes_16bit_Task : public Task
 {
+public:
+    Swap_bytes_16bit_Task(TaskGroup* group, size_t width, size_t height, const uint16_t* inBuf, uint16_t* outBuf)
+        : Task(group)
+        , _width(width)
+        , _height(height)
+        , _inBuf(inBuf)
+        , _outBuf(outBuf)
+    {
+    }
+
+    virtual ~Swap_bytes_16bit_Task() {}
+
+    virtual void execute() { swap_bytes_16bit(_width, _height, _inBuf, _outBuf); }
+
+    const size_t _width;
+    const size_t _height;
+    const uint16_t* _inBuf;
+    uint16_t* _outBuf;
+};
+
+//------------------------------------------------------------------------------
+//
+void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* inBuf, uint32_t* outBuf)
+{
+    //
+    //  The readers call this too, possibly before (or without) the
+    //  thread pool being initialized
+    //
+
     static bool use_standard_memcpy = getenv("RV_USE_STD_MEMCPY");
-    if (use_standard_memcpy)
+    if (use_standard_memcpy || TwkFB::ThreadPool::getNumThreads() < 2)
     {
         HOP_PROF("swap_bytes_32bit()");
         swap_bytes_32bit(width, height, inBuf, outBuf);
@@ -618,7 +859,7 @@ void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* FASTMEMCPY
 
     HOP_PROF_FUNC();
 
-    const size_t taskHeight = height / TwkFB::ThreadPool::getNumThreads();
+    const size_t taskHeight = std::max(size_t(1), height / TwkFB::ThreadPool::getNumThreads());
     const size_t bufStride = width;
 
     size_t curY = 0;
@@ -627,10 +868,41 @@ void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* FASTMEMCPY
 
     while (curY < height)
     {
-        const uint32_t* FASTMEMCPYRESTRICT curInBuf = inBuf + curY * bufStride;
-        uint32_t* FASTMEMCPYRESTRICT curOutBuf = outBuf + curY * bufStride;
+        const uint32_t* curInBuf = inBuf + curY * bufStride;
+        uint32_t* curOutBuf = outBuf + curY * bufStride;
         const size_t curHeight = std::min(taskHeight, height - curY);
         TwkFB::ThreadPool::addTask(new Swap_bytes_32bit_Task(&taskGroup, width, curHeight, curInBuf, curOutBuf));
         curY += curHeight;
     }
 }
+
+//------------------------------------------------------------------------------
+//
+void swap_bytes_16bit_MP(size_t width, size_t height, const uint16_t* inBuf, uint16_t* outBuf)
+{
+    static bool use_standard_memcpy = getenv("RV_USE_STD_MEMCPY");
+    if (use_standard_memcpy || TwkFB::ThreadPool::getNumThreads() < 2)
+    {
+        HOP_PROF("swap_bytes_16bit()");
+        swap_bytes_16bit(width, height, inBuf, outBuf);
+        return;
+    }
+
+    HOP_PROF_FUNC();
+
+    const size_t taskHeight = std::max(size_t(1), height / TwkFB::ThreadPool::getNumThreads());
+    const size_t bufStride = width;
+
+    size_t curY = 0;
+
+    TaskGroup taskGroup;
+
+    while (curY < height)
+    {
+        const uint16_t* curInBuf = inBuf + curY * bufStride;
+        uint16_t* curOutBuf = outBuf + curY * bufStride;
+        const size_t curHeight = std::min(taskHeight, height - curY);
+        TwkFB::ThreadPool::addTask(new Swap_bytes_16bit_Task(&taskGroup, width, curHeight, curInBuf, curOutBuf));
+        curY += curHeight;
+    }
+}
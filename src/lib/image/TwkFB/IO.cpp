@@ -61,6 +61,23 @@ namespace TwkFB
     {
     }
 
+    std::string FrameBufferIO::ReadRequest::partialReadIdentifier() const
+    {
+        if (!hasRegion() && !hasLevel())
+            return "";
+
+        ostringstream str;
+
+        if (hasRegion())
+            str << "#region=" << x0 << "," << y0 << "," << x1 << "," << y1;
+        if (levelX != 0 || levelY != 0)
+            str << "#level=" << levelX << "," << levelY;
+        else if (hasLevel())
+            str << "#res=" << resolution;
+
+        return str.str();
+    }
+
     std::string FrameBufferIO::ImageTypeInfo::capabilitiesAsString() const
     {
         ostringstream str;
@@ -2209,6 +2209,124 @@ namespace TwkFB
         }
     }
 
+    namespace
+    {
+
+        template <typename T> void boxDownsamplePlane(const FrameBuffer* a, FrameBuffer* b, int factor)
+        {
+            const int nc = a->numChannels();
+            const int aw = a->width();
+            const int ah = a->height();
+            vector<float> sums(size_t(b->width()) * nc);
+
+            for (int by = 0; by < b->height(); by++)
+            {
+                const int y0 = by * factor;
+                const int y1 = std::min(y0 + factor, ah);
+
+                std::fill(sums.begin(), sums.end(), 0.0f);
+
+                for (int ay = y0; ay < y1; ay++)
+                {
+                    const T* p = a->scanline<T>(ay);
+
+                    for (int ax = 0; ax < aw; ax++)
+                    {
+                        float* s = &sums[size_t(ax / factor) * nc];
+                        for (int c = 0; c < nc; c++, p++)
+                            s[c] += float(*p);
+                    }
+                }
+
+                T* q = b->scanline<T>(by);
+                const int rows = y1 - y0;
+
+                for (int bx = 0; bx < b->width(); bx++)
+                {
+                    const int cols = std::min(factor, aw - bx * factor);
+                    const float scale = 1.0f / float(rows * cols);
+                    const float* s = &sums[size_t(bx) * nc];
+
+                    for (int c = 0; c < nc; c++)
+                    {
+                        if (numeric_limits<T>::is_integer)
+                            *q++ = T(s[c] * scale + 0.5f);
+                        else
+                            *q++ = T(s[c] * scale);
+                    }
+                }
+            }
+        }
+
+    } // namespace
+
+    FrameBuffer* boxDownsample(const FrameBuffer* fb, int factor)
+    {
+        if (factor < 1 || fb->depth() > 1)
+            return 0;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+        {
+            if (p->dataType() >= FrameBuffer::PACKED_R10_G10_B10_X2 || p->dataType() == FrameBuffer::BIT
+                || p->dataType() == FrameBuffer::DOUBLE)
+            {
+                return 0;
+            }
+        }
+
+        FrameBuffer* first = 0;
+
+        for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+        {
+            const int w = (p->width() + factor - 1) / factor;
+            const int h = (p->height() + factor - 1) / factor;
+
+            FrameBuffer* np = new FrameBuffer(p->coordinateType(), w, h, 0, p->numChannels(), p->dataType(), 0, &p->channelNames(),
+                                              p->orientation(), true);
+
+            switch (p->dataType())
+            {
+            case FrameBuffer::UCHAR:
+                boxDownsamplePlane<unsigned char>(p, np, factor);
+                break;
+            case FrameBuffer::USHORT:
+                boxDownsamplePlane<unsigned short>(p, np, factor);
+                break;
+            case FrameBuffer::UINT:
+                boxDownsamplePlane<unsigned int>(p, np, factor);
+                break;
+            case FrameBuffer::HALF:
+                boxDownsamplePlane<half>(p, np, factor);
+                break;
+            case FrameBuffer::FLOAT:
+            default:
+                boxDownsamplePlane<float>(p, np, factor);
+                break;
+            }
+
+            np->setPixelAspectRatio(p->pixelAspectRatio());
+
+            if (first)
+            {
+                first->appendPlane(np);
+            }
+            else
+            {
+                first = np;
+                fb->copyAttributesTo(first);
+
+                if (fb->uncrop())
+                {
+                    first->setUncrop((fb->uncropWidth() + factor - 1) / factor, (fb->uncropHeight() + factor - 1) / factor,
+                                     fb->uncropX() / factor, fb->uncropY() / factor);
+                    first->setUncropActive(true);
+                }
+            }
+        }
+
+        return first;
+    }
+
     void scaledTransfer(const float* inpixel, float* outpixel, void* data)
     {
         float scale = *reinterpret_cast<float*>(data);
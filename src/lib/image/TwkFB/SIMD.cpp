@@ -0,0 +1,157 @@
+//*****************************************************************************/
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//*****************************************************************************/
+
+#include <TwkFB/SIMD.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#if defined(TWKFB_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace TwkFB
+{
+
+#if defined(TWKFB_SIMD_X86)
+
+    static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4])
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuidex(r, int(leaf), int(subleaf));
+        for (int i = 0; i < 4; i++)
+            regs[i] = uint32_t(r[i]);
+#else
+        if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]))
+        {
+            regs[0] = regs[1] = regs[2] = regs[3] = 0;
+        }
+#endif
+    }
+
+    //
+    //  XCR0 tells us which register files the OS saves on a context
+    //  switch. A CPU may support AVX while the OS does not.
+    //
+
+    static uint64_t xgetbv0()
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (uint64_t(edx) << 32) | eax;
+#endif
+    }
+
+    static SIMDLevel detect()
+    {
+        uint32_t regs[4];
+
+        cpuid(0, 0, regs);
+        const uint32_t maxLeaf = regs[0];
+        if (maxLeaf < 1)
+            return SIMDScalar;
+
+        cpuid(1, 0, regs);
+        const bool ssse3 = (regs[2] & (1u << 9)) != 0;
+        const bool sse41 = (regs[2] & (1u << 19)) != 0;
+        const bool osxsave = (regs[2] & (1u << 27)) != 0;
+        const bool avx = (regs[2] & (1u << 28)) != 0;
+
+        if (!ssse3 || !sse41)
+            return SIMDScalar;
+        if (!osxsave || !avx || maxLeaf < 7)
+            return SIMDSSE41;
+
+        const uint64_t xcr0 = xgetbv0();
+        if ((xcr0 & 0x6) != 0x6)
+            return SIMDSSE41;
+
+        cpuid(7, 0, regs);
+        const bool avx2 = (regs[1] & (1u << 5)) != 0;
+        const bool avx512f = (regs[1] & (1u << 16)) != 0;
+        const bool avx512bw = (regs[1] & (1u << 30)) != 0;
+
+        if (!avx2)
+            return SIMDSSE41;
+        if (!avx512f || !avx512bw || (xcr0 & 0xE0) != 0xE0)
+            return SIMDAVX2;
+
+        return SIMDAVX512;
+    }
+
+#else
+
+    static SIMDLevel detect() { return SIMDScalar; }
+
+#endif
+
+    static SIMDLevel levelFromEnvironment(SIMDLevel detected)
+    {
+        const char* env = getenv("RV_SIMD_LEVEL");
+        if (!env)
+            return detected;
+
+        SIMDLevel level = detected;
+        if (!strcmp(env, "scalar") || !strcmp(env, "none"))
+            level = SIMDScalar;
+        else if (!strcmp(env, "sse4.1") || !strcmp(env, "sse41"))
+            level = SIMDSSE41;
+        else if (!strcmp(env, "avx2"))
+            level = SIMDAVX2;
+        else if (!strcmp(env, "avx512"))
+            level = SIMDAVX512;
+
+        return level < detected ? level : detected;
+    }
+
+    SIMDLevel detectedSIMDLevel()
+    {
+        static const SIMDLevel level = detect();
+        return level;
+    }
+
+    static std::atomic<int>& currentLevel()
+    {
+        static std::atomic<int> level(levelFromEnvironment(detectedSIMDLevel()));
+        return level;
+    }
+
+    SIMDLevel simdLevel() { return SIMDLevel(currentLevel().load(std::memory_order_relaxed)); }
+
+    void setSIMDLevel(SIMDLevel level)
+    {
+        const SIMDLevel detected = detectedSIMDLevel();
+        currentLevel().store(level < detected ? level : detected, std::memory_order_relaxed);
+    }
+
+    const char* simdLevelName(SIMDLevel level)
+    {
+        switch (level)
+        {
+        case SIMDSSE41:
+            return "sse4.1";
+        case SIMDAVX2:
+            return "avx2";
+        case SIMDAVX512:
+            return "avx512";
+        default:
+            return "scalar";
+        }
+    }
+
+} // namespace TwkFB
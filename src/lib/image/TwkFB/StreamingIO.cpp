@@ -6,6 +6,7 @@
 //
 //
 #include <TwkFB/StreamingIO.h>
+#include <TwkUtil/FileStream.h>
 
 namespace TwkFB
 {
@@ -34,4 +35,21 @@ namespace TwkFB
             m_iotype = (IOType)value;
     }
 
+    void StreamingFrameBufferIO::readAhead(const std::string& filename) const
+    {
+        //
+        //  StandardIO readers may not use FileStream at all so they can
+        //  only be helped through the page cache.
+        //
+
+        if (m_iotype == StandardIO || m_iotype == MemoryMappedIO)
+        {
+            TwkUtil::FileStream::readAheadToPageCache(filename);
+        }
+        else
+        {
+            TwkUtil::FileStream::readAhead(filename, TwkUtil::FileStream::Type(m_iotype - 1), m_iosize, m_iomaxAsync);
+        }
+    }
+
 } // namespace TwkFB
@@ -10,6 +10,7 @@
 #include <pthread.h>
 #include <TwkFB/dll_defs.h>
 #include <TwkFB/FrameBuffer.h>
+#include <TwkFB/StripedSet.h>
 #include <map>
 #include <deque>
 #include <string>
@@ -57,6 +58,7 @@ namespace TwkFB
         typedef TwkFB::FrameBuffer FrameBuffer;
         typedef FrameBuffer::DataType DataType;
         typedef std::map<IDString, FrameBuffer*> FBMap;
+        typedef StripedSet<IDString> IDIndex;
         typedef std::deque<std::pair<std::string, int>> LockLog;
 
         //
@@ -106,7 +108,10 @@ namespace TwkFB
         bool add(FrameBuffer*, bool force = false);
 
         //
-        //  Test for cached id
+        //  Test for cached id. This does not require the cache lock: the
+        //  answer comes from a lock-striped index of the ids in the
+        //  cache. Without the lock the answer may of course be stale by
+        //  the time the caller acts on it (use checkOut() for that).
         //
 
         bool isCached(const IDString&) const;
@@ -160,6 +165,7 @@ namespace TwkFB
         //
         //  Lock and unlock are necessary in multithreaded code. You
         //  should lock before making Cache calls and unlock when through.
+        //  Only isCached() may be called without the lock.
         //
 
         bool tryLock() const { return pthread_mutex_trylock(&m_mutex) == 0; }
@@ -208,6 +214,16 @@ namespace TwkFB
         bool trashContains(FrameBuffer* fb);
         size_t deleteFB(FrameBuffer* fb);
 
+        //
+        //  Called by freeTrash() for each unreferenced fb it removes
+        //  from the cache. The default is to deleteFB() it. A derived
+        //  cache can instead hand the fb to a secondary storage tier
+        //  (which then owns it). Returns the number of bytes released
+        //  from this cache.
+        //
+
+        virtual size_t evictFB(FrameBuffer* fb);
+
         static bool retrievalCompare(FrameBuffer* a, FrameBuffer* b) { return a->m_retrievalTime > b->m_retrievalTime; }
 
         //
@@ -223,12 +239,23 @@ namespace TwkFB
 
         bool hasOneReference(FrameBuffer* fb) const { return fb->m_cacheRef == 1; }
 
+        //
+        //  All changes to the keys of m_map go through these so the id
+        //  index stays in sync with it.
+        //
+
+        void mapInsert(FrameBuffer* fb);
+        void mapErase(FBMap::iterator i);
+        void mapErase(const IDString& id);
+        void mapClear();
+
     protected:
         bool m_full;
         size_t m_maxBytes;
         size_t m_currentBytes;
         size_t m_retrieveTime;
         FBMap m_map;
+        IDIndex m_index;
         mutable pthread_mutex_t m_mutex;
 
         TrashCan* m_trashCan;
@@ -62,10 +62,20 @@ extern "C"
     TWKFB_EXPORT void subsample422_10bit_MP(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
                                             uint32_t* FASTMEMCPYRESTRICT outBuf, size_t inBufStride, size_t outBufStride);
 
-    TWKFB_EXPORT void swap_bytes_32bit(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
-                                       uint32_t* FASTMEMCPYRESTRICT outBuf);
-    TWKFB_EXPORT void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* FASTMEMCPYRESTRICT inBuf,
-                                          uint32_t* FASTMEMCPYRESTRICT outBuf);
+    /// @brief Reverses the byte order of each 32 or 16 bit word of a
+    /// contiguous width x height buffer.
+    ///
+    /// inBuf and outBuf may be the same buffer (the swap is done in
+    /// place) but must not otherwise overlap.
+    ///
+    /// @param width The number of words per row.
+    /// @param height The number of rows.
+    /// @param inBuf The input buffer.
+    /// @param outBuf The output buffer.
+    TWKFB_EXPORT void swap_bytes_32bit(size_t width, size_t height, const uint32_t* inBuf, uint32_t* outBuf);
+    TWKFB_EXPORT void swap_bytes_32bit_MP(size_t width, size_t height, const uint32_t* inBuf, uint32_t* outBuf);
+    TWKFB_EXPORT void swap_bytes_16bit(size_t width, size_t height, const uint16_t* inBuf, uint16_t* outBuf);
+    TWKFB_EXPORT void swap_bytes_16bit_MP(size_t width, size_t height, const uint16_t* inBuf, uint16_t* outBuf);
 
 #ifdef __cplusplus
 }
@@ -297,6 +297,8 @@ namespace TwkFB
                 , x1(0)
                 , y1(0)
                 , resolution(0.0f)
+                , levelX(0)
+                , levelY(0)
             {
             }
 
@@ -321,9 +323,19 @@ namespace TwkFB
             //  means the request is asking for a scaled down version of
             //  the image.
             //
+            //  The region x0, y0, x1, y1 (inclusive) is in full
+            //  resolution pixels with the origin at the top left of the
+            //  display window. A reader may return more than the region
+            //  (e.g. whole scanline blocks or tiles) but never less of it.
+            //
+            //  levelX and levelY select a stored mip/rip map level (for
+            //  mip maps the larger of the two is used). If both are 0, a reader
+            //  may pick a level from the resolution.
+            //
             //  NOTE: asking for a smaller resolution or crop of the image
             //  is reader dependent. Not all readers are expected to have
-            //  this ability.
+            //  this ability (see the CropRead and MultiResolution
+            //  capabilities).
             //
 
             float resolution;
@@ -333,6 +345,22 @@ namespace TwkFB
             int x1;
             int y1;
 
+            int levelX;
+            int levelY;
+
+            bool hasRegion() const { return x0 != 0 || y0 != 0 || x1 != 0 || y1 != 0; }
+
+            bool hasLevel() const { return levelX != 0 || levelY != 0 || (resolution > 0.0f && resolution < 1.0f); }
+
+            //
+            //  A string which uniquely identifies the region and level
+            //  part of the request (empty if neither is set). Movies
+            //  append it to their identifiers so partial images are
+            //  cached separately from whole ones.
+            //
+
+            std::string partialReadIdentifier() const;
+
             //
             //  If either is non-empty return the layer/view
             //  requested. Note: layers are things like diffuse, views are
@@ -192,6 +192,17 @@ namespace TwkFB
 
     TWKFB_EXPORT void nearestNeighborResize(const FrameBuffer* from, FrameBuffer* to);
 
+    //
+    //  Returns a new fb which is 1/factor the size of fb in each
+    //  dimension (rounded up). Each output pixel is the average of the
+    //  factor x factor box of input pixels under it. Planes are reduced
+    //  independently; attributes, orientation and pixel aspect are
+    //  copied and the uncrop is scaled. Returns NULL for the packed
+    //  data types.
+    //
+
+    TWKFB_EXPORT FrameBuffer* boxDownsample(const FrameBuffer* fb, int factor);
+
     TWKFB_EXPORT FrameBuffer* channelMap(const FrameBuffer* from, const std::vector<std::string>& newMapping);
 
     TWKFB_EXPORT FrameBuffer* channelMapToPlanar(const FrameBuffer* from, std::vector<std::string> newMapping);
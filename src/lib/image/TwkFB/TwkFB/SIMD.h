@@ -0,0 +1,74 @@
+//*****************************************************************************/
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//*****************************************************************************/
+
+#ifndef __TwkFB__SIMD__h__
+#define __TwkFB__SIMD__h__
+
+#include <TwkFB/dll_defs.h>
+
+//
+//  Runtime selection of the vector kernels used by FastMemcpy and
+//  FastConversion. The kernels are compiled for several instruction
+//  sets in the same binary (using per function target attributes) and
+//  the widest one supported by the host CPU and OS is picked on the
+//  first call.
+//
+//  RV_SIMD_LEVEL can be set to "scalar", "sse4.1", "avx2" or "avx512"
+//  to cap the level that is used (e.g. to compare against the scalar
+//  versions or to avoid AVX-512 frequency throttling on some CPUs).
+//
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TWKFB_SIMD_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TWKFB_TARGET_SSE41
+#define TWKFB_TARGET_AVX2
+#define TWKFB_TARGET_AVX512
+#else
+#define TWKFB_TARGET_SSE41 __attribute__((target("ssse3,sse4.1")))
+#define TWKFB_TARGET_AVX2 __attribute__((target("avx2")))
+#define TWKFB_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+#endif
+#endif
+
+namespace TwkFB
+{
+
+    enum SIMDLevel
+    {
+        SIMDScalar = 0,
+        SIMDSSE41,
+        SIMDAVX2,
+        SIMDAVX512
+    };
+
+    //
+    //  The widest level supported by the host, ignoring RV_SIMD_LEVEL.
+    //
+
+    TWKFB_EXPORT SIMDLevel detectedSIMDLevel();
+
+    //
+    //  The level the kernels currently dispatch to.
+    //
+
+    TWKFB_EXPORT SIMDLevel simdLevel();
+
+    //
+    //  Force a level (clamped to the detected one). Mostly useful for
+    //  testing the vector kernels against the scalar ones.
+    //
+
+    TWKFB_EXPORT void setSIMDLevel(SIMDLevel level);
+
+    TWKFB_EXPORT const char* simdLevelName(SIMDLevel level);
+
+} // namespace TwkFB
+
+#endif //__TwkFB__SIMD__h__
@@ -29,7 +29,8 @@ namespace TwkFB
             UnbufferedIO,
             MemoryMappedIO,
             AsyncBufferedIO,
-            AsyncUnbufferedIO
+            AsyncUnbufferedIO,
+            IOUringIO
         };
 
         StreamingFrameBufferIO(const std::string& identifier, const std::string& sortKey, IOType type = StandardIO,
@@ -56,6 +57,13 @@ namespace TwkFB
 
         void iomaxAsync(size_t t) { m_iomaxAsync = t; }
 
+        //
+        //  Read the file into memory (the way readImages() will read it)
+        //  ahead of a readImages() call on another thread.
+        //
+
+        void readAhead(const std::string& filename) const;
+
     protected:
         IOType m_iotype;
         size_t m_iosize;
@@ -0,0 +1,122 @@
+//******************************************************************************
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//******************************************************************************
+#ifndef __TwkFB__StripedSet__h__
+#define __TwkFB__StripedSet__h__
+#include <pthread.h>
+#include <functional>
+#include <unordered_set>
+#include <stddef.h>
+
+namespace TwkFB
+{
+
+    //
+    //  StripedSet
+    //
+    //  A set which can be read and written by any number of threads at
+    //  once. The keys are spread over a fixed number of stripes (by hash)
+    //  and each stripe has its own mutex, so two threads only contend if
+    //  they happen to touch keys in the same stripe. Each operation holds
+    //  one stripe lock for the duration of a single hash set operation.
+    //
+    //  The caches use this to mirror the keys of maps that are otherwise
+    //  protected by the (global) cache lock: the maps are still only
+    //  modified with that lock held, but membership tests can be answered
+    //  from the StripedSet without it.
+    //
+
+    template <class Key, class Hash = std::hash<Key>, size_t NumStripes = 64> class StripedSet
+    {
+    public:
+        StripedSet()
+        {
+            for (size_t i = 0; i < NumStripes; i++)
+                pthread_mutex_init(&m_stripes[i].mutex, 0);
+        }
+
+        ~StripedSet()
+        {
+            for (size_t i = 0; i < NumStripes; i++)
+                pthread_mutex_destroy(&m_stripes[i].mutex);
+        }
+
+        void insert(const Key& key)
+        {
+            Stripe& s = stripe(key);
+            pthread_mutex_lock(&s.mutex);
+            s.keys.insert(key);
+            pthread_mutex_unlock(&s.mutex);
+        }
+
+        void erase(const Key& key)
+        {
+            Stripe& s = stripe(key);
+            pthread_mutex_lock(&s.mutex);
+            s.keys.erase(key);
+            pthread_mutex_unlock(&s.mutex);
+        }
+
+        bool contains(const Key& key) const
+        {
+            Stripe& s = stripe(key);
+            pthread_mutex_lock(&s.mutex);
+            const bool b = s.keys.find(key) != s.keys.end();
+            pthread_mutex_unlock(&s.mutex);
+            return b;
+        }
+
+        void clear()
+        {
+            for (size_t i = 0; i < NumStripes; i++)
+            {
+                Stripe& s = m_stripes[i];
+                pthread_mutex_lock(&s.mutex);
+                s.keys.clear();
+                pthread_mutex_unlock(&s.mutex);
+            }
+        }
+
+        size_t size() const
+        {
+            size_t n = 0;
+
+            for (size_t i = 0; i < NumStripes; i++)
+            {
+                Stripe& s = m_stripes[i];
+                pthread_mutex_lock(&s.mutex);
+                n += s.keys.size();
+                pthread_mutex_unlock(&s.mutex);
+            }
+
+            return n;
+        }
+
+    private:
+        StripedSet(const StripedSet&);
+        StripedSet& operator=(const StripedSet&);
+
+        //
+        //  Aligned so neighbouring stripe locks don't share a cache line.
+        //
+
+        struct alignas(64) Stripe
+        {
+            pthread_mutex_t mutex;
+            std::unordered_set<Key, Hash> keys;
+        };
+
+        Stripe& stripe(const Key& key) const { return m_stripes[m_hash(key) % NumStripes]; }
+
+    private:
+        mutable Stripe m_stripes[NumStripes];
+        Hash m_hash;
+    };
+
+} // namespace TwkFB
+
+#endif // __TwkFB__StripedSet__h__
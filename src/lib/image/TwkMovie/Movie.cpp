@@ -50,6 +50,8 @@ namespace TwkMovie
 
     void Movie::attributesAtFrame(const ReadRequest&, FrameBufferVector&) {}
 
+    void Movie::readAheadAtFrame(const ReadRequest&) {}
+
     void Movie::flush() {}
 
     size_t Movie::audioFillBuffer(const AudioReadRequest&, AudioBuffer&) { return 0; }
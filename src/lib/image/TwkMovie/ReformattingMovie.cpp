@@ -959,6 +959,8 @@ namespace TwkMovie
         }
     }
 
+    void ReformattingMovie::readAheadAtFrame(const ReadRequest& request) { m_movie->readAheadAtFrame(request); }
+
     void ReformattingMovie::identifier(ostream& idstream)
     {
         idstream << ":reformat"; // catch all
@@ -109,7 +109,7 @@ namespace TwkMovie
 
             size_t bsize = samples * 2;
             m_accumBuffer = new float[bsize * channels];
-            m_resampler = new MultiResampler(channels, factor, blocksize);
+            m_resampler = new PolyphaseResampler(channels, factor, blocksize);
             m_accumAllocated = bsize;
         }
     }
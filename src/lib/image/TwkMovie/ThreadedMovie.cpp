@@ -313,6 +313,8 @@ namespace TwkMovie
         m_threadData.front().movie->identifiersAtFrame(request, ids);
     }
 
+    void ThreadedMovie::readAheadAtFrame(const ReadRequest& request) { m_threadData.front().movie->readAheadAtFrame(request); }
+
     size_t ThreadedMovie::audioFillBuffer(const AudioReadRequest& request, AudioBuffer& buffer)
     {
         return m_threadData.front().movie->audioFillBuffer(request, buffer);
@@ -392,6 +392,17 @@ namespace TwkMovie
 
         virtual void attributesAtFrame(const ReadRequest&, FrameBufferVector& fbs);
 
+        ///
+        ///  Hint that imagesAtFrame() will soon be called with the
+        ///  request. A movie backed by files can use this to get the
+        ///  file data into memory ahead of the decode. This is called by
+        ///  a read-ahead thread which is independent of the threads
+        ///  calling imagesAtFrame() so it must be thread safe. The
+        ///  default does nothing.
+        ///
+
+        virtual void readAheadAtFrame(const ReadRequest&);
+
         ///
         ///  Fill a buffer with audio data. This is the lowest level
         ///  accessor function for audio. Fill the buffer to the requested
@@ -266,6 +266,7 @@ namespace TwkMovie
         virtual bool hasAudio() const;
         virtual void imagesAtFrame(const ReadRequest& request, FrameBufferVector& fbs);
         virtual void identifiersAtFrame(const ReadRequest& request, IdentifierVector& ids);
+        virtual void readAheadAtFrame(const ReadRequest& request);
         virtual void audioConfigure(const AudioConfiguration& conf);
         virtual size_t audioFillBuffer(const AudioReadRequest&, AudioBuffer&);
         virtual void flush();
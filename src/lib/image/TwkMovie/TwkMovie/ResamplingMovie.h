@@ -9,7 +9,7 @@
 #define __TwkMovie__ResamplingMovie__h__
 #include <TwkMovie/Movie.h>
 #include <TwkMovie/dll_defs.h>
-#include <TwkAudio/Resampler.h>
+#include <TwkAudio/PolyphaseResampler.h>
 #include <fstream>
 
 #define AUDIO_READPOSITIONOFFSET_THRESHOLD 0.01 // In secs; this is the max amount of slip we will allow
@@ -46,7 +46,7 @@ namespace TwkMovie
         TwkAudio::SampleTime maxAvailableSample(double rate);
 
         Movie* m_movie;
-        TwkAudio::MultiResampler* m_resampler;
+        TwkAudio::PolyphaseResampler* m_resampler;
         TwkAudio::Time m_readPosition;
         TwkAudio::Time m_readPositionOffset;
         TwkAudio::Time m_readStart;
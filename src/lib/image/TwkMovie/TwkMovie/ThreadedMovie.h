@@ -66,6 +66,7 @@ namespace TwkMovie
 
         virtual void imagesAtFrame(const ReadRequest&, FrameBufferVector& fbs);
         virtual void identifiersAtFrame(const ReadRequest&, IdentifierVector&);
+        virtual void readAheadAtFrame(const ReadRequest&);
         virtual size_t audioFillBuffer(const AudioReadRequest&, AudioBuffer&);
         virtual void audioConfigure(unsigned int channels, TwkAudio::Time rate, size_t bufferSize);
         virtual void flush();
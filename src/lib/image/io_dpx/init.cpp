@@ -32,6 +32,7 @@ extern "C"
         int ioSize = 61440;
         int ioMaxAsync = 16;
         int useChromaticities = 0;
+        int zeroCopy = 0;
         string format = "RGBA8";
 
         if (const char* args = getenv("IODPX_ARGS"))
@@ -55,7 +56,8 @@ extern "C"
                                    "Respect file chromaticities")("format", value<string>(&format)->default_value(format), "")(
                     "ioMethod", value<int>(&ioMethod)->default_value(ioMethod),
                     "I/O Method")("ioSize", value<int>(&ioSize)->default_value(ioSize), "I/O Max async read size")(
-                    "ioMaxAsync", value<int>(&ioMaxAsync)->default_value(ioMaxAsync), "I/O Max ASync Requests");
+                    "ioMaxAsync", value<int>(&ioMaxAsync)->default_value(ioMaxAsync), "I/O Max ASync Requests")(
+                    "zeroCopy", value<int>(&zeroCopy)->default_value(zeroCopy), "Use 10/12/16 bit RGB data as read");
 
                 variables_map vm;
                 store(parse_command_line(argc, argv, desc), vm);
@@ -72,7 +74,9 @@ extern "C"
             }
         }
 
-        return new IOdpx(format, useChromaticities, (StreamingFrameBufferIO::IOType)ioMethod, ioSize, ioMaxAsync);
+        IOdpx* io = new IOdpx(format, useChromaticities, (StreamingFrameBufferIO::IOType)ioMethod, ioSize, ioMaxAsync);
+        io->zeroCopy(zeroCopy != 0);
+        return io;
     }
 
     void destroy(IOdpx* plug) { delete plug; }
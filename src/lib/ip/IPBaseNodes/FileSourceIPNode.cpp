@@ -35,6 +35,7 @@
 #include <TwkUtil/PathConform.h>
 #include <TwkUtil/sgcHop.h>
 #include <TwkUtil/sgcHopTools.h>
+#include <TwkUtil/Trace.h>
 #include <TwkMediaLibrary/Library.h>
 
 #include <algorithm>
@@ -311,6 +312,8 @@ namespace IPCore
         m_balance = declareProperty<FloatProperty>("group.balance", 0.0f, ainfo);
         m_crossover = declareProperty<FloatProperty>("group.crossover", 0.0f, ainfo);
         m_readAllChannels = declareProperty<IntProperty>("request.readAllChannels", 0);
+        m_readRegion = declareProperty<IntProperty>("request.region");
+        m_readLevel = declareProperty<IntProperty>("request.level");
         m_rangeStart = 0;
 
         const bool progressiveSourceLoading = Application::optionValue<bool>("progressiveSourceLoading", false);
@@ -630,6 +633,40 @@ namespace IPCore
         result.poorRandomAccessPerformance = slow || result.poorRandomAccessPerformance;
     }
 
+    void FileSourceIPNode::readAhead(const Context& context)
+    {
+        ImageComponent selection;
+        MediaPointer media;
+        {
+            const QReadLocker readLock(&m_mediaMutex);
+
+            if (m_mediaVector.size() == 0)
+                return;
+
+            media = getMediaFromContext(selection, context);
+        }
+
+        Movie* mov = movieForThread(media.get(), context);
+        if (!mov || !mov->hasVideo())
+            return;
+
+        Movie::ReadRequest request(context.frame, context.stereo);
+        setupRequest(mov, selection, context, request);
+
+        //
+        //  Failures are ignored: evaluate() will run into the same
+        //  problem and report it.
+        //
+
+        try
+        {
+            mov->readAheadAtFrame(request);
+        }
+        catch (...)
+        {
+        }
+    }
+
     FileSourceIPNode::MediaPointer FileSourceIPNode::getMediaFromContext(ImageComponent& selection, const Context& context) const
     {
         selection = selectComponentFromContext(context);
@@ -847,6 +884,27 @@ namespace IPCore
         request.missing = context.missing;
         request.allChannels = (m_readAllChannels->front() ? true : false);
 
+        //
+        //  Optional region (x0, y0, x1, y1 in image pixels from the top
+        //  left) and mip/rip level (x, y) to read. Readers which can't
+        //  read part of an image ignore these. They're part of the image
+        //  identifiers so there's no need to flush when they change.
+        //
+
+        if (m_readRegion && m_readRegion->size() == 4)
+        {
+            request.x0 = (*m_readRegion)[0];
+            request.y0 = (*m_readRegion)[1];
+            request.x1 = (*m_readRegion)[2];
+            request.y1 = (*m_readRegion)[3];
+        }
+
+        if (m_readLevel && m_readLevel->size() == 2)
+        {
+            request.levelX = (*m_readLevel)[0];
+            request.levelY = (*m_readLevel)[1];
+        }
+
         //
         //  Limit requested views to ones this movie actually provides.
         //  Otherwise the movie reader may fallback to a "default" view,
@@ -997,8 +1055,18 @@ namespace IPCore
             HOP_PROF_DYN_NAME(imagesAtFrameMsg.c_str());
 #endif
 
+            TwkUtil::TraceScope ioTrace("io", "imagesAtFrame");
+
             mov->imagesAtFrame(request, fbs);
 
+            if (TwkUtil::Trace::enabled())
+            {
+                size_t bytes = 0;
+                for (size_t i = 0; i < fbs.size(); i++)
+                    bytes += fbs[i]->totalImageSize();
+                ioTrace.setArg("bytes", bytes);
+            }
+
             if (fbs.empty())
             {
                 empty = true;
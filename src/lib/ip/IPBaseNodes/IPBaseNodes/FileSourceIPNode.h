@@ -12,7 +12,7 @@
 #include <IPCore/IPGraph.h>
 #include <TwkApp/Bundle.h>
 #include <TwkAudio/AudioFormats.h>
-#include <TwkAudio/Resampler.h>
+#include <TwkAudio/PolyphaseResampler.h>
 #include <TwkMovie/Movie.h>
 
 #include <iostream>
@@ -56,7 +56,7 @@ namespace IPCore
         typedef TwkContainer::FloatProperty FloatProperty;
         typedef TwkContainer::IntProperty IntProperty;
         typedef TwkContainer::StringProperty StringProperty;
-        typedef TwkAudio::MultiResampler Resampler;
+        typedef TwkAudio::PolyphaseResampler Resampler;
         typedef std::vector<float> SampleVector;
         typedef std::set<std::string> StringSet;
         typedef std::recursive_mutex Mutex;
@@ -95,6 +95,7 @@ namespace IPCore
 
         virtual IPImage* evaluate(const Context&);
         virtual void testEvaluate(const Context&, TestEvaluationResult&);
+        virtual void readAhead(const Context&);
         virtual IPImageID* evaluateIdentifier(const Context&);
         virtual void flushAllCaches(const FlushContext&);
         virtual ImageRangeInfo imageRangeInfo() const;
@@ -242,6 +243,8 @@ namespace IPCore
         FloatProperty* m_balance;
         FloatProperty* m_crossover;
         IntProperty* m_readAllChannels;
+        IntProperty* m_readRegion;
+        IntProperty* m_readLevel;
         StringVector m_allViews;
         StringSet m_viewNameSet;
         Mutex m_audioMutex;
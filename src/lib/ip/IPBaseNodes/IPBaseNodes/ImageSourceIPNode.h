@@ -88,6 +88,25 @@ namespace IPCore
         void insertPixels(const std::string& view, const std::string& layer, int frame, int x, int y, int w, int h, const void* pixels,
                           size_t size);
 
+        //
+        //  Several blocks of the same image at once. The image is only
+        //  flushed and marked changed once for all of them.
+        //
+
+        struct PixelBlock
+        {
+            int x;
+            int y;
+            int w;
+            int h;
+            const void* pixels;
+            size_t size;
+        };
+
+        typedef std::vector<PixelBlock> PixelBlocks;
+
+        void insertPixelBlocks(const std::string& view, const std::string& layer, int frame, const PixelBlocks& blocks);
+
         virtual void readCompleted(const std::string&, unsigned int);
         virtual void writeCompleted();
 
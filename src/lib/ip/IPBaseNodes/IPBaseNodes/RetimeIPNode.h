@@ -8,6 +8,7 @@
 #ifndef __IPGraph__RetimeIPNode__h__
 #define __IPGraph__RetimeIPNode__h__
 #include <IPCore/IPNode.h>
+#include <TwkAudio/TimeStretcher.h>
 #include <TwkMovie/Movie.h>
 #include <boost/thread.hpp>
 #include <vector>
@@ -70,6 +71,25 @@ namespace IPCore
 
         bool explicitPropertiesOK() const;
 
+        size_t stretchAudio(AudioBuffer& buffer, float fps, double factor, bool reversed);
+
+        //
+        //  Reads the input for the stretcher. Backwards, the stream's
+        //  input sample i is input sample end - 1 - i.
+        //
+
+        struct StretchSource : public TwkAudio::TimeStretchStream::Source
+        {
+            virtual void read(TwkAudio::SampleTime start, size_t n, float* out);
+
+            RetimeIPNode* node;
+            TwkAudio::ChannelsVector channels;
+            Time rate;
+            float fps;
+            bool reversed;
+            TwkAudio::SampleTime end;
+        };
+
     private:
         FloatProperty* m_vscale;
         FloatProperty* m_voffset;
@@ -85,8 +105,6 @@ namespace IPCore
         IntProperty* m_explicitActive;
         IntProperty* m_explicitFirstOutputFrame;
         IntProperty* m_explicitInputFrames;
-        Time m_grainDuration;
-        Time m_grainEnvelope;
         mutable ImageRangeInfo m_inputInfo;
         mutable bool m_warpDataValid;
         mutable bool m_explicitDataValid;
@@ -96,6 +114,10 @@ namespace IPCore
         mutable FrameVector m_explicitInToOut;
         mutable int m_explicitFirstInputFrame;
         mutable bool m_fpsDetected{false};
+        Mutex m_audioMutex;
+        TwkAudio::TimeStretchStream* m_stretch;
+        bool m_stretchReversed;
+        TwkAudio::SampleTime m_stretchEnd;
     };
 
 } // namespace IPCore
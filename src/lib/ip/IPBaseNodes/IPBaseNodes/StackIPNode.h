@@ -71,6 +71,9 @@ namespace IPCore
     protected:
         void computeRanges();
         int inputFrame(size_t, int, bool unconstrained = false);
+        bool inputInStrictRange(size_t, int, bool useCutInfo);
+        bool inputsAreIndependent() const;
+        bool computeInputsAreIndependent() const;
         void mapInputToEvalFramesInternal(size_t inputIndex, const FrameVector&, FrameVector&) const;
 
         void lock() const { pthread_mutex_lock(&m_lock); }
@@ -105,6 +108,7 @@ namespace IPCore
         IntProperty* m_interactiveSize;
         IntProperty* m_supportReversedOrderBlending;
         FloatProperty* m_dissolveAmount;
+        mutable std::atomic<uint64_t> m_inputsIndependent;
 
     private:
         static std::string m_defaultCompType;
@@ -812,17 +812,12 @@ namespace IPCore
     void ImageSourceIPNode::insertPixels(const string& view, const string& layer, int frame, int x, int y, int w, int h, const void* pixels,
                                          size_t size)
     {
-        Property* p = findCreatePixels(frame, view, layer);
-        unsigned char* d = (unsigned char*)p->rawData();
-        const size_t iw = m_mediaInfo.width;
-        const size_t ih = m_mediaInfo.height;
-        const size_t ch = m_mediaInfo.numChannels;
-        const size_t esize = p->sizeofElement();
-        const size_t pixelSize = esize * ch;
-        const size_t iRowSize = iw * pixelSize;
-        const size_t tRowSize = w * pixelSize;
-        const size_t expectedSize = w * h * ch * esize;
+        PixelBlock block = {x, y, w, h, pixels, size};
+        insertPixelBlocks(view, layer, frame, PixelBlocks(1, block));
+    }
 
+    void ImageSourceIPNode::insertPixelBlocks(const string& view, const string& layer, int frame, const PixelBlocks& blocks)
+    {
         if (layer.find('/') != string::npos || layer.find('@') != string::npos || layer.find('#') != string::npos
             || layer.find('*') != string::npos || layer.find(':') != string::npos || layer.find(';') != string::npos)
         {
@@ -832,17 +827,56 @@ namespace IPCore
             TWK_THROW_STREAM(LayerOutOfBoundsExc, "Characters /, @, #, *, :, ; are illegal in layer names");
         }
 
-        if (expectedSize != size)
+        Property* p = findCreatePixels(frame, view, layer);
+        unsigned char* d = (unsigned char*)p->rawData();
+        const size_t iw = m_mediaInfo.width;
+        const size_t ih = m_mediaInfo.height;
+        const size_t ch = m_mediaInfo.numChannels;
+        const size_t esize = p->sizeofElement();
+        const size_t pixelSize = esize * ch;
+        const size_t iRowSize = iw * pixelSize;
+
+        //
+        //  Check all of the blocks before touching the pixels so a bad
+        //  batch doesn't leave the image half updated.
+        //
+
+        for (size_t b = 0; b < blocks.size(); b++)
         {
-            TWK_THROW_STREAM(PixelBlockSizeMismatchExc, "Received pixels of size " << size << ". Expected " << expectedSize);
+            const PixelBlock& block = blocks[b];
+
+            //
+            //  The geometry comes off the network: add in 64 bits so a
+            //  huge x + w can't wrap around into the image. Once it's
+            //  inside the image the size can't overflow either.
+            //
+
+            if (block.x < 0 || block.y < 0 || block.w < 0 || block.h < 0 || int64_t(block.x) + int64_t(block.w) > int64_t(iw)
+                || int64_t(block.y) + int64_t(block.h) > int64_t(ih))
+            {
+                TWK_THROW_STREAM(PixelBlockSizeMismatchExc, "Received pixel block " << block.w << "x" << block.h << " at " << block.x
+                                                                                      << "," << block.y << " outside of the image");
+            }
+
+            const size_t expectedSize = size_t(block.w) * block.h * ch * esize;
+
+            if (expectedSize != block.size)
+            {
+                TWK_THROW_STREAM(PixelBlockSizeMismatchExc, "Received pixels of size " << block.size << ". Expected " << expectedSize);
+            }
         }
 
-        for (size_t i = y; i < (y + h); i++)
+        for (size_t b = 0; b < blocks.size(); b++)
         {
-            unsigned char* dst = d + iRowSize * i + x * pixelSize;
-            unsigned char* src = (unsigned char*)pixels + tRowSize * (i - y);
-            assert((dst + tRowSize - 1) < (d + iw * ih * ch * esize));
-            memcpy(dst, src, tRowSize);
+            const PixelBlock& block = blocks[b];
+            const size_t tRowSize = block.w * pixelSize;
+
+            for (size_t i = size_t(block.y), e = i + size_t(block.h); i < e; i++)
+            {
+                unsigned char* dst = d + iRowSize * i + block.x * pixelSize;
+                const unsigned char* src = (const unsigned char*)block.pixels + tRowSize * (i - block.y);
+                memcpy(dst, src, tRowSize);
+            }
         }
 
         //
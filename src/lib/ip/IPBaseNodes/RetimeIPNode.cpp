@@ -16,6 +16,7 @@
 #include <TwkAudio/Audio.h>
 #include <TwkFB/FrameBuffer.h>
 #include <iostream>
+#include <string.h>
 
 namespace IPCore
 {
@@ -43,8 +44,9 @@ namespace IPCore
         , m_explicitFirstInputFrame(0)
         , m_explicitInputFrames(0)
         , m_explicitDataValid(false)
-        , m_grainDuration(0.022)
-        , m_grainEnvelope(0.006)
+        , m_stretch(0)
+        , m_stretchReversed(false)
+        , m_stretchEnd(0)
     {
         m_vscale = declareProperty<FloatProperty>("visual.scale", 1.0);
         m_voffset = declareProperty<FloatProperty>("visual.offset", 0.0);
@@ -80,7 +82,7 @@ namespace IPCore
         setMaxInputs(1);
     }
 
-    RetimeIPNode::~RetimeIPNode() {}
+    RetimeIPNode::~RetimeIPNode() { delete m_stretch; }
 
     bool RetimeIPNode::testInputs(const IPNodes& inputs, std::ostringstream& msg) const
     {
@@ -853,74 +855,82 @@ namespace IPCore
             }
         }
 
-        const Time rate = buffer.rate();
-        const size_t ch = buffer.numChannels();
-        const size_t start = buffer.startSample();
-        const size_t num = buffer.size();
-        const size_t end = start + num;
+        //
+        //  Backwards the stretcher reads the input from its end, so the
+        //  output of consecutive buffers is still consecutive
+        //
 
-        const size_t grainSamples = timeToSamples(m_grainDuration, buffer.rate());
-        const size_t grainMarginSamples = timeToSamples(m_grainEnvelope, buffer.rate());
-        const size_t grainSyncWidth = grainSamples + grainMarginSamples;
+        AudioBuffer output(context.buffer, 0, nsamples, reversed ? context.buffer.startTime() : startTime);
+        return stretchAudio(output, newContext.fps, factor, reversed);
+    }
 
-        const size_t sync0 = start / grainSyncWidth;
-        const size_t syncN = (start + num) / grainSyncWidth;
-        const size_t grainSize = grainSyncWidth + grainMarginSamples;
+    //
+    //  Reads input samples [start, start + n) of the stream. Anything
+    //  before the start of the input (or after its end, backwards) is
+    //  silence.
+    //
 
-        float* out = buffer.pointer();
+    void RetimeIPNode::StretchSource::read(SampleTime start, size_t n, float* out)
+    {
+        const SampleTime first = reversed ? end - start - SampleTime(n) : start;
+        const SampleTime lo = std::max(first, SampleTime(0));
+        const SampleTime hi = reversed ? std::min(first + SampleTime(n), end) : first + SampleTime(n);
 
-        for (size_t i = sync0; i <= syncN; i++)
+        if (lo < hi)
         {
-            //
-            //  Locate the grain we want. t is relative to the output
-            //  time.
-            //
-
-            Time t = i * samplesToTime(grainSyncWidth, rate) - samplesToTime(grainMarginSamples, rate);
-            Time d = samplesToTime(grainSize, rate);
-
-            if (t < 0)
-                t = 0;
+            AudioBuffer part(out + (lo - first) * channels.size(), channels, size_t(hi - lo), samplesToTime(lo, rate), rate);
+            AudioContext context(part, fps);
+            node->IPNode::audioFillBuffer(context);
+        }
 
-            AudioBuffer grain(grainSize, buffer.channels(), rate, t * factor);
-            AudioContext rcontext(grain, newContext.fps); // !!!! fps???
+        if (reversed)
+        {
+            AudioBuffer all(out, channels, n, 0, rate);
+            all.reverse();
+        }
+    }
 
-            if (IPNode::audioFillBuffer(rcontext) == 0)
-                break;
+    //
+    //  Fills buffer with the input played factor times faster at the
+    //  same pitch: output sample s comes from around input sample s *
+    //  factor, counted from the end of the input when reversed. The
+    //  audio thread asks for consecutive buffers in either direction so
+    //  the stream carries on from where the last one finished.
+    //
 
-            //
-            //  render the grain
-            //
+    size_t RetimeIPNode::stretchAudio(AudioBuffer& buffer, float fps, double factor, bool reversed)
+    {
+        ScopedLock lock(m_audioMutex);
 
-            const float* in = grain.pointer();
-            size_t gpos = timeToSamples(t, rate);
+        const size_t ch = buffer.numChannels();
+        const size_t num = buffer.size();
 
-            for (size_t q = 0; q < grainSize; q++, gpos++)
-            {
-                if (gpos < start)
-                    continue;
-                if (gpos >= end)
-                    break;
+        if (!ch || !num)
+            return num;
 
-                double env = 1.0;
+        if (!m_stretch || m_stretch->stretcher().size() != ch || m_stretch->stretcher().rate() != buffer.rate())
+        {
+            delete m_stretch;
+            m_stretch = new TimeStretchStream(ch, buffer.rate());
+        }
 
-                if (q < grainMarginSamples)
-                {
-                    env = double(q) / double(grainMarginSamples);
-                }
-                else if (q > grainSyncWidth)
-                {
-                    env = 1.0 - double(q - grainSyncWidth) / double(grainMarginSamples);
-                }
+        StretchSource source;
+        source.node = this;
+        source.channels = buffer.channels();
+        source.rate = buffer.rate();
+        source.fps = fps;
+        source.reversed = reversed;
+        source.end = reversed ? timeToSamples(Time(m_inputInfo.end - m_inputInfo.start) / Time(m_inputInfo.fps), buffer.rate()) : 0;
 
-                for (size_t c = 0; c < ch; c++)
-                {
-                    out[(gpos - start) * ch + c] += env * in[q * ch + c];
-                }
-            }
+        if (reversed != m_stretchReversed || source.end != m_stretchEnd)
+        {
+            m_stretch->reset();
+            m_stretchReversed = reversed;
+            m_stretchEnd = source.end;
         }
 
-        return buffer.size();
+        m_stretch->fill(source, factor, buffer.startSample(), num, buffer.pointer());
+        return num;
     }
 
     bool RetimeIPNode::explicitPropertiesOK() const
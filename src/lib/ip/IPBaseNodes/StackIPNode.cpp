@@ -15,6 +15,7 @@
 #include <TwkMath/Function.h>
 #include <TwkFB/FrameBuffer.h>
 #include <TwkFB/Operations.h>
+#include <TwkUtil/TaskPool.h>
 #include <stl_ext/stl_ext_algo.h>
 #include <iostream>
 
@@ -37,6 +38,7 @@ namespace IPCore
     namespace
     {
         bool useMerge = getenv("TWK_STACKIPNODE_USE_MERGE") != 0;
+        bool serialInputs = getenv("TWK_STACKIPNODE_SERIAL_INPUTS") != 0;
         bool useMergeForReplace =
             (getenv("TWK_STACKIPNODE_USE_MERGE_FOR_REPLACE") == 0 || getenv("TWK_STACKIPNODE_USE_MERGE_FOR_REPLACE")[0] != '0');
     } // namespace
@@ -47,6 +49,7 @@ namespace IPCore
         , m_fit(true)
         , m_rangeInfoDirty(false)
         , m_activeAudioInputIndex(-2)
+        , m_inputsIndependent(0)
     {
         pthread_mutex_init(&m_lock, 0);
         setHasLinearTransform(m_fit);
@@ -329,6 +332,72 @@ namespace IPCore
         m_structureInfoDirty = false;
     }
 
+    bool StackIPNode::inputInStrictRange(size_t index, int frame, bool useCutInfo)
+    {
+        const int inF = inputFrame(index, frame, true);
+        const ImageRangeInfo& info = m_rangeInfos[index];
+
+        if (useCutInfo)
+            return inF >= info.cutIn && inF <= info.cutOut;
+        else
+            return inF >= info.start && inF <= info.end;
+    }
+
+    bool StackIPNode::inputsAreIndependent() const
+    {
+        //
+        //  The answer is kept with the IPNode::inputsGeneration() it was
+        //  computed for (generation << 1 | answer) so it's only
+        //  recomputed after something in the graph is reconnected.
+        //
+
+        const uint64_t g = inputsGeneration();
+        const uint64_t cached = m_inputsIndependent.load(std::memory_order_acquire);
+
+        if (cached >> 1 == g)
+            return cached & 1;
+
+        const bool independent = computeInputsAreIndependent();
+        m_inputsIndependent.store((g << 1) | (independent ? 1 : 0), std::memory_order_release);
+        return independent;
+    }
+
+    bool StackIPNode::computeInputsAreIndependent() const
+    {
+        //
+        //  True if no node can be reached from more than one of the
+        //  inputs. Group nodes own their members so walking the inputs
+        //  is enough.
+        //
+
+        const IPNodes& nodes = inputs();
+        IPNodeSet seen;
+
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            IPNodeSet mine;
+            IPNodes stack(1, nodes[i]);
+
+            while (!stack.empty())
+            {
+                IPNode* n = stack.back();
+                stack.pop_back();
+
+                if (!mine.insert(n).second)
+                    continue;
+                if (seen.count(n))
+                    return false;
+
+                const IPNodes& ins = n->inputs();
+                stack.insert(stack.end(), ins.begin(), ins.end());
+            }
+
+            seen.insert(mine.begin(), mine.end());
+        }
+
+        return true;
+    }
+
     int StackIPNode::inputFrame(size_t index, int frame, bool unconstrained)
     {
         const ImageRangeInfo& info = m_rangeInfos[index];
@@ -522,24 +591,103 @@ namespace IPCore
         {
             bool haveOneImage = false;
 
-            for (unsigned int i = 0; i < ninputs; i++)
+            //
+            //  Stacks (and layouts) of independent sources evaluate each
+            //  input on the task pool. Only done when nothing is shared
+            //  between the inputs' subgraphs: a source node's per-thread
+            //  readers are indexed by the eval thread number, which all
+            //  of the tasks share.
+            //
+
+            const bool parallel = !topmostOnly && !dissolveOnly && !serialInputs && ninputs > 1
+                                  && TwkUtil::TaskPool::globalPool() && !graph()->needsProfilingSamples()
+                                  && inputsAreIndependent();
+
+            if (parallel)
             {
-                if (strictFrameRanges)
+                vector<int> indices;
+                vector<Context> contexts;
+
+                for (unsigned int i = 0; i < ninputs; i++)
                 {
-                    int inF = inputFrame(i, frame, true);
-                    const ImageRangeInfo& info = m_rangeInfos[i];
+                    if (strictFrameRanges && !inputInStrictRange(i, frame, useCutInfo))
+                        continue;
 
-                    if (useCutInfo)
+                    Context c = context;
+                    c.fps = m_outputFPS->front();
+                    c.frame = inputFrame(i, frame);
+
+                    indices.push_back(i);
+                    contexts.push_back(c);
+                }
+
+                IPImageVector results(indices.size(), (IPImage*)0);
+
+                {
+                    TwkUtil::TaskPool::Group group(TwkUtil::TaskPool::globalPool());
+
+                    for (size_t q = 0; q < indices.size(); q++)
                     {
-                        if (inF < info.cutIn || inF > info.cutOut)
-                            continue;
+                        group.run([&, q] { results[q] = nodes[indices[q]]->evaluate(contexts[q]); });
+                    }
+
+                    try
+                    {
+                        group.wait();
+                    }
+                    catch (std::exception&)
+                    {
+                        //
+                        //  Hand whatever did get evaluated to the handler
+                        //  below so it's checked back in
+                        //
+
+                        for (size_t q = 0; q < results.size(); q++)
+                        {
+                            if (results[q])
+                                images.push_back(results[q]);
+                        }
+
+                        throw;
+                    }
+                }
+
+                for (size_t q = 0; q < results.size(); q++)
+                {
+                    IPImage* current = results[q];
+
+                    if (!current)
+                    {
+                        //
+                        //  Put the rest where the handler will find them
+                        //
+
+                        for (size_t r = q + 1; r < results.size(); r++)
+                        {
+                            if (results[r])
+                                images.push_back(results[r]);
+                        }
+
+                        IPNode* node = nodes[indices[q]];
+                        TWK_THROW_STREAM(EvaluationFailedExc, "StackIPNode evaluation failed on node " << node->name());
+                    }
+                    else if (current->isNoImage() || current->isBlank())
+                    {
+                        delete current;
                     }
                     else
                     {
-                        if (inF < info.start || inF > info.end)
-                            continue;
+                        if (m_fit)
+                            current->fitToAspect(aspect);
+                        images.push_back(current);
                     }
                 }
+            }
+
+            for (unsigned int i = 0; !parallel && i < ninputs; i++)
+            {
+                if (strictFrameRanges && !inputInStrictRange(i, frame, useCutInfo))
+                    continue;
 
                 if (topmostOnly)
                 {
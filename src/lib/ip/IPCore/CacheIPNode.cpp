@@ -8,6 +8,7 @@
 
 #include <IPCore/CacheIPNode.h>
 #include <IPCore/Exception.h>
+#include <IPCore/FBProxyCache.h>
 #include <IPCore/ShaderCommon.h>
 #include <iostream>
 #include <IPCore/IPGraph.h>
@@ -93,8 +94,8 @@ namespace IPCore
 
             try
             {
-                DB("IPImageTreeFromIDTree: calling checkOut " << id->id);
-                TwkFB::FrameBuffer* fb = context.cache.checkOut(id->id);
+                DB("IPImageTreeFromIDTree: calling checkOutOrRestore " << id->id);
+                TwkFB::FrameBuffer* fb = context.cache.checkOutOrRestore(id->id);
                 const IPNode* snode = node->sourceNode();
                 img = fb ? (new IPImage(snode, IPImage::BlendRenderType, fb)) : (new IPImage(snode));
 
@@ -144,6 +145,66 @@ namespace IPCore
         }
     };
 
+    //
+    //  Builds an IPImage tree from the reduced resolution proxies of the
+    //  ids. Unlike the above nothing is checked out of the cache: each
+    //  proxy carries its own static reference which the IPImage releases.
+    //  Only a complete tree is useful so any missing proxy is a miss.
+    //
+
+    struct ProxyImageTreeFromIDTree
+    {
+        ProxyImageTreeFromIDTree(FBProxyCache* c, const CacheIPNode* n)
+            : proxies(c)
+            , missed(false)
+            , node(n)
+        {
+        }
+
+        FBProxyCache* proxies;
+        bool missed;
+        const CacheIPNode* node;
+
+        IPImage* operator()(IPImageID* id)
+        {
+            TwkFB::FrameBuffer* fb = missed ? 0 : proxies->checkOut(id->id);
+
+            if (!fb)
+            {
+                missed = true;
+                return new IPImage(node);
+            }
+
+            IPImage* img = new IPImage(node->sourceNode(), IPImage::BlendRenderType, fb);
+            if (id->noIntermediate)
+                img->noIntermediate = true;
+            return img;
+        }
+    };
+
+    //
+    //  Finds out if any id in an IPImageID tree is in the cache (or can be
+    //  restored from its disk tier). This does not need the cache lock.
+    //
+
+    struct AnyIDCached
+    {
+        AnyIDCached(const FBCache& c)
+            : cache(c)
+            , found(false)
+        {
+        }
+
+        const FBCache& cache;
+        bool found;
+
+        void operator()(IPImageID* id)
+        {
+            if (!found && cache.isCachedOrOnDisk(id->id))
+                found = true;
+        }
+    };
+
     //
     //  Assign source shaders. This has to be the last pass in case we
     //  reused a cached fb (it can get deleted out from under the
@@ -350,6 +411,17 @@ namespace IPCore
                 }
 
                 TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+
+                //
+                //  The fb is checked out so it can be reduced without
+                //  holding the cache lock.
+                //
+
+                if (thread == IPNode::CacheEvalThread && fb->inCache())
+                {
+                    if (FBProxyCache* proxies = context.cache.proxyCache())
+                        proxies->storeProxyOf(fb);
+                }
             }
         }
     };
@@ -460,14 +532,34 @@ namespace IPCore
 
         PROFILE_SAMPLE(profile, cacheQueryStart);
 
-        TWK_CACHE_LOCK(context.cache, "thread=" << thread);
+        //
+        //  While the cache is filling most evaluations are complete
+        //  misses. Those are detected without the cache lock so the
+        //  caching threads don't contend with the display thread for
+        //  nothing. It takes one hit to need the locked lookup.
+        //
+
+        AnyIDCached anyCached(context.cache);
+        foreach_ip(idTree, anyCached);
 
-        IPImageTreeFromIDTree F(context, this);
+        const bool locked = anyCached.found;
+        IPImage* root = 0;
 
-        DB("evaluate: calling transform_ip with callable "
-           "IPImageTreeFromIDTree ");
-        IPImage* root = transform_ip<IPImage, IPImageID, IPImageTreeFromIDTree>(idTree, F);
-        missed = F.missed || missed;
+        if (locked)
+        {
+            TWK_CACHE_LOCK(context.cache, "thread=" << thread);
+
+            IPImageTreeFromIDTree F(context, this);
+
+            DB("evaluate: calling transform_ip with callable "
+               "IPImageTreeFromIDTree ");
+            root = transform_ip<IPImage, IPImageID, IPImageTreeFromIDTree>(idTree, F);
+            missed = F.missed || missed;
+        }
+        else
+        {
+            missed = true;
+        }
 
         if (missed)
         {
@@ -493,11 +585,45 @@ namespace IPCore
             delete root;
             root = 0;
 
-            TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+            if (locked)
+                TWK_CACHE_UNLOCK(context.cache, "thread=" << thread);
+
+            //
+            //  If the display would have to wait for the reader and the
+            //  caching threads have already left proxies of this frame
+            //  behind, show those. The frame is the cache's display frame
+            //  so the caching threads get to the full resolution version
+            //  first and the next render (the UI keeps rendering while
+            //  caching) picks it up. If the display stops on the frame
+            //  before that happens the Session renders it again and this
+            //  time it's evaluated at full resolution.
+            //
+
+            FBProxyCache* proxies = context.cache.proxyCache();
+
+            if (thread == DisplayEvalThread && !missing && proxies && idTree && context.cache.useProxiesAt(context.frame))
+            {
+                ProxyImageTreeFromIDTree P(proxies, this);
+                root = transform_ip<IPImage, IPImageID, ProxyImageTreeFromIDTree>(idTree, P);
+
+                if (P.missed)
+                {
+                    delete root;
+                    root = 0;
+                }
+                else
+                {
+                    context.cache.proxyShown(context.frame);
+                }
+            }
+
             delete idTree; // clean up previously used identifiers
 
             PROFILE_SAMPLE(profile, cacheQueryEnd);
+        }
 
+        if (missed && !root)
+        {
             if (thread == DisplayNoEvalThread)
             {
                 //
@@ -537,7 +663,7 @@ namespace IPCore
 
             PROFILE_SAMPLE(profile, cacheEvalEnd);
         }
-        else
+        else if (!missed)
         {
             //
             //  All of the fbs were in the cache. Append them to the image
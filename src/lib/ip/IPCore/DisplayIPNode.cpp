@@ -40,6 +40,7 @@ namespace IPCore
 
     DisplayIPNode::DisplayIPNode(const std::string& name, const NodeDefinition* def, IPGraph* g, GroupIPNode* group)
         : LUTIPNode(name, def, g, group)
+        , m_userMatrix(this, "color.matrix")
     {
         setMaxInputs(1);
         setHasLinearTransform(true); // fits to aspect
@@ -362,7 +363,7 @@ namespace IPCore
         //  Check for user matrix
         //
 
-        if (Mat44fProperty* dmatrix = property<Mat44fProperty>("color.matrix"))
+        if (Mat44fProperty* dmatrix = m_userMatrix.get())
         {
             if (dmatrix->size() > 0)
             {
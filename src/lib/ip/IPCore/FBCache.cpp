@@ -7,12 +7,16 @@
 //******************************************************************************
 
 #include <IPCore/FBCache.h>
+#include <IPCore/FBDiskCache.h>
+#include <IPCore/FBProxyCache.h>
 #include <IPCore/IPGraph.h>
 #include <IPCore/IPImage.h>
 #include <IPCore/Application.h>
 #include <TwkUtil/EnvVar.h>
+#include <TwkUtil/MemPool.h>
 #include <TwkUtil/ThreadName.h>
 #include <TwkUtil/Timer.h>
+#include <TwkUtil/Trace.h>
 
 static ENVVAR_BOOL(evActiveTailCaching, "RV_ACTIVE_TAIL_CACHING", false);
 
@@ -769,9 +773,13 @@ namespace IPCore
         , m_activeTailCachingEnabled(false)
         , m_cacheStatsDisabled(false)
         , m_cacheStatsDirty(true)
+        , m_proxyFrame(NAF)
+        , m_fullResFrame(NAF)
     {
         m_cacheEdges = new CacheEdges(this);
         m_perNodeCache = new PerNodeCache(this);
+        m_diskCache = FBDiskCache::createFromEnvironment();
+        m_proxyCache = FBProxyCache::createFromEnvironment();
         pthread_mutex_init(&m_statMutex, 0);
 
         m_cacheStatsDisabled = IPCore::App()->optionValue<bool>("disableCacheStats", false);
@@ -785,6 +793,16 @@ namespace IPCore
 
     FBCache::~FBCache()
     {
+        //
+        //  Delete the tiers first so clearInternal() doesn't empty them:
+        //  a persistent disk tier is kept for the next session.
+        //
+
+        delete m_diskCache;
+        delete m_proxyCache;
+        m_diskCache = 0;
+        m_proxyCache = 0;
+
         lock();
         clearInternal();
         delete m_cacheEdges;
@@ -1022,6 +1040,7 @@ namespace IPCore
                 }
 
                 setCacheStatsDirty();
+                TWK_TRACE_COUNTER("cache", "cache bytes", used());
                 if (isFrameCached(frame))
                 {
                     DBL(DB_EDGES, "add() calling addCacheEdge (1)" << frame << ", " << m_frames[frame].size() << " ids for this frame");
@@ -1040,6 +1059,7 @@ namespace IPCore
             }
             else
             {
+                TWK_TRACE_INSTANT("cache", "cache full", "frame", frame);
                 checkMetadata();
                 return false;
             }
@@ -1295,6 +1315,7 @@ namespace IPCore
             "clearInternal() current " << m_currentBytes << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
 
         clearFrameCaches();
+        clearTiers();
         //
         //  We no longer clear the lower-level cache here, since it has
         //  a trash collection scheme that should let us reuse fb's that
@@ -1309,7 +1330,9 @@ namespace IPCore
                                                   << " max " << m_maxBytes << " " << double(m_currentBytes) / double(m_maxBytes));
 
         //
-        //  This only clears frame-level data unless "force" is true.
+        //  This only clears frame-level data unless "force" is true. The
+        //  disk and proxy tiers are left alone: this runs for every
+        //  displayed frame when caching is off.
         //
 
         if (m_frames.size() == 0 || (m_frames.size() == 1 && m_frames.begin()->first == frame))
@@ -1745,7 +1768,97 @@ namespace IPCore
     //  is already available, or it may free more than requested if the
     //  cache is over-full.
     //
-    bool FBCache::free(size_t inbytes) { return freeInternal(inbytes, true); }
+    bool FBCache::free(size_t inbytes)
+    {
+        TWK_TRACE_SCOPE("cache", "FBCache::free");
+        const bool freed = freeInternal(inbytes, true);
+        TWK_TRACE_COUNTER("cache", "cache bytes", used());
+        return freed;
+    }
+
+    //
+    //  An fb is leaving memory for good. If there's a disk tier give it
+    //  the fb instead of deleting it so a later miss can be served
+    //  without going back to the reader.
+    //
+    size_t FBCache::evictFB(FrameBuffer* fb)
+    {
+        if (m_diskCache)
+        {
+            const size_t bytes = fb->totalImageSize();
+            if (m_diskCache->store(fb))
+                return bytes;
+        }
+
+        return TwkFB::Cache::evictFB(fb);
+    }
+
+    TwkFB::FrameBuffer* FBCache::checkOutOrRestore(const IDString& idstring)
+    {
+        if (FrameBuffer* fb = checkOut(idstring))
+            return fb;
+
+        if (!m_diskCache || idstring.empty() || idstring[0] == '|')
+            return 0;
+
+        FrameBuffer* fb = m_diskCache->restore(idstring);
+
+        if (!fb)
+            return 0;
+
+        DBL(DB_GENERAL, "checkOutOrRestore() restored " << idstring << " from disk");
+
+        //
+        //  Forced, like any fb that was just evaluated (see
+        //  UseCacheImageIfExists). The frame-level references are added
+        //  by the caller once all of the frame's fbs are found.
+        //
+
+        TwkFB::Cache::add(fb, true);
+        checkOut(fb);
+        setCacheStatsDirty();
+
+        return fb;
+    }
+
+    bool FBCache::isCachedOrOnDisk(const IDString& idstring) const
+    {
+        if (isCached(idstring))
+            return true;
+
+        return m_diskCache && !idstring.empty() && idstring[0] != '|' && m_diskCache->contains(idstring);
+    }
+
+    void FBCache::flushDiskTier(const IDString& idstring)
+    {
+        if (m_diskCache)
+            m_diskCache->flush(idstring);
+    }
+
+    void FBCache::flushProxyTier(const IDString& idstring)
+    {
+        if (m_proxyCache)
+            m_proxyCache->flush(idstring);
+    }
+
+    bool FBCache::refreshProxyFrame(int frame)
+    {
+        int f = frame;
+
+        if (!m_proxyFrame.compare_exchange_strong(f, NAF))
+            return false;
+
+        m_fullResFrame = frame;
+        return true;
+    }
+
+    void FBCache::clearTiers()
+    {
+        if (m_diskCache)
+            m_diskCache->clear();
+        if (m_proxyCache)
+            m_proxyCache->clear();
+    }
 
     bool FBCache::freeInternal(size_t inbytes, bool freeMemory)
     {
@@ -1953,6 +2066,30 @@ namespace IPCore
         m_cacheStats.capacity = capacity();
         m_cacheStats.used = used();
 
+        if (m_diskCache)
+        {
+            FBDiskCache::Stats dstats = m_diskCache->stats();
+            m_cacheStats.diskCapacity = dstats.capacity;
+            m_cacheStats.diskUsed = dstats.used;
+            m_cacheStats.diskHits = dstats.hits;
+            m_cacheStats.diskMisses = dstats.misses;
+            m_cacheStats.diskWrites = dstats.writes;
+        }
+
+        if (m_proxyCache)
+        {
+            FBProxyCache::Stats xstats = m_proxyCache->stats();
+            m_cacheStats.proxyCapacity = xstats.capacity;
+            m_cacheStats.proxyUsed = xstats.used;
+            m_cacheStats.proxyCount = xstats.count;
+            m_cacheStats.proxyHits = xstats.hits;
+        }
+
+        TwkUtil::MemPool::Stats pstats = TwkUtil::MemPool::stats();
+        m_cacheStats.poolHits = pstats.hits;
+        m_cacheStats.poolMisses = pstats.misses;
+        m_cacheStats.poolResident = pstats.residentBytes;
+
         //
         //  This requires some work
         //
@@ -2373,6 +2510,16 @@ namespace IPCore
             ret = ret || success;
         }
 
+        if (m_diskCache)
+        {
+            m_diskCache->flushSubstr(vector<string>(subStrings.begin(), subStrings.end()));
+        }
+
+        if (m_proxyCache)
+        {
+            m_proxyCache->flushSubstr(vector<string>(subStrings.begin(), subStrings.end()));
+        }
+
         return ret;
     }
 
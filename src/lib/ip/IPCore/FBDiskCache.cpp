@@ -0,0 +1,1085 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/FBDiskCache.h>
+#include <TwkFB/Attribute.h>
+#include <TwkMath/Vec3.h>
+#include <TwkMath/Vec4.h>
+#include <TwkUtil/EnvVar.h>
+#include <TwkUtil/FNV1a.h>
+#include <TwkUtil/MemPool.h>
+#include <TwkUtil/ThreadName.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+static ENVVAR_STRING(evDiskCacheDir, "RV_DISK_CACHE_DIR", "");
+static ENVVAR_INT(evDiskCacheSize, "RV_DISK_CACHE_SIZE", 16384);
+static ENVVAR_BOOL(evDiskCachePersistent, "RV_DISK_CACHE_PERSISTENT", false);
+
+namespace IPCore
+{
+    using namespace std;
+    using namespace TwkFB;
+    using namespace TwkMath;
+
+    namespace
+    {
+
+        //
+        //  File layout:
+        //
+        //      FileHeader
+        //      metadata (FileHeader::metaSize bytes): id, planes, attributes
+        //      pixels of each plane at an offset aligned to PixelAlignment
+        //
+        //  The pixel alignment is large enough to be a multiple of the
+        //  page size (and mmap offset granularity) on every platform.
+        //
+
+        const unsigned int Magic = 0x43445652; // "RVDC"
+        const unsigned int Version = 1;
+        const size_t PixelAlignment = 64 * 1024;
+        const size_t MaxPendingBytes = size_t(1024) * 1024 * 1024;
+        const char* EntryExtension = ".rvfb";
+
+        struct FileHeader
+        {
+            unsigned int magic;
+            unsigned int version;
+            unsigned long long metaSize;
+        };
+
+        struct PlaneLayout
+        {
+            int coordinateType;
+            int width;
+            int height;
+            int depth;
+            int numChannels;
+            int dataType;
+            int orientation;
+            int extraScanlines;
+            int extraScanlinePixels;
+            int uncrop;
+            int uncropWidth;
+            int uncropHeight;
+            int uncropX;
+            int uncropY;
+            float pixelAspect;
+            unsigned long long allocSize;
+            unsigned long long offset;
+        };
+
+        enum AttributeTag
+        {
+            StringTag = 1,
+            FloatTag,
+            IntTag,
+            BoolTag,
+            DoubleTag,
+            ShortTag,
+            UCharTag,
+            Vec2fTag,
+            Vec2iTag,
+            Vec3fTag,
+            Vec3iTag,
+            Vec4fTag,
+            Vec4iTag,
+            Mat33fTag,
+            Mat44fTag,
+            FloatVectorTag,
+            IntVectorTag,
+            StringVectorTag,
+            DataTag
+        };
+
+        size_t alignUp(size_t n) { return (n + PixelAlignment - 1) / PixelAlignment * PixelAlignment; }
+
+        class MetaWriter
+        {
+        public:
+            template <typename T> void put(const T& v) { m_buffer.append((const char*)&v, sizeof(T)); }
+
+            void putString(const string& s)
+            {
+                put((unsigned int)s.size());
+                m_buffer.append(s);
+            }
+
+            const string& buffer() const { return m_buffer; }
+
+        private:
+            string m_buffer;
+        };
+
+        class MetaReader
+        {
+        public:
+            MetaReader(const char* p, size_t n)
+                : m_p(p)
+                , m_end(p + n)
+                , m_ok(true)
+            {
+            }
+
+            template <typename T> T get()
+            {
+                T v = T();
+                if (m_ok && size_t(m_end - m_p) >= sizeof(T))
+                {
+                    memcpy(&v, m_p, sizeof(T));
+                    m_p += sizeof(T);
+                }
+                else
+                    m_ok = false;
+                return v;
+            }
+
+            string getString()
+            {
+                unsigned int n = get<unsigned int>();
+                if (!m_ok || size_t(m_end - m_p) < n)
+                {
+                    m_ok = false;
+                    return string();
+                }
+                string s(m_p, n);
+                m_p += n;
+                return s;
+            }
+
+            bool ok() const { return m_ok; }
+
+        private:
+            const char* m_p;
+            const char* m_end;
+            bool m_ok;
+        };
+
+        template <typename T> bool putValue(MetaWriter& w, const FBAttribute* a, AttributeTag tag)
+        {
+            if (const TypedFBAttribute<T>* ta = dynamic_cast<const TypedFBAttribute<T>*>(a))
+            {
+                w.put(int(tag));
+                w.putString(a->name());
+                w.put(ta->value());
+                return true;
+            }
+
+            return false;
+        }
+
+        template <typename T> bool putVector(MetaWriter& w, const FBAttribute* a, AttributeTag tag)
+        {
+            if (const TypedFBVectorAttribute<T>* ta = dynamic_cast<const TypedFBVectorAttribute<T>*>(a))
+            {
+                w.put(int(tag));
+                w.putString(a->name());
+                w.put((unsigned int)ta->value().size());
+                for (size_t i = 0; i < ta->value().size(); i++)
+                    w.put(ta->value()[i]);
+                return true;
+            }
+
+            return false;
+        }
+
+        bool putAttribute(MetaWriter& w, const FBAttribute* a)
+        {
+            if (const StringAttribute* sa = dynamic_cast<const StringAttribute*>(a))
+            {
+                w.put(int(StringTag));
+                w.putString(a->name());
+                w.putString(sa->value());
+                return true;
+            }
+            else if (const TypedFBVectorAttribute<string>* sva = dynamic_cast<const TypedFBVectorAttribute<string>*>(a))
+            {
+                w.put(int(StringVectorTag));
+                w.putString(a->name());
+                w.put((unsigned int)sva->value().size());
+                for (size_t i = 0; i < sva->value().size(); i++)
+                    w.putString(sva->value()[i]);
+                return true;
+            }
+            else if (const DataContainerAttribute* da = dynamic_cast<const DataContainerAttribute*>(a))
+            {
+                w.put(int(DataTag));
+                w.putString(a->name());
+                w.putString(string((const char*)da->data(), da->size()));
+                return true;
+            }
+
+            return putValue<float>(w, a, FloatTag) || putValue<int>(w, a, IntTag) || putValue<bool>(w, a, BoolTag)
+                   || putValue<double>(w, a, DoubleTag) || putValue<short>(w, a, ShortTag) || putValue<unsigned char>(w, a, UCharTag)
+                   || putValue<Vec2f>(w, a, Vec2fTag) || putValue<Vec2i>(w, a, Vec2iTag) || putValue<Vec3f>(w, a, Vec3fTag)
+                   || putValue<Vec3i>(w, a, Vec3iTag) || putValue<Vec4f>(w, a, Vec4fTag) || putValue<Vec4i>(w, a, Vec4iTag)
+                   || putValue<Mat33f>(w, a, Mat33fTag) || putValue<Mat44f>(w, a, Mat44fTag) || putVector<float>(w, a, FloatVectorTag)
+                   || putVector<int>(w, a, IntVectorTag);
+        }
+
+        template <typename T> FBAttribute* getValue(MetaReader& r, const string& name)
+        {
+            T v = r.get<T>();
+            return r.ok() ? new TypedFBAttribute<T>(name, v) : 0;
+        }
+
+        template <typename T> FBAttribute* getVector(MetaReader& r, const string& name)
+        {
+            vector<T> v(r.get<unsigned int>());
+            for (size_t i = 0; r.ok() && i < v.size(); i++)
+                v[i] = r.get<T>();
+            return r.ok() ? new TypedFBVectorAttribute<T>(name, v) : 0;
+        }
+
+        FBAttribute* getAttribute(MetaReader& r)
+        {
+            const int tag = r.get<int>();
+            const string name = r.getString();
+
+            if (!r.ok())
+                return 0;
+
+            switch (tag)
+            {
+            case StringTag:
+            {
+                string s = r.getString();
+                return r.ok() ? new StringAttribute(name, s) : 0;
+            }
+            case StringVectorTag:
+            {
+                vector<string> v(r.get<unsigned int>());
+                for (size_t i = 0; r.ok() && i < v.size(); i++)
+                    v[i] = r.getString();
+                return r.ok() ? new TypedFBVectorAttribute<string>(name, v) : 0;
+            }
+            case DataTag:
+            {
+                string s = r.getString();
+                return r.ok() ? new DataContainerAttribute(name, s.data(), s.size()) : 0;
+            }
+            case FloatTag:
+                return getValue<float>(r, name);
+            case IntTag:
+                return getValue<int>(r, name);
+            case BoolTag:
+                return getValue<bool>(r, name);
+            case DoubleTag:
+                return getValue<double>(r, name);
+            case ShortTag:
+                return getValue<short>(r, name);
+            case UCharTag:
+                return getValue<unsigned char>(r, name);
+            case Vec2fTag:
+                return getValue<Vec2f>(r, name);
+            case Vec2iTag:
+                return getValue<Vec2i>(r, name);
+            case Vec3fTag:
+                return getValue<Vec3f>(r, name);
+            case Vec3iTag:
+                return getValue<Vec3i>(r, name);
+            case Vec4fTag:
+                return getValue<Vec4f>(r, name);
+            case Vec4iTag:
+                return getValue<Vec4i>(r, name);
+            case Mat33fTag:
+                return getValue<Mat33f>(r, name);
+            case Mat44fTag:
+                return getValue<Mat44f>(r, name);
+            case FloatVectorTag:
+                return getVector<float>(r, name);
+            case IntVectorTag:
+                return getVector<int>(r, name);
+            default:
+                return 0;
+            }
+        }
+
+        //
+        //  Serialize everything but the pixels. Returns false if the fb
+        //  can't be faithfully represented on disk.
+        //
+
+        bool serializeMeta(const FrameBuffer* fb, const string& id, string& out, size_t& pixelBytes)
+        {
+            MetaWriter w;
+            size_t nplanes = fb->numPlanes();
+            size_t offset = 0;
+
+            //
+            //  The offsets depend on the size of the metadata so do a
+            //  first pass to compute the size then a second one for
+            //  real. The metadata size does not depend on the offsets.
+            //
+
+            for (int pass = 0; pass < 2; pass++)
+            {
+                w = MetaWriter();
+                w.putString(id);
+                w.put((unsigned int)nplanes);
+
+                size_t poffset = offset;
+
+                for (const FrameBuffer* p = fb; p; p = p->nextPlane())
+                {
+                    if (p->allocSize() == 0 || !p->pixels<unsigned char>())
+                        return false;
+
+                    PlaneLayout layout;
+                    layout.coordinateType = p->coordinateType();
+                    layout.width = p->width();
+                    layout.height = p->height();
+                    layout.depth = p->depth();
+                    layout.numChannels = p->numChannels();
+                    layout.dataType = p->dataType();
+                    layout.orientation = p->orientation();
+                    layout.extraScanlines = p->extraScanlines();
+                    layout.extraScanlinePixels = p->scanlinePixelPadding();
+                    layout.uncrop = p->uncrop() ? 1 : 0;
+                    layout.uncropWidth = p->uncropWidth();
+                    layout.uncropHeight = p->uncropHeight();
+                    layout.uncropX = p->uncropX();
+                    layout.uncropY = p->uncropY();
+                    layout.pixelAspect = p->pixelAspectRatio();
+                    layout.allocSize = p->allocSize();
+                    layout.offset = poffset;
+                    w.put(layout);
+
+                    poffset = alignUp(poffset + p->allocSize());
+
+                    w.put((unsigned int)p->channelNames().size());
+                    for (size_t i = 0; i < p->channelNames().size(); i++)
+                        w.putString(p->channelName(i));
+
+                    const FrameBuffer::AttributeVector& attrs = p->attributes();
+                    w.put((unsigned int)attrs.size());
+
+                    for (size_t i = 0; i < attrs.size(); i++)
+                    {
+                        if (!putAttribute(w, attrs[i]))
+                            return false;
+                    }
+                }
+
+                pixelBytes = poffset - offset;
+                offset = alignUp(sizeof(FileHeader) + w.buffer().size());
+            }
+
+            FileHeader header;
+            header.magic = Magic;
+            header.version = Version;
+            header.metaSize = w.buffer().size();
+
+            out.assign((const char*)&header, sizeof(FileHeader));
+            out.append(w.buffer());
+            return true;
+        }
+
+        bool readFully(int fd, char* p, size_t n)
+        {
+            while (n)
+            {
+                ssize_t r = ::read(fd, p, n);
+                if (r <= 0)
+                {
+                    if (r < 0 && errno == EINTR)
+                        continue;
+                    return false;
+                }
+                p += r;
+                n -= r;
+            }
+
+            return true;
+        }
+
+        bool writeFully(int fd, const char* p, size_t n)
+        {
+            while (n)
+            {
+                ssize_t r = ::write(fd, p, n);
+                if (r <= 0)
+                {
+                    if (r < 0 && errno == EINTR)
+                        continue;
+                    return false;
+                }
+                p += r;
+                n -= r;
+            }
+
+            return true;
+        }
+
+        bool readMeta(int fd, string& meta)
+        {
+            FileHeader header;
+
+            if (!readFully(fd, (char*)&header, sizeof(FileHeader)) || header.magic != Magic || header.version != Version
+                || header.metaSize > 64 * 1024 * 1024)
+            {
+                return false;
+            }
+
+            meta.resize(header.metaSize);
+            return readFully(fd, &meta[0], meta.size());
+        }
+
+#ifdef WIN32
+        int openForRead(const string& path) { return ::open(path.c_str(), O_RDONLY | O_BINARY); }
+
+        int openForWrite(const string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644); }
+#else
+        int openForRead(const string& path) { return ::open(path.c_str(), O_RDONLY); }
+
+        int openForWrite(const string& path) { return ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644); }
+#endif
+
+        //
+        //  True if the file is named after the hash of id (see
+        //  FBDiskCache::pathForID())
+        //
+
+        bool hasHashName(const boost::filesystem::path& p, const string& id)
+        {
+            ostringstream str;
+            str << hex << TwkUtil::FNV1a64(id.data(), id.size());
+            const string hash = str.str();
+            const string stem = p.stem().string();
+
+            return stem == hash || (stem.size() > hash.size() + 1 && stem.compare(0, hash.size() + 1, hash + "-") == 0);
+        }
+
+        //
+        //  Returns the pixels of one plane. On POSIX systems the file is
+        //  mapped copy-on-write and the mapping handed to MemPool so that
+        //  the FrameBuffer can release it like any other large block.
+        //
+
+        unsigned char* mapPlane(int fd, const PlaneLayout& layout)
+        {
+#ifndef WIN32
+            void* p = mmap(0, layout.allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, off_t(layout.offset));
+
+            if (p == MAP_FAILED)
+                return 0;
+
+            //
+            //  Let the kernel start reading the pages now; they'll be
+            //  touched as soon as the frame is uploaded.
+            //
+
+            madvise(p, layout.allocSize, MADV_WILLNEED);
+            TwkUtil::MemPool::adoptMappedBlock(p, layout.allocSize);
+            return (unsigned char*)p;
+#else
+            unsigned char* p = (unsigned char*)FrameBuffer::allocateLargeBlock(layout.allocSize);
+
+            if (p && (_lseeki64(fd, layout.offset, SEEK_SET) < 0 || !readFully(fd, (char*)p, layout.allocSize)))
+            {
+                FrameBuffer::deallocateLargeBlock(p);
+                return 0;
+            }
+
+            return p;
+#endif
+        }
+
+    } // namespace
+
+    FBDiskCache::FBDiskCache(const string& directory, size_t capacity, bool persistent)
+        : m_directory(directory)
+        , m_capacity(capacity)
+        , m_maxPending(min(capacity, MaxPendingBytes))
+        , m_persistent(persistent)
+        , m_shutdown(false)
+        , m_writer(0)
+    {
+        m_stats.capacity = capacity;
+        if (persistent)
+            scanDirectory();
+        m_writer = new boost::thread([this]() { writerMain(); });
+    }
+
+    FBDiskCache::~FBDiskCache()
+    {
+        {
+            ScopedLock lock(m_mutex);
+            m_shutdown = true;
+        }
+
+        m_pendingCond.notify_all();
+        m_writer->join();
+        delete m_writer;
+
+        for (size_t i = 0; i < m_pending.size(); i++)
+            delete m_pending[i].fb;
+        m_pending.clear();
+
+        if (!m_persistent)
+        {
+            clear();
+            boost::system::error_code ec;
+            boost::filesystem::remove(m_directory, ec);
+        }
+    }
+
+    FBDiskCache* FBDiskCache::createFromEnvironment()
+    {
+        const string root = evDiskCacheDir.getValue();
+
+        if (root.empty())
+            return 0;
+
+        //
+        //  RV_DISK_CACHE_DIR can be shared by several sessions. Unless
+        //  the cache is persistent each session uses its own directory
+        //  in it, so it never touches another session's files.
+        //
+
+        const bool persistent = evDiskCachePersistent.getValue();
+        const string dir = persistent ? root : root + "/session-" + boost::filesystem::unique_path("%%%%%%%%%%%%%%%%").string();
+
+        try
+        {
+            boost::filesystem::create_directories(dir);
+        }
+        catch (std::exception& exc)
+        {
+            cerr << "ERROR: disk cache: cannot create " << dir << ": " << exc.what() << endl;
+            return 0;
+        }
+
+        const size_t capacity = size_t(max(evDiskCacheSize.getValue(), 0)) * 1024 * 1024;
+
+        if (capacity == 0)
+            return 0;
+
+        cout << "INFO: disk cache enabled in " << dir << " (" << capacity / (1024 * 1024) << " MB)" << endl;
+
+        return new FBDiskCache(dir, capacity, persistent);
+    }
+
+    string FBDiskCache::pathForID(const IDString& id) const
+    {
+        //
+        //  Entries are named by the hash of their identifier. If another
+        //  identifier with the same hash already has that file, use the
+        //  next free "<hash>-<n>" instead.
+        //
+
+        ostringstream base;
+        base << m_directory << "/" << hex << TwkUtil::FNV1a64(id.data(), id.size());
+
+        for (size_t n = 0;; n++)
+        {
+            ostringstream str;
+            str << base.str();
+            if (n)
+                str << "-" << n;
+            str << EntryExtension;
+
+            PathMap::const_iterator i = m_paths.find(str.str());
+
+            if (i == m_paths.end() || i->second == id)
+                return str.str();
+        }
+    }
+
+    void FBDiskCache::setCapacity(size_t bytes)
+    {
+        ScopedLock lock(m_mutex);
+        m_capacity = bytes;
+        m_stats.capacity = bytes;
+        m_maxPending = min(bytes, MaxPendingBytes);
+        evictToCapacity();
+    }
+
+    bool FBDiskCache::store(FrameBuffer* fb)
+    {
+        const IDString id = fb->identifier();
+
+        //
+        //  Missing-frame identifiers (leading '|') and proxy buffers
+        //  (which share pixels with a master fb) are never stored.
+        //
+
+        if (id.empty() || id[0] == '|' || fb->hasAttribute("ProxyBuffers") || fb->hasAttribute("ProxyBufferOwnerPtr"))
+        {
+            ScopedLock lock(m_mutex);
+            m_stats.rejects++;
+            return false;
+        }
+
+        bool alreadyStored = false;
+
+        {
+            ScopedLock lock(m_mutex);
+
+            if (m_shutdown)
+                return false;
+
+            EntryMap::iterator i = m_entries.find(id);
+
+            if (i != m_entries.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, i->second);
+                alreadyStored = true;
+            }
+        }
+
+        if (alreadyStored)
+        {
+            delete fb;
+            return true;
+        }
+
+        PendingWrite w;
+        w.fb = fb;
+        w.id = id;
+
+        if (!serializeMeta(fb, id, w.header, w.bytes))
+        {
+            ScopedLock lock(m_mutex);
+            m_stats.rejects++;
+            return false;
+        }
+
+        {
+            ScopedLock lock(m_mutex);
+
+            if (m_stats.pending + w.bytes > m_maxPending)
+            {
+                m_stats.rejects++;
+                return false;
+            }
+
+            m_stats.pending += w.bytes;
+            m_pending.push_back(w);
+        }
+
+        m_pendingCond.notify_one();
+        return true;
+    }
+
+    bool FBDiskCache::writeEntry(const PendingWrite& w, const string& path)
+    {
+        //
+        //  A persistent directory can be shared with other sessions, so
+        //  the temporary's name is random.
+        //
+
+        const string tmpPath = path + "." + boost::filesystem::unique_path("%%%%%%%%%%%%%%%%").string() + ".tmp";
+        const int fd = openForWrite(tmpPath);
+
+        if (fd < 0)
+            return false;
+
+        bool ok = writeFully(fd, w.header.data(), w.header.size());
+        size_t written = w.header.size();
+        const vector<char> zeros(PixelAlignment, 0);
+
+        for (const FrameBuffer* p = w.fb; ok && p; p = p->nextPlane())
+        {
+            const size_t pad = alignUp(written) - written;
+            ok = writeFully(fd, &zeros.front(), pad) && writeFully(fd, (const char*)p->pixels<unsigned char>(), p->allocSize());
+            written += pad + p->allocSize();
+        }
+
+        ok = (::close(fd) == 0) && ok;
+
+        if (ok)
+        {
+            boost::system::error_code ec;
+            boost::filesystem::rename(tmpPath, path, ec);
+            ok = !ec;
+        }
+
+        if (!ok)
+            ::unlink(tmpPath.c_str());
+
+        return ok;
+    }
+
+    void FBDiskCache::writerMain()
+    {
+        TwkUtil::setThreadName("RV Disk Cache");
+
+        while (true)
+        {
+            PendingWrite w;
+            string path;
+
+            {
+                ScopedLock lock(m_mutex);
+
+                while (m_pending.empty() && !m_shutdown)
+                    m_pendingCond.wait(lock);
+
+                if (m_shutdown)
+                    return;
+
+                w = m_pending.front();
+                m_pending.pop_front();
+                path = pathForID(w.id);
+            }
+
+            const bool ok = writeEntry(w, path);
+            const size_t bytes = w.header.size() + w.bytes;
+
+            {
+                ScopedLock lock(m_mutex);
+                m_stats.pending -= w.bytes;
+
+                if (ok)
+                {
+                    m_stats.writes++;
+                    insertEntry(w.id, path, bytes);
+                    evictToCapacity();
+                }
+                else
+                {
+                    m_stats.rejects++;
+                }
+            }
+
+            delete w.fb;
+        }
+    }
+
+    void FBDiskCache::insertEntry(const IDString& id, const string& path, size_t bytes)
+    {
+        EntryMap::iterator i = m_entries.find(id);
+
+        if (i != m_entries.end())
+        {
+            if (i->second->path != path)
+                m_paths.erase(i->second->path);
+            m_stats.used -= i->second->bytes;
+            m_lru.erase(i->second);
+            m_entries.erase(i);
+        }
+
+        Entry e;
+        e.id = id;
+        e.path = path;
+        e.bytes = bytes;
+
+        m_lru.push_front(e);
+        m_entries[id] = m_lru.begin();
+        m_paths[path] = id;
+        m_stats.used += bytes;
+    }
+
+    void FBDiskCache::removeEntry(EntryMap::iterator i)
+    {
+        const Entry& e = *i->second;
+        ::unlink(e.path.c_str());
+
+        PathMap::iterator p = m_paths.find(e.path);
+        if (p != m_paths.end() && p->second == e.id)
+            m_paths.erase(p);
+
+        m_stats.used -= e.bytes;
+        m_lru.erase(i->second);
+        m_entries.erase(i);
+    }
+
+    void FBDiskCache::evictToCapacity()
+    {
+        while (m_stats.used > m_capacity && !m_lru.empty())
+        {
+            removeEntry(m_entries.find(m_lru.back().id));
+            m_stats.evictions++;
+        }
+    }
+
+    FrameBuffer* FBDiskCache::restore(const IDString& id)
+    {
+        string path;
+
+        {
+            ScopedLock lock(m_mutex);
+
+            //
+            //  Still waiting to be written? Just hand it back.
+            //
+
+            for (PendingQueue::iterator i = m_pending.begin(); i != m_pending.end(); ++i)
+            {
+                if (i->id == id)
+                {
+                    FrameBuffer* fb = i->fb;
+                    m_stats.pending -= i->bytes;
+                    m_stats.hits++;
+                    m_pending.erase(i);
+                    return fb;
+                }
+            }
+
+            EntryMap::iterator i = m_entries.find(id);
+
+            if (i == m_entries.end())
+            {
+                m_stats.misses++;
+                return 0;
+            }
+
+            m_lru.splice(m_lru.begin(), m_lru, i->second);
+            path = i->second->path;
+        }
+
+        //
+        //  The file may be evicted between here and the open; that
+        //  just turns into a miss.
+        //
+
+        FrameBuffer* root = 0;
+        const int fd = openForRead(path);
+        string meta;
+
+        if (fd >= 0 && readMeta(fd, meta))
+        {
+            MetaReader r(meta.data(), meta.size());
+            const string fileID = r.getString();
+            const unsigned int nplanes = r.get<unsigned int>();
+            bool ok = r.ok() && fileID == id && nplanes > 0;
+
+            for (unsigned int n = 0; ok && n < nplanes; n++)
+            {
+                const PlaneLayout layout = r.get<PlaneLayout>();
+                FrameBuffer::StringVector names(r.get<unsigned int>());
+
+                for (size_t i = 0; r.ok() && i < names.size(); i++)
+                    names[i] = r.getString();
+
+                ok = r.ok() && layout.dataType >= 0 && layout.dataType < FrameBuffer::__NUM_TYPES__;
+                unsigned char* pixels = ok ? mapPlane(fd, layout) : 0;
+
+                if (!pixels)
+                {
+                    ok = false;
+                    break;
+                }
+
+                FrameBuffer* fb = new FrameBuffer(FrameBuffer::CoordinateTypes(layout.coordinateType), layout.width, layout.height,
+                                                  layout.depth, layout.numChannels, FrameBuffer::DataType(layout.dataType), pixels,
+                                                  &names, FrameBuffer::Orientation(layout.orientation), true, layout.extraScanlines,
+                                                  layout.extraScanlinePixels);
+
+                const unsigned int nattrs = r.get<unsigned int>();
+
+                for (unsigned int i = 0; ok && i < nattrs; i++)
+                {
+                    if (FBAttribute* a = getAttribute(r))
+                        fb->addAttribute(a);
+                    else
+                        ok = false;
+                }
+
+                if (fb->allocSize() != layout.allocSize)
+                    ok = false;
+
+                if (fb->hasAttribute("PixelAspectRatio"))
+                    fb->setPixelAspectRatio(layout.pixelAspect);
+                fb->setUncrop(layout.uncropWidth, layout.uncropHeight, layout.uncropX, layout.uncropY);
+                fb->setUncropActive(layout.uncrop != 0);
+
+                if (root)
+                    root->appendPlane(fb);
+                else
+                    root = fb;
+            }
+
+            if (ok)
+            {
+                root->setIdentifier(id);
+            }
+            else
+            {
+                delete root;
+                root = 0;
+            }
+        }
+
+        if (fd >= 0)
+            ::close(fd);
+
+        ScopedLock lock(m_mutex);
+
+        if (root)
+        {
+            m_stats.hits++;
+        }
+        else
+        {
+            m_stats.misses++;
+            EntryMap::iterator i = m_entries.find(id);
+            if (i != m_entries.end())
+                removeEntry(i);
+        }
+
+        return root;
+    }
+
+    bool FBDiskCache::contains(const IDString& id) const
+    {
+        ScopedLock lock(m_mutex);
+        return m_entries.count(id) != 0;
+    }
+
+    void FBDiskCache::flush(const IDString& id)
+    {
+        FrameBuffer* deadFB = 0;
+
+        {
+            ScopedLock lock(m_mutex);
+            EntryMap::iterator i = m_entries.find(id);
+
+            if (i != m_entries.end())
+                removeEntry(i);
+
+            for (PendingQueue::iterator q = m_pending.begin(); q != m_pending.end(); ++q)
+            {
+                if (q->id == id)
+                {
+                    m_stats.pending -= q->bytes;
+                    deadFB = q->fb;
+                    m_pending.erase(q);
+                    break;
+                }
+            }
+        }
+
+        delete deadFB;
+    }
+
+    void FBDiskCache::flushSubstr(const vector<string>& subStrings)
+    {
+        vector<FrameBuffer*> deadFBs;
+
+        {
+            ScopedLock lock(m_mutex);
+
+            for (EntryMap::iterator i = m_entries.begin(); i != m_entries.end();)
+            {
+                EntryMap::iterator next = i;
+                ++next;
+
+                for (size_t q = 0; q < subStrings.size(); q++)
+                {
+                    if (i->first.find(subStrings[q]) != string::npos)
+                    {
+                        removeEntry(i);
+                        break;
+                    }
+                }
+
+                i = next;
+            }
+
+            for (PendingQueue::iterator i = m_pending.begin(); i != m_pending.end();)
+            {
+                bool matched = false;
+
+                for (size_t q = 0; !matched && q < subStrings.size(); q++)
+                    matched = i->id.find(subStrings[q]) != string::npos;
+
+                if (matched)
+                {
+                    m_stats.pending -= i->bytes;
+                    deadFBs.push_back(i->fb);
+                    i = m_pending.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < deadFBs.size(); i++)
+            delete deadFBs[i];
+    }
+
+    void FBDiskCache::clear()
+    {
+        ScopedLock lock(m_mutex);
+
+        while (!m_entries.empty())
+            removeEntry(m_entries.begin());
+    }
+
+    FBDiskCache::Stats FBDiskCache::stats() const
+    {
+        ScopedLock lock(m_mutex);
+        return m_stats;
+    }
+
+    //
+    //  Indexes the entries a previous session left in a persistent
+    //  directory. The directory may be shared with other sessions, so
+    //  nothing is deleted here: files which aren't usable entries
+    //  (temporaries being written, other versions, duplicates) are just
+    //  skipped.
+    //
+
+    void FBDiskCache::scanDirectory()
+    {
+        using namespace boost::filesystem;
+
+        try
+        {
+            for (directory_iterator i(m_directory); i != directory_iterator(); ++i)
+            {
+                const path p = i->path();
+
+                if (p.extension().string() != EntryExtension)
+                    continue;
+
+                string meta;
+                const int fd = openForRead(p.string());
+
+                if (fd < 0)
+                    continue;
+
+                if (readMeta(fd, meta))
+                {
+                    MetaReader r(meta.data(), meta.size());
+                    const string id = r.getString();
+
+                    if (r.ok() && !m_entries.count(id) && hasHashName(p, id))
+                    {
+                        insertEntry(id, p.string(), file_size(p));
+                    }
+                }
+
+                ::close(fd);
+            }
+        }
+        catch (std::exception& exc)
+        {
+            cerr << "WARNING: disk cache: scanning " << m_directory << ": " << exc.what() << endl;
+        }
+
+        evictToCapacity();
+    }
+
+} // namespace IPCore
@@ -0,0 +1,236 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/FBProxyCache.h>
+#include <TwkFB/Operations.h>
+#include <TwkUtil/EnvVar.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+static ENVVAR_INT(evProxyCacheScale, "RV_PROXY_CACHE_SCALE", 0);
+static ENVVAR_INT(evProxyCacheSize, "RV_PROXY_CACHE_SIZE", 2048);
+
+namespace IPCore
+{
+    using namespace std;
+    using namespace TwkFB;
+
+    namespace
+    {
+
+        //
+        //  Anything smaller than this isn't worth a proxy: reading it is
+        //  already cheap.
+        //
+
+        const int MinProxySourceWidth = 256;
+
+        string proxyIdentifier(const string& id, int scale)
+        {
+            ostringstream str;
+            str << id << "#proxy=" << scale;
+            return str.str();
+        }
+
+    } // namespace
+
+    FBProxyCache::FBProxyCache(int scale, size_t capacity)
+        : m_scale(scale)
+        , m_capacity(capacity)
+    {
+        m_stats.capacity = capacity;
+    }
+
+    FBProxyCache::~FBProxyCache() { clear(); }
+
+    FBProxyCache* FBProxyCache::createFromEnvironment()
+    {
+        const int scale = evProxyCacheScale.getValue();
+
+        if (scale <= 1)
+            return 0;
+
+        if (scale != 2 && scale != 4 && scale != 8)
+        {
+            cerr << "WARNING: proxy cache: RV_PROXY_CACHE_SCALE must be 2, 4 or 8 (got " << scale << "), proxies disabled" << endl;
+            return 0;
+        }
+
+        const size_t capacity = size_t(max(evProxyCacheSize.getValue(), 0)) * 1024 * 1024;
+
+        if (capacity == 0)
+            return 0;
+
+        cout << "INFO: proxy cache enabled at 1/" << scale << " resolution (" << capacity / (1024 * 1024) << " MB)" << endl;
+
+        return new FBProxyCache(scale, capacity);
+    }
+
+    void FBProxyCache::setCapacity(size_t bytes)
+    {
+        ScopedLock lock(m_mutex);
+        m_capacity = bytes;
+        m_stats.capacity = bytes;
+        evictToCapacity();
+    }
+
+    void FBProxyCache::storeProxyOf(const FrameBuffer* fb)
+    {
+        const IDString id = fb->identifier();
+
+        //
+        //  Missing-frame identifiers (leading '|'), proxy buffers (which
+        //  share pixels with a master fb) and images which are still
+        //  being filled in are never reduced.
+        //
+
+        if (id.empty() || id[0] == '|' || fb->width() < MinProxySourceWidth || fb->hasAttribute("ProxyBuffers")
+            || fb->hasAttribute("ProxyBufferOwnerPtr") || fb->hasAttribute("PartialImage")
+            || fb->hasAttribute("RequestedFrameLoading"))
+        {
+            return;
+        }
+
+        {
+            ScopedLock lock(m_mutex);
+            EntryMap::iterator i = m_entries.find(id);
+
+            if (i != m_entries.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, i->second);
+                return;
+            }
+        }
+
+        FrameBuffer* proxy = boxDownsample(fb, m_scale);
+
+        if (!proxy)
+            return;
+
+        proxy->setIdentifier(proxyIdentifier(id, m_scale));
+        proxy->newAttribute("ProxyLevel", m_scale);
+        proxy->staticRef();
+
+        Entry e;
+        e.id = id;
+        e.fb = proxy;
+        e.bytes = proxy->totalImageSize();
+
+        ScopedLock lock(m_mutex);
+
+        if (m_entries.count(id) || e.bytes > m_capacity)
+        {
+            //
+            //  Another thread got there first (or it will never fit)
+            //
+
+            delete proxy;
+            return;
+        }
+
+        m_lru.push_front(e);
+        m_entries[id] = m_lru.begin();
+        m_stats.used += e.bytes;
+        m_stats.count++;
+        evictToCapacity();
+    }
+
+    FrameBuffer* FBProxyCache::checkOut(const IDString& id)
+    {
+        ScopedLock lock(m_mutex);
+        EntryMap::iterator i = m_entries.find(id);
+
+        if (i == m_entries.end())
+        {
+            m_stats.misses++;
+            return 0;
+        }
+
+        m_lru.splice(m_lru.begin(), m_lru, i->second);
+        m_stats.hits++;
+
+        FrameBuffer* fb = i->second->fb;
+        fb->staticRef();
+        return fb;
+    }
+
+    void FBProxyCache::removeEntry(EntryMap::iterator i)
+    {
+        FrameBuffer* fb = i->second->fb;
+        m_stats.used -= i->second->bytes;
+        m_stats.count--;
+        m_lru.erase(i->second);
+        m_entries.erase(i);
+
+        //
+        //  An IPImage may still be holding it; it will delete it when it
+        //  lets go.
+        //
+
+        if (fb->staticUnRef())
+            delete fb;
+    }
+
+    void FBProxyCache::evictToCapacity()
+    {
+        while (m_stats.used > m_capacity && !m_lru.empty())
+        {
+            removeEntry(m_entries.find(m_lru.back().id));
+            m_stats.evictions++;
+        }
+    }
+
+    bool FBProxyCache::contains(const IDString& id) const
+    {
+        ScopedLock lock(m_mutex);
+        return m_entries.count(id) != 0;
+    }
+
+    void FBProxyCache::flush(const IDString& id)
+    {
+        ScopedLock lock(m_mutex);
+        EntryMap::iterator i = m_entries.find(id);
+        if (i != m_entries.end())
+            removeEntry(i);
+    }
+
+    void FBProxyCache::flushSubstr(const vector<string>& subStrings)
+    {
+        ScopedLock lock(m_mutex);
+
+        for (EntryMap::iterator i = m_entries.begin(); i != m_entries.end();)
+        {
+            EntryMap::iterator next = i;
+            ++next;
+
+            for (size_t q = 0; q < subStrings.size(); q++)
+            {
+                if (i->first.find(subStrings[q]) != string::npos)
+                {
+                    removeEntry(i);
+                    break;
+                }
+            }
+
+            i = next;
+        }
+    }
+
+    void FBProxyCache::clear()
+    {
+        ScopedLock lock(m_mutex);
+
+        while (!m_entries.empty())
+            removeEntry(m_entries.begin());
+    }
+
+    FBProxyCache::Stats FBProxyCache::stats() const
+    {
+        ScopedLock lock(m_mutex);
+        return m_stats;
+    }
+
+} // namespace IPCore
@@ -58,6 +58,7 @@ namespace IPCore
         Vec2fProperty* m_blue;
         Vec2fProperty* m_neutral;
         StringProperty* m_overrideColorspace;
+        TwkContainer::PropertyHandle<Mat44fProperty> m_userMatrix;
     };
 
 } // namespace IPCore
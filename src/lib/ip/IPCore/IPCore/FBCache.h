@@ -10,6 +10,7 @@
 #include <TwkFB/Cache.h>
 #include <set>
 #include <map>
+#include <atomic>
 
 namespace IPCore
 {
@@ -18,6 +19,8 @@ namespace IPCore
     class IPImageID;
     class IPNode;
     class CacheEdges;
+    class FBDiskCache;
+    class FBProxyCache;
 
     //
     //  FBCache is a modification of TwkFB::Cache that handles cross
@@ -39,8 +42,49 @@ namespace IPCore
         typedef std::map<FrameBuffer*, FrameSet> ItemFrames;
         typedef std::vector<int> FrameVector;
         typedef std::set<std::string> IDSet;
-        typedef std::map<int, IDSet> FrameMap;
-        typedef std::map<size_t, FBVector> FreeLists;
+
+        //
+        //  The frame to ids map. Like the TwkFB::Cache id map it is only
+        //  modified with the cache lock held, but every frame added or
+        //  removed is mirrored in a lock-striped index so
+        //  isFrameCached() can be answered without the lock.
+        //
+
+        class FrameMap : public std::map<int, IDSet>
+        {
+        public:
+            typedef std::map<int, IDSet> Base;
+
+            IDSet& operator[](int frame)
+            {
+                iterator i = find(frame);
+
+                if (i == end())
+                {
+                    m_index.insert(frame);
+                    i = Base::insert(value_type(frame, IDSet())).first;
+                }
+
+                return i->second;
+            }
+
+            size_t erase(int frame)
+            {
+                m_index.erase(frame);
+                return Base::erase(frame);
+            }
+
+            void clear()
+            {
+                m_index.clear();
+                Base::clear();
+            }
+
+            bool contains(int frame) const { return m_index.contains(frame); }
+
+        private:
+            TwkFB::StripedSet<int> m_index;
+        };
         typedef std::vector<std::string> IDStringVector;
         typedef std::vector<IDStringVector> IDTree;
         typedef std::pair<int, int> FrameRange;
@@ -69,11 +113,35 @@ namespace IPCore
             float lookAheadSeconds;        /// as returned by
                                            /// computeLookAheadSecondsStat()
             FrameRangeVector cachedRanges; /// as returned by computeCachedRangesStat()
+            size_t diskCapacity;           /// disk tier budget (0 if no disk tier)
+            size_t diskUsed;               /// bytes stored in the disk tier
+            size_t diskHits;               /// misses served by the disk tier
+            size_t diskMisses;             /// misses not found in the disk tier
+            size_t diskWrites;             /// fbs written to the disk tier
+            size_t poolHits;               /// pixel allocs recycled by TwkUtil::MemPool
+            size_t poolMisses;             /// pixel allocs that needed a real alloc
+            size_t poolResident;           /// bytes held for reuse by TwkUtil::MemPool
+            size_t proxyCapacity;          /// proxy tier budget (0 if no proxy tier)
+            size_t proxyUsed;              /// bytes held by the proxy tier
+            size_t proxyCount;             /// frames with a proxy
+            size_t proxyHits;              /// proxies shown in place of uncached frames
 
             CacheStats()
                 : capacity(0)
                 , used(0)
                 , lookAheadSeconds(0.0)
+                , diskCapacity(0)
+                , diskUsed(0)
+                , diskHits(0)
+                , diskMisses(0)
+                , diskWrites(0)
+                , poolHits(0)
+                , poolMisses(0)
+                , poolResident(0)
+                , proxyCapacity(0)
+                , proxyUsed(0)
+                , proxyCount(0)
+                , proxyHits(0)
             {
             }
         };
@@ -116,7 +184,53 @@ namespace IPCore
 
         bool frameItems(int frame, FBVector& items) const;
 
-        bool isFrameCached(int frame) const { return m_frames.find(frame) != m_frames.end(); }
+        //
+        //  Same as TwkFB::Cache::checkOut() except that on a miss the
+        //  disk tier (if any) is consulted. A restored fb is added back
+        //  into the memory cache before being checked out.
+        //
+
+        FrameBuffer* checkOutOrRestore(const IDString&);
+
+        FBDiskCache* diskCache() const { return m_diskCache; }
+
+        //
+        //  Drop any copy of the id held by the disk tier (e.g. because
+        //  the media is being reloaded).
+        //
+
+        void flushDiskTier(const IDString&);
+
+        //
+        //  The reduced resolution tier (if any). See FBProxyCache.h
+        //
+
+        FBProxyCache* proxyCache() const { return m_proxyCache; }
+
+        void flushProxyTier(const IDString&);
+
+        //
+        //  Proxies only stand in for a frame the first time the display
+        //  asks for it. proxyShown() is called by CacheIPNode when it
+        //  substitutes them. Once the display has settled on that frame
+        //  (not playing) refreshProxyFrame() returns true and the next
+        //  render of it evaluates at full resolution.
+        //
+
+        bool useProxiesAt(int frame) const { return frame != m_fullResFrame; }
+
+        void proxyShown(int frame) { m_proxyFrame = frame; }
+
+        bool refreshProxyFrame(int frame);
+
+        //
+        //  isFrameCached() and isCachedOrOnDisk() do not require the cache
+        //  lock.
+        //
+
+        bool isFrameCached(int frame) const { return m_frames.contains(frame); }
+
+        bool isCachedOrOnDisk(const IDString&) const;
 
         bool hasPartialFrameCache(int frame) const;
 
@@ -262,8 +376,10 @@ namespace IPCore
         void setInOutFrames(int a, int b, int c, int d);
 
         virtual void clearInternal();
+        void clearTiers();
         virtual bool free(size_t bytes);
         virtual bool freeInternal(size_t bytes, bool freeMemory = true);
+        virtual size_t evictFB(FrameBuffer* fb);
         bool freeIDSet(const IDSet&, int frame);
         bool freeInRangeForwards(size_t, FrameVector&, int, int, bool);
         bool freeInRangeBackwards(size_t, FrameVector&, int, int, bool);
@@ -346,10 +462,14 @@ namespace IPCore
         float m_targetCacheFrameUtility;
         CacheEdges* m_cacheEdges;
         PerNodeCache* m_perNodeCache;
+        FBDiskCache* m_diskCache;
+        FBProxyCache* m_proxyCache;
         float m_lookBehindFraction;
         bool m_activeTailCachingEnabled;
         bool m_cacheStatsDisabled;
         bool m_cacheStatsDirty;
+        std::atomic<int> m_proxyFrame;
+        std::atomic<int> m_fullResFrame;
 
         static bool m_cacheOutsideRegion;
 
@@ -0,0 +1,177 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__FBDiskCache__h__
+#define __IPCore__FBDiskCache__h__
+#include <TwkFB/FrameBuffer.h>
+#include <boost/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace IPCore
+{
+
+    //
+    //  FBDiskCache
+    //
+    //  A second cache tier behind FBCache. FrameBuffers evicted from the
+    //  memory cache are written (in their decoded TwkFB layout) to one
+    //  file per cache identifier in a local directory. A later lookup of
+    //  that identifier memory maps the file and wraps the mapping in a
+    //  new FrameBuffer, so a hit costs no decode and no copy. The tier
+    //  has its own byte budget and evicts least recently used entries
+    //  when it is exceeded.
+    //
+    //  Writing happens on a background thread: store() takes ownership of
+    //  the fb and deletes it once its pixels are on disk. Lookups of an
+    //  identifier that is still waiting to be written get the pending fb
+    //  back directly.
+    //
+    //  The tier is enabled by setting RV_DISK_CACHE_DIR to a directory
+    //  (ideally on a fast local drive). RV_DISK_CACHE_SIZE sets the
+    //  budget in MB. Unless RV_DISK_CACHE_PERSISTENT is set (a cache
+    //  identifier does not capture changes to the source media) each
+    //  session writes to its own subdirectory and removes it on exit. A
+    //  persistent cache uses the directory itself and indexes the entries
+    //  it finds there at startup.
+    //
+
+    class FBDiskCache
+    {
+    public:
+        typedef TwkFB::FrameBuffer FrameBuffer;
+        typedef std::string IDString;
+        typedef boost::mutex Mutex;
+        typedef boost::mutex::scoped_lock ScopedLock;
+        typedef boost::condition_variable Condition;
+
+        struct Stats
+        {
+            size_t capacity;  /// byte budget of the tier
+            size_t used;      /// bytes currently on disk
+            size_t pending;   /// bytes waiting to be written
+            size_t hits;      /// lookups served from the tier
+            size_t misses;    /// lookups not found in the tier
+            size_t writes;    /// frame buffers written
+            size_t rejects;   /// frame buffers that could not be stored
+            size_t evictions; /// entries removed to stay within budget
+
+            Stats()
+                : capacity(0)
+                , used(0)
+                , pending(0)
+                , hits(0)
+                , misses(0)
+                , writes(0)
+                , rejects(0)
+                , evictions(0)
+            {
+            }
+        };
+
+        FBDiskCache(const std::string& directory, size_t capacity, bool persistent = false);
+        ~FBDiskCache();
+
+        //
+        //  Returns a new FBDiskCache configured from the environment or
+        //  NULL if the tier is not enabled.
+        //
+
+        static FBDiskCache* createFromEnvironment();
+
+        const std::string& directory() const { return m_directory; }
+
+        size_t capacity() const { return m_capacity; }
+
+        void setCapacity(size_t bytes);
+
+        //
+        //  Queue the fb to be written. Returns true if the tier took
+        //  ownership of the fb (the caller must not touch it again). If
+        //  the fb cannot be represented on disk (proxy buffers, attribute
+        //  types that can't be serialized, etc) or the write queue is
+        //  full, false is returned and the caller keeps the fb.
+        //
+
+        bool store(FrameBuffer* fb);
+
+        //
+        //  Returns a new FrameBuffer for the identifier or NULL. The
+        //  caller owns the returned fb. Its pixels are mapped from disk
+        //  (copy-on-write) and are released by the normal FrameBuffer
+        //  deallocation path.
+        //
+
+        FrameBuffer* restore(const IDString& id);
+
+        bool contains(const IDString& id) const;
+
+        void flush(const IDString& id);
+
+        //
+        //  Remove every entry (on disk and pending) whose identifier
+        //  contains one of the given substrings. Used when media is
+        //  reloaded so stale pixels are never served.
+        //
+
+        void flushSubstr(const std::vector<std::string>& subStrings);
+
+        void clear();
+
+        Stats stats() const;
+
+    private:
+        struct Entry
+        {
+            IDString id;
+            std::string path;
+            size_t bytes;
+        };
+
+        struct PendingWrite
+        {
+            FrameBuffer* fb;
+            IDString id;
+            std::string header;
+            size_t bytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef std::map<IDString, EntryList::iterator> EntryMap;
+        typedef std::map<std::string, IDString> PathMap;
+        typedef std::deque<PendingWrite> PendingQueue;
+
+        std::string pathForID(const IDString&) const;
+        void writerMain();
+        bool writeEntry(const PendingWrite&, const std::string& path);
+        void insertEntry(const IDString&, const std::string& path, size_t bytes);
+        void removeEntry(EntryMap::iterator);
+        void evictToCapacity();
+        void scanDirectory();
+
+    private:
+        std::string m_directory;
+        size_t m_capacity;
+        size_t m_maxPending;
+        EntryList m_lru;
+        EntryMap m_entries;
+        PathMap m_paths;
+        PendingQueue m_pending;
+        Stats m_stats;
+        bool m_persistent;
+        bool m_shutdown;
+        mutable Mutex m_mutex;
+        Condition m_pendingCond;
+        boost::thread* m_writer;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__FBDiskCache__h__
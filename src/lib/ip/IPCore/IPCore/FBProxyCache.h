@@ -0,0 +1,132 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__FBProxyCache__h__
+#define __IPCore__FBProxyCache__h__
+#include <TwkFB/FrameBuffer.h>
+#include <boost/thread/mutex.hpp>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace IPCore
+{
+
+    //
+    //  FBProxyCache
+    //
+    //  Holds a reduced resolution (1/2, 1/4 or 1/8 in each dimension)
+    //  copy of the fbs the caching threads put in FBCache. The copies
+    //  live in their own (much smaller) byte budget, so they typically
+    //  cover a whole shot even when the full resolution cache does not.
+    //  When the display needs a frame which isn't cached yet it can show
+    //  the proxies instead of stalling on the reader; the full resolution
+    //  version is swapped in once the caching threads get to it.
+    //
+    //  The proxy of an fb has the fb's identifier with "#proxy=N"
+    //  appended and a "ProxyLevel" attribute (N). Proxies handed out by
+    //  checkOut() carry a static reference so an IPImage holding one
+    //  releases it like any other uncached fb; an evicted proxy is
+    //  deleted when its last user lets go of it.
+    //
+    //  Enabled by setting RV_PROXY_CACHE_SCALE to 2, 4 or 8.
+    //  RV_PROXY_CACHE_SIZE sets the budget in MB.
+    //
+
+    class FBProxyCache
+    {
+    public:
+        typedef TwkFB::FrameBuffer FrameBuffer;
+        typedef std::string IDString;
+        typedef boost::mutex Mutex;
+        typedef boost::mutex::scoped_lock ScopedLock;
+
+        struct Stats
+        {
+            size_t capacity;  /// byte budget
+            size_t used;      /// bytes held by proxies
+            size_t count;     /// number of proxies held
+            size_t hits;      /// proxies handed out for display
+            size_t misses;    /// lookups without a proxy
+            size_t evictions; /// proxies removed to stay within budget
+
+            Stats()
+                : capacity(0)
+                , used(0)
+                , count(0)
+                , hits(0)
+                , misses(0)
+                , evictions(0)
+            {
+            }
+        };
+
+        FBProxyCache(int scale, size_t capacity);
+        ~FBProxyCache();
+
+        //
+        //  Returns a new FBProxyCache configured from the environment or
+        //  NULL if proxies are not enabled.
+        //
+
+        static FBProxyCache* createFromEnvironment();
+
+        int scale() const { return m_scale; }
+
+        size_t capacity() const { return m_capacity; }
+
+        void setCapacity(size_t bytes);
+
+        //
+        //  Build (outside of the lock) and keep a proxy of fb unless there
+        //  is one already. The caller must keep fb alive for the duration
+        //  (e.g. by having it checked out of FBCache).
+        //
+
+        void storeProxyOf(const FrameBuffer* fb);
+
+        //
+        //  Returns the proxy of the fb with the given identifier or NULL.
+        //
+
+        FrameBuffer* checkOut(const IDString& id);
+
+        bool contains(const IDString& id) const;
+
+        void flush(const IDString& id);
+
+        void flushSubstr(const std::vector<std::string>& subStrings);
+
+        void clear();
+
+        Stats stats() const;
+
+    private:
+        struct Entry
+        {
+            IDString id;
+            FrameBuffer* fb;
+            size_t bytes;
+        };
+
+        typedef std::list<Entry> EntryList;
+        typedef std::map<IDString, EntryList::iterator> EntryMap;
+
+        void removeEntry(EntryMap::iterator);
+        void evictToCapacity();
+
+    private:
+        int m_scale;
+        size_t m_capacity;
+        EntryList m_lru;
+        EntryMap m_entries;
+        Stats m_stats;
+        mutable Mutex m_mutex;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__FBProxyCache__h__
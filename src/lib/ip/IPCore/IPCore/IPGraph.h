@@ -19,6 +19,7 @@
 #include <boost/signals2.hpp>
 #include <boost/thread.hpp>
 #include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <set>
@@ -535,6 +536,16 @@ namespace IPCore
 
         void evalThreadMain(EvalThreadData*);
 
+        //
+        //  Read-ahead thread: walks the frames the caching threads are
+        //  about to evaluate and lets the source nodes start their I/O.
+        //  It sleeps until signalReadAhead() says the caching threads
+        //  have moved on (or stopped).
+        //
+
+        void readAheadThreadMain(EvalThreadData*);
+        void signalReadAhead();
+
         //
         //  Audio eval
         //
@@ -808,6 +819,11 @@ namespace IPCore
         ThreadDataVector m_threadData;
         ThreadGroup* m_threadGroup;
         ThreadGroup* m_threadGroupSingle;
+        ThreadGroup* m_threadGroupReadAhead;
+        EvalThreadData m_readAheadThreadData;
+        std::mutex m_readAheadMutex;
+        std::condition_variable m_readAheadCond;
+        size_t m_readAheadSerial;
         mutable pthread_mutex_t m_internalLock;
         mutable pthread_mutex_t m_dispatchLock;
         const IPNode::AudioContext* m_audioRequestContext;
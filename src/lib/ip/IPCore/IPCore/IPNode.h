@@ -12,10 +12,12 @@
 #include <TwkAudio/Audio.h>
 #include <TwkAudio/AudioFormats.h>
 #include <TwkContainer/PropertyContainer.h>
+#include <TwkContainer/PropertyHandle.h>
 #include <TwkContainer/Properties.h>
 #include <TwkFB/FrameBuffer.h>
 #include <TwkFB/IO.h>
 #include <TwkMovie/Movie.h>
+#include <atomic>
 #include <limits>
 #include <string>
 #include <vector>
@@ -70,6 +72,7 @@ namespace IPCore
         typedef TwkMovie::MovieInfo MovieInfo;
         typedef std::vector<std::string> StringVector;
         typedef TwkContainer::Property Property;
+        typedef TwkContainer::PropertyName PropertyName;
         typedef TwkContainer::Component Component;
         typedef TwkContainer::FloatProperty FloatProperty;
         typedef TwkContainer::HalfProperty HalfProperty;
@@ -349,6 +352,8 @@ namespace IPCore
                 //  do the below.
                 //
                 c.cache.TwkFB::Cache::flush(i->id);
+                c.cache.flushDiskTier(i->id);
+                c.cache.flushProxyTier(i->id);
             }
         };
 
@@ -409,6 +414,14 @@ namespace IPCore
 
         PropertyInsertSignal& propertyDidInsertSignal() { return m_propertyDidInsertSignal; }
 
+        //
+        //  Incremented whenever the inputs of any node change, so
+        //  something computed from the shape of a subgraph can be cached
+        //  until this moves.
+        //
+
+        static uint64_t inputsGeneration() { return m_inputsGeneration.load(std::memory_order_acquire); }
+
         //
         //  Node Name and type
         //
@@ -949,6 +962,16 @@ namespace IPCore
 
         virtual void testEvaluate(const Context&, TestEvaluationResult&);
 
+        //
+        //  Read-ahead is a hint that the node will be evaluated with the
+        //  context soon. Nodes which read from disk can start the I/O
+        //  (without decoding). It's called from the graph's read-ahead
+        //  thread via metaEvaluate() so it is not recursive and it must
+        //  be thread safe. The default does nothing.
+        //
+
+        virtual void readAhead(const Context&);
+
         //
         //  This function should flush any caching occuring per node
         //  The propagate functions call flushAllCaches() either up
@@ -1292,6 +1315,8 @@ namespace IPCore
         bool m_metaSearchable : 1;
         bool m_hasVideo : 1;
         bool m_hasAudio : 1;
+
+        static std::atomic<uint64_t> m_inputsGeneration;
     };
 
     template <typename Predicate> void IPNode::findInEvaluationPath(int frame, Predicate P, IPNodes& nodes, bool ascendingOrder)
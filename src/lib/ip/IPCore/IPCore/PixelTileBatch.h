@@ -0,0 +1,213 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__PixelTileBatch__h__
+#define __IPCore__PixelTileBatch__h__
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace IPCore
+{
+
+    //
+    //  Batched pixel tile transport
+    //
+    //  The original PIXELTILE network message carries one tile per
+    //  message with its geometry in the interp string. PIXELTILES carries
+    //  any number of tiles of one image (media, view, layer and frame are
+    //  in the interp string as for PIXELTILE) in a binary batch:
+    //
+    //      PIXELTILES(media=foo,view=left,f=1) <n> <batch>
+    //
+    //  A batch is a BatchHeader followed by its body, all little endian.
+    //  The body is numTiles TileHeaders followed by the tiles' pixels in
+    //  the same order (each TileHeader::size bytes, rows packed, in the
+    //  image source's pixel format). The body may be compressed with
+    //  zlib (BatchHeader::compression == ZLibCompression).
+    //
+    //  Clients on the same host can avoid the socket for the pixels by
+    //  creating a PixelTileRing and adding shm=<name> to the interp
+    //  string. The message data is then a RingSpan naming where in the
+    //  ring the batch is; RV reads the tiles straight out of the shared
+    //  memory and advances the ring's tail when it's done with them.
+    //
+    //  Clients discover what the receiving RV supports by sending the
+    //  event "pixel-tile-caps" with RETURNEVENT. Versions of RV without
+    //  this transport return an empty string.
+    //
+
+    class PixelTileBatch
+    {
+    public:
+        enum Compression
+        {
+            NoCompression = 0,
+            ZLibCompression = 1
+        };
+
+        static const uint32_t Magic = 0x54505652; // "RVPT"
+        static const uint16_t Version = 1;
+
+        struct BatchHeader
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t compression;
+            uint32_t numTiles;
+            uint32_t reserved;
+            uint64_t bodySize;    // uncompressed
+            uint64_t encodedSize; // bytes following this header
+        };
+
+        struct TileHeader
+        {
+            int32_t x;
+            int32_t y;
+            uint32_t width;
+            uint32_t height;
+            uint64_t size;
+        };
+
+        struct RingSpan
+        {
+            uint64_t offset; // stream position of the batch
+            uint64_t size;
+        };
+
+        struct Tile
+        {
+            int x;
+            int y;
+            size_t width;
+            size_t height;
+            const void* pixels;
+            size_t size;
+        };
+
+        typedef std::vector<Tile> Tiles;
+
+        //
+        //  Decodes the batch in data. On success the tiles point into
+        //  data or, when compressed, into the batch's own buffer so they
+        //  are valid until the next decode() or the batch is destroyed.
+        //
+
+        bool decode(const void* data, size_t size);
+
+        const Tiles& tiles() const { return m_tiles; }
+
+        const std::string& error() const { return m_error; }
+
+        //
+        //  The reply to "pixel-tile-caps"
+        //
+
+        static std::string capabilities();
+
+    private:
+        Tiles m_tiles;
+        std::vector<char> m_buffer;
+        std::string m_error;
+    };
+
+    //
+    //  PixelTileRing
+    //
+    //  A single producer, single consumer byte ring in a named shared
+    //  memory segment (POSIX shm_open on Linux and macOS, a named file
+    //  mapping on Windows). The segment starts with a RingHeader; the
+    //  data area follows at DataOffset.
+    //
+    //  head and tail are stream positions (they only increase). The
+    //  producer writes a batch at head % capacity -- a batch never wraps,
+    //  the producer skips to the start of the data area instead -- sends
+    //  the RingSpan, and advances head. The consumer stores the end of
+    //  each span it has finished with in tail. The producer must not
+    //  write past tail + capacity.
+    //
+    //  The consumer takes the capacity from the header once, when it
+    //  attaches. A producer which closes its ring clears the magic and
+    //  a new ring gets a new generation, so a consumer can tell when a
+    //  name it attached to before now refers to something else and
+    //  attach again.
+    //
+
+    class PixelTileRing
+    {
+    public:
+        static const uint32_t Magic = 0x52505652; // "RVPR"
+        static const uint32_t Version = 1;
+        static const size_t DataOffset = 64;
+
+        struct RingHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t capacity;
+            volatile uint64_t head;
+            volatile uint64_t tail;
+            uint64_t generation;
+        };
+
+        ~PixelTileRing();
+
+        //
+        //  Producers create a ring, consumers attach to one. Both return
+        //  NULL with error set on failure.
+        //
+
+        static PixelTileRing* create(const std::string& name, size_t capacity, std::string& error);
+        static PixelTileRing* attach(const std::string& name, std::string& error);
+
+        const std::string& name() const { return m_name; }
+
+        size_t capacity() const { return size_t(m_capacity); }
+
+        //
+        //  True if the segment isn't the ring this was created or
+        //  attached as any more (closed, or recreated under the same
+        //  name)
+        //
+
+        bool stale() const;
+
+        //
+        //  Consumer: returns the span's bytes or NULL if the span isn't
+        //  inside the ring's written region. release() marks everything
+        //  up to the end of span consumed.
+        //
+
+        const char* data(const PixelTileBatch::RingSpan& span) const;
+        void release(const PixelTileBatch::RingSpan& span);
+
+        //
+        //  Producer: reserve() returns where to write size bytes (or NULL
+        //  if the consumer hasn't made enough room yet) and fills in
+        //  span; commit() publishes it.
+        //
+
+        char* reserve(size_t size, PixelTileBatch::RingSpan& span);
+        void commit(const PixelTileBatch::RingSpan& span);
+
+    private:
+        PixelTileRing(const std::string& name, void* handle, void* memory, size_t mappedSize, bool owner);
+
+    private:
+        std::string m_name;
+        void* m_handle;
+        void* m_memory;
+        size_t m_mappedSize;
+        RingHeader* m_header;
+        char* m_data;
+        bool m_owner;
+        uint64_t m_capacity;
+        uint64_t m_generation;
+    };
+
+} // namespace IPCore
+
+#endif // __IPCore__PixelTileBatch__h__
@@ -12,6 +12,7 @@
 #include <IPCore/IPGraph.h>
 #include <IPCore/IPImage.h>
 #include <IPCore/IPNode.h>
+#include <IPCore/PixelTileBatch.h>
 #include <TwkApp/Document.h>
 #include <TwkContainer/PropertyContainer.h>
 #include <TwkMath/Time.h>
@@ -233,6 +234,7 @@ namespace IPCore
         typedef boost::condition_variable Condition;
         typedef std::deque<int> IntDeque;
         typedef std::vector<int> IntVector;
+        typedef std::map<std::string, PixelTileRing*> PixelTileRings;
 
         typedef std::pair<TwkAudio::SampleTime, TwkAudio::SampleTime> AudioRange;
 
@@ -285,6 +287,18 @@ namespace IPCore
                 used = s.used;
                 lookAheadSeconds = s.lookAheadSeconds;
                 cachedRanges = s.cachedRanges;
+                diskCapacity = s.diskCapacity;
+                diskUsed = s.diskUsed;
+                diskHits = s.diskHits;
+                diskMisses = s.diskMisses;
+                diskWrites = s.diskWrites;
+                poolHits = s.poolHits;
+                poolMisses = s.poolMisses;
+                poolResident = s.poolResident;
+                proxyCapacity = s.proxyCapacity;
+                proxyUsed = s.proxyUsed;
+                proxyCount = s.proxyCount;
+                proxyHits = s.proxyHits;
             }
         };
 
@@ -648,6 +662,13 @@ namespace IPCore
 
         void pixelBlockEvent(const std::string& eventName, const std::string& interp, const char* data, size_t dataSize);
 
+        //
+        //  Same for a PIXELTILES batch (see PixelTileBatch.h): one event
+        //  carries all of the batch's tiles.
+        //
+
+        void pixelBlockBatchEvent(const std::string& eventName, const std::string& interp, const char* data, size_t dataSize);
+
         //
         //  Evaluation
         //
@@ -1074,8 +1095,11 @@ namespace IPCore
         ProfilingRecord& beginProfilingSample();
         ProfilingRecord& currentProfilingSample();
         void endProfilingSample();
+        void traceProfilingSample();
         void dumpProfilingToFile(std::ostream&);
 
+        const ProfilingRecordVector& profilingSamples() const { return m_profilingSamples; }
+
         bool postFirstNonEmptyRender() { return m_postFirstNonEmptyRender; }
 
         void addMissingInfo(const std::string s) { m_missingFrameInfos.push_back(s); }
@@ -1256,6 +1280,8 @@ namespace IPCore
         bool m_audioUnavailble;
         static float m_audioDrift;
         bool m_beingDeleted;
+        PixelTileBatch m_pixelTileBatch;
+        PixelTileRings m_pixelTileRings;
         CacheStats m_cacheStats;
         Time m_syncOffset;
         SyncTimes m_syncTimes;
@@ -0,0 +1,134 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__ShaderBinaryCache__h__
+#define __IPCore__ShaderBinaryCache__h__
+#include <TwkGLF/GL.h>
+#include <boost/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace IPCore
+{
+    namespace Shader
+    {
+
+        //
+        //  BinaryCache
+        //
+        //  A persistent cache of linked GLSL programs. When a Program is
+        //  linked its driver binary (glGetProgramBinary) is written to one
+        //  file per program in a local directory; the next time the same
+        //  program is needed -- later in the session or in another session
+        //  -- the binary is handed back to the driver instead of compiling
+        //  and linking the shaders again.
+        //
+        //  Entries are keyed by the complete GLSL source of the program
+        //  plus the driver identity (vendor, renderer and version
+        //  strings). The key is stored in the entry and compared in full so
+        //  a hash collision can never select the wrong program. Drivers are
+        //  also free to reject a binary (e.g. after an update that didn't
+        //  change the version string); the program is then compiled
+        //  normally and the entry replaced.
+        //
+        //  When the cache is created a background thread reads the entries
+        //  belonging to the current driver into memory, so first use of a
+        //  previously seen pipeline costs neither a compile nor file I/O.
+        //
+        //  Enabled by setting RV_SHADER_CACHE_DIR to a directory. The
+        //  cache is not available on platforms whose GL lacks
+        //  ARB_get_program_binary.
+        //
+
+        class BinaryCache
+        {
+        public:
+            typedef boost::mutex Mutex;
+            typedef boost::mutex::scoped_lock ScopedLock;
+
+            struct Stats
+            {
+                size_t hits;      /// programs restored from a binary
+                size_t misses;    /// programs that had to be compiled
+                size_t rejects;   /// binaries the driver refused to load
+                size_t stores;    /// binaries written to the cache
+                size_t prewarmed; /// entries read ahead of use
+
+                Stats()
+                    : hits(0)
+                    , misses(0)
+                    , rejects(0)
+                    , stores(0)
+                    , prewarmed(0)
+                {
+                }
+            };
+
+            BinaryCache(const std::string& directory, const std::string& driver);
+            ~BinaryCache();
+
+            //
+            //  Returns a new BinaryCache configured from the environment or
+            //  NULL if the cache is not enabled or not supported by the
+            //  current GL context. Must be called with the context current.
+            //
+
+            static BinaryCache* createFromEnvironment(const std::string& driver);
+
+            const std::string& directory() const { return m_directory; }
+
+            const std::string& driver() const { return m_driver; }
+
+            //
+            //  load() tries to restore the program object (which must not
+            //  be linked yet) from the binary for source. If it returns
+            //  false the caller should call markRetrievable() on the
+            //  program, link it normally, and then call store().
+            //
+
+            bool load(GLuint program, const std::string& source);
+            void markRetrievable(GLuint program);
+            void store(GLuint program, const std::string& source);
+
+            Stats stats() const;
+
+        private:
+            struct Entry
+            {
+                Entry()
+                    : format(0)
+                {
+                }
+
+                std::string source;
+                GLenum format;
+                std::vector<char> binary;
+            };
+
+            typedef std::map<size_t, Entry> EntryMap;
+
+            size_t hashSource(const std::string& source) const;
+            std::string pathForHash(size_t) const;
+            bool readEntry(const std::string& path, bool skipOtherDrivers, Entry&) const;
+            bool writeEntry(const std::string& path, const Entry&) const;
+            void prewarmMain();
+
+        private:
+            std::string m_directory;
+            std::string m_driver;
+            size_t m_driverHash;
+            EntryMap m_entries;
+            Stats m_stats;
+            bool m_shutdown;
+            mutable Mutex m_mutex;
+            boost::thread* m_prewarm;
+        };
+
+    } // namespace Shader
+} // namespace IPCore
+
+#endif // __IPCore__ShaderBinaryCache__h__
@@ -0,0 +1,92 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __IPCore__ShaderCPU__h__
+#define __IPCore__ShaderCPU__h__
+#include <IPCore/ShaderExpression.h>
+#include <TwkFB/FrameBuffer.h>
+#include <vector>
+
+namespace IPCore
+{
+    class IPImage;
+
+    namespace Shader
+    {
+
+        //
+        //  CPU evaluation of colour expressions
+        //
+        //  A source IPImage arrives at the renderer with a chain of colour
+        //  Functions (matrix, CDL, LUTs, transfer curves, premult, ...)
+        //  stacked on its Source expression. On a software GL (Mesa,
+        //  OSMesa) running those per pixel in the rasterizer is slow.
+        //
+        //  evaluateOnCPU() walks the IPImage tree and, for each image
+        //  whose expression bottoms out in a plain packed RGBA source,
+        //  applies the longest run of supported functions above the source
+        //  with vectorized kernels on the TwkUtil::TaskPool. The image's fb
+        //  is replaced by the (float RGBA) result and that part of the
+        //  expression by a new Source; any functions above the run are
+        //  left for the GPU as before. Results match the GLSL versions to
+        //  about 1e-6 (pow, log and exp use polynomial approximations).
+        //
+        //  It must run before the IPImage's graph IDs, aux frame buffers,
+        //  and render IDs are computed (see IPGraph::evaluate()).
+        //
+        //  RV_CPU_SHADERS=1 forces this on, 0 forces it off. By default it
+        //  is turned on by the renderer when it finds a software GL
+        //  (llvmpipe, softpipe or swrast).
+        //
+
+        void setCPUEvaluation(bool);
+        bool cpuEvaluation();
+
+        //
+        //  Returns the number of images that were (partly) evaluated.
+        //  Replaced fbs which are checked out of the cache are appended to
+        //  cachedFBs; the caller has to check them in (with the cache
+        //  locked). Other replaced fbs are deleted.
+        //
+
+        size_t evaluateOnCPU(IPImage* root, std::vector<TwkFB::FrameBuffer*>& cachedFBs);
+
+        //
+        //  Colour chain baking
+        //
+        //  bakeColorChains() replaces each run of two or more adjacent
+        //  colour Functions in a source image's expression (the ones
+        //  evaluateOnCPU() implements, minus those that touch alpha) by a
+        //  single equivalent Function:
+        //
+        //      * a run of affine functions (matrices, CDL with unit power)
+        //        becomes one ColorMatrix
+        //
+        //      * a run over an integer source or a [0, 1] clamp becomes
+        //        one 3D LUT
+        //
+        //      * any other run of four or more becomes a log shaper and a
+        //        3D LUT. The shaper covers [0, 16], so this is only done
+        //        when the run's input is known to be in that range (a
+        //        clamp, or a float source whose pixels are checked);
+        //        otherwise the run is left unbaked.
+        //
+        //  LUTs are baked on the TaskPool and kept in a small LRU cache
+        //  keyed by the run's exact parameter values, so only a chain
+        //  whose properties changed is rebaked. Custom shaders (OCIO,
+        //  ICC) end a run.
+        //
+        //  Enabled with RV_BAKE_COLOR=1; RV_BAKE_COLOR_LUT_SIZE sets the
+        //  3D LUT size (default 33, at most 64). Same calling convention
+        //  as evaluateOnCPU(); when both are on baking must come first.
+        //
+
+        bool colorBaking();
+        size_t bakeColorChains(IPImage* root, std::vector<TwkFB::FrameBuffer*>& cachedFBs);
+
+    } // namespace Shader
+} // namespace IPCore
+
+#endif // __IPCore__ShaderCPU__h__
@@ -17,6 +17,7 @@ namespace IPCore
 
         struct FunctionGLState;
         struct ProgramGLState;
+        class BinaryCache;
 
         struct CompareExpr
         {
@@ -142,7 +143,7 @@ namespace IPCore
             //  Constructors
             //
 
-            Program(Expression*);
+            Program(Expression*, BinaryCache* binaryCache = 0);
             ~Program();
 
             //
@@ -181,6 +182,9 @@ namespace IPCore
             // output uniform variables needed in case of uncropped images
             void outputUncropUniforms(std::ostream&, const Expression*);
 
+            // complete source of the program (key for the BinaryCache)
+            std::string binaryCacheKey() const;
+
             Expression* m_expr;
             GraphIDSet m_outputSTSet;
             GraphIDSet m_outputSizeSet;
@@ -198,6 +202,7 @@ namespace IPCore
             bool m_needOutputSize{false};
             bool m_needOutputST{false};
             bool m_needFragmentPosition{false};
+            BinaryCache* m_binaryCache;
         };
 
         class ProgramCache
@@ -217,8 +222,19 @@ namespace IPCore
             const Program* select(const Expression*);
             void flush();
 
+            //
+            //  Turns on the persistent binary cache (if it is enabled in
+            //  the environment) for the given driver identity. Called by
+            //  the renderer once its GL context is current.
+            //
+
+            void useBinaryCache(const std::string& driver);
+
+            const BinaryCache* binaryCache() const { return m_binaryCache; }
+
         private:
             ProgramCacheMap m_programCache;
+            BinaryCache* m_binaryCache;
         };
 
     } // namespace Shader
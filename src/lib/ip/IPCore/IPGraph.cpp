@@ -20,6 +20,7 @@
 #include <IPCore/OutputGroupIPNode.h>
 #include <IPCore/RootIPNode.h>
 #include <IPCore/SessionIPNode.h>
+#include <IPCore/ShaderCPU.h>
 #include <IPCore/ShaderProgram.h>
 #include <IPCore/SoundTrackIPNode.h>
 #include <IPCore/Transform2DIPNode.h>
@@ -32,6 +33,7 @@
 #include <TwkAudio/Filters.h>
 #include <TwkAudio/Mix.h>
 #include <TwkMath/Function.h>
+#include <TwkUtil/EnvVar.h>
 #include <TwkUtil/File.h>
 #include <TwkUtil/ThreadName.h>
 #include <TwkUtil/FrameUtils.h>
@@ -133,6 +135,24 @@ namespace IPCore
 
     static pthread_t notAThread;
 
+    //
+    //  The read-ahead thread is off unless RV_READAHEAD_FRAMES asks for
+    //  it (8 is a good start for image sequences on network storage).
+    //
+
+    static ENVVAR_INT(evReadAheadFrames, "RV_READAHEAD_FRAMES", 0);
+
+    namespace
+    {
+
+        class ReadAheadVisitor : public IPNode::MetaEvalVisitor
+        {
+        public:
+            virtual void enter(const IPNode::Context& c, IPNode* n) { n->readAhead(c); }
+        };
+
+    } // namespace
+
     static void evalThreadTrampoline(IPGraph::EvalThreadData* d)
     {
         try
@@ -244,6 +264,8 @@ namespace IPCore
         , m_viewGroupNode(0)
         , m_threadGroup(0)
         , m_threadGroupSingle(0)
+        , m_threadGroupReadAhead(0)
+        , m_readAheadSerial(0)
         , m_audioThreadGroup(1, 2)
         , m_cacheMode(NeverCache)
         , m_fbcache(this)
@@ -549,11 +571,28 @@ namespace IPCore
         n->setGraph(0);
     }
 
+    static void readAheadThreadTrampoline(IPGraph::EvalThreadData* d)
+    {
+        try
+        {
+            setThreadName("IPGraph ReadAhead");
+            HOP_SET_THREAD_NAME("IPGraph ReadAhead");
+
+            d->graph->readAheadThreadMain(d);
+        }
+        catch (std::exception& exc)
+        {
+            cerr << "ERROR: read-ahead thread exited via exception: " << exc.what() << endl;
+        }
+    }
+
     void IPGraph::setNumEvalThreads(size_t n)
     {
         finishCachingThread();
         delete m_threadGroup;
         delete m_threadGroupSingle;
+        delete m_threadGroupReadAhead;
+        m_threadGroupReadAhead = 0;
 
         m_threadData.resize(n);
 
@@ -582,6 +621,26 @@ namespace IPCore
 
         m_threadGroupSingle = new ThreadGroup(1, 8, 0, &funcs, &datas);
 
+        //
+        //  Read-ahead thread. It only issues I/O so it doesn't count
+        //  against the evaluation threads.
+        //
+
+        if (evReadAheadFrames.getValue() > 0)
+        {
+            m_readAheadThreadData.id = n + 1;
+            m_readAheadThreadData.graph = this;
+            m_readAheadThreadData.running = false;
+            m_readAheadThreadData.mythread = notAThread;
+
+            funcs.resize(0);
+            datas.resize(0);
+            funcs.push_back((ThreadGroup::thread_function)readAheadThreadTrampoline);
+            datas.push_back(&m_readAheadThreadData);
+
+            m_threadGroupReadAhead = new ThreadGroup(1, 8, 0, &funcs, &datas);
+        }
+
         //
         //  Other caching threads.
         //
@@ -1141,20 +1200,25 @@ IPGraph::findNodesByAbstractPath(int frame,
         string head = prefixBuffer.back();
         const char qualifier = head[0];
         buffer.erase(buffer.begin());
-        string rest = algorithm::join(buffer, ".");
+
+        //
+        //  buffer now holds the property path already split; it's passed
+        //  to find() as is so it isn't joined and parsed again for each
+        //  node searched.
+        //
 
         if (qualifier == '#')
         {
             if (head == "#View")
             {
-                if (Property* p = viewNode()->find(rest))
+                if (Property* p = viewNode()->find(buffer.begin(), buffer.end()))
                 {
                     props.push_back(p);
                 }
             }
             else if (head == "#Session")
             {
-                if (Property* p = sessionNode()->find(rest))
+                if (Property* p = sessionNode()->find(buffer.begin(), buffer.end()))
                 {
                     props.push_back(p);
                 }
@@ -1177,7 +1241,7 @@ IPGraph::findNodesByAbstractPath(int frame,
                     {
                         node = infos[i].node;
 
-                        if (Property* p = node->find(rest))
+                        if (Property* p = node->find(buffer.begin(), buffer.end()))
                         {
                             propSet.insert(p);
                         }
@@ -1195,7 +1259,7 @@ IPGraph::findNodesByAbstractPath(int frame,
             if (!infos.empty())
             {
                 node = infos.front().node;
-                if (Property* p = node->find(rest))
+                if (Property* p = node->find(buffer.begin(), buffer.end()))
                     props.push_back(p);
             }
         }
@@ -1205,7 +1269,7 @@ IPGraph::findNodesByAbstractPath(int frame,
 
             if (const NodeDefinition* def = m_nodeManager->definition(typeName))
             {
-                if (const Property* p = def->find(rest))
+                if (const Property* p = def->find(buffer.begin(), buffer.end()))
                 {
                     props.push_back((Property*)p);
                 }
@@ -1219,7 +1283,7 @@ IPGraph::findNodesByAbstractPath(int frame,
             {
                 node = i->second;
 
-                if (Property* p = node->find(rest))
+                if (Property* p = node->find(buffer.begin(), buffer.end()))
                 {
                     props.push_back(p);
                 }
@@ -1451,6 +1515,17 @@ IPGraph::findNodesByAbstractPath(int frame,
         lockInternal();
         m_cacheStop = true;
         unlockInternal();
+        signalReadAhead();
+    }
+
+    void IPGraph::signalReadAhead()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_readAheadMutex);
+            m_readAheadSerial++;
+        }
+
+        m_readAheadCond.notify_all();
     }
 
     void IPGraph::setCacheModeSize(CachingMode mode, size_t size)
@@ -1595,18 +1670,19 @@ IPGraph::findNodesByAbstractPath(int frame,
 
         PROFILE_SAMPLE(cacheTestStart);
 
-        PROFILE_SAMPLE(cacheTestLockStart);
-        TWK_CACHE_LOCK(m_fbcache, "");
-        PROFILE_SAMPLE(cacheTestLockEnd);
-
         //
         //  If we're evaluating for display and the frame is not the one the
         //  cache thinks we're currently viewing, then set a flag that will
-        //  awaken caching threads later.
+        //  awaken caching threads later. Only this needs the cache lock,
+        //  isFrameCached() doesn't.
         //
         PROFILE_SAMPLE(setDisplayFrameStart);
         if (forDisplay)
         {
+            PROFILE_SAMPLE(cacheTestLockStart);
+            TWK_CACHE_LOCK(m_fbcache, "");
+            PROFILE_SAMPLE(cacheTestLockEnd);
+
             m_newFrame = frame != m_fbcache.displayFrame();
 
             //
@@ -1617,6 +1693,8 @@ IPGraph::findNodesByAbstractPath(int frame,
             {
                 m_fbcache.setDisplayFrame(frame);
             }
+
+            TWK_CACHE_UNLOCK(m_fbcache, "");
         }
         PROFILE_SAMPLE(setDisplayFrameEnd);
 
@@ -1624,7 +1702,6 @@ IPGraph::findNodesByAbstractPath(int frame,
         bool isCached = m_fbcache.isFrameCached(frame);
         PROFILE_SAMPLE(frameCachedTestEnd);
 
-        TWK_CACHE_UNLOCK(m_fbcache, "");
         // DB ("evaluateAtFrame f " << frame << " forDisplay " << forDisplay <<
         // " isCached " << isCached);
         PROFILE_SAMPLE(cacheTestEnd);
@@ -2065,6 +2142,9 @@ IPGraph::findNodesByAbstractPath(int frame,
             }
         }
 
+        if (m_threadGroupReadAhead)
+            m_threadGroupReadAhead->maybe_dispatch(0, 0);
+
         unlockInternal();
     }
 
@@ -2078,6 +2158,8 @@ IPGraph::findNodesByAbstractPath(int frame,
             m_threadGroup->control_wait();
         if (m_threadGroupSingle)
             m_threadGroupSingle->control_wait();
+        if (m_threadGroupReadAhead)
+            m_threadGroupReadAhead->control_wait();
         lockInternal();
         m_cacheStop = false;
         unlockInternal();
@@ -2109,6 +2191,9 @@ IPGraph::findNodesByAbstractPath(int frame,
 
                 if (m_threadGroup && !m_evalSlowMedia)
                     m_threadGroup->awaken_all_workers();
+
+                if (m_threadGroupReadAhead)
+                    m_threadGroupReadAhead->awaken_all_workers();
             }
         }
     }
@@ -2169,6 +2254,31 @@ IPGraph::findNodesByAbstractPath(int frame,
 
             if (img)
             {
+                //
+                //  On a software GL the colour functions stacked on the
+                //  sources are cheaper to apply here than per fragment.
+                //  This has to happen before the IDs are computed since it
+                //  changes the fbs and expressions.
+                //
+
+                if ((thread & IPNode::DisplayThread) && (Shader::colorBaking() || Shader::cpuEvaluation()))
+                {
+                    vector<TwkFB::FrameBuffer*> cachedFBs;
+
+                    if (Shader::colorBaking())
+                        Shader::bakeColorChains(img, cachedFBs);
+                    if (Shader::cpuEvaluation())
+                        Shader::evaluateOnCPU(img, cachedFBs);
+
+                    if (!cachedFBs.empty())
+                    {
+                        TWK_CACHE_LOCK(m_fbcache, "");
+                        for (size_t i = 0; i < cachedFBs.size(); i++)
+                            m_fbcache.Cache::checkIn(cachedFBs[i]);
+                        TWK_CACHE_UNLOCK(m_fbcache, "");
+                    }
+                }
+
                 img->computeGraphIDs();
                 img->computeMatrices(m_controlDevice, m_outputDevice);
                 img->assembleAuxFrameBuffers();
@@ -2569,6 +2679,9 @@ IPGraph::findNodesByAbstractPath(int frame,
                 lastFrameCached = frame;
                 ++framesCached;
 
+                if (m_threadGroupReadAhead)
+                    signalReadAhead();
+
                 //
                 //  Update cacheStats no more often than 10x a second.  Only
                 //  caching thread #1 updates stats while caching.
@@ -2584,6 +2697,9 @@ IPGraph::findNodesByAbstractPath(int frame,
             lockInternal();
             threadData->running = false;
             unlockInternal();
+
+            if (m_threadGroupReadAhead)
+                signalReadAhead();
         }
         else
         {
@@ -2636,6 +2752,106 @@ IPGraph::findNodesByAbstractPath(int frame,
         m_textureCacheUpdated();
     }
 
+    void IPGraph::readAheadThreadMain(EvalThreadData* threadData)
+    {
+        const size_t maxFrames = size_t(evReadAheadFrames.getValue());
+        std::set<int> issued;
+        std::set<int> window;
+        std::vector<int> targets;
+
+        if (!m_rootNode)
+            return;
+
+        while (cacheThreadContinue())
+        {
+            size_t serial;
+
+            {
+                std::lock_guard<std::mutex> lock(m_readAheadMutex);
+                serial = m_readAheadSerial;
+            }
+
+            //
+            //  Walk forward from the cache frame in display order and
+            //  collect the first maxFrames frames that aren't cached
+            //  yet. Frames which have already been read ahead are kept
+            //  in the window (so they aren't issued again) but are not
+            //  targets.
+            //
+
+            targets.clear();
+            window.clear();
+
+            TWK_CACHE_LOCK(m_fbcache, "");
+
+            const int in = m_fbcache.inFrame();
+            const int out = m_fbcache.outFrame();
+            const int range = out - in;
+            const int inc = m_fbcache.displayInc() < 0 ? -1 : 1;
+            int f = m_fbcache.cacheFrame();
+
+            for (int i = 0; range > 0 && i < range && window.size() < maxFrames; i++, f += inc)
+            {
+                if (f >= out)
+                    f = in;
+                if (f < in)
+                    f = out - 1;
+
+                if (m_fbcache.isFrameCached(f))
+                    continue;
+
+                window.insert(f);
+                if (issued.find(f) == issued.end())
+                    targets.push_back(f);
+            }
+
+            TWK_CACHE_UNLOCK(m_fbcache, "");
+
+            for (std::set<int>::iterator i = issued.begin(); i != issued.end();)
+            {
+                if (window.find(*i) == window.end())
+                    issued.erase(i++);
+                else
+                    ++i;
+            }
+
+            if (targets.empty())
+            {
+                //
+                //  Nothing left to read. Stay around while the caching
+                //  threads are working (each frame they finish moves the
+                //  window), otherwise return to the thread group.
+                //  awakenAllCachingThreads() restarts us.
+                //
+
+                if (!isCacheThreadRunning())
+                    break;
+
+                std::unique_lock<std::mutex> lock(m_readAheadMutex);
+                m_readAheadCond.wait(lock, [&] { return m_readAheadSerial != serial; });
+                continue;
+            }
+
+            for (size_t i = 0; i < targets.size() && cacheThreadContinue(); i++)
+            {
+                IPNode::Context context(targets[i], targets[i], m_fbcache.displayFPS(), 0, 0, IPNode::CacheEvalThread, threadData->id,
+                                        m_fbcache, false);
+
+                ReadAheadVisitor visitor;
+
+                try
+                {
+                    m_rootNode->metaEvaluate(context, visitor);
+                }
+                catch (...)
+                {
+                }
+
+                issued.insert(targets[i]);
+            }
+        }
+    }
+
     //----------------------------------------------------------------------
 
     void IPGraph::setAudioThreading(bool b)
@@ -2968,10 +3184,13 @@ IPGraph::findNodesByAbstractPath(int frame,
 
         if (m_audioConfigured && tryLockAudioFill() && m_rootNode)
         {
-            m_audioCache.lock();
+            //
+            //  fillBuffer() doesn't need the cache lock: the audio
+            //  callback must not wait on the audio caching thread.
+            //
+
             bool found = m_audioCache.fillBuffer(inbuffer);
             double rate = m_audioCache.rate();
-            m_audioCache.unlock();
 
             if (!found)
             {
@@ -26,6 +26,8 @@ namespace IPCore
     using namespace stl_ext;
     using namespace TwkMath;
 
+    std::atomic<uint64_t> IPNode::m_inputsGeneration(1);
+
     IPNode::IPNode(const string& name, const NodeDefinition* definition, IPGraph* graph, GroupIPNode* group)
         : PropertyContainer()
         , m_definition(definition)
@@ -175,7 +177,9 @@ namespace IPCore
 
     const string IPNode::uiName() const
     {
-        if (const StringProperty* sp = property<StringProperty>("ui.name"))
+        static const PropertyName uiNameProperty("ui.name");
+
+        if (const StringProperty* sp = property<StringProperty>(uiNameProperty))
         {
             return sp->front();
         }
@@ -256,6 +260,8 @@ namespace IPCore
             std::copy(nodes.begin(), nodes.end(), m_inputs.begin());
         }
 
+        m_inputsGeneration.fetch_add(1, std::memory_order_acq_rel);
+
         {
             HOP_PROF("addOutput loop");
             for (size_t i = 0; i < m_inputs.size(); i++)
@@ -438,6 +444,8 @@ namespace IPCore
         }
     }
 
+    void IPNode::readAhead(const Context&) {}
+
     IPNode::ImageRangeInfo IPNode::imageRangeInfo() const
     {
         if (m_inputs.size())
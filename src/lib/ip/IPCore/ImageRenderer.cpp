@@ -42,6 +42,7 @@
 #include <TwkUtil/sgcHopTools.h>
 #include <TwkUtil/SystemInfo.h>
 #include <TwkUtil/ThreadName.h>
+#include <TwkUtil/Trace.h>
 #include <assert.h>
 #include <half.h>
 #include <iostream>
@@ -55,6 +56,7 @@
 #include <IPCore/GroupIPNode.h>
 #include <IPCore/IPNode.h>
 #include <IPCore/ShaderCommon.h>
+#include <IPCore/ShaderCPU.h>
 #include <IPCore/ShaderState.h>
 #include <limits>
 #include <stdexcept>
@@ -777,10 +779,22 @@ namespace IPCore
         TwkUtil::CrashHandler::instance().addAnnotation("gpu_vendor", glven);
         TwkUtil::CrashHandler::instance().addAnnotation("gpu_renderer", glren);
 
+        m_programCache->useBinaryCache(glven + "\n" + glren + "\n" + glver + "\n" + glslver);
+
         vector<string> tokens;
         stl_ext::tokenize(tokens, glren);
         m_softwareGLRenderer = (tokens.size() && tokens[0] == "Mesa");
 
+        //
+        //  Rasterizing on the CPU anyway: do the per source colour work
+        //  with vector code instead of the software fragment pipeline.
+        //  Only the software Mesa drivers: hardware drivers also report
+        //  "Mesa ..." on Linux.
+        //
+
+        Shader::setCPUEvaluation(glren.find("llvmpipe") != string::npos || glren.find("softpipe") != string::npos
+                                 || glren.find("swrast") != string::npos);
+
         vector<string> tokens2;
         stl_ext::tokenize(tokens2, glslver, ".");
         size_t glslMajor = 0, glslMinor = 0;
@@ -4575,6 +4589,8 @@ namespace IPCore
 #endif
 
         ProfilerGuard guard(m_profilingState);
+        TwkUtil::TraceScope uploadTrace("gpu", "uploadPlane");
+        uploadTrace.setArg("bytes", fb->allocSize());
 
         if (fb->coordinateType() == FrameBuffer::NormalizedCoordinates)
         {
@@ -0,0 +1,392 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/PixelTileBatch.h>
+#include <atomic>
+#include <errno.h>
+#include <sstream>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace IPCore
+{
+    using namespace std;
+
+    //
+    //  A batch can't be bigger than a single network message, which
+    //  Qt limits to 2GB.
+    //
+
+    static const uint64_t MaxBatchSize = uint64_t(1) << 31;
+
+    //
+    //  zlib can't compress by more than about 1032:1, so a body which
+    //  claims to inflate to more than this is lying. Checked before the
+    //  body buffer is allocated.
+    //
+
+    static const uint64_t MaxCompressionRatio = 1032;
+
+    bool PixelTileBatch::decode(const void* data, size_t size)
+    {
+        m_tiles.clear();
+        m_error.clear();
+
+        BatchHeader header;
+
+        if (size < sizeof(header))
+        {
+            m_error = "pixel tile batch is truncated";
+            return false;
+        }
+
+        memcpy(&header, data, sizeof(header));
+
+        if (header.magic != Magic || header.version != Version)
+        {
+            m_error = "not a pixel tile batch or unsupported version";
+            return false;
+        }
+
+        if (header.encodedSize != size - sizeof(header) || header.bodySize == 0 || header.bodySize > MaxBatchSize
+            || header.numTiles > header.bodySize / sizeof(TileHeader))
+        {
+            m_error = "pixel tile batch sizes are inconsistent";
+            return false;
+        }
+
+        const char* body = (const char*)data + sizeof(header);
+
+        if (header.compression == ZLibCompression)
+        {
+            if (header.bodySize > header.encodedSize * MaxCompressionRatio)
+            {
+                m_error = "pixel tile batch claims an impossible compression ratio";
+                return false;
+            }
+
+            m_buffer.resize(header.bodySize);
+            uLongf n = uLongf(header.bodySize);
+
+            if (uncompress((Bytef*)&m_buffer.front(), &n, (const Bytef*)body, uLong(header.encodedSize)) != Z_OK
+                || n != header.bodySize)
+            {
+                m_error = "pixel tile batch failed to decompress";
+                return false;
+            }
+
+            body = &m_buffer.front();
+        }
+        else if (header.compression != NoCompression || header.bodySize != header.encodedSize)
+        {
+            m_error = "pixel tile batch has unknown compression";
+            return false;
+        }
+
+        const uint64_t tableSize = uint64_t(header.numTiles) * sizeof(TileHeader);
+        uint64_t offset = tableSize;
+
+        m_tiles.resize(header.numTiles);
+
+        for (size_t i = 0; i < m_tiles.size(); i++)
+        {
+            TileHeader t;
+            memcpy(&t, body + i * sizeof(TileHeader), sizeof(t));
+
+            if (t.size > header.bodySize - offset)
+            {
+                m_tiles.clear();
+                m_error = "pixel tile batch tile data exceeds the batch";
+                return false;
+            }
+
+            Tile& tile = m_tiles[i];
+            tile.x = t.x;
+            tile.y = t.y;
+            tile.width = t.width;
+            tile.height = t.height;
+            tile.pixels = body + offset;
+            tile.size = size_t(t.size);
+            offset += t.size;
+        }
+
+        return true;
+    }
+
+    string PixelTileBatch::capabilities()
+    {
+        ostringstream str;
+        str << "version=" << Version << " compression=none,zlib shm=" << PixelTileRing::Version;
+        return str.str();
+    }
+
+    //----------------------------------------------------------------------
+
+    PixelTileRing::PixelTileRing(const string& name, void* handle, void* memory, size_t mappedSize, bool owner)
+        : m_name(name)
+        , m_handle(handle)
+        , m_memory(memory)
+        , m_mappedSize(mappedSize)
+        , m_header((RingHeader*)memory)
+        , m_data((char*)memory + DataOffset)
+        , m_owner(owner)
+        , m_capacity(0)
+        , m_generation(0)
+    {
+    }
+
+    PixelTileRing::~PixelTileRing()
+    {
+        //
+        //  Consumers still mapping the segment see it's gone
+        //
+
+        if (m_owner)
+            m_header->magic = 0;
+
+#ifdef PLATFORM_WINDOWS
+        UnmapViewOfFile(m_memory);
+        CloseHandle((HANDLE)m_handle);
+#else
+        munmap(m_memory, m_mappedSize);
+        if (m_owner)
+            shm_unlink(m_name.c_str());
+#endif
+    }
+
+    PixelTileRing* PixelTileRing::create(const string& name, size_t capacity, string& error)
+    {
+        const size_t mappedSize = DataOffset + capacity;
+
+#ifdef PLATFORM_WINDOWS
+        HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, DWORD(uint64_t(mappedSize) >> 32),
+                                      DWORD(mappedSize & 0xffffffff), name.c_str());
+
+        if (!h)
+        {
+            error = "cannot create shared memory " + name;
+            return 0;
+        }
+
+        void* p = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, mappedSize);
+
+        if (!p)
+        {
+            CloseHandle(h);
+            error = "cannot map shared memory " + name;
+            return 0;
+        }
+
+        PixelTileRing* ring = new PixelTileRing(name, h, p, mappedSize, true);
+#else
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+
+        if (fd < 0)
+        {
+            error = "cannot create shared memory " + name + ": " + strerror(errno);
+            return 0;
+        }
+
+        void* p = MAP_FAILED;
+
+        if (ftruncate(fd, off_t(mappedSize)) == 0)
+        {
+            p = mmap(0, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        close(fd);
+
+        if (p == MAP_FAILED)
+        {
+            error = "cannot map shared memory " + name + ": " + strerror(errno);
+            shm_unlink(name.c_str());
+            return 0;
+        }
+
+        PixelTileRing* ring = new PixelTileRing(name, 0, p, mappedSize, true);
+#endif
+
+        //
+        //  The generation only has to differ from the last ring created
+        //  with this name
+        //
+
+#ifdef PLATFORM_WINDOWS
+        const uint64_t pid = GetCurrentProcessId();
+#else
+        const uint64_t pid = getpid();
+#endif
+        static std::atomic<uint64_t> count(0);
+        const uint64_t generation = (uint64_t(time(0)) << 32) ^ (pid << 16) ^ ++count;
+
+        RingHeader* header = ring->m_header;
+        header->capacity = capacity;
+        header->head = 0;
+        header->tail = 0;
+        header->generation = generation;
+        header->version = Version;
+        ring->m_capacity = capacity;
+        ring->m_generation = generation;
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = Magic;
+
+        return ring;
+    }
+
+    PixelTileRing* PixelTileRing::attach(const string& name, string& error)
+    {
+#ifdef PLATFORM_WINDOWS
+        HANDLE h = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+
+        if (!h)
+        {
+            error = "cannot open shared memory " + name;
+            return 0;
+        }
+
+        void* p = MapViewOfFile(h, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        MEMORY_BASIC_INFORMATION info;
+
+        if (!p || !VirtualQuery(p, &info, sizeof(info)))
+        {
+            if (p)
+                UnmapViewOfFile(p);
+            CloseHandle(h);
+            error = "cannot map shared memory " + name;
+            return 0;
+        }
+
+        PixelTileRing* ring = new PixelTileRing(name, h, p, info.RegionSize, false);
+#else
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+        if (fd < 0)
+        {
+            error = "cannot open shared memory " + name + ": " + strerror(errno);
+            return 0;
+        }
+
+        struct stat sb;
+        void* p = MAP_FAILED;
+
+        if (fstat(fd, &sb) == 0 && size_t(sb.st_size) > DataOffset)
+        {
+            p = mmap(0, size_t(sb.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+
+        close(fd);
+
+        if (p == MAP_FAILED)
+        {
+            error = "cannot map shared memory " + name;
+            return 0;
+        }
+
+        PixelTileRing* ring = new PixelTileRing(name, 0, p, size_t(sb.st_size), false);
+#endif
+
+        const RingHeader* header = ring->m_header;
+
+        if (ring->m_mappedSize < DataOffset || header->magic != Magic || header->version != Version)
+        {
+            error = "shared memory " + name + " is not a pixel tile ring";
+            delete ring;
+            return 0;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        //
+        //  The producer can write to the header at any time: read the
+        //  capacity once, check it and only use that from now on.
+        //
+
+        const uint64_t capacity = header->capacity;
+
+        if (capacity == 0 || capacity > ring->m_mappedSize - DataOffset)
+        {
+            error = "shared memory " + name + " has a bad pixel tile ring capacity";
+            delete ring;
+            return 0;
+        }
+
+        ring->m_capacity = capacity;
+        ring->m_generation = header->generation;
+        return ring;
+    }
+
+    bool PixelTileRing::stale() const
+    {
+        const RingHeader* header = m_header;
+        return header->magic != Magic || header->version != Version || header->generation != m_generation;
+    }
+
+    const char* PixelTileRing::data(const PixelTileBatch::RingSpan& span) const
+    {
+        const uint64_t head = m_header->head;
+        const uint64_t tail = m_header->tail;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        const uint64_t capacity = m_capacity;
+        const uint64_t start = span.offset % capacity;
+
+        if (span.offset < tail || span.offset > head || span.size > head - span.offset || span.size > capacity - start)
+        {
+            return 0;
+        }
+
+        return m_data + start;
+    }
+
+    void PixelTileRing::release(const PixelTileBatch::RingSpan& span)
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->tail = span.offset + span.size;
+    }
+
+    char* PixelTileRing::reserve(size_t size, PixelTileBatch::RingSpan& span)
+    {
+        const uint64_t capacity = m_capacity;
+        uint64_t offset = m_header->head;
+
+        if (size > capacity)
+            return 0;
+
+        //
+        //  Batches don't wrap: skip the end of the data area if the
+        //  batch doesn't fit there.
+        //
+
+        if (capacity - offset % capacity < size)
+            offset += capacity - offset % capacity;
+
+        const uint64_t tail = m_header->tail;
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (offset + size > tail + capacity)
+            return 0;
+
+        span.offset = offset;
+        span.size = size;
+        return m_data + offset % capacity;
+    }
+
+    void PixelTileRing::commit(const PixelTileBatch::RingSpan& span)
+    {
+        std::atomic_thread_fence(std::memory_order_release);
+        m_header->head = span.offset + span.size;
+    }
+
+} // namespace IPCore
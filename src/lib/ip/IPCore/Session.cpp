@@ -35,6 +35,7 @@
 #include <TwkUtil/sgcHop.h>
 #include <TwkUtil/sgcHopTools.h>
 #include <TwkUtil/Clock.h>
+#include <TwkUtil/Trace.h>
 #include <Mu/GarbageCollector.h>
 #include <algorithm>
 #include <iostream>
@@ -647,6 +648,11 @@ namespace IPCore
         delete m_errorImage;
         delete m_fpsCalc;
 
+        for (PixelTileRings::iterator i = m_pixelTileRings.begin(); i != m_pixelTileRings.end(); ++i)
+        {
+            delete i->second;
+        }
+
         m_renderer = 0;
         m_proxyImage = 0;
         m_errorImage = 0;
@@ -2108,6 +2114,13 @@ namespace IPCore
 
         graph().cache().setFreeMode(fmode);
 
+        //
+        //  Don't leave the frame at proxy resolution
+        //
+
+        if (graph().cache().refreshProxyFrame(m_frame))
+            askForRedraw();
+
         m_shift = m_frame - rangeStart();
         //  cerr << "stop() setting(2) m_shift to " << m_shift << ".  m_frame "
         //  << m_frame << " rs " << rangeStart() << endl;
@@ -3174,6 +3187,15 @@ namespace IPCore
 
     void Session::postRender()
     {
+        //
+        //  If the frame was shown with proxies and the display isn't
+        //  moving on, render it again at full resolution. The caching
+        //  threads may never get to it (e.g. it's outside the region).
+        //
+
+        if (!isPlaying() && graph().cache().refreshProxyFrame(m_frame))
+            askForRedraw();
+
         if (m_avPlaybackVersion == 2)
         {
             return postRender_v2();
@@ -4474,65 +4496,190 @@ namespace IPCore
         return event.returnContent();
     }
 
+    namespace
+    {
+
+        //
+        //  The interp string of PIXELTILE and PIXELTILES messages looks
+        //  like a python call with keyword args, e.g.
+        //
+        //      PIXELTILE(media=foo,view=left,w=64,h=64,x=0,y=64,f=1)
+        //
+
+        struct PixelTileInterp
+        {
+            PixelTileInterp(const string& eventName)
+                : event(eventName)
+                , layer("-")
+                , view("-")
+                , x(0)
+                , y(0)
+                , w(0)
+                , h(0)
+                , f(0)
+            {
+            }
+
+            void parse(const string& interp)
+            {
+                vector<string> tokens;
+                stl_ext::tokenize(tokens, interp, "(), ");
+
+                for (size_t i = 0; i < tokens.size(); i++)
+                {
+                    vector<string> attr;
+                    stl_ext::tokenize(attr, tokens[i], "=");
+
+                    if (attr.size() == 2)
+                    {
+                        const string& n = attr[0];
+                        const string& v = attr[1];
+
+                        if (n == "w")
+                            w = atoi(v.c_str());
+                        else if (n == "h")
+                            h = atoi(v.c_str());
+                        else if (n == "x")
+                            x = atoi(v.c_str());
+                        else if (n == "y")
+                            y = atoi(v.c_str());
+                        else if (n == "f")
+                            f = atoi(v.c_str());
+                        else if (n == "event")
+                            event = v;
+                        else if (n == "media")
+                            media = v;
+                        else if (n == "layer")
+                            layer = v;
+                        else if (n == "view")
+                            view = v;
+                        else if (n == "shm")
+                            shm = v;
+                    }
+                }
+            }
+
+            string event; // could be overriden by interp
+            string media;
+            string layer;
+            string view;
+            string shm; // PIXELTILES only: shared memory ring name
+            int x;      // tile's x offset
+            int y;      // tile's y offset
+            size_t w;   // tile width
+            size_t h;   // tile height
+            int f;      // frame
+        };
+
+    } // namespace
+
     void Session::pixelBlockEvent(const string& eventName, const string& interp, const char* data, size_t size)
     {
         if (m_beingDeleted)
             return;
 
-        vector<string> tokens;
-        stl_ext::tokenize(tokens, interp, "(), ");
+        PixelTileInterp p(eventName);
+        p.parse(interp);
 
-        //
-        //  Default values
-        //
+        PixelBlockTransferEvent event(p.event, this, p.media, p.layer, p.view, p.f, p.x, p.y, p.w, p.h, data, size, 0);
 
-        string ename = eventName; // could be overriden by interp
-        string media = "";
-        string layer = "-";
-        string view = "-";
-        int x = 0;    // tile's x offset
-        int y = 0;    // tile's y offset
-        size_t w = 0; // tile width
-        size_t h = 0; // tile height
-        int f = 0;    // frame
+        sendEvent(event);
+    }
 
-        for (size_t i = 0; i < tokens.size(); i++)
+    void Session::pixelBlockBatchEvent(const string& eventName, const string& interp, const char* data, size_t size)
+    {
+        if (m_beingDeleted)
+            return;
+
+        PixelTileInterp p(eventName);
+        p.parse(interp);
+
+        PixelTileRing* ring = 0;
+        PixelTileBatch::RingSpan span;
+
+        if (!p.shm.empty())
         {
-            vector<string> attr;
-            stl_ext::tokenize(attr, tokens[i], "=");
+            if (size != sizeof(span))
+            {
+                cerr << "ERROR: pixel tiles: bad shared memory span" << endl;
+                return;
+            }
+
+            PixelTileRings::iterator i = m_pixelTileRings.find(p.shm);
+
+            //
+            //  The client may have closed the ring and made a new one
+            //  with the same name since we attached
+            //
 
-            if (!attr.empty())
+            if (i != m_pixelTileRings.end() && i->second->stale())
             {
-                if (attr.size() == 2)
+                delete i->second;
+                m_pixelTileRings.erase(i);
+                i = m_pixelTileRings.end();
+            }
+
+            if (i != m_pixelTileRings.end())
+            {
+                ring = i->second;
+            }
+            else
+            {
+                string error;
+
+                if (!(ring = PixelTileRing::attach(p.shm, error)))
                 {
-                    const string& n = attr[0];
-                    const string& v = attr[1];
-
-                    if (n == "w")
-                        w = atoi(v.c_str());
-                    else if (n == "h")
-                        h = atoi(v.c_str());
-                    else if (n == "x")
-                        x = atoi(v.c_str());
-                    else if (n == "y")
-                        y = atoi(v.c_str());
-                    else if (n == "f")
-                        f = atoi(v.c_str());
-                    else if (n == "event")
-                        ename = v;
-                    else if (n == "media")
-                        media = v;
-                    else if (n == "layer")
-                        layer = v;
-                    else if (n == "view")
-                        view = v;
+                    cerr << "ERROR: pixel tiles: " << error << endl;
+                    return;
                 }
+
+                m_pixelTileRings[p.shm] = ring;
             }
+
+            memcpy(&span, data, sizeof(span));
+
+            if (!(data = ring->data(span)))
+            {
+                //
+                //  Forget the ring: if the name is reused the next batch
+                //  attaches to the new one
+                //
+
+                cerr << "ERROR: pixel tiles: span is outside of " << p.shm << endl;
+                m_pixelTileRings.erase(p.shm);
+                delete ring;
+                return;
+            }
+
+            size = size_t(span.size);
         }
 
-        PixelBlockTransferEvent event(ename, this, media, layer, view, f, x, y, w, h, data, size, 0);
+        if (!m_pixelTileBatch.decode(data, size))
+        {
+            cerr << "ERROR: pixel tiles: " << m_pixelTileBatch.error() << endl;
+        }
+        else if (!m_pixelTileBatch.tiles().empty())
+        {
+            const PixelTileBatch::Tiles& tiles = m_pixelTileBatch.tiles();
+            PixelBlockTransferEvent::Blocks blocks(tiles.size());
 
-        sendEvent(event);
+            for (size_t i = 0; i < tiles.size(); i++)
+            {
+                PixelBlockTransferEvent::Block& b = blocks[i];
+                b.x = tiles[i].x;
+                b.y = tiles[i].y;
+                b.width = tiles[i].width;
+                b.height = tiles[i].height;
+                b.pixels = tiles[i].pixels;
+                b.size = tiles[i].size;
+            }
+
+            PixelBlockTransferEvent event(p.event, this, p.media, p.layer, p.view, p.f, blocks, 0);
+            sendEvent(event);
+        }
+
+        if (ring)
+            ring->release(span);
     }
 
     void Session::fullScreenMode(bool b)
@@ -5050,6 +5197,75 @@ namespace IPCore
     {
         // m_profilingSamples.back().gccount = GC_gc_no;
         m_profilingSamples.back().gccount = 0;
+
+        if (TwkUtil::Trace::enabled())
+            traceProfilingSample();
+    }
+
+    void Session::traceProfilingSample()
+    {
+        //
+        //  Replays the sample (and the graph's matching one) into the
+        //  trace. Both are on the profiling clock, so shift them onto
+        //  the trace clock.
+        //
+
+        const double offset = TwkUtil::Trace::now() - profilingElapsedTime() * 1e6;
+        const ProfilingRecord& t = m_profilingSamples.back();
+
+        struct Span
+        {
+            const char* name;
+            double start;
+            double end;
+        };
+
+        const Span spans[] = {{"render", t.renderStart, t.renderEnd},
+                              {"swap", t.swapStart, t.swapEnd},
+                              {"evaluate", t.evaluateStart, t.evaluateEnd},
+                              {"user render", t.userRenderStart, t.userRenderEnd},
+                              {"frame change event", t.frameChangeEventStart, t.frameChangeEventEnd},
+                              {"internal render", t.internalRenderStart, t.internalRenderEnd},
+                              {"internal prefetch", t.internalPrefetchStart, t.internalPrefetchEnd},
+                              {"prefetch render", t.prefetchRenderStart, t.prefetchRenderEnd}};
+
+        for (size_t i = 0; i < sizeof(spans) / sizeof(spans[0]); i++)
+        {
+            if (spans[i].end > spans[i].start)
+            {
+                TwkUtil::Trace::complete("rvprof", spans[i].name, offset + spans[i].start * 1e6, offset + spans[i].end * 1e6, "frame",
+                                         t.frame);
+            }
+        }
+
+        const IPGraph::ProfilingVector& graphSamples = graph().profilingSamples();
+
+        if (graphSamples.size() == m_profilingSamples.size())
+        {
+            const IPGraph::EvalProfilingRecord& g = graphSamples.back();
+
+            const Span graphSpans[] = {{"cache test", g.cacheTestStart, g.cacheTestEnd},
+                                       {"eval internal", g.evalInternalStart, g.evalInternalEnd},
+                                       {"eval ID", g.evalIDStart, g.evalIDEnd},
+                                       {"cache query", g.cacheQueryStart, g.cacheQueryEnd},
+                                       {"cache eval", g.cacheEvalStart, g.cacheEvalEnd},
+                                       {"io", g.ioStart, g.ioEnd},
+                                       {"restart threads A", g.restartThreadsAStart, g.restartThreadsAEnd},
+                                       {"restart threads B", g.restartThreadsBStart, g.restartThreadsBEnd},
+                                       {"cache test lock", g.cacheTestLockStart, g.cacheTestLockEnd},
+                                       {"set display frame", g.setDisplayFrameStart, g.setDisplayFrameEnd},
+                                       {"frame cached test", g.frameCachedTestStart, g.frameCachedTestEnd},
+                                       {"awaken threads", g.awakenThreadsStart, g.awakenThreadsEnd}};
+
+            for (size_t i = 0; i < sizeof(graphSpans) / sizeof(graphSpans[0]); i++)
+            {
+                if (graphSpans[i].end > graphSpans[i].start)
+                {
+                    TwkUtil::Trace::complete("rvprof", graphSpans[i].name, offset + graphSpans[i].start * 1e6,
+                                             offset + graphSpans[i].end * 1e6, "frame", t.frame);
+                }
+            }
+        }
     }
 
     void Session::dumpProfilingToFile(ostream& file)
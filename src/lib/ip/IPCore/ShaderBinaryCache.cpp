@@ -0,0 +1,387 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/ShaderBinaryCache.h>
+#include <TwkUtil/EnvVar.h>
+#include <TwkUtil/File.h>
+#include <TwkUtil/FNV1a.h>
+#include <TwkUtil/ThreadName.h>
+#include <TwkUtil/Trace.h>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+
+//
+//  Apple's legacy GL profile (which RV uses) has no program binaries.
+//
+
+#if defined(GL_PROGRAM_BINARY_LENGTH) && !defined(PLATFORM_DARWIN)
+#define TWK_SHADER_BINARY_CACHE 1
+#endif
+
+static ENVVAR_STRING(evShaderCacheDir, "RV_SHADER_CACHE_DIR", "");
+
+namespace IPCore
+{
+    namespace Shader
+    {
+        using namespace std;
+
+        namespace
+        {
+
+            //
+            //  File layout:
+            //
+            //      FileHeader
+            //      source (FileHeader::sourceSize bytes)
+            //      binary (FileHeader::binarySize bytes)
+            //
+            //  driverHash lets the prewarm thread skip entries written by
+            //  other drivers without reading the rest of the file.
+            //
+
+            const unsigned int Magic = 0x42535652; // "RVSB"
+            const unsigned int Version = 1;
+            const char* EntryExtension = ".rvsb";
+
+            //
+            //  Upper bound on what the prewarm thread keeps in memory.
+            //  Entries past it are read when first used.
+            //
+
+            const size_t MaxPrewarmBytes = size_t(256) * 1024 * 1024;
+
+            struct FileHeader
+            {
+                unsigned int magic;
+                unsigned int version;
+                unsigned int format;
+                unsigned int pad;
+                unsigned long long driverHash;
+                unsigned long long sourceSize;
+                unsigned long long binarySize;
+            };
+
+            bool readFully(FILE* f, void* p, size_t n) { return n == 0 || fread(p, 1, n, f) == n; }
+
+            bool writeFully(FILE* f, const void* p, size_t n) { return n == 0 || fwrite(p, 1, n, f) == n; }
+
+        } // namespace
+
+        BinaryCache::BinaryCache(const string& directory, const string& driver)
+            : m_directory(directory)
+            , m_driver(driver)
+            , m_driverHash(TwkUtil::FNV1a64(driver.data(), driver.size()))
+            , m_shutdown(false)
+            , m_prewarm(0)
+        {
+            m_prewarm = new boost::thread([this]() { prewarmMain(); });
+        }
+
+        BinaryCache::~BinaryCache()
+        {
+            {
+                ScopedLock lock(m_mutex);
+                m_shutdown = true;
+            }
+
+            m_prewarm->join();
+            delete m_prewarm;
+
+            if (m_stats.hits || m_stats.misses)
+            {
+                cout << "INFO: shader cache: " << m_stats.hits << " hits, " << m_stats.misses << " misses, " << m_stats.rejects
+                     << " rejected" << endl;
+            }
+        }
+
+        BinaryCache* BinaryCache::createFromEnvironment(const string& driver)
+        {
+            const string dir = evShaderCacheDir.getValue();
+
+            if (dir.empty())
+                return 0;
+
+#ifdef TWK_SHADER_BINARY_CACHE
+            GLint numFormats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+            if (numFormats <= 0)
+            {
+                cerr << "WARNING: shader cache: GL driver does not support program binaries" << endl;
+                return 0;
+            }
+
+            try
+            {
+                boost::filesystem::create_directories(dir);
+            }
+            catch (std::exception& exc)
+            {
+                cerr << "ERROR: shader cache: cannot create " << dir << ": " << exc.what() << endl;
+                return 0;
+            }
+
+            cout << "INFO: shader cache enabled in " << dir << endl;
+
+            return new BinaryCache(dir, driver);
+#else
+            cerr << "WARNING: shader cache: not supported on this platform" << endl;
+            return 0;
+#endif
+        }
+
+        size_t BinaryCache::hashSource(const string& source) const
+        {
+            const size_t h = TwkUtil::FNV1a64(source.data(), source.size());
+            return h ^ (m_driverHash + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+        }
+
+        string BinaryCache::pathForHash(size_t h) const
+        {
+            ostringstream str;
+            str << m_directory << "/" << hex << h << EntryExtension;
+            return str.str();
+        }
+
+        bool BinaryCache::readEntry(const string& path, bool skipOtherDrivers, Entry& entry) const
+        {
+            FILE* f = TwkUtil::fopen(path.c_str(), "rb");
+
+            if (!f)
+                return false;
+
+            FileHeader header;
+            bool ok = readFully(f, &header, sizeof(header)) && header.magic == Magic && header.version == Version
+                      && (!skipOtherDrivers || header.driverHash == m_driverHash) && header.binarySize > 0
+                      && header.sourceSize + header.binarySize < MaxPrewarmBytes;
+
+            if (ok)
+            {
+                entry.format = GLenum(header.format);
+                entry.source.resize(header.sourceSize);
+                entry.binary.resize(header.binarySize);
+                ok = readFully(f, &entry.source[0], entry.source.size()) && readFully(f, &entry.binary.front(), entry.binary.size());
+            }
+
+            fclose(f);
+            return ok;
+        }
+
+        bool BinaryCache::writeEntry(const string& path, const Entry& entry) const
+        {
+            //
+            //  Write to a temporary and rename so another RV process
+            //  sharing the directory never sees a partial entry. The
+            //  temporary's name is random so writers of the same entry
+            //  (other threads or processes) don't write into one file.
+            //
+
+            const string tmpPath = path + "." + boost::filesystem::unique_path("%%%%%%%%%%%%%%%%").string() + ".tmp";
+            FILE* f = TwkUtil::fopen(tmpPath.c_str(), "wb");
+
+            if (!f)
+                return false;
+
+            FileHeader header;
+            header.magic = Magic;
+            header.version = Version;
+            header.format = (unsigned int)entry.format;
+            header.pad = 0;
+            header.driverHash = m_driverHash;
+            header.sourceSize = entry.source.size();
+            header.binarySize = entry.binary.size();
+
+            bool ok = writeFully(f, &header, sizeof(header)) && writeFully(f, entry.source.data(), entry.source.size())
+                      && writeFully(f, &entry.binary.front(), entry.binary.size());
+
+            ok = (fclose(f) == 0) && ok;
+
+            if (ok)
+            {
+                boost::system::error_code ec;
+                boost::filesystem::rename(tmpPath, path, ec);
+                ok = !ec;
+            }
+
+            if (!ok)
+            {
+                boost::system::error_code ec;
+                boost::filesystem::remove(tmpPath, ec);
+            }
+
+            return ok;
+        }
+
+        void BinaryCache::prewarmMain()
+        {
+            using namespace boost::filesystem;
+
+            TwkUtil::setThreadName("RV Shader Cache");
+            TWK_TRACE_SCOPE("gpu", "shader cache prewarm");
+
+            size_t total = 0;
+
+            try
+            {
+                for (directory_iterator i(m_directory); i != directory_iterator(); ++i)
+                {
+                    const path p = i->path();
+
+                    if (p.extension().string() != EntryExtension)
+                        continue;
+
+                    Entry entry;
+
+                    if (!readEntry(p.string(), true, entry))
+                        continue;
+
+                    const size_t h = hashSource(entry.source);
+
+                    if (pathForHash(h) != p.string())
+                        continue;
+
+                    ScopedLock lock(m_mutex);
+
+                    if (m_shutdown)
+                        return;
+
+                    total += entry.source.size() + entry.binary.size();
+
+                    if (total > MaxPrewarmBytes)
+                        break;
+
+                    if (m_entries.find(h) == m_entries.end())
+                    {
+                        m_entries[h].source.swap(entry.source);
+                        m_entries[h].binary.swap(entry.binary);
+                        m_entries[h].format = entry.format;
+                        m_stats.prewarmed++;
+                    }
+                }
+            }
+            catch (std::exception& exc)
+            {
+                cerr << "WARNING: shader cache: scanning " << m_directory << ": " << exc.what() << endl;
+            }
+        }
+
+        bool BinaryCache::load(GLuint program, const string& source)
+        {
+#ifdef TWK_SHADER_BINARY_CACHE
+            const size_t h = hashSource(source);
+            Entry entry;
+            bool found = false;
+
+            {
+                ScopedLock lock(m_mutex);
+                EntryMap::const_iterator i = m_entries.find(h);
+
+                if (i != m_entries.end() && i->second.source == source)
+                {
+                    entry = i->second;
+                    found = true;
+                }
+            }
+
+            //
+            //  Not read ahead (yet): go to the file directly
+            //
+
+            if (!found)
+                found = readEntry(pathForHash(h), true, entry) && entry.source == source;
+
+            if (!found)
+            {
+                ScopedLock lock(m_mutex);
+                m_stats.misses++;
+                TWK_TRACE_INSTANT("gpu", "shader cache miss", 0, 0);
+                return false;
+            }
+
+            glProgramBinary(program, entry.format, &entry.binary.front(), GLsizei(entry.binary.size()));
+
+            GLint status = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+            ScopedLock lock(m_mutex);
+
+            if (status != GL_TRUE)
+            {
+                //
+                //  Clear the error glProgramBinary may have left behind so
+                //  TWK_GLDEBUG doesn't report it later.
+                //
+
+                while (glGetError() != GL_NO_ERROR)
+                    ;
+
+                m_entries.erase(h);
+                m_stats.rejects++;
+                m_stats.misses++;
+                TWK_TRACE_INSTANT("gpu", "shader cache reject", 0, 0);
+                return false;
+            }
+
+            m_stats.hits++;
+            TWK_TRACE_INSTANT("gpu", "shader cache hit", 0, 0);
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void BinaryCache::markRetrievable(GLuint program)
+        {
+#ifdef TWK_SHADER_BINARY_CACHE
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+        }
+
+        void BinaryCache::store(GLuint program, const string& source)
+        {
+#ifdef TWK_SHADER_BINARY_CACHE
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+            if (length <= 0)
+                return;
+
+            Entry entry;
+            entry.source = source;
+            entry.binary.resize(length);
+
+            GLsizei written = 0;
+            glGetProgramBinary(program, length, &written, &entry.format, &entry.binary.front());
+
+            if (written <= 0)
+                return;
+
+            entry.binary.resize(written);
+
+            const size_t h = hashSource(source);
+
+            if (!writeEntry(pathForHash(h), entry))
+            {
+                cerr << "WARNING: shader cache: failed to write " << pathForHash(h) << endl;
+                return;
+            }
+
+            ScopedLock lock(m_mutex);
+            m_entries[h] = entry;
+            m_stats.stores++;
+#endif
+        }
+
+        BinaryCache::Stats BinaryCache::stats() const
+        {
+            ScopedLock lock(m_mutex);
+            return m_stats;
+        }
+
+    } // namespace Shader
+} // namespace IPCore
@@ -0,0 +1,1909 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <IPCore/ShaderCPU.h>
+#include <IPCore/IPImage.h>
+#include <IPCore/LUTIPNode.h>
+#include <IPCore/ShaderCommon.h>
+#include <IPCore/ShaderFunction.h>
+#include <IPCore/ShaderSymbol.h>
+#include <TwkFB/SIMD.h>
+#include <TwkUtil/EnvVar.h>
+#include <TwkUtil/FNV1a.h>
+#include <TwkUtil/TaskPool.h>
+#include <TwkUtil/Trace.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <deque>
+#include <half.h>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string.h>
+
+//
+//  SSE2 is part of the x86-64 baseline so the vector kernels need no
+//  runtime dispatch beyond honoring RV_SIMD_LEVEL=scalar.
+//
+
+#if defined(TWKFB_SIMD_X86) && (defined(__SSE2__) || defined(_M_X64))
+#define TWK_CPU_SHADER_SSE2 1
+#endif
+
+static ENVVAR_INT(evCPUShaders, "RV_CPU_SHADERS", -1);
+static ENVVAR_BOOL(evBakeColor, "RV_BAKE_COLOR", false);
+static ENVVAR_INT(evBakeLUTSize, "RV_BAKE_COLOR_LUT_SIZE", 33);
+
+namespace IPCore
+{
+    namespace Shader
+    {
+        using namespace std;
+        using namespace TwkMath;
+        using TwkFB::FrameBuffer;
+
+        namespace
+        {
+
+            std::atomic<bool> autoEnabled(false);
+
+            //
+            //  Pixels are converted to float and processed in strips of
+            //  StripSize pixels stored as separate R, G, B and A arrays so
+            //  every kernel works on four pixels per instruction. Rows are
+            //  handed to the task pool in bands of BandHeight.
+            //
+
+            const size_t StripSize = 64;
+            const int BandHeight = 32;
+
+            struct Strip
+            {
+                alignas(16) float r[StripSize];
+                alignas(16) float g[StripSize];
+                alignas(16) float b[StripSize];
+                alignas(16) float a[StripSize];
+            };
+
+            enum OpType
+            {
+                OpMatrix,
+                OpMatrix4D,
+                OpCDL,
+                OpCDLSat,
+                OpGamma,
+                OpCineonLogLinear,
+                OpLinearCineonLog,
+                OpToLinear,
+                OpFromLinear,
+                OpPremult,
+                OpUnpremult,
+                OpClamp,
+                OpOpacity,
+                Op3DLUT,
+                OpChannelLUT
+            };
+
+            //
+            //  LUT contents converted to float RGB triples. 3D LUTs are
+            //  indexed ((b * h) + g) * w + r, channel LUTs just by entry.
+            //
+
+            struct LUTTable
+            {
+                int w;
+                int h;
+                int d;
+                vector<float> rgb;
+            };
+
+            struct Op
+            {
+                OpType type;
+                float m[16]; // row major
+                float v0[3];
+                float v1[3];
+                float v2[3];
+                float v3[3];
+                float f0;
+                float f1;
+                float f2;
+                float f3;
+                bool clamp;
+                const LUTTable* lut;
+            };
+
+            struct Pipeline
+            {
+                vector<Op> ops;
+                deque<LUTTable> luts;
+            };
+
+            //
+            //  Scalar four wide float. Used when vector kernels are disabled
+            //  or not available; its transcendentals are the C library ones.
+            //
+
+            struct F4S
+            {
+                float v[4];
+
+                static F4S load(const float* p)
+                {
+                    F4S r;
+                    r.v[0] = p[0];
+                    r.v[1] = p[1];
+                    r.v[2] = p[2];
+                    r.v[3] = p[3];
+                    return r;
+                }
+
+                static F4S splat(float x)
+                {
+                    F4S r;
+                    r.v[0] = r.v[1] = r.v[2] = r.v[3] = x;
+                    return r;
+                }
+
+                void store(float* p) const
+                {
+                    p[0] = v[0];
+                    p[1] = v[1];
+                    p[2] = v[2];
+                    p[3] = v[3];
+                }
+            };
+
+            struct M4S
+            {
+                bool v[4];
+            };
+
+#define TWK_F4S_BINOP(OP)                              \
+    inline F4S operator OP(const F4S& a, const F4S& b) \
+    {                                                  \
+        F4S r;                                         \
+        for (int i = 0; i < 4; i++)                    \
+            r.v[i] = a.v[i] OP b.v[i];                 \
+        return r;                                      \
+    }
+
+#define TWK_F4S_CMPOP(OP)                              \
+    inline M4S operator OP(const F4S& a, const F4S& b) \
+    {                                                  \
+        M4S r;                                         \
+        for (int i = 0; i < 4; i++)                    \
+            r.v[i] = a.v[i] OP b.v[i];                 \
+        return r;                                      \
+    }
+
+            TWK_F4S_BINOP(+)
+            TWK_F4S_BINOP(-)
+            TWK_F4S_BINOP(*)
+            TWK_F4S_BINOP(/)
+            TWK_F4S_CMPOP(<=)
+            TWK_F4S_CMPOP(>)
+
+#undef TWK_F4S_BINOP
+#undef TWK_F4S_CMPOP
+
+            inline F4S select(const M4S& m, const F4S& a, const F4S& b)
+            {
+                F4S r;
+                for (int i = 0; i < 4; i++)
+                    r.v[i] = m.v[i] ? a.v[i] : b.v[i];
+                return r;
+            }
+
+            inline F4S vmin(const F4S& a, const F4S& b)
+            {
+                F4S r;
+                for (int i = 0; i < 4; i++)
+                    r.v[i] = std::min(a.v[i], b.v[i]);
+                return r;
+            }
+
+            inline F4S vmax(const F4S& a, const F4S& b)
+            {
+                F4S r;
+                for (int i = 0; i < 4; i++)
+                    r.v[i] = std::max(a.v[i], b.v[i]);
+                return r;
+            }
+
+            inline F4S vlog2(const F4S& a)
+            {
+                F4S r;
+                for (int i = 0; i < 4; i++)
+                    r.v[i] = std::log2(std::max(a.v[i], FLT_MIN));
+                return r;
+            }
+
+            inline F4S vexp2(const F4S& a)
+            {
+                F4S r;
+                for (int i = 0; i < 4; i++)
+                    r.v[i] = std::exp2(a.v[i]);
+                return r;
+            }
+
+#ifdef TWK_CPU_SHADER_SSE2
+
+            struct F4V
+            {
+                __m128 v;
+
+                F4V() {}
+
+                F4V(__m128 x)
+                    : v(x)
+                {
+                }
+
+                static F4V load(const float* p) { return F4V(_mm_load_ps(p)); }
+
+                static F4V splat(float x) { return F4V(_mm_set1_ps(x)); }
+
+                void store(float* p) const { _mm_store_ps(p, v); }
+            };
+
+            struct M4V
+            {
+                __m128 v;
+            };
+
+            inline F4V operator+(const F4V& a, const F4V& b) { return _mm_add_ps(a.v, b.v); }
+
+            inline F4V operator-(const F4V& a, const F4V& b) { return _mm_sub_ps(a.v, b.v); }
+
+            inline F4V operator*(const F4V& a, const F4V& b) { return _mm_mul_ps(a.v, b.v); }
+
+            inline F4V operator/(const F4V& a, const F4V& b) { return _mm_div_ps(a.v, b.v); }
+
+            inline M4V operator<=(const F4V& a, const F4V& b)
+            {
+                M4V m;
+                m.v = _mm_cmple_ps(a.v, b.v);
+                return m;
+            }
+
+            inline M4V operator>(const F4V& a, const F4V& b)
+            {
+                M4V m;
+                m.v = _mm_cmpgt_ps(a.v, b.v);
+                return m;
+            }
+
+            inline F4V select(const M4V& m, const F4V& a, const F4V& b)
+            {
+                return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v));
+            }
+
+            inline F4V vmin(const F4V& a, const F4V& b) { return _mm_min_ps(a.v, b.v); }
+
+            inline F4V vmax(const F4V& a, const F4V& b) { return _mm_max_ps(a.v, b.v); }
+
+            inline __m128 floor4(__m128 x)
+            {
+                const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+                return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+            }
+
+            //
+            //  log2 from the Cephes logf polynomial: split x into a
+            //  mantissa in [sqrt(1/2), sqrt(2)) and an exponent and
+            //  approximate ln(1 + m - 1). Non-positive inputs are treated
+            //  as FLT_MIN (callers mask them out where it matters).
+            //
+
+            inline F4V vlog2(const F4V& a)
+            {
+                const __m128 one = _mm_set1_ps(1.0f);
+                const __m128i bits = _mm_castps_si128(_mm_max_ps(a.v, _mm_set1_ps(FLT_MIN)));
+                const __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126));
+                const __m128 m = _mm_or_ps(_mm_castsi128_ps(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff))), _mm_set1_ps(0.5f));
+                const __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+
+                const __m128 fe = _mm_sub_ps(_mm_cvtepi32_ps(e), _mm_and_ps(small, one));
+                const __m128 x = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(small, m)), one);
+                const __m128 z = _mm_mul_ps(x, x);
+
+                __m128 y = _mm_set1_ps(7.0376836292e-2f);
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.1514610310e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.1676998740e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.2420140846e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.4249322787e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-1.6668057665e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(2.0000714765e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(-2.4999993993e-1f));
+                y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(3.3333331174e-1f));
+                y = _mm_mul_ps(_mm_mul_ps(y, x), z);
+                y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+
+                const __m128 ln = _mm_add_ps(x, y);
+                return _mm_add_ps(_mm_mul_ps(ln, _mm_set1_ps(1.44269504088896341f)), fe);
+            }
+
+            //
+            //  exp2 as 2^round(x) (built in the exponent bits) times the
+            //  degree 6 Taylor polynomial of 2^f for f in [-1/2, 1/2].
+            //
+
+            inline F4V vexp2(const F4V& a)
+            {
+                const __m128 x = _mm_min_ps(_mm_max_ps(a.v, _mm_set1_ps(-126.0f)), _mm_set1_ps(127.4f));
+                const __m128 fi = floor4(_mm_add_ps(x, _mm_set1_ps(0.5f)));
+                const __m128 f = _mm_sub_ps(x, fi);
+
+                __m128 p = _mm_set1_ps(1.540353039338e-4f);
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.333355814643e-3f));
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.618129107628e-3f));
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.550410866482e-2f));
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.402265069591e-1f));
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.931471805599e-1f));
+                p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+
+                const __m128i e = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(fi), _mm_set1_epi32(127)), 23);
+                return _mm_mul_ps(p, _mm_castsi128_ps(e));
+            }
+
+#endif
+
+            //
+            //  pow() for x > 0, 0 otherwise. GLSL leaves negative bases
+            //  undefined; drivers mostly return NaN which displays black.
+            //
+
+            template <typename F> inline F vpow(const F& x, const F& y)
+            {
+                const F zero = F::splat(0.0f);
+                return select(x > zero, vexp2(y * vlog2(x)), zero);
+            }
+
+            template <typename F> inline F vclamp(const F& x, const F& lo, const F& hi) { return vmin(vmax(x, lo), hi); }
+
+            //
+            //  out = M * (r, g, b, w) using the first three (or all four)
+            //  rows of M.
+            //
+
+            template <typename F> void applyMatrix(const float* m, bool fourD, Strip& s, size_t n)
+            {
+                for (size_t i = 0; i < n; i += 4)
+                {
+                    const F r = F::load(s.r + i);
+                    const F g = F::load(s.g + i);
+                    const F b = F::load(s.b + i);
+                    const F a = F::load(s.a + i);
+                    const F w = fourD ? a : F::splat(1.0f);
+
+                    (F::splat(m[0]) * r + F::splat(m[1]) * g + F::splat(m[2]) * b + F::splat(m[3]) * w).store(s.r + i);
+                    (F::splat(m[4]) * r + F::splat(m[5]) * g + F::splat(m[6]) * b + F::splat(m[7]) * w).store(s.g + i);
+                    (F::splat(m[8]) * r + F::splat(m[9]) * g + F::splat(m[10]) * b + F::splat(m[11]) * w).store(s.b + i);
+
+                    if (fourD)
+                    {
+                        (F::splat(m[12]) * r + F::splat(m[13]) * g + F::splat(m[14]) * b + F::splat(m[15]) * w).store(s.a + i);
+                    }
+                }
+            }
+
+            template <typename F> void applyCDL(const Op& op, Strip& s, size_t n)
+            {
+                const F zero = F::splat(0.0f);
+                const F one = F::splat(1.0f);
+                float* ch[3] = {s.r, s.g, s.b};
+
+                for (int c = 0; c < 3; c++)
+                {
+                    const F slope = F::splat(op.v0[c]);
+                    const F offset = F::splat(op.v1[c]);
+                    const F power = F::splat(op.v2[c]);
+
+                    for (size_t i = 0; i < n; i += 4)
+                    {
+                        F x = F::load(ch[c] + i) * slope + offset;
+                        if (op.clamp)
+                            x = vclamp(x, zero, one);
+                        vpow(x, power).store(ch[c] + i);
+                    }
+                }
+
+                if (op.type == OpCDLSat)
+                {
+                    applyMatrix<F>(op.m, false, s, n);
+
+                    if (op.clamp)
+                    {
+                        for (int c = 0; c < 3; c++)
+                        {
+                            for (size_t i = 0; i < n; i += 4)
+                                vclamp(F::load(ch[c] + i), zero, one).store(ch[c] + i);
+                        }
+                    }
+                }
+            }
+
+            //
+            //  The sRGB and Rec.709 transfer functions have the same form:
+            //
+            //      to linear:    c <= p ? c / b : ((c + a) / (1 + a))^g
+            //      from linear:  c <= p ? c * b : (1 + a) * c^g - a
+            //
+            //  with f0..f3 = a, b, p, g.
+            //
+
+            template <typename F> void applyTransfer(const Op& op, Strip& s, size_t n)
+            {
+                const F zero = F::splat(0.0f);
+                const F a = F::splat(op.f0);
+                const F b = F::splat(op.f1);
+                const F p = F::splat(op.f2);
+                const F g = F::splat(op.f3);
+                const F onePlusA = F::splat(1.0f + op.f0);
+                float* ch[3] = {s.r, s.g, s.b};
+
+                for (int c = 0; c < 3; c++)
+                {
+                    for (size_t i = 0; i < n; i += 4)
+                    {
+                        const F x = vmax(F::load(ch[c] + i), zero);
+
+                        if (op.type == OpToLinear)
+                        {
+                            select(x <= p, x / b, vpow((x + a) / onePlusA, g)).store(ch[c] + i);
+                        }
+                        else
+                        {
+                            select(x <= p, x * b, onePlusA * vpow(x, g) - a).store(ch[c] + i);
+                        }
+                    }
+                }
+            }
+
+            template <typename F> void applyOp(const Op& op, Strip& s, size_t n)
+            {
+                const F zero = F::splat(0.0f);
+                const F one = F::splat(1.0f);
+                float* rgb[3] = {s.r, s.g, s.b};
+                float* rgba[4] = {s.r, s.g, s.b, s.a};
+
+                switch (op.type)
+                {
+                case OpMatrix:
+                case OpMatrix4D:
+                    applyMatrix<F>(op.m, op.type == OpMatrix4D, s, n);
+                    break;
+
+                case OpCDL:
+                case OpCDLSat:
+                    applyCDL<F>(op, s, n);
+                    break;
+
+                case OpGamma:
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const F g = F::splat(op.v0[c]);
+                        for (size_t i = 0; i < n; i += 4)
+                            vpow(vmax(F::load(rgb[c] + i), zero), g).store(rgb[c] + i);
+                    }
+                    break;
+
+                case OpCineonLogLinear:
+                {
+                    //
+                    //  10^(c * 1023 * 0.002 / 0.6) == 2^(c * k)
+                    //
+
+                    const F k = F::splat(float(1023.0 * 0.002 / 0.6 * 3.32192809488736234787));
+                    const F black = F::splat(op.f0);
+                    const F diff = F::splat(op.f1);
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        for (size_t i = 0; i < n; i += 4)
+                        {
+                            const F x = vmin(F::load(rgb[c] + i), one);
+                            (vmax(vexp2(x * k) - black, zero) / diff).store(rgb[c] + i);
+                        }
+                    }
+                    break;
+                }
+
+                case OpLinearCineonLog:
+                {
+                    const F gain = F::splat(op.f0);
+                    const F white = F::splat(op.f1 / 1023.0f);
+                    const F k = F::splat(float(0.69314718055994530942 / 7.85181516711));
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        for (size_t i = 0; i < n; i += 4)
+                        {
+                            const F x = (F::load(rgb[c] + i) - one) * gain + one;
+                            (white + vlog2(x) * k).store(rgb[c] + i);
+                        }
+                    }
+                    break;
+                }
+
+                case OpToLinear:
+                case OpFromLinear:
+                    applyTransfer<F>(op, s, n);
+                    break;
+
+                case OpPremult:
+                    for (size_t i = 0; i < n; i += 4)
+                    {
+                        const F a = F::load(s.a + i);
+                        for (int c = 0; c < 3; c++)
+                            (F::load(rgb[c] + i) * a).store(rgb[c] + i);
+                    }
+                    break;
+
+                case OpUnpremult:
+                    for (size_t i = 0; i < n; i += 4)
+                    {
+                        const F a = F::load(s.a + i);
+                        const auto nonZero = a > zero;
+                        const F inv = one / select(nonZero, a, one);
+                        for (int c = 0; c < 3; c++)
+                            (F::load(rgb[c] + i) * inv).store(rgb[c] + i);
+                    }
+                    break;
+
+                case OpClamp:
+                {
+                    const F lo = F::splat(op.f0);
+                    const F hi = F::splat(op.f1);
+                    for (int c = 0; c < 4; c++)
+                    {
+                        for (size_t i = 0; i < n; i += 4)
+                            vclamp(F::load(rgba[c] + i), lo, hi).store(rgba[c] + i);
+                    }
+                    break;
+                }
+
+                case OpOpacity:
+                {
+                    const F o = F::splat(op.f0);
+                    for (int c = 0; c < 4; c++)
+                    {
+                        for (size_t i = 0; i < n; i += 4)
+                            (F::load(rgba[c] + i) * o).store(rgba[c] + i);
+                    }
+                    break;
+                }
+
+                default:
+                    break;
+                }
+            }
+
+            //
+            //  The LUT lookups are gathers which SSE2 can't do, so these
+            //  are scalar. They reproduce the GL sampling: trilinear
+            //  between lattice points for the 3D LUTs and linear filtering
+            //  at texel centers (clamped to the edge) for ColorChannelLUT.
+            //  For 3D LUTs the lattice position is P * v0 + v3.
+            //
+
+            void apply3DLUT(const Op& op, Strip& s, size_t n)
+            {
+                const LUTTable& lut = *op.lut;
+                const int size[3] = {lut.w, lut.h, lut.d};
+                const size_t stride[3] = {3, size_t(lut.w) * 3, size_t(lut.w) * lut.h * 3};
+                const float* data = &lut.rgb.front();
+
+                for (size_t i = 0; i < n; i++)
+                {
+                    const float P[3] = {s.r[i], s.g[i], s.b[i]};
+                    size_t i0[3];
+                    size_t i1[3];
+                    float u[3];
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const float x = std::min(std::max(P[c] * op.v0[c] + op.v3[c], 0.0f), float(size[c] - 1));
+                        const float f = std::floor(x);
+                        const int p0 = std::min(int(f), size[c] - 1);
+                        i0[c] = size_t(p0) * stride[c];
+                        i1[c] = size_t(std::min(p0 + 1, size[c] - 1)) * stride[c];
+                        u[c] = x - f;
+                    }
+
+                    float out[3];
+
+                    for (int c = 0; c < 3; c++)
+                    {
+                        const float* d = data + c;
+                        const float c00 = d[i0[0] + i0[1] + i0[2]] + (d[i1[0] + i0[1] + i0[2]] - d[i0[0] + i0[1] + i0[2]]) * u[0];
+                        const float c10 = d[i0[0] + i1[1] + i0[2]] + (d[i1[0] + i1[1] + i0[2]] - d[i0[0] + i1[1] + i0[2]]) * u[0];
+                        const float c01 = d[i0[0] + i0[1] + i1[2]] + (d[i1[0] + i0[1] + i1[2]] - d[i0[0] + i0[1] + i1[2]]) * u[0];
+                        const float c11 = d[i0[0] + i1[1] + i1[2]] + (d[i1[0] + i1[1] + i1[2]] - d[i0[0] + i1[1] + i1[2]]) * u[0];
+                        const float c0 = c00 + (c10 - c00) * u[1];
+                        const float c1 = c01 + (c11 - c01) * u[1];
+                        out[c] = (c0 + (c1 - c0) * u[2]) * op.v1[c] + op.v2[c];
+                    }
+
+                    s.r[i] = out[0];
+                    s.g[i] = out[1];
+                    s.b[i] = out[2];
+                }
+            }
+
+            void applyChannelLUT(const Op& op, Strip& s, size_t n)
+            {
+                const LUTTable& lut = *op.lut;
+                const int last = lut.w - 1;
+                const float* data = &lut.rgb.front();
+                float* ch[3] = {s.r, s.g, s.b};
+
+                for (int c = 0; c < 3; c++)
+                {
+                    float* p = ch[c];
+
+                    for (size_t i = 0; i < n; i++)
+                    {
+                        const float x = std::min(std::max(p[i] * op.v0[c], 0.0f), float(last));
+                        const int x0 = int(x);
+                        const int x1 = std::min(x0 + 1, last);
+                        const float f = x - x0;
+                        const float v0 = data[x0 * 3 + c];
+                        const float v1 = data[x1 * 3 + c];
+                        p[i] = (v0 + (v1 - v0) * f) * op.v1[c] + op.v2[c];
+                    }
+                }
+            }
+
+            void applyPipeline(const Pipeline& pipeline, Strip& s, size_t n, bool simd)
+            {
+                for (size_t q = 0; q < pipeline.ops.size(); q++)
+                {
+                    const Op& op = pipeline.ops[q];
+
+                    if (op.type == Op3DLUT)
+                    {
+                        apply3DLUT(op, s, n);
+                    }
+                    else if (op.type == OpChannelLUT)
+                    {
+                        applyChannelLUT(op, s, n);
+                    }
+#ifdef TWK_CPU_SHADER_SSE2
+                    else if (simd)
+                    {
+                        applyOp<F4V>(op, s, n);
+                    }
+#endif
+                    else
+                    {
+                        applyOp<F4S>(op, s, n);
+                    }
+                }
+            }
+
+            //
+            //  Reading and writing pixels
+            //
+
+            inline float channelToFloat(unsigned char v) { return v * (1.0f / 255.0f); }
+
+            inline float channelToFloat(unsigned short v) { return v * (1.0f / 65535.0f); }
+
+            inline float channelToFloat(half v) { return float(v); }
+
+            inline float channelToFloat(float v) { return v; }
+
+            float channelToFloat(const FrameBuffer* fb, const unsigned char* p)
+            {
+                switch (fb->dataType())
+                {
+                case FrameBuffer::UCHAR:
+                    return channelToFloat(*p);
+                case FrameBuffer::USHORT:
+                    return channelToFloat(*(const unsigned short*)p);
+                case FrameBuffer::HALF:
+                    return channelToFloat(*(const half*)p);
+                case FrameBuffer::FLOAT:
+                    return channelToFloat(*(const float*)p);
+                default:
+                    return 0.0f;
+                }
+            }
+
+            //
+            //  channels[] holds the fb channel index of R, G, B and A; A is
+            //  -1 if the image has no alpha.
+            //
+
+            template <typename T> void readStrip(const FrameBuffer* fb, const int* channels, int y, int x0, size_t n, Strip& s)
+            {
+                const int nc = fb->numChannels();
+                const T* p = fb->scanline<T>(y) + size_t(x0) * nc;
+
+                for (size_t i = 0; i < n; i++, p += nc)
+                {
+                    s.r[i] = channelToFloat(p[channels[0]]);
+                    s.g[i] = channelToFloat(p[channels[1]]);
+                    s.b[i] = channelToFloat(p[channels[2]]);
+                    s.a[i] = channels[3] < 0 ? 1.0f : channelToFloat(p[channels[3]]);
+                }
+            }
+
+            void writeStrip(const Strip& s, size_t n, float* out)
+            {
+                for (size_t i = 0; i < n; i++, out += 4)
+                {
+                    out[0] = s.r[i];
+                    out[1] = s.g[i];
+                    out[2] = s.b[i];
+                    out[3] = s.a[i];
+                }
+            }
+
+            void processRows(const Pipeline& pipeline, const FrameBuffer* in, const int* channels, FrameBuffer* out, int y0, int y1,
+                             bool simd)
+            {
+                const int width = in->width();
+                Strip s;
+
+                for (int y = y0; y < y1; y++)
+                {
+                    float* dst = out->scanline<float>(y);
+
+                    for (int x = 0; x < width; x += int(StripSize))
+                    {
+                        const size_t n = std::min(StripSize, size_t(width - x));
+                        const size_t n4 = (n + 3) & ~size_t(3);
+
+                        switch (in->dataType())
+                        {
+                        case FrameBuffer::UCHAR:
+                            readStrip<unsigned char>(in, channels, y, x, n, s);
+                            break;
+                        case FrameBuffer::USHORT:
+                            readStrip<unsigned short>(in, channels, y, x, n, s);
+                            break;
+                        case FrameBuffer::HALF:
+                            readStrip<half>(in, channels, y, x, n, s);
+                            break;
+                        default:
+                            readStrip<float>(in, channels, y, x, n, s);
+                            break;
+                        }
+
+                        for (size_t i = n; i < n4; i++)
+                        {
+                            s.r[i] = s.g[i] = s.b[i] = 0.0f;
+                            s.a[i] = 1.0f;
+                        }
+
+                        applyPipeline(pipeline, s, n4, simd);
+                        writeStrip(s, n, dst + size_t(x) * 4);
+                    }
+                }
+            }
+
+            //
+            //  Expression inspection
+            //
+
+            template <typename T> bool argValue(const Expression* expr, size_t i, T& value)
+            {
+                const ArgumentVector& args = expr->arguments();
+
+                if (i >= args.size())
+                    return false;
+
+                if (const TypedBoundSymbol<T>* s = dynamic_cast<const TypedBoundSymbol<T>*>(args[i]))
+                {
+                    value = s->value();
+                    return true;
+                }
+
+                return false;
+            }
+
+            void copyVec3(const Vec3f& v, float* p)
+            {
+                p[0] = v.x;
+                p[1] = v.y;
+                p[2] = v.z;
+            }
+
+            void copyMatrix(const Mat44f& M, float* p)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    for (int j = 0; j < 4; j++)
+                        p[i * 4 + j] = M(i, j);
+                }
+            }
+
+            bool fillLUT(const FrameBuffer* fb, bool is3D, LUTTable& lut)
+            {
+                if (!fb || fb->isPlanar() || fb->numChannels() < 3)
+                    return false;
+
+                switch (fb->dataType())
+                {
+                case FrameBuffer::UCHAR:
+                case FrameBuffer::USHORT:
+                case FrameBuffer::HALF:
+                case FrameBuffer::FLOAT:
+                    break;
+                default:
+                    return false;
+                }
+
+                lut.w = fb->width();
+                lut.h = is3D ? fb->height() : 1;
+                lut.d = is3D ? std::max(fb->depth(), 1) : 1;
+
+                if (lut.w < 1 || lut.h < 1 || (is3D && fb->depth() < 1))
+                    return false;
+
+                const size_t channelSize = fb->pixelSize() / fb->numChannels();
+                const unsigned char* base = fb->pixels<unsigned char>();
+                lut.rgb.resize(size_t(lut.w) * lut.h * lut.d * 3);
+                float* out = &lut.rgb.front();
+
+                for (int z = 0; z < lut.d; z++)
+                {
+                    for (int y = 0; y < lut.h; y++)
+                    {
+                        const unsigned char* p = base + z * fb->planeSize() + y * fb->scanlinePaddedSize();
+
+                        for (int x = 0; x < lut.w; x++, p += fb->pixelSize())
+                        {
+                            for (int c = 0; c < 3; c++)
+                                *out++ = channelToFloat(fb, p + c * channelSize);
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            const FrameBuffer* lutArgument(const Expression* expr)
+            {
+                ImageOrFB s;
+                return argValue(expr, 1, s) && !s.image ? s.fb : 0;
+            }
+
+            //
+            //  Converts expr into an Op. Returns false if it has no CPU
+            //  implementation or unexpected arguments.
+            //
+
+            bool buildOp(const Expression* expr, Pipeline& pipeline, Op& op)
+            {
+                const string& name = expr->function()->name();
+                Mat44f M;
+                Vec3f v0, v1, v2, v3;
+
+                memset(&op, 0, sizeof(Op));
+
+                if (name == "ColorMatrix" || name == "ColorMatrix4D")
+                {
+                    if (!argValue(expr, 1, M))
+                        return false;
+                    op.type = name == "ColorMatrix" ? OpMatrix : OpMatrix4D;
+                    copyMatrix(M, op.m);
+                }
+                else if (name == "ColorCDL" || name == "ColorCDL_SAT" || name == "ColorCDL_SAT_noClamp")
+                {
+                    if (!argValue(expr, 1, v0) || !argValue(expr, 2, v1) || !argValue(expr, 3, v2))
+                        return false;
+
+                    op.type = OpCDL;
+                    op.clamp = name != "ColorCDL_SAT_noClamp";
+                    copyVec3(v0, op.v0);
+                    copyVec3(v1, op.v1);
+                    copyVec3(v2, op.v2);
+
+                    if (name != "ColorCDL")
+                    {
+                        if (!argValue(expr, 4, M))
+                            return false;
+                        op.type = OpCDLSat;
+                        copyMatrix(M, op.m);
+                    }
+                }
+                else if (name == "ColorGamma")
+                {
+                    if (!argValue(expr, 1, v0))
+                        return false;
+                    op.type = OpGamma;
+                    copyVec3(v0, op.v0);
+                }
+                else if (name == "ColorCineonLogLinear")
+                {
+                    if (!argValue(expr, 1, op.f0) || !argValue(expr, 2, op.f1))
+                        return false;
+                    op.type = OpCineonLogLinear;
+                }
+                else if (name == "ColorLinearCineonLog")
+                {
+                    float refBlack, refWhite;
+                    if (!argValue(expr, 1, refBlack) || !argValue(expr, 2, refWhite))
+                        return false;
+                    op.type = OpLinearCineonLog;
+                    op.f0 = 1.0f - std::pow(10.0f, (refBlack - refWhite) * 0.003333333333f);
+                    op.f1 = refWhite;
+                }
+                else if (name == "ColorSRGBLinear")
+                {
+                    op.type = OpToLinear;
+                    op.f0 = 0.055f;
+                    op.f1 = 12.92f;
+                    op.f2 = 0.04045f;
+                    op.f3 = 2.4f;
+                }
+                else if (name == "ColorLinearSRGB")
+                {
+                    op.type = OpFromLinear;
+                    op.f0 = 0.055f;
+                    op.f1 = 12.92f;
+                    op.f2 = 0.0031308f;
+                    op.f3 = 1.0f / 2.4f;
+                }
+                else if (name == "ColorRec709Linear")
+                {
+                    op.type = OpToLinear;
+                    op.f0 = 0.099f;
+                    op.f1 = 4.5f;
+                    op.f2 = 0.081f;
+                    op.f3 = 1.0f / 0.45f;
+                }
+                else if (name == "ColorLinearRec709")
+                {
+                    op.type = OpFromLinear;
+                    op.f0 = 0.099f;
+                    op.f1 = 4.5f;
+                    op.f2 = 0.018f;
+                    op.f3 = 0.45f;
+                }
+                else if (name == "ColorPremult")
+                {
+                    op.type = OpPremult;
+                }
+                else if (name == "ColorUnpremult")
+                {
+                    op.type = OpUnpremult;
+                }
+                else if (name == "ColorClamp")
+                {
+                    if (!argValue(expr, 1, op.f0) || !argValue(expr, 2, op.f1))
+                        return false;
+                    op.type = OpClamp;
+                }
+                else if (name == "Opacity")
+                {
+                    if (!argValue(expr, 1, op.f0))
+                        return false;
+                    op.type = OpOpacity;
+                }
+                else if (name == "Color3DLUT")
+                {
+                    if (!argValue(expr, 2, v0) || !argValue(expr, 5, v1) || !argValue(expr, 6, v2))
+                        return false;
+
+                    LUTTable lut;
+                    if (!fillLUT(lutArgument(expr), true, lut))
+                        return false;
+
+                    op.type = Op3DLUT;
+                    copyVec3(v0, op.v0);
+                    copyVec3(v1, op.v1);
+                    copyVec3(v2, op.v2);
+                    pipeline.luts.push_back(lut);
+                    op.lut = &pipeline.luts.back();
+                }
+                else if (name == "Color3DLUTGLSampling")
+                {
+                    if (!argValue(expr, 2, v0) || !argValue(expr, 3, v3) || !argValue(expr, 4, v1) || !argValue(expr, 5, v2))
+                        return false;
+
+                    LUTTable lut;
+                    if (!fillLUT(lutArgument(expr), true, lut))
+                        return false;
+
+                    //
+                    //  The texture coordinate P * inScale + inOffset in
+                    //  texels is that times the size minus a half
+                    //
+
+                    const Vec3f size(lut.w, lut.h, lut.d);
+                    op.type = Op3DLUT;
+                    copyVec3(v0 * size, op.v0);
+                    copyVec3(v3 * size - Vec3f(0.5f), op.v3);
+                    copyVec3(v1, op.v1);
+                    copyVec3(v2, op.v2);
+                    pipeline.luts.push_back(lut);
+                    op.lut = &pipeline.luts.back();
+                }
+                else if (name == "ColorChannelLUT")
+                {
+                    if (!argValue(expr, 2, v0) || !argValue(expr, 3, v1) || !argValue(expr, 4, v2))
+                        return false;
+
+                    LUTTable lut;
+                    if (!fillLUT(lutArgument(expr), false, lut))
+                        return false;
+
+                    op.type = OpChannelLUT;
+                    copyVec3(v0, op.v0);
+                    copyVec3(v1, op.v1);
+                    copyVec3(v2, op.v2);
+                    pipeline.luts.push_back(lut);
+                    op.lut = &pipeline.luts.back();
+                }
+                else
+                {
+                    return false;
+                }
+
+                return true;
+            }
+
+            //
+            //  Finds the fb channels holding R, G, B and (optionally) A.
+            //  Only plain packed images are handled; anything the renderer
+            //  would have to convert (YUV, packed 10 bit, planes, data
+            //  windows) is left alone.
+            //
+
+            bool sourceChannels(const FrameBuffer* fb, int* channels)
+            {
+                if (fb->isPlanar() || fb->uncrop() || fb->depth() > 1)
+                    return false;
+
+                switch (fb->dataType())
+                {
+                case FrameBuffer::UCHAR:
+                case FrameBuffer::USHORT:
+                case FrameBuffer::HALF:
+                case FrameBuffer::FLOAT:
+                    break;
+                default:
+                    return false;
+                }
+
+                const int nc = fb->numChannels();
+
+                if (nc != 3 && nc != 4)
+                    return false;
+
+                channels[0] = channels[1] = channels[2] = channels[3] = -1;
+
+                for (int c = 0; c < nc; c++)
+                {
+                    const string& n = fb->channelName(c);
+                    const int i = n == "R" ? 0 : n == "G" ? 1 : n == "B" ? 2 : n == "A" ? 3 : -1;
+
+                    if (i < 0 || channels[i] >= 0)
+                        return false;
+                    channels[i] = c;
+                }
+
+                return channels[0] >= 0 && channels[1] >= 0 && channels[2] >= 0;
+            }
+
+            void releaseFrameBuffer(const FrameBuffer* fb, vector<FrameBuffer*>& cachedFBs, bool owned)
+            {
+                if (fb->inCache())
+                {
+                    if (owned)
+                        cachedFBs.push_back(const_cast<FrameBuffer*>(fb));
+                }
+                else if (owned ? (!fb->hasStaticRef() || fb->staticUnRef()) : !fb->hasStaticRef())
+                {
+                    delete fb;
+                }
+            }
+
+            //
+            //  LUT fbs are owned by the expression until
+            //  assembleAuxFrameBuffers() hands them to the IPImage, which
+            //  hasn't happened yet. Ref counted ones belong to somebody
+            //  else.
+            //
+
+            void releaseAuxFrameBuffers(const Expression* expr, vector<FrameBuffer*>& cachedFBs)
+            {
+                if (const FrameBuffer* fb = lutArgument(expr))
+                    releaseFrameBuffer(fb, cachedFBs, false);
+            }
+
+            //
+            //  Collects the chain of single input functions from root down
+            //  and returns it bottom first. The walk stops at a Source or
+            //  at a function which doesn't have exactly one expression
+            //  argument (its first).
+            //
+
+            void collectChain(Expression* root, vector<Expression*>& chain)
+            {
+                for (Expression* e = root; e;)
+                {
+                    chain.push_back(e);
+
+                    if (e->function()->type() == Function::Source)
+                        break;
+
+                    const ArgumentVector& args = e->arguments();
+
+                    if (args.empty() || !args[0] || !args[0]->isExpression())
+                        break;
+
+                    bool single = true;
+
+                    for (size_t i = 1; i < args.size(); i++)
+                    {
+                        if (args[i] && args[i]->isExpression())
+                            single = false;
+                    }
+
+                    if (!single)
+                        break;
+
+                    e = static_cast<BoundExpression*>(args[0])->value();
+                }
+
+                std::reverse(chain.begin(), chain.end());
+            }
+
+            bool isSourceRGBA(const Expression* expr)
+            {
+                const string& name = expr->function()->name();
+                return name == "SourceRGBA" || name == "SourceBGRA";
+            }
+
+            //
+            //  Replaces chain[bottom..top] (bottom first) with expr, which
+            //  must already take the input of chain[bottom] as its input.
+            //  LUTs used only by the removed functions are released.
+            //
+
+            void replaceRun(IPImage* image, vector<Expression*>& chain, size_t bottom, size_t top, Expression* expr,
+                            vector<FrameBuffer*>& cachedFBs)
+            {
+                for (size_t i = bottom; i <= top; i++)
+                    releaseAuxFrameBuffers(chain[i], cachedFBs);
+
+                if (top + 1 == chain.size())
+                {
+                    image->shaderExpr = expr;
+                }
+                else
+                {
+                    static_cast<BoundExpression*>(chain[top + 1]->arguments()[0])->setValue(expr);
+                }
+
+                delete chain[top];
+            }
+
+            bool resolveImage(IPImage* image, vector<FrameBuffer*>& cachedFBs, bool simd)
+            {
+                if (!image->fb || !image->shaderExpr)
+                    return false;
+
+                vector<Expression*> chain;
+                collectChain(image->shaderExpr, chain);
+
+                ImageOrFB source;
+
+                if (chain.size() < 2 || !isSourceRGBA(chain[0]) || !argValue(chain[0], 0, source) || source.image != image
+                    || source.fb != image->fb)
+                {
+                    return false;
+                }
+
+                int channels[4];
+                FrameBuffer* in = image->fb;
+
+                if (!sourceChannels(in, channels))
+                    return false;
+
+                //
+                //  Take the longest run of supported functions above the
+                //  source.
+                //
+
+                Pipeline pipeline;
+                size_t top = 0;
+
+                for (size_t i = 1; i < chain.size(); i++)
+                {
+                    Op op;
+
+                    if (!buildOp(chain[i], pipeline, op))
+                        break;
+
+                    pipeline.ops.push_back(op);
+                    top = i;
+                }
+
+                if (!top)
+                    return false;
+
+                TWK_TRACE_SCOPE("render", "cpu shader");
+
+                ostringstream hashStream;
+                chain[top]->outputHash(hashStream);
+                const string hashString = hashStream.str();
+
+                FrameBuffer* out = new FrameBuffer(in->width(), in->height(), 4, FrameBuffer::FLOAT, NULL, NULL, in->orientation());
+                in->copyAttributesTo(out);
+                out->setPixelAspectRatio(in->pixelAspectRatio());
+                out->idstream() << in->identifier() << "|cpu:" << hex << TwkUtil::FNV1a64(hashString.data(), hashString.size());
+
+                const int height = in->height();
+                TwkUtil::TaskPool::Group group(height > BandHeight ? TwkUtil::TaskPool::globalPool() : 0);
+
+                for (int y = 0; y < height; y += BandHeight)
+                {
+                    const int y1 = std::min(y + BandHeight, height);
+                    group.run([&, y, y1] { processRows(pipeline, in, channels, out, y, y1, simd); });
+                }
+
+                group.wait();
+
+                //
+                //  Swap in the result: the top of the run is replaced by a
+                //  plain source of the new fb
+                //
+
+                image->fb = out;
+                replaceRun(image, chain, 1, top, newSourceRGBA(image), cachedFBs);
+                releaseFrameBuffer(in, cachedFBs, true);
+
+                return true;
+            }
+
+            size_t resolveRecursive(IPImage* image, vector<FrameBuffer*>& cachedFBs, bool simd)
+            {
+                size_t count = 0;
+
+                for (IPImage* child = image->children; child; child = child->next)
+                {
+                    count += resolveRecursive(child, cachedFBs, simd);
+                }
+
+                if (resolveImage(image, cachedFBs, simd))
+                    count++;
+
+                return count;
+            }
+
+            //
+            //  Colour chain baking
+            //
+            //  Runs whose input isn't known to be in [0, 1] are baked
+            //  through a log shaper covering [0, ShaperMax]:
+            //
+            //      s(x) = log2(1 + x / ShaperMax * ShaperK) / log2(1 + ShaperK)
+            //
+            //  The shaper clamps to [0, ShaperMax], so a run is only baked
+            //  this way when its input is known to stay in that range (see
+            //  inShaperRange()). Within it the bake approximates the
+            //  original chain to about 0.3% on average.
+            //
+
+            const float ShaperMax = 16.0f;
+            const float ShaperK = 255.0f;
+            const int ShaperSize = 4096;
+            const size_t MaxBakedLUTs = 32;
+
+            enum BakeKind
+            {
+                NotBakeable,
+                Affine,
+                NonLinear
+            };
+
+            struct BakedLUT
+            {
+                FrameBuffer* lut;    // the cache holds a static ref
+                FrameBuffer* shaper; // NULL for runs baked over [0, 1]
+                size_t lastUse;
+            };
+
+            typedef map<string, BakedLUT> BakedLUTMap;
+
+            std::mutex bakeMutex;
+            BakedLUTMap bakedLUTs;
+            size_t bakeClock = 0;
+
+            //
+            //  Affine functions come back as a matrix on (r, g, b, 1).
+            //  Functions which read or write alpha are not bakeable.
+            //
+
+            BakeKind bakeKind(const Expression* expr, Mat44f& M)
+            {
+                const string& name = expr->function()->name();
+                Vec3f slope, offset, power;
+                Mat44f S;
+
+                if (name == "ColorMatrix")
+                {
+                    return argValue(expr, 1, M) ? Affine : NotBakeable;
+                }
+                else if (name == "ColorCDL_SAT_noClamp")
+                {
+                    if (!argValue(expr, 1, slope) || !argValue(expr, 2, offset) || !argValue(expr, 3, power) || !argValue(expr, 4, S))
+                    {
+                        return NotBakeable;
+                    }
+
+                    if (power != Vec3f(1.0f))
+                        return NonLinear;
+
+                    M = S
+                        * Mat44f(slope.x, 0, 0, offset.x, 0, slope.y, 0, offset.y, 0, 0, slope.z, offset.z, 0, 0, 0, 1);
+                    return Affine;
+                }
+                else if (name == "ColorGamma")
+                {
+                    if (!argValue(expr, 1, power))
+                        return NotBakeable;
+
+                    M = Mat44f();
+                    return power == Vec3f(1.0f) ? Affine : NonLinear;
+                }
+                else if (name == "ColorCDL" || name == "ColorCDL_SAT" || name == "ColorCineonLogLinear" || name == "ColorLinearCineonLog"
+                         || name == "ColorSRGBLinear" || name == "ColorLinearSRGB" || name == "ColorRec709Linear"
+                         || name == "ColorLinearRec709" || name == "Color3DLUT" || name == "Color3DLUTGLSampling"
+                         || name == "ColorChannelLUT")
+                {
+                    return NonLinear;
+                }
+
+                return NotBakeable;
+            }
+
+            size_t valueSize(Symbol::Type type)
+            {
+                switch (type)
+                {
+                case Symbol::FloatType:
+                case Symbol::IntType:
+                case Symbol::BoolType:
+                    return 4;
+                case Symbol::Vec2fType:
+                case Symbol::Vec2iType:
+                    return 8;
+                case Symbol::Vec3fType:
+                case Symbol::Vec3iType:
+                    return 12;
+                case Symbol::Vec4fType:
+                case Symbol::Vec4iType:
+                case Symbol::Matrix2fType:
+                    return 16;
+                case Symbol::Matrix3fType:
+                    return 36;
+                case Symbol::Matrix4fType:
+                    return 64;
+                default:
+                    return 0;
+                }
+            }
+
+            //
+            //  The cache key is the exact parameter state of the run (LUTs
+            //  by identifier), so editing any of the contributing node
+            //  properties selects a different bake while the other sources
+            //  keep theirs.
+            //
+
+            void appendBakeKey(const Expression* expr, string& key)
+            {
+                const ArgumentVector& args = expr->arguments();
+
+                key += expr->function()->name();
+                key += '(';
+
+                for (size_t i = 1; i < args.size(); i++)
+                {
+                    BoundSymbol* s = args[i];
+
+                    if (!s)
+                        continue;
+
+                    const size_t n = valueSize(s->symbol()->type());
+
+                    if (const BoundSampler* sampler = dynamic_cast<const BoundSampler*>(s))
+                    {
+                        if (sampler->value().fb)
+                            key += sampler->value().fb->identifier();
+                    }
+                    else if (n)
+                    {
+                        key.append((const char*)s->valuePointer(), n);
+                    }
+                    else
+                    {
+                        ostringstream str;
+                        s->outputHash(str);
+                        key += str.str();
+                    }
+
+                    key += ',';
+                }
+
+                key += ')';
+            }
+
+            //
+            //  True if the values coming out of expr are in [0, 1]: integer
+            //  sources and clamps.
+            //
+
+            bool unitRange(const Expression* expr)
+            {
+                const string& name = expr->function()->name();
+
+                if (isSourceRGBA(expr))
+                {
+                    ImageOrFB source;
+
+                    if (!argValue(expr, 0, source) || !source.fb)
+                        return false;
+
+                    switch (source.fb->dataType())
+                    {
+                    case FrameBuffer::UCHAR:
+                    case FrameBuffer::USHORT:
+                    case FrameBuffer::PACKED_R10_G10_B10_X2:
+                    case FrameBuffer::PACKED_X2_B10_G10_R10:
+                        return true;
+                    default:
+                        return false;
+                    }
+                }
+                else if (name == "ColorClamp")
+                {
+                    float lo, hi;
+                    return argValue(expr, 1, lo) && argValue(expr, 2, hi) && lo >= 0.0f && hi <= 1.0f;
+                }
+
+                return false;
+            }
+
+            //
+            //  True if the values coming out of expr are in [0, ShaperMax]:
+            //  clamps, and float sources whose pixels are all in range.
+            //  The source check reads the whole image, which is still far
+            //  cheaper than the run it lets us replace.
+            //
+
+            template <typename T> bool rowsInShaperRange(const FrameBuffer* fb, const int* channels, int y0, int y1)
+            {
+                const int width = fb->width();
+                Strip s;
+
+                for (int y = y0; y < y1; y++)
+                {
+                    for (int x = 0; x < width; x += int(StripSize))
+                    {
+                        const size_t n = std::min(StripSize, size_t(width - x));
+                        readStrip<T>(fb, channels, y, x, n, s);
+
+                        for (size_t i = 0; i < n; i++)
+                        {
+                            //
+                            //  Written so NaNs are out of range too
+                            //
+
+                            if (!(s.r[i] >= 0.0f && s.r[i] <= ShaperMax && s.g[i] >= 0.0f && s.g[i] <= ShaperMax && s.b[i] >= 0.0f
+                                  && s.b[i] <= ShaperMax))
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                }
+
+                return true;
+            }
+
+            bool inShaperRange(const Expression* expr)
+            {
+                if (isSourceRGBA(expr))
+                {
+                    ImageOrFB source;
+                    int channels[4];
+
+                    if (!argValue(expr, 0, source) || !source.fb || !sourceChannels(source.fb, channels))
+                        return false;
+
+                    const FrameBuffer* fb = source.fb;
+                    const bool isHalf = fb->dataType() == FrameBuffer::HALF;
+
+                    if (!isHalf && fb->dataType() != FrameBuffer::FLOAT)
+                        return false;
+
+                    std::atomic<bool> ok(true);
+                    TwkUtil::TaskPool::Group group(TwkUtil::TaskPool::globalPool());
+
+                    for (int y0 = 0; y0 < fb->height(); y0 += BandHeight)
+                    {
+                        const int y1 = std::min(fb->height(), y0 + BandHeight);
+
+                        group.run(
+                            [&, y0, y1]
+                            {
+                                if (ok && !(isHalf ? rowsInShaperRange<half>(fb, channels, y0, y1)
+                                                   : rowsInShaperRange<float>(fb, channels, y0, y1)))
+                                {
+                                    ok = false;
+                                }
+                            });
+                    }
+
+                    group.wait();
+                    return ok;
+                }
+                else if (expr->function()->name() == "ColorClamp")
+                {
+                    float lo, hi;
+                    return argValue(expr, 1, lo) && argValue(expr, 2, hi) && lo >= 0.0f && hi <= ShaperMax;
+                }
+
+                return false;
+            }
+
+            float shaperInverse(float s)
+            {
+                return ShaperMax * (std::exp2(s * std::log2(1.0f + ShaperK)) - 1.0f) / ShaperK;
+            }
+
+            //
+            //  Evaluates the run at every lattice point. Each row of the
+            //  LUT is one strip (the LUT size is capped at StripSize).
+            //
+
+            void bakeLUT(const Pipeline& pipeline, bool shaped, FrameBuffer* lut, bool simd)
+            {
+                const int n = lut->width();
+                vector<float> lattice(n);
+
+                for (int i = 0; i < n; i++)
+                {
+                    const float u = float(i) / float(n - 1);
+                    lattice[i] = shaped ? shaperInverse(u) : u;
+                }
+
+                TwkUtil::TaskPool::Group group(TwkUtil::TaskPool::globalPool());
+
+                for (int z = 0; z < n; z++)
+                {
+                    group.run(
+                        [&, z]
+                        {
+                            Strip s;
+                            const size_t n4 = (size_t(n) + 3) & ~size_t(3);
+
+                            for (int y = 0; y < n; y++)
+                            {
+                                for (size_t x = 0; x < n4; x++)
+                                {
+                                    s.r[x] = lattice[std::min(x, size_t(n - 1))];
+                                    s.g[x] = lattice[y];
+                                    s.b[x] = lattice[z];
+                                    s.a[x] = 1.0f;
+                                }
+
+                                applyPipeline(pipeline, s, n4, simd);
+
+                                float* out = (float*)(lut->pixels<unsigned char>() + z * lut->planeSize()
+                                                      + y * lut->scanlinePaddedSize());
+
+                                for (int x = 0; x < n; x++, out += 3)
+                                {
+                                    out[0] = s.r[x];
+                                    out[1] = s.g[x];
+                                    out[2] = s.b[x];
+                                }
+                            }
+                        });
+                }
+
+                group.wait();
+            }
+
+            FrameBuffer* newShaperLUT()
+            {
+                FrameBuffer* fb = new FrameBuffer(ShaperSize, 1, 3, FrameBuffer::FLOAT);
+                float* p = fb->pixels<float>();
+                const float scale = 1.0f / std::log2(1.0f + ShaperK);
+
+                for (int i = 0; i < ShaperSize; i++, p += 3)
+                {
+                    p[0] = p[1] = p[2] = std::log2(1.0f + float(i) / float(ShaperSize - 1) * ShaperK) * scale;
+                }
+
+                return fb;
+            }
+
+            void unrefBakedLUT(BakedLUT& b)
+            {
+                if (b.lut->staticUnRef())
+                    delete b.lut;
+
+                if (b.shaper && b.shaper->staticUnRef())
+                    delete b.shaper;
+            }
+
+            //
+            //  Returns the bake for key, creating it if necessary. The
+            //  fbs returned carry an extra static ref for the caller.
+            //
+
+            BakedLUT findOrBake(const string& key, vector<Expression*>& chain, size_t bottom, size_t top, bool shaped, int size,
+                                bool simd)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(bakeMutex);
+                    BakedLUTMap::iterator i = bakedLUTs.find(key);
+
+                    if (i != bakedLUTs.end())
+                    {
+                        i->second.lastUse = ++bakeClock;
+                        i->second.lut->staticRef();
+                        if (i->second.shaper)
+                            i->second.shaper->staticRef();
+                        return i->second;
+                    }
+                }
+
+                TWK_TRACE_SCOPE("render", "bake colour LUT");
+
+                BakedLUT b;
+                b.lut = 0;
+                b.shaper = 0;
+                b.lastUse = 0;
+
+                Pipeline pipeline;
+
+                for (size_t i = bottom; i <= top; i++)
+                {
+                    Op op;
+
+                    if (!buildOp(chain[i], pipeline, op))
+                        return b;
+
+                    pipeline.ops.push_back(op);
+                }
+
+                const size_t h = TwkUtil::FNV1a64(key.data(), key.size());
+
+                b.lut = new FrameBuffer(FrameBuffer::NormalizedCoordinates, size, size, size, 3, FrameBuffer::FLOAT, NULL, NULL,
+                                        FrameBuffer::BOTTOMLEFT, true);
+                b.lut->idstream() << "bake:" << hex << h;
+                b.lut->staticRef();
+                bakeLUT(pipeline, shaped, b.lut, simd);
+
+                if (shaped)
+                {
+                    b.shaper = newShaperLUT();
+                    b.shaper->idstream() << "bake-shaper:" << ShaperSize;
+                    b.shaper->staticRef();
+                }
+
+                std::lock_guard<std::mutex> lock(bakeMutex);
+
+                BakedLUTMap::iterator i = bakedLUTs.find(key);
+
+                if (i != bakedLUTs.end())
+                {
+                    //
+                    //  Somebody else baked it meanwhile
+                    //
+
+                    unrefBakedLUT(b);
+                    b = i->second;
+                }
+                else
+                {
+                    if (bakedLUTs.size() >= MaxBakedLUTs)
+                    {
+                        BakedLUTMap::iterator oldest = bakedLUTs.begin();
+
+                        for (BakedLUTMap::iterator q = bakedLUTs.begin(); q != bakedLUTs.end(); ++q)
+                        {
+                            if (q->second.lastUse < oldest->second.lastUse)
+                                oldest = q;
+                        }
+
+                        unrefBakedLUT(oldest->second);
+                        bakedLUTs.erase(oldest);
+                    }
+
+                    b.lastUse = ++bakeClock;
+                    bakedLUTs[key] = b;
+                }
+
+                b.lut->staticRef();
+                if (b.shaper)
+                    b.shaper->staticRef();
+
+                return b;
+            }
+
+            //
+            //  Bakes chain[bottom..top]. Returns false if the run is too
+            //  short to be worth it.
+            //
+
+            bool bakeRun(IPImage* image, vector<Expression*>& chain, size_t bottom, size_t top, bool affine, const Mat44f& M,
+                         vector<FrameBuffer*>& cachedFBs, bool simd)
+            {
+                const size_t length = top - bottom + 1;
+                const bool shaped = !affine && !unitRange(chain[bottom - 1]);
+
+                //
+                //  A shaped bake costs a matrix and two lookups
+                //
+
+                if (length < 2 || (shaped && length < 4))
+                    return false;
+
+                //
+                //  Values the shaper would clamp are left to the unbaked
+                //  chain
+                //
+
+                if (shaped && !inShaperRange(chain[bottom - 1]))
+                    return false;
+
+                BoundExpression* input = static_cast<BoundExpression*>(chain[bottom]->arguments()[0]);
+                Expression* expr = input->value();
+
+                if (affine)
+                {
+                    input->setValue(0);
+                    expr = newColorMatrix(expr, M);
+                }
+                else
+                {
+                    const int size = std::max(2, std::min(int(StripSize), evBakeLUTSize.getValue()));
+                    string key = shaped ? "shaped:" : "unit:";
+                    key += char('0' + size / 10);
+                    key += char('0' + size % 10);
+
+                    for (size_t i = bottom; i <= top; i++)
+                        appendBakeKey(chain[i], key);
+
+                    BakedLUT b = findOrBake(key, chain, bottom, top, shaped, size, simd);
+
+                    if (!b.lut)
+                        return false;
+
+                    input->setValue(0);
+
+                    if (shaped)
+                    {
+                        const float k = 1.0f / ShaperMax;
+                        expr = newColorMatrix(expr, Mat44f(k, 0, 0, 0, 0, k, 0, 0, 0, 0, k, 0, 0, 0, 0, 1));
+                        expr = newColorChannelLUT(expr, b.shaper, Vec3f(1.0f), Vec3f(0.0f));
+                    }
+
+                    if (LUTIPNode::newGLSLlutInterp)
+                    {
+                        expr = newColor3DLUT(expr, b.lut, Vec3f(1.0f), Vec3f(0.0f));
+                    }
+                    else
+                    {
+                        const Vec3f grid(1.0f / size);
+                        expr = newColor3DLUTGLSampling(expr, b.lut, Vec3f(1.0f) - grid, grid / 2.0f, Vec3f(1.0f), Vec3f(0.0f));
+                    }
+                }
+
+                replaceRun(image, chain, bottom, top, expr, cachedFBs);
+                return true;
+            }
+
+            size_t bakeImage(IPImage* image, vector<FrameBuffer*>& cachedFBs, bool simd)
+            {
+                if (!image->shaderExpr)
+                    return 0;
+
+                vector<Expression*> chain;
+                collectChain(image->shaderExpr, chain);
+
+                //
+                //  Find the maximal runs of bakeable functions from the top
+                //  down so replacing one doesn't move the ones below it.
+                //
+
+                size_t count = 0;
+                size_t top = chain.size();
+
+                while (top > 1)
+                {
+                    top--;
+
+                    Mat44f M;
+                    BakeKind kind = bakeKind(chain[top], M);
+
+                    if (kind == NotBakeable)
+                        continue;
+
+                    bool affine = kind == Affine;
+                    Mat44f product = M;
+                    size_t bottom = top;
+
+                    while (bottom > 1)
+                    {
+                        Mat44f N;
+                        BakeKind k = bakeKind(chain[bottom - 1], N);
+
+                        if (k == NotBakeable)
+                            break;
+
+                        affine = affine && k == Affine;
+                        product = product * N;
+                        bottom--;
+                    }
+
+                    if (bakeRun(image, chain, bottom, top, affine, product, cachedFBs, simd))
+                        count++;
+
+                    top = bottom;
+                }
+
+                return count;
+            }
+
+            size_t bakeRecursive(IPImage* image, vector<FrameBuffer*>& cachedFBs, bool simd)
+            {
+                size_t count = 0;
+
+                for (IPImage* child = image->children; child; child = child->next)
+                {
+                    count += bakeRecursive(child, cachedFBs, simd);
+                }
+
+                return count + bakeImage(image, cachedFBs, simd);
+            }
+
+        } // namespace
+
+        void setCPUEvaluation(bool b) { autoEnabled = b; }
+
+        bool cpuEvaluation()
+        {
+            const int mode = evCPUShaders.getValue();
+            return mode < 0 ? autoEnabled.load() : mode != 0;
+        }
+
+        size_t evaluateOnCPU(IPImage* root, vector<FrameBuffer*>& cachedFBs)
+        {
+            if (!root)
+                return 0;
+
+            const bool simd = TwkFB::simdLevel() != TwkFB::SIMDScalar;
+            return resolveRecursive(root, cachedFBs, simd);
+        }
+
+        bool colorBaking() { return evBakeColor.getValue(); }
+
+        size_t bakeColorChains(IPImage* root, vector<FrameBuffer*>& cachedFBs)
+        {
+            if (!root)
+                return 0;
+
+            const bool simd = TwkFB::simdLevel() != TwkFB::SIMDScalar;
+            return bakeRecursive(root, cachedFBs, simd);
+        }
+
+    } // namespace Shader
+} // namespace IPCore
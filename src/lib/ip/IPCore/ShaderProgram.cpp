@@ -6,11 +6,13 @@
 //
 //
 #include <IPCore/ShaderProgram.h>
+#include <IPCore/ShaderBinaryCache.h>
 #include <IPCore/ShaderSymbol.h>
 #include <IPCore/ShaderState.h>
 #include <IPCore/IPImage.h>
 #include <TwkGLF/GL.h>
 #include <TwkUtil/Timer.h>
+#include <algorithm>
 #include <cassert>
 #include <set>
 #include <sstream>
@@ -30,10 +32,11 @@ namespace IPCore::Shader
         Timer shaderClock(true);
     }
 
-    Program::Program(Expression* expr)
+    Program::Program(Expression* expr, BinaryCache* binaryCache)
         : m_expr(expr)
         , m_main(nullptr)
         , m_totalST(0)
+        , m_binaryCache(binaryCache)
     {
         m_localFunctions.emplace_back("main", "", expr);
         collectSymbolNames(expr, 0);
@@ -424,10 +427,9 @@ namespace IPCore::Shader
         }
 
         //
-        // Attach vertex shader
+        //  Vertex shader source
         //
 
-        GLuint vshader = glCreateShader(GL_VERTEX_SHADER);
         ostringstream vertexCode;
 
         if (isGL3OrAbove)
@@ -493,43 +495,7 @@ namespace IPCore::Shader
 
         vertexCode << "}" << endl;
 
-        //
-        //  Compile/Attach vertex shader
-        //
-
-        string vertexStr = vertexCode.str();
         m_vertexCode = vertexCode.str();
-        const char* vertexStrPointer = m_vertexCode.c_str();
-
-        glShaderSource(vshader, 1, &vertexStrPointer, NULL);
-        glCompileShader(vshader);
-
-        if (Shader::debuggingType() != Shader::NoDebugInfo)
-        {
-            cout << "INFO: ---- vertex shader source follows ----" << endl;
-            outputAnnotatedCode(cout, m_vertexCode);
-        }
-
-        // print out log
-        GLint infologLength = 0, status = GL_TRUE;
-        glGetShaderiv(vshader, GL_COMPILE_STATUS, &status);
-
-        if (status != GL_TRUE)
-        {
-            glGetShaderiv(vshader, GL_INFO_LOG_LENGTH, &infologLength);
-            if (infologLength > 1)
-            {
-                char* infoLog = new char[infologLength + 1];
-                int charsWritten = 0;
-                glGetShaderInfoLog(vshader, infologLength, &charsWritten, infoLog);
-                cout << infoLog << endl;
-                delete[] infoLog;
-            }
-        }
-
-        TWK_GLDEBUG;
-        glAttachShader(m_programId, vshader);
-        TWK_GLDEBUG;
 
         //
         //  Output extern declarations
@@ -601,6 +567,76 @@ namespace IPCore::Shader
 
         code << endl;
 
+        //
+        //  The first LocalFunction is always main.
+        //
+
+        outputLocalFunction(code, m_localFunctions.front());
+
+        //
+        //  Write the execution pipeline
+        //
+
+        m_main = new Function("main", code.str(), Function::Main, SymbolVector(), SymbolVector());
+
+        //
+        //  If this exact program was linked before (by this driver) the
+        //  shaders don't need to be compiled at all.
+        //
+
+        string binaryKey;
+
+        if (m_binaryCache)
+        {
+            binaryKey = binaryCacheKey();
+
+            if (m_binaryCache->load(m_programId, binaryKey))
+            {
+                collectUniforms();
+                collectAttribs();
+                return true;
+            }
+
+            m_binaryCache->markRetrievable(m_programId);
+        }
+
+        //
+        //  Compile/Attach vertex shader
+        //
+
+        GLuint vshader = glCreateShader(GL_VERTEX_SHADER);
+        const char* vertexStrPointer = m_vertexCode.c_str();
+
+        glShaderSource(vshader, 1, &vertexStrPointer, NULL);
+        glCompileShader(vshader);
+
+        if (Shader::debuggingType() != Shader::NoDebugInfo)
+        {
+            cout << "INFO: ---- vertex shader source follows ----" << endl;
+            outputAnnotatedCode(cout, m_vertexCode);
+        }
+
+        // print out log
+        GLint infologLength = 0, status = GL_TRUE;
+        glGetShaderiv(vshader, GL_COMPILE_STATUS, &status);
+
+        if (status != GL_TRUE)
+        {
+            glGetShaderiv(vshader, GL_INFO_LOG_LENGTH, &infologLength);
+            if (infologLength > 1)
+            {
+                char* infoLog = new char[infologLength + 1];
+                int charsWritten = 0;
+                glGetShaderInfoLog(vshader, infologLength, &charsWritten, infoLog);
+                cout << infoLog << endl;
+                delete[] infoLog;
+            }
+        }
+
+        TWK_GLDEBUG;
+        glAttachShader(m_programId, vshader);
+        TWK_GLDEBUG;
+
         //
         //  Compile any attached functions that have not yet been compiled
         //
@@ -634,18 +670,6 @@ namespace IPCore::Shader
             }
         }
 
-        //
-        //  The first LocalFunction is always main.
-        //
-
-        outputLocalFunction(code, m_localFunctions.front());
-
-        //
-        //  Write the execution pipeline
-        //
-
-        m_main = new Function("main", code.str(), Function::Main, SymbolVector(), SymbolVector());
-
         if (!m_main->compile())
         {
             cout << "ERROR: main failed to compile. Cannot build program" << endl;
@@ -711,9 +735,42 @@ namespace IPCore::Shader
         collectUniforms();
         collectAttribs();
 
+        if (m_binaryCache)
+            m_binaryCache->store(m_programId, binaryKey);
+
         return true;
     }
 
+    string Program::binaryCacheKey() const
+    {
+        //
+        //  m_functions is ordered by pointer so sort the sources to get
+        //  the same key in every session.
+        //
+
+        vector<string> sources;
+
+        for (FunctionSet::const_iterator i = m_functions.begin(); i != m_functions.end(); ++i)
+        {
+            if (!(*i)->isInline())
+                sources.push_back((*i)->source());
+        }
+
+        sort(sources.begin(), sources.end());
+
+        string key = m_vertexCode;
+
+        for (size_t i = 0; i < sources.size(); i++)
+        {
+            key += '\0';
+            key += sources[i];
+        }
+
+        key += '\0';
+        key += m_main->source();
+        return key;
+    }
+
     void Program::releaseCompiledState()
     {
         if (m_programId)
@@ -1059,9 +1116,33 @@ namespace IPCore::Shader
 
     //----------------------------------------------------------------------
 
-    ProgramCache::ProgramCache() {}
+    ProgramCache::ProgramCache()
+        : m_binaryCache(0)
+    {
+    }
 
-    ProgramCache::~ProgramCache() { flush(); }
+    ProgramCache::~ProgramCache()
+    {
+        flush();
+        delete m_binaryCache;
+    }
+
+    void ProgramCache::useBinaryCache(const string& driver)
+    {
+        if (m_binaryCache && m_binaryCache->driver() == driver)
+            return;
+
+        //
+        //  Programs only refer to the cache while compiling but drop them
+        //  anyway: they were built for another context.
+        //
+
+        if (m_binaryCache)
+            flush();
+
+        delete m_binaryCache;
+        m_binaryCache = BinaryCache::createFromEnvironment(driver);
+    }
 
     void ProgramCache::flush()
     {
@@ -1094,7 +1175,7 @@ namespace IPCore::Shader
         else
         {
             Expression* Aunbound = A->copyUnbound();
-            Program* p = new Program(Aunbound);
+            Program* p = new Program(Aunbound, m_binaryCache);
 
             if (p->compile())
             {
@@ -1118,6 +1118,30 @@ namespace IPMu
         NODE_RETURN(tuple);
     }
 
+    NODE_IMPLEMENTATION(memoryPoolInfo, Mu::Pointer)
+    {
+        Session* s = Session::currentSession();
+        const Class* ttype = (const Class*)NODE_THIS.type();
+
+        struct PoolTuple
+        {
+            int64 hits;
+            int64 misses;
+            int64 resident;
+        };
+
+        ClassInstance* tuple = ClassInstance::allocate(ttype);
+        PoolTuple* pinfo = reinterpret_cast<PoolTuple*>(tuple->structure());
+
+        Session::CacheStats stats = s->cacheStats();
+
+        pinfo->hits = stats.poolHits;
+        pinfo->misses = stats.poolMisses;
+        pinfo->resident = stats.poolResident;
+
+        NODE_RETURN(tuple);
+    }
+
     NODE_IMPLEMENTATION(audioCacheInfo, Mu::Pointer)
     {
         Process* p = NODE_THREAD.process();
@@ -5496,6 +5520,12 @@ namespace IPMu
                                            0)); // cached frame ranges
         context->tupleType(types);
 
+        types.clear();                         // memoryPoolInfo() return tuple
+        types.push_back(context->int64Type()); // pixel allocs recycled
+        types.push_back(context->int64Type()); // pixel allocs not recycled
+        types.push_back(context->int64Type()); // bytes held for recycling
+        context->tupleType(types);
+
         types.clear();                         // audioCacheInfo() return tuple
         types.push_back(context->floatType()); // seconds of audio cached
         types.push_back(context->arrayType(context->intType(), 1,
@@ -5693,6 +5723,8 @@ namespace IPMu
 
             new Function(c, "cacheInfo", cacheInfo, None, Return, "(int64,int64,int64,float,float,float,int[])", End),
 
+            new Function(c, "memoryPoolInfo", memoryPoolInfo, None, Return, "(int64,int64,int64)", End),
+
             new Function(c, "audioCacheInfo", audioCacheInfo, None, Return, "(float,int[])", End),
 
             new Function(c, "isBuffering", isBuffering, None, Return, "bool", End),
@@ -7,6 +7,7 @@
 //
 #include <TwkQtChat/Client.h>
 #include <TwkQtChat/Connection.h>
+#include <TwkQtChat/SyncBatch.h>
 #include <QtNetwork/QtNetwork>
 #include <QtCore/QtCore>
 
@@ -30,12 +31,30 @@ namespace TwkQtChat
 {
     using namespace std;
 
+    //
+    //  How long a sync channel with nothing to say waits before sending a
+    //  clock probe (see SyncChannel::wantsFlush()).
+    //
+
+    static const int SyncIdleInterval = 1000;
+
+    static const char* SyncBatchInterp = "SYNCBATCH(v=1)";
+
     Client::Client(const QString& name, const QString& appName, int port, bool pingpong, ConnectionFactory fact)
         : m_pingpong(pingpong)
         , m_contactName(name)
         , m_contactApp(appName)
         , m_connectionFactory(fact)
+        , m_syncInterval(16)
     {
+        if (getenv("RV_SYNC_BATCH_INTERVAL"))
+        {
+            m_syncInterval = atoi(getenv("RV_SYNC_BATCH_INTERVAL"));
+        }
+
+        m_syncTimer.setSingleShot(true);
+        connect(&m_syncTimer, SIGNAL(timeout()), this, SLOT(flushSyncChannels()));
+
         //
         //  Most clients (who only want to communicate with RV) have no need of
         //  a Server, since they will not be listening for connections.  They
@@ -69,7 +88,10 @@ namespace TwkQtChat
 
         QList<Connection*> connections = m_connectionMap.values();
         foreach (Connection* connection, connections)
+        {
+            flushSyncChannel(connection);
             connection->sendMessage(message);
+        }
     }
 
     void Client::sendMessage(const QString& who, const QString& message)
@@ -82,7 +104,10 @@ namespace TwkQtChat
         foreach (Connection* c, connections)
         {
             if (c->remoteContactName() == who && c->isValid())
+            {
+                flushSyncChannel(c);
                 c->sendMessage(message);
+            }
         }
     }
 
@@ -97,6 +122,7 @@ namespace TwkQtChat
         {
             if (c->remoteContactName() == who && c->isValid())
             {
+                flushSyncChannel(c);
                 c->sendData(interp, data);
             }
         }
@@ -104,16 +130,83 @@ namespace TwkQtChat
 
     void Client::broadcastEvent(const QString& eventName, const QString& target, const QString& text, bool rsvp)
     {
-        QString type = (rsvp) ? "RETURNEVENT " : "EVENT ";
-        QString message = type + eventName + " " + target + " " + text;
-        broadcastMessage(message);
+        QList<Connection*> connections = m_connectionMap.values();
+        foreach (Connection* c, connections)
+            sendEventTo(c, eventName, target, text, rsvp);
     }
 
     void Client::sendEvent(const QString& who, const QString& eventName, const QString& target, const QString& text, bool rsvp)
     {
+        QList<Connection*> connections = m_connectionMap.values();
+
+        foreach (Connection* c, connections)
+        {
+            if (c->remoteContactName() == who && c->isValid())
+                sendEventTo(c, eventName, target, text, rsvp);
+        }
+    }
+
+    void Client::sendEventTo(Connection* c, const QString& eventName, const QString& target, const QString& text, bool rsvp)
+    {
+        string name = eventName.toUtf8().constData();
+        SyncChannel* channel = m_syncChannels.value(c, 0);
+
+        if (!rsvp && channel && channel->batching() && SyncBatch::batchable(name))
+        {
+            channel->queue(name, target.toUtf8().constData(), text.toUtf8().constData(), SyncBatch::now());
+
+            if (!m_syncTimer.isActive() || m_syncTimer.remainingTime() > m_syncInterval)
+                m_syncTimer.start(m_syncInterval);
+            return;
+        }
+
         QString type = (rsvp) ? "RETURNEVENT " : "EVENT ";
-        QString message = type + eventName + " " + target + " " + text;
-        sendMessage(who, message);
+        flushSyncChannel(c);
+        c->sendMessage(type + eventName + " " + target + " " + text);
+    }
+
+    void Client::flushSyncChannel(Connection* c)
+    {
+        SyncChannel* channel = m_syncChannels.value(c, 0);
+
+        if (channel && channel->encoder().pending() && c->isValid())
+        {
+            string batch;
+            channel->flush(SyncBatch::now(), batch);
+            c->sendData(SyncBatchInterp, QByteArray(batch.data(), int(batch.size())));
+        }
+    }
+
+    void Client::flushSyncChannels()
+    {
+        const uint64_t now = SyncBatch::now();
+        bool active = false;
+
+        QList<Connection*> connections = m_syncChannels.keys();
+
+        foreach (Connection* c, connections)
+        {
+            SyncChannel* channel = m_syncChannels.value(c, 0);
+            if (!channel)
+                continue;
+
+            if (channel->wantsFlush(now) && c->isValid())
+            {
+                string batch;
+                channel->flush(now, batch);
+                c->sendData(SyncBatchInterp, QByteArray(batch.data(), int(batch.size())));
+            }
+
+            active = active || channel->batching();
+        }
+
+        //
+        //  Keep probing idle channels so their clock estimates stay
+        //  current.
+        //
+
+        if (active && !m_syncTimer.isActive())
+            m_syncTimer.start(SyncIdleInterval);
     }
 
     bool Client::waitForMessage(const QString& who)
@@ -139,6 +232,7 @@ namespace TwkQtChat
         {
             if (c->remoteContactName() == who && c->isValid())
             {
+                flushSyncChannel(c);
                 return c->waitForBytesWritten();
             }
         }
@@ -230,6 +324,7 @@ namespace TwkQtChat
         if (Connection* c = connectionByName(contact))
         {
             DB("    found connection");
+            flushSyncChannel(c);
             c->disconnectFromHost();
         }
     }
@@ -279,19 +374,121 @@ namespace TwkQtChat
             || connectionByName(connection->remoteContactName()))
             return;
 
-        connect(connection, SIGNAL(newMessage(const QString&, const QString&)), this, SIGNAL(newMessage(const QString&, const QString&)));
+        connect(connection, SIGNAL(newMessage(const QString&, const QString&)), this,
+                SLOT(connectionMessage(const QString&, const QString&)));
 
         connect(connection, SIGNAL(newData(const QString&, const QString&, const QByteArray&)), this,
-                SIGNAL(newData(const QString&, const QString&, const QByteArray&)));
+                SLOT(connectionData(const QString&, const QString&, const QByteArray&)));
 
         m_connectionMap.insert(connection->peerAddress(), connection);
         QString contact = connection->remoteContactName();
         if (!m_pingpong)
             connection->pingPongControl(false);
+
+        //
+        //  Offer batched session sync to other RVs. It's only used once
+        //  the other end makes the same offer.
+        //
+
+        if (m_syncInterval > 0 && m_contactApp == "rv" && connection->remoteApp() == "rv")
+        {
+            m_syncChannels.insert(connection, new SyncChannel());
+            connection->sendMessage(QString("SYNCBATCH %1").arg(SyncBatch::Version));
+        }
         if (!contact.isEmpty())
             emit newContact(contact);
     }
 
+    void Client::connectionMessage(const QString& from, const QString& message)
+    {
+        if (message.startsWith("SYNCBATCH "))
+        {
+            Connection* c = qobject_cast<Connection*>(sender());
+            if (SyncChannel* channel = m_syncChannels.value(c, 0))
+            {
+                channel->setPeerVersion(qMin(message.section(" ", 1, 1).toInt(), int(SyncBatch::Version)));
+                if (!m_syncTimer.isActive())
+                    m_syncTimer.start(0);
+            }
+            return;
+        }
+
+        emit newMessage(from, message);
+    }
+
+    void Client::connectionData(const QString& from, const QString& interp, const QByteArray& data)
+    {
+        if (!interp.startsWith("SYNCBATCH("))
+        {
+            emit newData(from, interp, data);
+            return;
+        }
+
+        Connection* c = qobject_cast<Connection*>(sender());
+        SyncChannel* channel = m_syncChannels.value(c, 0);
+
+        if (!channel)
+        {
+            //
+            //  Batches can arrive without an offer when a stored stream is
+            //  played back.
+            //
+
+            channel = new SyncChannel();
+            m_syncChannels.insert(c, channel);
+        }
+
+        const uint64_t now = SyncBatch::now();
+
+        if (!channel->receive(data.constData(), data.size(), now))
+        {
+            cerr << "ERROR: dropping session sync batch from " << from.toUtf8().constData() << ": " << channel->error()
+                 << endl;
+
+            //
+            //  The channel asks the sender to reset its tables on the
+            //  next flush
+            //
+
+            if (channel->wantsFlush(now) && (!m_syncTimer.isActive() || m_syncTimer.remainingTime() > m_syncInterval))
+            {
+                m_syncTimer.start(m_syncInterval);
+            }
+
+            return;
+        }
+
+        const SyncBatch::Events& events = channel->events();
+
+        for (size_t i = 0; i < events.size(); i++)
+        {
+            const SyncBatch::Event& e = events[i];
+            QString contents = QString::fromUtf8(e.contents.c_str());
+
+            //
+            //  Tell the sync package how long ago playback started (or
+            //  where the playhead was) on the sender so it can catch up:
+            //  "frame;;latency|session|originator".
+            //
+
+            if (e.name == "remote-sync-play-start" || e.name == "remote-sync-play-clock")
+            {
+                int bar = contents.indexOf('|');
+                if (bar < 0)
+                    bar = contents.size();
+                contents.insert(bar, QString(";;%1").arg(channel->latency(e, now), 0, 'f', 6));
+            }
+
+            emit newMessage(from, "EVENT " + QString::fromUtf8(e.name.c_str()) + " " + QString::fromUtf8(e.target.c_str()) + " "
+                                      + contents);
+        }
+
+        if (channel->wantsFlush(now) && (!m_syncTimer.isActive() || m_syncTimer.remainingTime() > m_syncInterval))
+        {
+            m_syncTimer.start(m_syncInterval);
+        }
+    }
+
     void Client::disconnected()
     {
         if (Connection* connection = qobject_cast<Connection*>(sender()))
@@ -329,6 +526,8 @@ namespace TwkQtChat
     void Client::removeConnection(Connection* connection)
     {
         DB("Client::removeConnection dupe " << connection->duplicate());
+        delete m_syncChannels.take(connection);
+
         if (m_connectionMap.contains(connection->peerAddress()))
         {
             DB("    removing connection from map");
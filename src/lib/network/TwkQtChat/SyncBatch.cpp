@@ -0,0 +1,528 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#include <TwkQtChat/SyncBatch.h>
+#include <algorithm>
+#include <chrono>
+
+namespace TwkQtChat
+{
+    using namespace std;
+
+    //
+    //  Both ends start their string table and deltas over when the
+    //  encoder's grow past these (e.g. after a long session of edits to
+    //  many different properties).
+    //
+
+    static const size_t MaxStrings = 4096;
+    static const size_t MaxDeltas = 4096;
+
+    //
+    //  A probe (a batch asking for an ack) goes out at least this often
+    //  so the clock estimate keeps up with drift.
+    //
+
+    static const uint64_t ProbeInterval = 1000000;
+    static const size_t ClockSamples = 8;
+
+    static void putVarint(string& out, uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(char((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+
+        out.push_back(char(v));
+    }
+
+    static bool getVarint(const unsigned char*& p, const unsigned char* end, uint64_t& v)
+    {
+        v = 0;
+
+        for (int shift = 0; p < end && shift < 64; shift += 7)
+        {
+            const unsigned char c = *p++;
+            v |= uint64_t(c & 0x7f) << shift;
+            if (!(c & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+
+    static string deltaKey(const string& name, const string& target, const string& key)
+    {
+        string k = name;
+        k += '\n';
+        k += target;
+        k += '\n';
+        k += key;
+        return k;
+    }
+
+    //----------------------------------------------------------------------
+
+    bool SyncBatch::batchable(const string& name) { return name.compare(0, 12, "remote-sync-") == 0; }
+
+    string SyncBatch::coalesceKey(const string& name, const string& contents, bool& coalesce)
+    {
+        //
+        //  Events which only say what the current state is. A newer one
+        //  makes an older one redundant.
+        //
+
+        static const char* stateEvents[] = {"remote-sync-frame-changed",
+                                            "remote-sync-play-clock",
+                                            "remote-sync-pointer",
+                                            "remote-sync-new-in-point",
+                                            "remote-sync-new-out-point",
+                                            "remote-sync-play-inc",
+                                            "remote-sync-fps",
+                                            "remote-sync-play-mode",
+                                            "remote-sync-realtime",
+                                            "remote-sync-play-all-frames",
+                                            0};
+
+        coalesce = false;
+
+        for (const char** e = stateEvents; *e; e++)
+        {
+            if (name == *e)
+            {
+                coalesce = true;
+                return string();
+            }
+        }
+
+        //
+        //  A graph-state edit is "prop/altprop/command|session|origin";
+        //  accumulated ones join several with '&' and are left alone.
+        //
+
+        if (name == "remote-sync-graph-state")
+        {
+            const size_t slash = contents.find('/');
+
+            if (slash != string::npos && contents.find('&') == string::npos)
+            {
+                coalesce = true;
+                return contents.substr(0, slash);
+            }
+        }
+
+        return string();
+    }
+
+    uint64_t SyncBatch::now()
+    {
+        using namespace std::chrono;
+        return uint64_t(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+    }
+
+    //----------------------------------------------------------------------
+
+    SyncBatchEncoder::SyncBatchEncoder()
+        : m_pending(0)
+        , m_sequence(0)
+    {
+    }
+
+    void SyncBatchEncoder::queue(const string& name, const string& target, const string& contents, uint64_t now)
+    {
+        bool coalesce;
+        const string key = SyncBatch::coalesceKey(name, contents, coalesce);
+
+        m_stats.queued++;
+
+        if (coalesce)
+        {
+            const string k = deltaKey(name, target, key);
+            KeyIndex::iterator i = m_coalesce.find(k);
+
+            if (i != m_coalesce.end())
+            {
+                m_queue[i->second].live = false;
+                m_pending--;
+                m_stats.coalesced++;
+            }
+
+            m_coalesce[k] = m_queue.size();
+        }
+        else
+        {
+            //
+            //  Nothing queued before this event may be replaced by one
+            //  queued after it.
+            //
+
+            m_coalesce.clear();
+        }
+
+        m_queue.resize(m_queue.size() + 1);
+        Queued& q = m_queue.back();
+        q.name = name;
+        q.target = target;
+        q.key = key;
+        q.contents = contents;
+        q.time = now;
+        q.live = true;
+        m_pending++;
+    }
+
+    void SyncBatchEncoder::writeString(const string& s, string& out)
+    {
+        StringTable::const_iterator i = m_strings.find(s);
+
+        if (i != m_strings.end())
+        {
+            putVarint(out, uint64_t(i->second) + 1);
+        }
+        else
+        {
+            putVarint(out, 0);
+            putVarint(out, s.size());
+            out += s;
+
+            const uint32_t index = uint32_t(m_strings.size());
+            m_strings[s] = index;
+        }
+    }
+
+    void SyncBatchEncoder::encode(uint64_t now, uint64_t echoTime, uint64_t echoDelay, unsigned int flags, string& out)
+    {
+        const size_t start = out.size();
+
+        if ((flags & SyncBatch::ResetTables) || m_strings.size() >= MaxStrings || m_deltas.size() >= MaxDeltas)
+        {
+            m_strings.clear();
+            m_deltas.clear();
+            flags |= SyncBatch::ResetTables;
+        }
+
+        out.push_back(char(SyncBatch::Version));
+        out.push_back(char(flags));
+        putVarint(out, ++m_sequence);
+        putVarint(out, now);
+        putVarint(out, echoTime);
+        putVarint(out, echoDelay);
+        putVarint(out, m_pending);
+
+        for (size_t i = 0; i < m_queue.size(); i++)
+        {
+            const Queued& q = m_queue[i];
+            if (!q.live)
+                continue;
+
+            writeString(q.name, out);
+            writeString(q.target, out);
+            writeString(q.key, out);
+            putVarint(out, now > q.time ? now - q.time : 0);
+
+            string& base = m_deltas[deltaKey(q.name, q.target, q.key)];
+            const size_t n = min(base.size(), q.contents.size());
+            size_t prefix = 0;
+            while (prefix < n && base[prefix] == q.contents[prefix])
+                prefix++;
+
+            putVarint(out, prefix);
+            putVarint(out, q.contents.size() - prefix);
+            out.append(q.contents, prefix, string::npos);
+            base = q.contents;
+        }
+
+        m_stats.records += m_pending;
+        m_stats.batches++;
+        m_stats.bytes += out.size() - start;
+
+        m_queue.clear();
+        m_coalesce.clear();
+        m_pending = 0;
+    }
+
+    //----------------------------------------------------------------------
+
+    SyncBatchDecoder::SyncBatchDecoder()
+        : m_lastSequence(0)
+        , m_hasHeader(false)
+        , m_needsReset(false)
+    {
+        m_header.flags = 0;
+        m_header.sequence = 0;
+        m_header.sendTime = 0;
+        m_header.echoTime = 0;
+        m_header.echoDelay = 0;
+    }
+
+    bool SyncBatchDecoder::readString(const unsigned char*& p, const unsigned char* end, string& s)
+    {
+        uint64_t index;
+
+        if (!getVarint(p, end, index))
+            return false;
+
+        if (index)
+        {
+            if (index > m_strings.size())
+                return false;
+            s = m_strings[index - 1];
+            return true;
+        }
+
+        uint64_t n;
+
+        if (!getVarint(p, end, n) || n > uint64_t(end - p))
+            return false;
+
+        s.assign((const char*)p, size_t(n));
+        p += n;
+        m_strings.push_back(s);
+        return true;
+    }
+
+    bool SyncBatchDecoder::decode(const void* data, size_t size)
+    {
+        m_events.clear();
+        m_error.clear();
+        m_hasHeader = false;
+
+        const unsigned char* p = (const unsigned char*)data;
+        const unsigned char* end = p + size;
+
+        if (size < 2 || p[0] != SyncBatch::Version)
+        {
+            m_error = "not a sync batch or unsupported version";
+            return false;
+        }
+
+        Header h;
+        h.flags = p[1];
+        p += 2;
+
+        uint64_t sequence, count;
+
+        if (!getVarint(p, end, sequence) || !getVarint(p, end, h.sendTime) || !getVarint(p, end, h.echoTime)
+            || !getVarint(p, end, h.echoDelay) || !getVarint(p, end, count) || count > uint64_t(end - p))
+        {
+            m_error = "sync batch is truncated";
+            return false;
+        }
+
+        h.sequence = uint32_t(sequence);
+
+        if (m_lastSequence && h.sequence <= m_lastSequence)
+        {
+            m_error = "stale sync batch";
+            return false;
+        }
+
+        m_header = h;
+        m_hasHeader = true;
+
+        //
+        //  The deltas only make sense if we've seen every batch before
+        //  this one (unless the sender started over). Once one is
+        //  missing nothing can be decoded until the sender does start
+        //  over.
+        //
+
+        if (h.flags & SyncBatch::ResetTables)
+        {
+            m_strings.clear();
+            m_deltas.clear();
+            m_needsReset = false;
+        }
+        else if (m_needsReset)
+        {
+            m_lastSequence = h.sequence;
+            m_error = "sync batch dropped until the sender resets its tables";
+            return false;
+        }
+        else if (h.sequence != m_lastSequence + 1)
+        {
+            m_lastSequence = h.sequence;
+            m_needsReset = true;
+            m_error = "sync batch sequence gap";
+            return false;
+        }
+
+        m_lastSequence = h.sequence;
+        m_events.resize(size_t(count));
+
+        for (size_t i = 0; i < m_events.size(); i++)
+        {
+            SyncBatch::Event& e = m_events[i];
+            string key;
+            uint64_t prefix, n;
+
+            if (!readString(p, end, e.name) || !readString(p, end, e.target) || !readString(p, end, key)
+                || !getVarint(p, end, e.age) || !getVarint(p, end, prefix) || !getVarint(p, end, n)
+                || n > uint64_t(end - p))
+            {
+                m_events.clear();
+                m_needsReset = true;
+                m_error = "sync batch record is corrupt";
+                return false;
+            }
+
+            string& base = m_deltas[deltaKey(e.name, e.target, key)];
+
+            if (prefix > base.size())
+            {
+                m_events.clear();
+                m_needsReset = true;
+                m_error = "sync batch delta has no base";
+                return false;
+            }
+
+            e.contents.assign(base, 0, size_t(prefix));
+            e.contents.append((const char*)p, size_t(n));
+            p += n;
+            base = e.contents;
+        }
+
+        return true;
+    }
+
+    //----------------------------------------------------------------------
+
+    SyncChannel::SyncChannel()
+        : m_peerVersion(0)
+        , m_ackPending(false)
+        , m_resetPending(false)
+        , m_requestPending(false)
+        , m_lastProbe(0)
+        , m_peerTime(0)
+        , m_peerTimeAt(0)
+        , m_nextSample(0)
+        , m_roundTrip(uint64_t(-1))
+        , m_offset(0)
+    {
+    }
+
+    void SyncChannel::queue(const string& name, const string& target, const string& contents, uint64_t now)
+    {
+        m_encoder.queue(name, target, contents, now);
+    }
+
+    bool SyncChannel::wantsFlush(uint64_t now) const
+    {
+        return batching()
+               && (m_encoder.pending() || m_ackPending || m_resetPending || m_requestPending || now - m_lastProbe >= ProbeInterval);
+    }
+
+    void SyncChannel::flush(uint64_t now, string& out)
+    {
+        unsigned int flags = 0;
+
+        if (now - m_lastProbe >= ProbeInterval)
+        {
+            flags |= SyncBatch::AckRequested;
+            m_lastProbe = now;
+        }
+
+        if (m_resetPending)
+            flags |= SyncBatch::ResetTables;
+
+        //
+        //  Keep asking until a reset arrives in case this batch crosses
+        //  one which was already on its way.
+        //
+
+        if (m_decoder.needsReset())
+            flags |= SyncBatch::ResetRequested;
+
+        m_encoder.encode(now, m_peerTime, m_peerTime ? now - m_peerTimeAt : 0, flags, out);
+        m_ackPending = false;
+        m_resetPending = false;
+        m_requestPending = false;
+    }
+
+    bool SyncChannel::receive(const void* data, size_t size, uint64_t now)
+    {
+        //
+        //  A batch dropped because a previous one is missing still has
+        //  a usable header. Both ends may be waiting for a reset at the
+        //  same time, so its ResetRequested has to be honored.
+        //
+
+        const bool decoded = m_decoder.decode(data, size);
+
+        if (!m_decoder.hasHeader())
+            return false;
+
+        if (!decoded)
+            m_requestPending = true;
+
+        const SyncBatchDecoder::Header& h = m_decoder.header();
+
+        //
+        //  t1 = echoTime (ours), t2 = sendTime - echoDelay and t3 =
+        //  sendTime (theirs), t4 = now (ours)
+        //
+
+        if (h.echoTime && h.echoTime <= now && h.echoDelay <= now - h.echoTime)
+        {
+            const uint64_t roundTrip = now - h.echoTime - h.echoDelay;
+            const int64_t offset =
+                (int64_t(h.sendTime - h.echoDelay - h.echoTime) + int64_t(h.sendTime - now)) / 2;
+            addClockSample(roundTrip, offset);
+        }
+
+        m_peerTime = h.sendTime;
+        m_peerTimeAt = now;
+        if (h.flags & SyncBatch::AckRequested)
+            m_ackPending = true;
+        if (h.flags & SyncBatch::ResetRequested)
+            m_resetPending = true;
+
+        return decoded;
+    }
+
+    void SyncChannel::addClockSample(uint64_t roundTrip, int64_t offset)
+    {
+        ClockSample s;
+        s.roundTrip = roundTrip;
+        s.offset = offset;
+
+        if (m_samples.size() < ClockSamples)
+            m_samples.push_back(s);
+        else
+            m_samples[m_nextSample] = s;
+
+        m_nextSample = (m_nextSample + 1) % ClockSamples;
+
+        //
+        //  The sample with the shortest round trip has the least queueing
+        //  in it so its offset is the most trustworthy.
+        //
+
+        const ClockSample* best = &m_samples.front();
+
+        for (size_t i = 1; i < m_samples.size(); i++)
+        {
+            if (m_samples[i].roundTrip < best->roundTrip)
+                best = &m_samples[i];
+        }
+
+        m_roundTrip = best->roundTrip;
+        m_offset = best->offset;
+    }
+
+    double SyncChannel::latency(const SyncBatch::Event& e, uint64_t now) const
+    {
+        int64_t usec = int64_t(e.age);
+
+        if (clockValid())
+        {
+            const int64_t sent = int64_t(m_decoder.header().sendTime) - m_offset;
+            usec += max(int64_t(now) - sent, int64_t(0));
+        }
+
+        return double(usec) / 1e6;
+    }
+
+} // namespace TwkQtChat
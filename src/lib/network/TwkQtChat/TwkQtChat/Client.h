@@ -12,6 +12,7 @@
 #include <QtCore/QHash>
 #include <QtNetwork/QHostAddress>
 #include <QtCore/QSettings>
+#include <QtCore/QTimer>
 #include <TwkQtChat/Server.h>
 
 namespace TwkQtChat
@@ -19,6 +20,7 @@ namespace TwkQtChat
     class Connection;
     class DataServer;
     class DataConnection;
+    class SyncChannel;
 
     class Client : public QObject
     {
@@ -26,6 +28,7 @@ namespace TwkQtChat
 
     public:
         typedef QMultiHash<QHostAddress, Connection*> ConnectionMap;
+        typedef QHash<Connection*, SyncChannel*> SyncChannelMap;
 
         Client(const QString& contactName, const QString& contactApp = "rv", int port = 45124, bool pingpong = true,
                ConnectionFactory f = 0);
@@ -60,7 +63,8 @@ namespace TwkQtChat
 
         ///
         /// Formats a message as an event message and sends to particular
-        /// connected contacts.
+        /// connected contacts. Session sync events ("remote-sync-*") to
+        /// another RV are queued and sent in batches (see SyncBatch.h).
         ///
 
         void sendEvent(const QString& contact, const QString& event, const QString& target, const QString& message, bool rsvp = false);
@@ -152,10 +156,15 @@ namespace TwkQtChat
         void disconnected();
         void readyForUse();
         void requestGreeting();
+        void connectionMessage(const QString& from, const QString& message);
+        void connectionData(const QString& from, const QString& interp, const QByteArray& data);
+        void flushSyncChannels();
 
     private:
         void removeConnection(Connection* connection);
         Connection* connectionByName(const QString&) const;
+        void sendEventTo(Connection*, const QString& event, const QString& target, const QString& message, bool rsvp);
+        void flushSyncChannel(Connection*);
 
     private:
         QString m_contactName;
@@ -164,6 +173,9 @@ namespace TwkQtChat
         ConnectionMap m_connectionMap;
         DataServer* m_dataServer;
         bool m_pingpong;
+        SyncChannelMap m_syncChannels;
+        QTimer m_syncTimer;
+        int m_syncInterval;
 
         ConnectionFactory m_connectionFactory;
     };
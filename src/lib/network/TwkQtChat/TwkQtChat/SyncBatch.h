@@ -0,0 +1,306 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef __TwkQtChat__SyncBatch__h__
+#define __TwkQtChat__SyncBatch__h__
+#include <map>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace TwkQtChat
+{
+
+    //
+    //  Batched session sync
+    //
+    //  Session sync (the sync package) sends one text EVENT message per
+    //  frame change, pointer move, and property edit to every contact.
+    //  Between two RVs that both speak it, Client instead queues the
+    //  "remote-sync-*" events for a contact and sends them once per tick
+    //  (RV_SYNC_BATCH_INTERVAL ms, default 16, 0 turns it off) as one
+    //  binary message:
+    //
+    //      SYNCBATCH(v=1) <n> <batch>
+    //
+    //  While queued, state-like events (frame changes, pointer, in/out
+    //  points, play modes, and graph-state edits keyed by property) are
+    //  coalesced: only the newest one of each kind is kept, unless an
+    //  event which isn't state-like (play start/stop, marks, ...) was
+    //  queued after it.
+    //
+    //  A batch is a small header followed by its records. Integers are
+    //  LEB128 varints. Event names, targets and property keys go through
+    //  a string table both ends build as they go, and each record's
+    //  contents are a delta against the previous contents of the same
+    //  event/target/key: the length of the common prefix plus the new
+    //  suffix. Batches carry a sequence number; the decoder rejects old
+    //  ones. After a gap or a corrupt batch the deltas can't be trusted,
+    //  so the decoder drops everything up to the next batch which resets
+    //  the tables, and its channel asks the other end for one.
+    //
+    //  The header also carries the sender's clock, the last clock value
+    //  it received from us and how long it held on to it. From those
+    //  SyncChannel estimates the round trip and the offset between the two
+    //  clocks (as NTP does, keeping the lowest round trip samples), so a
+    //  receiver knows how long ago each event happened on the sender. The
+    //  sync package uses that to start playback at the frame the sender
+    //  is on now instead of the one it was on when it pressed play, and
+    //  to keep the playheads together with an occasional
+    //  "remote-sync-play-clock" instead of per frame messages.
+    //
+    //  The two ends agree to use batches by exchanging "SYNCBATCH 1"
+    //  messages when they connect; older versions ignore it.
+    //
+
+    class SyncBatch
+    {
+    public:
+        static const int Version = 1;
+
+        enum Flags
+        {
+            AckRequested = 1 << 0,  // reply even if there's nothing to send
+            ResetTables = 1 << 1,   // string table and deltas start over
+            ResetRequested = 1 << 2 // send ResetTables, we lost a batch
+        };
+
+        struct Event
+        {
+            std::string name;
+            std::string target;
+            std::string contents;
+            uint64_t age; // usec between queueing and sending
+        };
+
+        typedef std::vector<Event> Events;
+
+        //
+        //  batchable() is true for the events Client may queue.
+        //  coalesceKey() returns the key an event's deltas are kept
+        //  under and sets coalesce if a newer event with the same name,
+        //  target and key replaces it.
+        //
+
+        static bool batchable(const std::string& name);
+        static std::string coalesceKey(const std::string& name, const std::string& contents, bool& coalesce);
+
+        static uint64_t now(); // monotonic usec
+    };
+
+    //
+    //  SyncBatchEncoder
+    //
+
+    class SyncBatchEncoder
+    {
+    public:
+        struct Stats
+        {
+            size_t queued;    /// events handed to queue()
+            size_t coalesced; /// events replaced by a newer one
+            size_t records;   /// events sent
+            size_t batches;
+            size_t bytes;     /// batch bytes (not including framing)
+
+            Stats()
+                : queued(0)
+                , coalesced(0)
+                , records(0)
+                , batches(0)
+                , bytes(0)
+            {
+            }
+        };
+
+        SyncBatchEncoder();
+
+        void queue(const std::string& name, const std::string& target, const std::string& contents, uint64_t now);
+
+        size_t pending() const { return m_pending; }
+
+        //
+        //  Appends a batch with everything queued (possibly nothing) to
+        //  out and clears the queue. With ResetTables in flags the
+        //  string table and deltas start over.
+        //
+
+        void encode(uint64_t now, uint64_t echoTime, uint64_t echoDelay, unsigned int flags, std::string& out);
+
+        uint32_t sequence() const { return m_sequence; }
+
+        const Stats& stats() const { return m_stats; }
+
+    private:
+        struct Queued
+        {
+            std::string name;
+            std::string target;
+            std::string key;
+            std::string contents;
+            uint64_t time;
+            bool live;
+        };
+
+        typedef std::map<std::string, size_t> KeyIndex;
+        typedef std::map<std::string, uint32_t> StringTable;
+        typedef std::map<std::string, std::string> DeltaMap;
+
+        void writeString(const std::string&, std::string& out);
+
+    private:
+        std::vector<Queued> m_queue;
+        KeyIndex m_coalesce;
+        StringTable m_strings;
+        DeltaMap m_deltas;
+        size_t m_pending;
+        uint32_t m_sequence;
+        Stats m_stats;
+    };
+
+    //
+    //  SyncBatchDecoder
+    //
+
+    class SyncBatchDecoder
+    {
+    public:
+        struct Header
+        {
+            unsigned int flags;
+            uint32_t sequence;
+            uint64_t sendTime;
+            uint64_t echoTime;
+            uint64_t echoDelay;
+        };
+
+        SyncBatchDecoder();
+
+        //
+        //  On success events() holds the batch's events in order.
+        //
+        //  A batch after a gap in the sequence, or after a corrupt one,
+        //  is dropped and so is every batch after it until one has
+        //  ResetTables set; needsReset() is true in between. The header
+        //  of a dropped batch is still read (hasHeader() is true) so the
+        //  flags and clock can be used.
+        //
+
+        bool decode(const void* data, size_t size);
+
+        bool hasHeader() const { return m_hasHeader; }
+
+        bool needsReset() const { return m_needsReset; }
+
+        const Header& header() const { return m_header; }
+
+        const SyncBatch::Events& events() const { return m_events; }
+
+        const std::string& error() const { return m_error; }
+
+    private:
+        bool readString(const unsigned char*& p, const unsigned char* end, std::string&);
+
+    private:
+        typedef std::map<std::string, std::string> DeltaMap;
+
+        Header m_header;
+        SyncBatch::Events m_events;
+        std::vector<std::string> m_strings;
+        DeltaMap m_deltas;
+        uint32_t m_lastSequence;
+        bool m_hasHeader;
+        bool m_needsReset;
+        std::string m_error;
+    };
+
+    //
+    //  SyncChannel
+    //
+    //  One end of a batched connection: the encoder and decoder plus the
+    //  clock estimate. Times are SyncBatch::now() values (or any other
+    //  monotonic usec clock, the loopback test uses a virtual one).
+    //
+
+    class SyncChannel
+    {
+    public:
+        SyncChannel();
+
+        //
+        //  Set when the other end said it speaks batches
+        //
+
+        void setPeerVersion(int v) { m_peerVersion = v; }
+
+        int peerVersion() const { return m_peerVersion; }
+
+        bool batching() const { return m_peerVersion >= SyncBatch::Version; }
+
+        void queue(const std::string& name, const std::string& target, const std::string& contents, uint64_t now);
+
+        //
+        //  True if flush() has something to send: queued events, a
+        //  requested ack or table reset, or a clock probe that's due.
+        //
+
+        bool wantsFlush(uint64_t now) const;
+        void flush(uint64_t now, std::string& out);
+
+        bool receive(const void* data, size_t size, uint64_t now);
+
+        const SyncBatch::Events& events() const { return m_decoder.events(); }
+
+        const std::string& error() const { return m_decoder.error(); }
+
+        //
+        //  Seconds between an event of the last received batch being
+        //  queued on the sender and now.
+        //
+
+        double latency(const SyncBatch::Event&, uint64_t now) const;
+
+        //
+        //  Clock estimate: valid once a round trip has been seen. The
+        //  offset is peer clock minus local clock.
+        //
+
+        bool clockValid() const { return m_roundTrip != uint64_t(-1); }
+
+        uint64_t roundTrip() const { return m_roundTrip; }
+
+        int64_t clockOffset() const { return m_offset; }
+
+        const SyncBatchEncoder& encoder() const { return m_encoder; }
+
+    private:
+        struct ClockSample
+        {
+            uint64_t roundTrip;
+            int64_t offset;
+        };
+
+        void addClockSample(uint64_t roundTrip, int64_t offset);
+
+    private:
+        SyncBatchEncoder m_encoder;
+        SyncBatchDecoder m_decoder;
+        int m_peerVersion;
+        bool m_ackPending;
+        bool m_resetPending;   // the peer asked for ResetTables
+        bool m_requestPending; // we need to ask for it
+        uint64_t m_lastProbe;
+        uint64_t m_peerTime;   // last sendTime received
+        uint64_t m_peerTimeAt; // when we received it
+        std::vector<ClockSample> m_samples;
+        size_t m_nextSample;
+        uint64_t m_roundTrip;
+        int64_t m_offset;
+    };
+
+} // namespace TwkQtChat
+
+#endif // __TwkQtChat__SyncBatch__h__
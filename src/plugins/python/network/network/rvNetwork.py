@@ -7,8 +7,10 @@
 from __future__ import print_function
 
 import socket
+import struct
 import sys
 import time
+import zlib
 import six
 
 
@@ -145,6 +147,46 @@ class RvCommunicator:
         """
         self.sendEvent("remote-pyexec", code)
 
+    def _sendData(self, interp, data):
+        """
+        For internal use.  Send a raw data message.
+        """
+        header = "%s %d " % (interp, len(data))
+        self.sock.sendall(six.ensure_binary(header) + data)
+
+    def pixelTileCaps(self):
+        """
+        Ask RV which batched pixel tile transports it supports. Returns
+        a dict like {"version": "1", "compression": "none,zlib", "shm":
+        "1"}, or an empty dict if RV only understands PIXELTILE.
+        """
+        caps = six.ensure_str(self.sendEventAndReturn("pixel-tile-caps", ""))
+        return dict(c.split("=", 1) for c in caps.split() if "=" in c)
+
+    def sendPixelTiles(self, media, tiles, view="-", layer="-", frame=1, compress=False):
+        """
+        Send several tiles of the image source "media" in one PIXELTILES
+        message. tiles is a list of (x, y, width, height, pixels) where
+        pixels is a bytes-like object in the source's pixel format. With
+        compress=True the batch is zlib compressed, which pays off when
+        the network rather than the CPU is the bottleneck.
+        """
+        table = b"".join(struct.pack("<iiIIQ", x, y, w, h, len(p)) for (x, y, w, h, p) in tiles)
+        body = table + b"".join(bytes(t[4]) for t in tiles)
+        encoded = zlib.compress(body, 1) if compress else body
+        header = struct.pack(
+            "<IHHIIQQ",
+            0x54505652,
+            1,
+            1 if compress else 0,
+            len(tiles),
+            0,
+            len(body),
+            len(encoded),
+        )
+        interp = "PIXELTILES(media=%s,view=%s,layer=%s,f=%d)" % (media, view, layer, frame)
+        self._sendData(interp, header + encoded)
+
     def messageAvailable(self):
         """
         Return true iff there is an incomming message waiting.
@@ -0,0 +1,262 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Quality and throughput of PolyphaseResampler against MultiResampler
+//
+//  Each case resamples a few seconds of interleaved audio (every channel
+//  a sine at its own in-band frequency) in device sized packets, the way
+//  ResamplingMovie does, with both resamplers. For each it prints the
+//  time per second of audio and the worst channel's signal to noise
+//  ratio (the sine fitted to the output vs. what's left). When
+//  downsampling it also prints how far a tone between the output and
+//  input Nyquist frequencies is attenuated.
+//
+//  Fails if PolyphaseResampler's output is below the quality threshold
+//  or if it depends on how the input is split into packets.
+//
+//  usage: AudioResamplerTest [seconds]
+//
+
+#include <TwkAudio/PolyphaseResampler.h>
+#include <TwkAudio/Resampler.h>
+#include <TwkUtil/Timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace TwkAudio;
+using namespace std;
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+    const double MinimumSNR = 70.0;            // dB
+    const double MinimumAliasRejection = 60.0; // dB
+    const size_t PacketSize = TWEAK_AUDIO_DEFAULT_PACKET_SIZE;
+
+    struct Case
+    {
+        double inRate;
+        double outRate;
+        int channels;
+    };
+
+    struct Result
+    {
+        double seconds; // per second of input audio
+        double snr;     // worst channel, dB
+    };
+
+    double frequency(int channel, int channels, double inRate, double outRate)
+    {
+        const double nyquist = min(inRate, outRate) / 2.0;
+        return nyquist * (0.02 + 0.8 * double(channel + 1) / double(channels + 1));
+    }
+
+    vector<float> makeInput(const Case& c, size_t frames, bool aboveNyquist)
+    {
+        vector<float> in(frames * c.channels);
+
+        for (int ch = 0; ch < c.channels; ch++)
+        {
+            const double f = aboveNyquist ? (c.outRate + c.inRate) / 4.0 : frequency(ch, c.channels, c.inRate, c.outRate);
+            const double w = 2.0 * Pi * f / c.inRate;
+
+            for (size_t i = 0; i < frames; i++)
+                in[i * c.channels + ch] = float(0.5 * sin(w * double(i)));
+        }
+
+        return in;
+    }
+
+    //
+    //  MultiResampler's scratch buffers only hold about inSize * factor
+    //  samples per channel, so it can't be asked for more than that.
+    //
+
+    size_t outputLimit(const MultiResampler& r, size_t inSize, size_t capacity)
+    {
+        return min(capacity, size_t(double(inSize) * r.factor() + 0.49));
+    }
+
+    size_t outputLimit(const PolyphaseResampler& r, size_t inSize, size_t capacity) { return capacity; }
+
+    //
+    //  Resample in packets. Returns the interleaved output.
+    //
+
+    template <class R> vector<float> run(R& resampler, const vector<float>& in, int channels, size_t packet, double& seconds)
+    {
+        const size_t frames = in.size() / channels;
+        const size_t outPacket = resampler.outputSize(packet) + 64;
+        vector<float> out;
+        vector<float> buffer(outPacket * channels);
+
+        out.reserve(size_t(double(frames) * resampler.factor() + 1024) * channels);
+
+        TwkUtil::Timer timer(true);
+
+        for (size_t i = 0; i < frames; i += packet)
+        {
+            const size_t n = min(packet, frames - i);
+            const size_t written = resampler.process(&in[i * channels], n, &buffer.front(), outputLimit(resampler, n, outPacket), false, false);
+            out.insert(out.end(), buffer.begin(), buffer.begin() + written * channels);
+        }
+
+        seconds = timer.elapsed();
+        return out;
+    }
+
+    //
+    //  Fit a sine at frequency f to one channel (skipping the ends) and
+    //  return signal / residual in dB.
+    //
+
+    double snr(const vector<float>& out, int channels, int ch, double f, double rate, size_t skip)
+    {
+        const size_t frames = out.size() / channels;
+        if (frames <= 2 * skip)
+            return 0.0;
+
+        const double w = 2.0 * Pi * f / rate;
+        double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+
+        for (size_t i = skip; i < frames - skip; i++)
+        {
+            const double s = sin(w * double(i));
+            const double c = cos(w * double(i));
+            const double y = out[i * channels + ch];
+            ss += s * s;
+            sc += s * c;
+            cc += c * c;
+            ys += y * s;
+            yc += y * c;
+        }
+
+        const double det = ss * cc - sc * sc;
+        const double a = (ys * cc - yc * sc) / det;
+        const double b = (yc * ss - ys * sc) / det;
+        double signal = 0, noise = 0;
+
+        for (size_t i = skip; i < frames - skip; i++)
+        {
+            const double fit = a * sin(w * double(i)) + b * cos(w * double(i));
+            const double e = out[i * channels + ch] - fit;
+            signal += fit * fit;
+            noise += e * e;
+        }
+
+        return 10.0 * log10(signal / max(noise, 1e-30));
+    }
+
+    double rms(const vector<float>& out, size_t skip)
+    {
+        double sum = 0;
+        size_t n = 0;
+
+        for (size_t i = skip; i + skip < out.size(); i++, n++)
+            sum += double(out[i]) * double(out[i]);
+
+        return n ? sqrt(sum / double(n)) : 0.0;
+    }
+
+    template <class R> Result measure(const Case& c, const vector<float>& in, size_t frames)
+    {
+        const double factor = c.outRate / c.inRate;
+        R resampler(c.channels, factor, 64);
+        Result r;
+
+        vector<float> out = run(resampler, in, c.channels, PacketSize, r.seconds);
+        r.seconds /= double(frames) / c.inRate;
+        r.snr = 1000.0;
+
+        const size_t skip = resampler.filterWidth() * 2 + 16;
+
+        for (int ch = 0; ch < c.channels; ch++)
+            r.snr = min(r.snr, snr(out, c.channels, ch, frequency(ch, c.channels, c.inRate, c.outRate), c.outRate, skip));
+
+        return r;
+    }
+
+    template <class R> double aliasRejection(const Case& c, size_t frames)
+    {
+        vector<float> in = makeInput(c, frames, true);
+        R resampler(c.channels, c.outRate / c.inRate, 64);
+        double seconds;
+        vector<float> out = run(resampler, in, c.channels, PacketSize, seconds);
+        const size_t skip = (resampler.filterWidth() * 2 + 16) * c.channels;
+
+        return 20.0 * log10(rms(in, 0) / max(rms(out, skip), 1e-15));
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const double duration = argc > 1 ? atof(argv[1]) : 4.0;
+
+    const Case cases[] = {
+        {44100, 48000, 2},  {44100, 48000, 6},       {44100, 48000, 8},  {44100, 48000, 16}, {48000, 44100, 2},
+        {48000, 44100, 6},  {48000, 44100, 16},      {96000, 48000, 6},  {48000, 96000, 8},  {44100, 96000, 2},
+        {192000, 48000, 2}, {48000, 48000 / 1.001, 6}, {44100, 48047.3, 2}, {22050, 48000, 1},
+    };
+
+    bool ok = true;
+
+    printf("%-20s %4s  %12s %12s %8s  %10s %10s  %8s\n", "rates", "ch", "multi ms/s", "poly ms/s", "speedup", "multi dB", "poly dB",
+           "alias dB");
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const Case& c = cases[i];
+        const size_t frames = size_t(duration * c.inRate);
+        vector<float> in = makeInput(c, frames, false);
+
+        const Result multi = measure<MultiResampler>(c, in, frames);
+        const Result poly = measure<PolyphaseResampler>(c, in, frames);
+
+        char rates[64];
+        snprintf(rates, sizeof(rates), "%.0f->%.1f", c.inRate, c.outRate);
+        printf("%-20s %4d  %12.3f %12.3f %7.2fx  %10.1f %10.1f", rates, c.channels, multi.seconds * 1000.0, poly.seconds * 1000.0,
+               multi.seconds / poly.seconds, multi.snr, poly.snr);
+
+        if (poly.snr < MinimumSNR)
+            ok = false;
+
+        if (c.outRate < c.inRate * 0.95)
+        {
+            const double rejection = aliasRejection<PolyphaseResampler>(c, frames);
+            printf("  %8.1f", rejection);
+            if (rejection < MinimumAliasRejection)
+                ok = false;
+        }
+
+        printf("%s\n", poly.snr < MinimumSNR ? "  FAIL" : "");
+
+        //
+        //  The output mustn't depend on the packet size
+        //
+
+        PolyphaseResampler r0(c.channels, c.outRate / c.inRate);
+        PolyphaseResampler r1(c.channels, c.outRate / c.inRate);
+        double seconds;
+        vector<float> out0 = run(r0, in, c.channels, PacketSize, seconds);
+        vector<float> out1 = run(r1, in, c.channels, 333, seconds);
+
+        if (out0.size() != out1.size() || memcmp(&out0.front(), &out1.front(), out0.size() * sizeof(float)) != 0)
+        {
+            printf("    FAIL: output depends on the packet size (%zu vs %zu floats)\n", out0.size(), out1.size());
+            ok = false;
+        }
+    }
+
+    return ok ? 0 : 1;
+}
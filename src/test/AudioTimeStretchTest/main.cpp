@@ -0,0 +1,267 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Cost and quality of TimeStretcher at the usual review speeds
+//
+//  Each case plays a few seconds of interleaved audio (every channel a
+//  tone at the same pitch) at 0.5x to 2x through a TimeStretchStream,
+//  as RetimeIPNode does: the output is asked for in device sized buffers
+//  and each grain reads its input separately. It prints the average and worst time per buffer
+//  (and the worst as a percentage of the buffer's duration, i.e. of the
+//  audio callback's budget) and the signal to noise ratio of a tone at
+//  the original pitch fitted to the output. For comparison it also
+//  prints the SNR without the alignment search, which is what plain
+//  overlap-add of grains gives.
+//
+//  Fails if the output isn't at the original pitch (low SNR), if it
+//  depends on how the output is split into buffers or if the stream
+//  starts over between consecutive buffers.
+//
+//  usage: AudioTimeStretchTest [seconds]
+//
+
+#include <TwkAudio/ScaleTime.h>
+#include <TwkAudio/TimeStretcher.h>
+#include <TwkUtil/Timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace TwkAudio;
+using namespace std;
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+    const double Rate = 48000.0;
+    const double Frequency = 441.7;
+    const double MinimumSNR = 40.0; // dB
+    const size_t BufferSize = TWEAK_AUDIO_DEFAULT_PACKET_SIZE;
+
+    struct Result
+    {
+        double average;  // seconds per buffer
+        double worst;    // seconds per buffer
+        double snr;      // worst channel, dB
+        bool continuous; // no grain was read twice
+    };
+
+    vector<float> makeInput(int channels, size_t frames)
+    {
+        vector<float> in(frames * channels);
+
+        for (int ch = 0; ch < channels; ch++)
+        {
+            const double w = 2.0 * Pi * Frequency / Rate;
+            const double a = 0.5 / (1.0 + 0.1 * ch);
+
+            for (size_t i = 0; i < frames; i++)
+                in[i * channels + ch] = float(a * sin(w * double(i) + 0.3 * ch));
+        }
+
+        return in;
+    }
+
+    //
+    //  The input is a buffer with silence around it. Counts the grains
+    //  read.
+    //
+
+    struct VectorSource : public TimeStretchStream::Source
+    {
+        VectorSource(const vector<float>& in, int channels)
+            : in(in)
+            , channels(channels)
+            , reads(0)
+        {
+        }
+
+        virtual void read(SampleTime start, size_t n, float* out)
+        {
+            const SampleTime frames = in.size() / channels;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                const SampleTime s = start + SampleTime(i);
+                if (s >= 0 && s < frames)
+                    memcpy(out + i * channels, &in[s * channels], channels * sizeof(float));
+            }
+
+            reads++;
+        }
+
+        const vector<float>& in;
+        size_t channels;
+        size_t reads;
+    };
+
+    vector<float> run(int channels, double factor, double search, const vector<float>& in, size_t frames, size_t buffer, Result& r)
+    {
+        TimeStretchStream stream(channels, Rate, 0.040, search);
+        VectorSource source(in, channels);
+        vector<float> out(frames * channels);
+        double total = 0;
+        size_t count = 0;
+        r.worst = 0;
+
+        for (size_t i = 0; i < frames; i += buffer, count++)
+        {
+            const size_t n = min(buffer, frames - i);
+            TwkUtil::Timer timer(true);
+            stream.fill(source, factor, SampleTime(i), n, &out[i * channels]);
+            const double t = timer.elapsed();
+            total += t;
+            r.worst = max(r.worst, t);
+        }
+
+        //
+        //  Every grain is read once, plus the one before the first
+        //
+
+        const size_t hop = stream.stretcher().hopSize();
+        r.average = total / double(count);
+        r.continuous = source.reads == (frames + hop - 1) / hop + 1;
+        return out;
+    }
+
+    //
+    //  Fit a tone at Frequency to each block of one channel (skipping
+    //  the ends) and return signal / residual in dB. Fitting blocks
+    //  rather than the whole thing allows for the phase to wander
+    //  slightly: grains are aligned to the nearest sample, so their
+    //  phase can't always continue exactly.
+    //
+
+    double snr(const vector<float>& out, int channels, int ch, size_t skip)
+    {
+        const size_t frames = out.size() / channels;
+        const size_t block = size_t(Rate * 0.05);
+        const double w = 2.0 * Pi * Frequency / Rate;
+        double signal = 0, noise = 0;
+
+        for (size_t i0 = skip; i0 + block + skip <= frames; i0 += block)
+        {
+            double ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+
+            for (size_t i = i0; i < i0 + block; i++)
+            {
+                const double s = sin(w * double(i));
+                const double c = cos(w * double(i));
+                const double y = out[i * channels + ch];
+                ss += s * s;
+                sc += s * c;
+                cc += c * c;
+                ys += y * s;
+                yc += y * c;
+            }
+
+            const double det = ss * cc - sc * sc;
+            const double a = (ys * cc - yc * sc) / det;
+            const double b = (yc * ss - ys * sc) / det;
+
+            for (size_t i = i0; i < i0 + block; i++)
+            {
+                const double fit = a * sin(w * double(i)) + b * cos(w * double(i));
+                const double e = out[i * channels + ch] - fit;
+                signal += fit * fit;
+                noise += e * e;
+            }
+        }
+
+        return 10.0 * log10(max(signal, 1e-30) / max(noise, 1e-30));
+    }
+
+    double worstSNR(const vector<float>& out, int channels)
+    {
+        double r = 1000.0;
+        for (int ch = 0; ch < channels; ch++)
+            r = min(r, snr(out, channels, ch, size_t(Rate * 0.1)));
+        return r;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const double duration = argc > 1 ? atof(argv[1]) : 4.0;
+    const double factors[] = {0.5, 0.75, 0.9, 1.1, 1.25, 1.5, 2.0};
+    const int channels[] = {2, 6, 8};
+    const double budget = double(BufferSize) / Rate;
+    bool ok = true;
+
+    printf("%6s %4s  %10s %10s %8s  %8s %8s\n", "speed", "ch", "avg ms", "worst ms", "budget", "ola dB", "wsola dB");
+
+    for (size_t j = 0; j < sizeof(channels) / sizeof(channels[0]); j++)
+    {
+        for (size_t i = 0; i < sizeof(factors) / sizeof(factors[0]); i++)
+        {
+            const int ch = channels[j];
+            const double factor = factors[i];
+            const size_t frames = size_t(duration * Rate);
+            vector<float> in = makeInput(ch, size_t(double(frames) * factor) + 4096);
+
+            Result ola, wsola;
+            ola.snr = worstSNR(run(ch, factor, 0.0, in, frames, BufferSize, ola), ch);
+            vector<float> out = run(ch, factor, 0.012, in, frames, BufferSize, wsola);
+            wsola.snr = worstSNR(out, ch);
+
+            printf("%5.2fx %4d  %10.4f %10.4f %7.2f%%  %8.1f %8.1f%s\n", factor, ch, wsola.average * 1000.0, wsola.worst * 1000.0,
+                   100.0 * wsola.worst / budget, ola.snr, wsola.snr, wsola.snr < MinimumSNR ? "  FAIL" : "");
+
+            if (wsola.snr < MinimumSNR)
+                ok = false;
+
+            if (!wsola.continuous)
+            {
+                printf("    FAIL: the stream started over between buffers\n");
+                ok = false;
+            }
+
+            //
+            //  The output mustn't depend on the buffer size
+            //
+
+            Result r;
+            vector<float> out1 = run(ch, factor, 0.012, in, frames, 333, r);
+
+            if (memcmp(&out.front(), &out1.front(), out.size() * sizeof(float)) != 0)
+            {
+                printf("    FAIL: output depends on the buffer size\n");
+                ok = false;
+            }
+        }
+    }
+
+    //
+    //  scaleTime() stretches a whole buffer
+    //
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        const size_t inFrames = size_t(Rate * duration);
+        const size_t outFrames = i == 0 ? inFrames / 2 : inFrames * 2;
+        vector<float> in = makeInput(2, inFrames);
+        AudioBuffer inbuffer(inFrames, Stereo_2, Rate);
+        AudioBuffer outbuffer(outFrames, Stereo_2, Rate);
+        memcpy(inbuffer.pointer(), &in.front(), in.size() * sizeof(float));
+
+        scaleTime(inbuffer, outbuffer);
+
+        vector<float> out(outbuffer.pointer(), outbuffer.pointer() + outFrames * 2);
+        const double s = worstSNR(out, 2);
+        printf("scaleTime %zu -> %zu: %.1f dB%s\n", inFrames, outFrames, s, s < MinimumSNR ? "  FAIL" : "");
+
+        if (s < MinimumSNR)
+            ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,260 @@
+//*****************************************************************************/
+//
+// Filename: TestFastConversion.cpp
+//
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//*****************************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+#include <TwkUtil/Timer.h>
+#include <TwkFB/FastConversion.h>
+#include <TwkFB/FastMemcpy.h>
+#include <TwkFB/SIMD.h>
+#include <TwkFB/TwkFBThreadPool.h>
+
+namespace
+{
+
+    //
+    //  Each kernel is run on a width x height image. The sizes are in
+    //  bytes and the output planes are packed back to back in one buffer.
+    //
+
+    struct Kernel
+    {
+        const char* name;
+        size_t (*inBytes)(size_t width, size_t height);
+        size_t (*outBytes)(size_t width, size_t height);
+        void (*run)(const uint8_t* in, uint8_t* out, size_t width, size_t height);
+    };
+
+    const Kernel kernels[] = {
+        {"convert_ABGR10_to_RGBA10", [](size_t w, size_t h) { return w * h * 4; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         { convert_ABGR10_to_RGBA10(w, h, reinterpret_cast<const uint32_t*>(in), reinterpret_cast<uint32_t*>(out)); }},
+
+        {"swap_bytes_32bit", [](size_t w, size_t h) { return w * h * 4; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         { swap_bytes_32bit(w, h, reinterpret_cast<const uint32_t*>(in), reinterpret_cast<uint32_t*>(out)); }},
+
+        {"subsample422_8bit_UYVY", [](size_t w, size_t h) { return w * h * 3; }, [](size_t w, size_t h) { return w * h * 2; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h) { subsample422_8bit_UYVY(w, h, in, out); }},
+
+        {"packedBGRA64BE_to_packedABGR64LE", [](size_t w, size_t h) { return w * h * 8; }, [](size_t w, size_t h) { return w * h * 8; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             packedBGRA64BE_to_packedABGR64LE(w * 8, h, reinterpret_cast<const uint64_t*>(in), reinterpret_cast<uint64_t*>(out), w * 8);
+         }},
+
+        {"packedUYVY10_to_planarYUV16", [](size_t w, size_t h) { return w / 6 * 16 * h; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             packedUYVY10_to_planarYUV16(w / 6 * 16, h, reinterpret_cast<const uint32_t*>(in), y, y + w * h, y + w * h + w / 2 * h, w * 2,
+                                         w, w);
+         }},
+
+        {"packedUYVY16_to_planarYUV16", [](size_t w, size_t h) { return w * h * 4; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             packedUYVY16_to_planarYUV16(w * 4, h, reinterpret_cast<const uint16_t*>(in), y, y + w * h, y + w * h + w / 2 * h, w * 2, w,
+                                         w);
+         }},
+
+        {"packedUVYA16_to_planarYUVA16", [](size_t w, size_t h) { return w * h * 8; }, [](size_t w, size_t h) { return w * h * 8; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             packedUVYA16_to_planarYUVA16(w * 8, h, reinterpret_cast<const uint64_t*>(in), y, y + w * h, y + 2 * w * h, y + 3 * w * h,
+                                          w * 2, w * 2, w * 2, w * 2);
+         }},
+
+        {"packedAYUV64_to_planarYUVA16", [](size_t w, size_t h) { return w * h * 8; }, [](size_t w, size_t h) { return w * h * 8; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             packedAYUV64_to_planarYUVA16(w, h, in, y, y + w * h, y + 2 * w * h, y + 3 * w * h);
+         }},
+
+        {"planarP210_to_planarYUV422P16", [](size_t w, size_t h) { return w * h * 4; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             const uint16_t* iy = reinterpret_cast<const uint16_t*>(in);
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             planarP210_to_planarYUV422P16(w, h, iy, iy + w * h, w * 2, w * 2, y, y + w * h, y + w * h + w / 2 * h, w * 2, w, w);
+         }},
+
+        {"planarP416_to_planarYUV444P16", [](size_t w, size_t h) { return w * h * 6; }, [](size_t w, size_t h) { return w * h * 6; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             const uint16_t* iy = reinterpret_cast<const uint16_t*>(in);
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             planarP416_to_planarYUV444P16(w, h, iy, iy + w * h, w * 2, w * 4, y, y + w * h, y + 2 * w * h, w * 2, w * 2, w * 2);
+         }},
+
+        {"packedYUV444_10bits_to_P216", [](size_t w, size_t h) { return w * h * 4; }, [](size_t w, size_t h) { return w * h * 4; },
+         [](const uint8_t* in, uint8_t* out, size_t w, size_t h)
+         {
+             uint16_t* y = reinterpret_cast<uint16_t*>(out);
+             packedYUV444_10bits_to_P216(w, h, reinterpret_cast<const uint32_t*>(in), y, y + w * h, w * 4, w * 2, true);
+         }},
+    };
+
+    void fillRandom(std::vector<uint8_t>& buffer)
+    {
+        uint32_t state = 0x12345678;
+        for (size_t i = 0; i < buffer.size(); i++)
+        {
+            state = state * 1664525u + 1013904223u;
+            buffer[i] = uint8_t(state >> 24);
+        }
+    }
+
+    //
+    //  Compare every SIMD level the host supports against the scalar
+    //  version. The odd sizes make sure the scalar tails are exercised.
+    //
+
+    bool checkKernel(const Kernel& kernel, size_t width, size_t height)
+    {
+        std::vector<uint8_t> in(kernel.inBytes(width, height));
+        std::vector<uint8_t> ref(kernel.outBytes(width, height), 0xCD);
+        std::vector<uint8_t> out(ref.size());
+        fillRandom(in);
+
+        TwkFB::setSIMDLevel(TwkFB::SIMDScalar);
+        kernel.run(in.data(), ref.data(), width, height);
+
+        bool ok = true;
+
+        for (int level = TwkFB::SIMDSSE41; level <= TwkFB::detectedSIMDLevel(); level++)
+        {
+            TwkFB::setSIMDLevel(TwkFB::SIMDLevel(level));
+            memset(out.data(), 0xCD, out.size());
+            kernel.run(in.data(), out.data(), width, height);
+
+            if (memcmp(out.data(), ref.data(), out.size()) != 0)
+            {
+                printf("FAILED: %s (%s) differs from scalar for %zux%zu\n", kernel.name, TwkFB::simdLevelName(TwkFB::SIMDLevel(level)),
+                       width, height);
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    //
+    //  The readers swap 16 bit images in place, so check the swap with
+    //  in == out as well as into a separate buffer. The odd widths leave
+    //  a scalar tail after the vector loop.
+    //
+
+    bool checkSwap16(const char* name, void (*swap)(size_t, size_t, const uint16_t*, uint16_t*), size_t width, size_t height)
+    {
+        std::vector<uint8_t> bytes(width * height * sizeof(uint16_t));
+        fillRandom(bytes);
+
+        std::vector<uint16_t> in(width * height);
+        std::vector<uint16_t> ref(in.size());
+        memcpy(in.data(), bytes.data(), bytes.size());
+
+        for (size_t i = 0; i < in.size(); i++)
+            ref[i] = uint16_t((in[i] << 8) | (in[i] >> 8));
+
+        bool ok = true;
+
+        for (int level = TwkFB::SIMDScalar; level <= TwkFB::detectedSIMDLevel(); level++)
+        {
+            TwkFB::setSIMDLevel(TwkFB::SIMDLevel(level));
+
+            std::vector<uint16_t> out(in.size(), 0xCDCD);
+            swap(width, height, in.data(), out.data());
+
+            std::vector<uint16_t> inPlace(in);
+            swap(width, height, inPlace.data(), inPlace.data());
+
+            if (out != ref || inPlace != ref)
+            {
+                printf("FAILED: %s (%s) is wrong %sfor %zux%zu\n", name, TwkFB::simdLevelName(TwkFB::SIMDLevel(level)),
+                       out == ref ? "in place " : "", width, height);
+                ok = false;
+            }
+        }
+
+        return ok;
+    }
+
+    void timeKernel(const Kernel& kernel, size_t width, size_t height, size_t tryCount)
+    {
+        std::vector<uint8_t> in(kernel.inBytes(width, height));
+        std::vector<uint8_t> out(kernel.outBytes(width, height));
+        fillRandom(in);
+
+        for (int level = TwkFB::SIMDScalar; level <= TwkFB::detectedSIMDLevel(); level++)
+        {
+            TwkFB::setSIMDLevel(TwkFB::SIMDLevel(level));
+
+            TwkUtil::Timer timer(true);
+            for (size_t i = 0; i < tryCount; i++)
+                kernel.run(in.data(), out.data(), width, height);
+            printf("%s() %s for 4k frame:%f sec/frame\n", kernel.name, TwkFB::simdLevelName(TwkFB::SIMDLevel(level)),
+                   timer.elapsed() / tryCount);
+        }
+    }
+
+} // namespace
+
+bool TestFastConversion()
+{
+    printf("Test TestFastConversion (host supports %s)\n", TwkFB::simdLevelName(TwkFB::detectedSIMDLevel()));
+
+    const TwkFB::SIMDLevel initialLevel = TwkFB::simdLevel();
+    const size_t kernelCount = sizeof(kernels) / sizeof(kernels[0]);
+    bool ok = true;
+
+    for (size_t i = 0; i < kernelCount; i++)
+    {
+        ok = checkKernel(kernels[i], 1926, 5) && ok;
+        ok = checkKernel(kernels[i], 96, 3) && ok;
+        ok = checkKernel(kernels[i], 6, 2) && ok;
+    }
+
+    const size_t widths[] = {1, 7, 9, 17, 33, 1927};
+
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+        ok = checkSwap16("swap_bytes_16bit", swap_bytes_16bit, widths[i], 3) && ok;
+    }
+
+    //
+    //  swap_bytes_16bit_MP() only splits the work with a thread pool
+    //
+
+    TwkFB::ThreadPool::initialize();
+
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+    {
+        ok = checkSwap16("swap_bytes_16bit_MP", swap_bytes_16bit_MP, widths[i], 37) && ok;
+    }
+
+    TwkFB::ThreadPool::shutdown();
+
+    for (size_t i = 0; i < kernelCount; i++)
+    {
+        timeKernel(kernels[i], 3840, 2160, 20);
+    }
+
+    TwkFB::setSIMDLevel(initialLevel);
+
+    return ok;
+}
@@ -0,0 +1,12 @@
+//*****************************************************************************/
+//
+// Filename: TestFastConversion.h
+//
+// Copyright (c) 2026 Autodesk, Inc.
+// All rights reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+//*****************************************************************************/
+
+bool TestFastConversion();
@@ -5,11 +5,12 @@
 //
 
 #include <TestFastMemcpy.h>
+#include <TestFastConversion.h>
 
 #include <cstdio>
 
 int main(int argc, char* argv[])
 {
     TestFastMemcpy();
-    return 0;
+    return TestFastConversion() ? 0 : 1;
 }
@@ -0,0 +1,339 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  IOhtj2k's reduced resolution and region decoding
+//
+//  Each case encodes a small lossless HTJ2K codestream with OpenJPH
+//  (interleaved and planar, 8, 12 and 16 bits) and reads it back with
+//  IOhtj2k. The full decode has to give back every sample written. A
+//  decode which skips resolution levels has to have the reduced size,
+//  and a region at full or reduced resolution has to be the clipped
+//  region of the decode at that level, with the data window placing it
+//  in the image.
+//
+//  Image sizes are odd so the reduced sizes round up.
+//
+//  usage: HTJ2KReadTest [directory]
+//
+
+#include <IOhtj2k/IOhtj2k.h>
+#include <TwkFB/FrameBuffer.h>
+#include <openjph/ojph_codestream.h>
+#include <openjph/ojph_file.h>
+#include <openjph/ojph_mem.h>
+#include <openjph/ojph_params.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace TwkFB;
+using namespace std;
+
+namespace
+{
+    struct Case
+    {
+        const char* name;
+        int width;
+        int height;
+        int channels;
+        int bits; // 8, 12 or 16
+        bool planar;
+        int decompositions;
+    };
+
+    struct Region
+    {
+        int x0, y0, x1, y1; // full resolution, from the top left, inclusive
+    };
+
+    int sampleValue(const Case& t, int x, int y, int c)
+    {
+        return (x * 3 + y * 5 + c * 40 + ((x * y) & 15)) & ((1 << t.bits) - 1);
+    }
+
+    //
+    //  IOhtj2k shifts 10 and 12 bit samples to the top of a short
+    //
+
+    int storedValue(const Case& t, int v) { return t.bits == 12 ? v << 4 : v; }
+
+    bool writeJ2C(const Case& t, const string& filename)
+    {
+        ojph::codestream codestream;
+
+        ojph::param_siz siz = codestream.access_siz();
+        siz.set_image_extent(ojph::point(t.width, t.height));
+        siz.set_num_components(t.channels);
+        for (int c = 0; c < t.channels; c++)
+            siz.set_component(c, ojph::point(1, 1), t.bits, false);
+        siz.set_image_offset(ojph::point(0, 0));
+        siz.set_tile_size(ojph::size(0, 0));
+        siz.set_tile_offset(ojph::point(0, 0));
+
+        ojph::param_cod cod = codestream.access_cod();
+        cod.set_num_decomposition(t.decompositions);
+        cod.set_block_dims(32, 32);
+        cod.set_color_transform(t.channels == 3 && !t.planar);
+        cod.set_reversible(true);
+        codestream.set_planar(t.planar);
+
+        ojph::j2c_outfile file;
+        file.open(filename.c_str());
+        codestream.write_headers(&file);
+
+        ojph::ui32 c;
+        ojph::line_buf* line = codestream.exchange(NULL, c);
+        const int lines = t.height * t.channels;
+
+        for (int i = 0; i < lines; i++)
+        {
+            //
+            //  Planar codestreams take all of a component's lines
+            //  first, interleaved ones a line of each in turn
+            //
+
+            const int y = t.planar ? i % t.height : i / t.channels;
+
+            for (int x = 0; x < t.width; x++)
+                line->i32[x] = sampleValue(t, x, y, int(c));
+
+            line = codestream.exchange(line, c);
+        }
+
+        codestream.flush();
+        codestream.close();
+        return true;
+    }
+
+    int readSample(const Case& t, const FrameBuffer& fb, int x, int y, int c)
+    {
+        if (t.bits == 8)
+            return fb.scanline<unsigned char>(y)[x * t.channels + c];
+        return fb.scanline<unsigned short>(y)[x * t.channels + c];
+    }
+
+    bool read(const Case& t, const string& filename, int level, const Region* region, FrameBuffer& fb, const char* label)
+    {
+        FrameBufferIO::ReadRequest request;
+        request.levelX = level;
+        request.levelY = level;
+
+        if (region)
+        {
+            request.x0 = region->x0;
+            request.y0 = region->y0;
+            request.x1 = region->x1;
+            request.y1 = region->y1;
+        }
+
+        try
+        {
+            IOhtj2k io;
+            io.readImage(fb, filename, request);
+        }
+        catch (std::exception& e)
+        {
+            printf("FAIL %s: %s\n", label, e.what());
+            return false;
+        }
+
+        if (fb.numChannels() != t.channels || fb.orientation() != FrameBuffer::TOPLEFT)
+        {
+            printf("FAIL %s: %d channels, orientation %d\n", label, fb.numChannels(), int(fb.orientation()));
+            return false;
+        }
+
+        return true;
+    }
+
+    //
+    //  The whole image at full resolution: exactly what was written
+    //
+
+    bool checkFull(const Case& t, const string& filename, FrameBuffer& full)
+    {
+        const string label = string(t.name) + " full";
+
+        if (!read(t, filename, 0, 0, full, label.c_str()))
+            return false;
+
+        if (full.width() != t.width || full.height() != t.height || full.uncrop())
+        {
+            printf("FAIL %s: read %dx%d%s, expected %dx%d\n", label.c_str(), full.width(), full.height(),
+                   full.uncrop() ? " with a data window" : "", t.width, t.height);
+            return false;
+        }
+
+        for (int y = 0; y < t.height; y++)
+        {
+            for (int x = 0; x < t.width; x++)
+            {
+                for (int c = 0; c < t.channels; c++)
+                {
+                    const int expected = storedValue(t, sampleValue(t, x, y, c));
+                    const int actual = readSample(t, full, x, y, c);
+
+                    if (actual != expected)
+                    {
+                        printf("FAIL %s: channel %d at %d, %d is %d, expected %d\n", label.c_str(), c, x, y, actual, expected);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    //
+    //  A level's whole image: each level halves the size of the one
+    //  above, rounding up
+    //
+
+    bool checkLevel(const Case& t, const string& filename, int level, FrameBuffer& fb)
+    {
+        const string label = string(t.name) + " level " + to_string(level);
+
+        if (!read(t, filename, level, 0, fb, label.c_str()))
+            return false;
+
+        const int width = (t.width + (1 << level) - 1) >> level;
+        const int height = (t.height + (1 << level) - 1) >> level;
+
+        if (fb.width() != width || fb.height() != height || fb.uncrop())
+        {
+            printf("FAIL %s: read %dx%d%s, expected %dx%d\n", label.c_str(), fb.width(), fb.height(),
+                   fb.uncrop() ? " with a data window" : "", width, height);
+            return false;
+        }
+
+        return true;
+    }
+
+    //
+    //  A region of a level against the whole of that level
+    //
+
+    bool checkRegion(const Case& t, const string& filename, int level, const Region& region, const FrameBuffer& whole)
+    {
+        char label[128];
+        snprintf(label, sizeof(label), "%s level %d region %d %d %d %d", t.name, level, region.x0, region.y0, region.x1,
+                 region.y1);
+
+        FrameBuffer fb;
+
+        if (!read(t, filename, level, &region, fb, label))
+            return false;
+
+        const int w = whole.width();
+        const int h = whole.height();
+        const int x0 = max(0, region.x0 >> level);
+        const int y0 = max(0, region.y0 >> level);
+        const int x1 = min(w - 1, region.x1 >> level);
+        const int y1 = min(h - 1, region.y1 >> level);
+        const int width = x1 - x0 + 1;
+        const int height = y1 - y0 + 1;
+
+        if (fb.width() != width || fb.height() != height)
+        {
+            printf("FAIL %s: read %dx%d, expected %dx%d\n", label, fb.width(), fb.height(), width, height);
+            return false;
+        }
+
+        if (width != w || height != h)
+        {
+            if (!fb.uncrop() || fb.uncropWidth() != w || fb.uncropHeight() != h || fb.uncropX() != x0 || fb.uncropY() != y0)
+            {
+                printf("FAIL %s: data window %d %d in %dx%d, expected %d %d in %dx%d\n", label, fb.uncropX(), fb.uncropY(),
+                       fb.uncropWidth(), fb.uncropHeight(), x0, y0, w, h);
+                return false;
+            }
+        }
+
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                for (int c = 0; c < t.channels; c++)
+                {
+                    const int expected = readSample(t, whole, x0 + x, y0 + y, c);
+                    const int actual = readSample(t, fb, x, y, c);
+
+                    if (actual != expected)
+                    {
+                        printf("FAIL %s: channel %d at %d, %d is %d, expected %d\n", label, c, x0 + x, y0 + y, actual,
+                               expected);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const string dir = argc > 1 ? argv[1] : ".";
+
+    const Case cases[] = {
+        {"rgb8 interleaved", 203, 117, 3, 8, false, 5},
+        {"gray12 planar", 151, 97, 1, 12, true, 4},
+        {"rgb16 planar", 77, 61, 3, 16, true, 3},
+    };
+
+    int failures = 0;
+    int checks = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const Case& t = cases[i];
+        const string filename = dir + "/HTJ2KReadTest." + to_string(i) + ".j2c";
+
+        if (!writeJ2C(t, filename))
+        {
+            printf("FAIL %s: couldn't write %s\n", t.name, filename.c_str());
+            failures++;
+            continue;
+        }
+
+        const Region regions[] = {
+            {5, 3, 5, 3},                                       // one pixel
+            {10, 7, t.width / 2, t.height / 2},                 // inside
+            {t.width - 9, t.height - 4, t.width - 1, t.height - 1}, // bottom right corner
+            {t.width / 3, -5, t.width + 40, t.height / 4},      // past the edges
+        };
+
+        for (int level = 0; level <= 2; level++)
+        {
+            FrameBuffer whole;
+
+            checks++;
+            if (!(level == 0 ? checkFull(t, filename, whole) : checkLevel(t, filename, level, whole)))
+            {
+                failures++;
+                continue;
+            }
+
+            for (size_t r = 0; r < sizeof(regions) / sizeof(regions[0]); r++)
+            {
+                checks++;
+                if (!checkRegion(t, filename, level, regions[r], whole))
+                    failures++;
+            }
+        }
+
+        remove(filename.c_str());
+    }
+
+    printf("%d of %d reads failed\n", failures, checks);
+    return failures == 0 ? 0 : 1;
+}
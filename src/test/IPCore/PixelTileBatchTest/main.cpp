@@ -0,0 +1,398 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <IPCore/PixelTileBatch.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+
+using namespace std;
+using namespace IPCore;
+
+//
+//  Batches and rings come from other processes (possibly over the
+//  network), so every field of a header has to be treated as hostile.
+//
+
+namespace
+{
+    typedef PixelTileBatch::BatchHeader BatchHeader;
+    typedef PixelTileBatch::TileHeader TileHeader;
+
+    vector<char> makeBody(size_t numTiles, size_t tileSize)
+    {
+        vector<char> body(numTiles * (sizeof(TileHeader) + tileSize));
+
+        for (size_t i = 0; i < numTiles; i++)
+        {
+            TileHeader t = {int32_t(i * 4), 0, 2, 2, tileSize};
+            memcpy(&body[i * sizeof(TileHeader)], &t, sizeof(t));
+            memset(&body[numTiles * sizeof(TileHeader) + i * tileSize], int(i + 1), tileSize);
+        }
+
+        return body;
+    }
+
+    BatchHeader makeHeader(size_t numTiles, uint64_t bodySize, uint64_t encodedSize, uint16_t compression)
+    {
+        BatchHeader h;
+        memset(&h, 0, sizeof(h));
+        h.magic = PixelTileBatch::Magic;
+        h.version = PixelTileBatch::Version;
+        h.compression = compression;
+        h.numTiles = uint32_t(numTiles);
+        h.bodySize = bodySize;
+        h.encodedSize = encodedSize;
+        return h;
+    }
+
+    vector<char> makeBatch(const BatchHeader& h, const vector<char>& encoded)
+    {
+        vector<char> batch(sizeof(h) + encoded.size());
+        memcpy(&batch[0], &h, sizeof(h));
+        if (!encoded.empty())
+            memcpy(&batch[sizeof(h)], &encoded[0], encoded.size());
+        return batch;
+    }
+
+    vector<char> compress(const vector<char>& body)
+    {
+        uLongf n = compressBound(uLong(body.size()));
+        vector<char> out(n);
+        ::compress((Bytef*)&out[0], &n, (const Bytef*)&body[0], uLong(body.size()));
+        out.resize(n);
+        return out;
+    }
+
+    bool decode(PixelTileBatch& batch, const vector<char>& data) { return batch.decode(data.empty() ? 0 : &data[0], data.size()); }
+
+    string ringName(const char* what)
+    {
+        char name[128];
+        snprintf(name, sizeof(name), "/rvPixelTileBatchTest-%d-%s", int(getpid()), what);
+        return name;
+    }
+
+    //
+    //  Makes a segment holding whatever ring header we like, the way a
+    //  broken or malicious client could
+    //
+
+    void makeSegment(const string& name, const PixelTileRing::RingHeader& header, size_t capacity)
+    {
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        REQUIRE(fd >= 0);
+        REQUIRE(ftruncate(fd, off_t(PixelTileRing::DataOffset + capacity)) == 0);
+        void* p = mmap(0, PixelTileRing::DataOffset + capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        REQUIRE(p != MAP_FAILED);
+        memcpy(p, &header, sizeof(header));
+        munmap(p, PixelTileRing::DataOffset + capacity);
+    }
+
+    PixelTileRing::RingHeader ringHeader(uint64_t capacity)
+    {
+        PixelTileRing::RingHeader h;
+        memset(&h, 0, sizeof(h));
+        h.magic = PixelTileRing::Magic;
+        h.version = PixelTileRing::Version;
+        h.capacity = capacity;
+        return h;
+    }
+
+} // namespace
+
+TEST_CASE("decode a valid uncompressed batch")
+{
+    vector<char> body = makeBody(3, 16);
+    vector<char> data = makeBatch(makeHeader(3, body.size(), body.size(), PixelTileBatch::NoCompression), body);
+    PixelTileBatch batch;
+
+    //
+    //  Uncompressed tiles point into the message
+    //
+
+    REQUIRE(decode(batch, data));
+    REQUIRE_EQ(batch.tiles().size(), 3u);
+    CHECK_EQ(batch.tiles()[0].pixels, (const void*)&data[sizeof(BatchHeader) + 3 * sizeof(TileHeader)]);
+    CHECK_EQ(batch.tiles()[2].x, 8);
+    CHECK_EQ(batch.tiles()[2].size, 16u);
+    CHECK_EQ(((const char*)batch.tiles()[2].pixels)[15], 3);
+}
+
+TEST_CASE("decode a valid compressed batch")
+{
+    vector<char> body = makeBody(2, 1000);
+    vector<char> encoded = compress(body);
+    PixelTileBatch batch;
+
+    REQUIRE(decode(batch, makeBatch(makeHeader(2, body.size(), encoded.size(), PixelTileBatch::ZLibCompression), encoded)));
+    REQUIRE_EQ(batch.tiles().size(), 2u);
+    CHECK_EQ(((const char*)batch.tiles()[1].pixels)[999], 2);
+}
+
+TEST_CASE("reject truncated and foreign data")
+{
+    vector<char> body = makeBody(1, 4);
+    vector<char> data = makeBatch(makeHeader(1, body.size(), body.size(), PixelTileBatch::NoCompression), body);
+    PixelTileBatch batch;
+
+    CHECK_FALSE(batch.decode(0, 0));
+    CHECK_FALSE(batch.decode(&data[0], sizeof(BatchHeader) - 1));
+    CHECK_FALSE(batch.decode(&data[0], data.size() - 1));
+
+    BatchHeader h = makeHeader(1, body.size(), body.size(), PixelTileBatch::NoCompression);
+    h.magic = 0;
+    CHECK_FALSE(decode(batch, makeBatch(h, body)));
+
+    h = makeHeader(1, body.size(), body.size(), PixelTileBatch::NoCompression);
+    h.version = PixelTileBatch::Version + 1;
+    CHECK_FALSE(decode(batch, makeBatch(h, body)));
+
+    h = makeHeader(1, body.size(), body.size(), 7);
+    CHECK_FALSE(decode(batch, makeBatch(h, body)));
+    CHECK(batch.tiles().empty());
+}
+
+TEST_CASE("reject an empty body")
+{
+    PixelTileBatch batch;
+    vector<char> none;
+
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0, 0, 0, PixelTileBatch::NoCompression), none)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0, 0, 0, PixelTileBatch::ZLibCompression), none)));
+
+    vector<char> junk(8, 'x');
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0, 0, junk.size(), PixelTileBatch::ZLibCompression), junk)));
+}
+
+TEST_CASE("reject impossible sizes before allocating")
+{
+    PixelTileBatch batch;
+    vector<char> tiny(16, 0);
+
+    //
+    //  A 16 byte message claiming to inflate to 2GB (or more)
+    //
+
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(1, uint64_t(1) << 31, tiny.size(), PixelTileBatch::ZLibCompression), tiny)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(1, ~uint64_t(0), tiny.size(), PixelTileBatch::ZLibCompression), tiny)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(1, tiny.size() * 2000, tiny.size(), PixelTileBatch::ZLibCompression), tiny)));
+
+    //
+    //  Uncompressed sizes which disagree with the message
+    //
+
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0, tiny.size() + 1, tiny.size(), PixelTileBatch::NoCompression), tiny)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0, tiny.size(), tiny.size() + 1, PixelTileBatch::NoCompression), tiny)));
+}
+
+TEST_CASE("reject corrupt compressed data")
+{
+    vector<char> body = makeBody(2, 100);
+    vector<char> encoded = compress(body);
+    PixelTileBatch batch;
+
+    vector<char> corrupt = encoded;
+    corrupt[corrupt.size() / 2] ^= 0x5a;
+    corrupt[2] ^= 0xff;
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(2, body.size(), corrupt.size(), PixelTileBatch::ZLibCompression), corrupt)));
+
+    //
+    //  Inflates to a different size than it claims
+    //
+
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(2, body.size() + 1, encoded.size(), PixelTileBatch::ZLibCompression), encoded)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(2, body.size() - 1, encoded.size(), PixelTileBatch::ZLibCompression), encoded)));
+}
+
+TEST_CASE("reject tile tables which don't fit the body")
+{
+    vector<char> body = makeBody(2, 16);
+    PixelTileBatch batch;
+
+    //
+    //  More tile headers than the body can hold
+    //
+
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(1000, body.size(), body.size(), PixelTileBatch::NoCompression), body)));
+    CHECK_FALSE(decode(batch, makeBatch(makeHeader(0xffffffff, body.size(), body.size(), PixelTileBatch::NoCompression), body)));
+
+    //
+    //  Tiles whose data runs past the end, including sizes which would
+    //  wrap the offset around
+    //
+
+    const uint64_t sizes[] = {17, 1000, ~uint64_t(0), ~uint64_t(0) - sizeof(TileHeader) * 2 + 1};
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        vector<char> bad = body;
+        TileHeader t;
+        memcpy(&t, &bad[sizeof(TileHeader)], sizeof(t));
+        t.size = sizes[i];
+        memcpy(&bad[sizeof(TileHeader)], &t, sizeof(t));
+        CHECK_FALSE(decode(batch, makeBatch(makeHeader(2, bad.size(), bad.size(), PixelTileBatch::NoCompression), bad)));
+        CHECK(batch.tiles().empty());
+    }
+}
+
+TEST_CASE("ring round trip")
+{
+    const string name = ringName("roundtrip");
+    string error;
+    shm_unlink(name.c_str());
+
+    PixelTileRing* producer = PixelTileRing::create(name, 4096, error);
+    REQUIRE(producer);
+    PixelTileRing* consumer = PixelTileRing::attach(name, error);
+    REQUIRE(consumer);
+    CHECK_EQ(consumer->capacity(), 4096u);
+
+    for (size_t i = 0; i < 10; i++)
+    {
+        PixelTileBatch::RingSpan span;
+        char* p = producer->reserve(1000, span);
+        REQUIRE(p);
+        memset(p, int(i), 1000);
+        producer->commit(span);
+
+        const char* q = consumer->data(span);
+        REQUIRE(q);
+        CHECK_EQ(q[999], char(i));
+        consumer->release(span);
+    }
+
+    CHECK_FALSE(consumer->stale());
+    delete consumer;
+    delete producer;
+}
+
+TEST_CASE("ring rejects spans outside the written region")
+{
+    const string name = ringName("spans");
+    string error;
+    shm_unlink(name.c_str());
+
+    PixelTileRing* producer = PixelTileRing::create(name, 4096, error);
+    REQUIRE(producer);
+    PixelTileRing* consumer = PixelTileRing::attach(name, error);
+    REQUIRE(consumer);
+
+    PixelTileBatch::RingSpan span;
+    REQUIRE(producer->reserve(1000, span));
+    producer->commit(span);
+
+    PixelTileBatch::RingSpan bad = {0, 1001};
+    CHECK_FALSE(consumer->data(bad));
+    bad.offset = 1000;
+    bad.size = 1;
+    CHECK_FALSE(consumer->data(bad));
+    bad.offset = ~uint64_t(0) - 10;
+    bad.size = 20;
+    CHECK_FALSE(consumer->data(bad));
+    bad.offset = 500;
+    bad.size = ~uint64_t(0) - 100;
+    CHECK_FALSE(consumer->data(bad));
+    CHECK(consumer->data(span));
+
+    delete consumer;
+    delete producer;
+}
+
+TEST_CASE("ring attach rejects bad capacities")
+{
+    const string name = ringName("capacity");
+    string error;
+
+    makeSegment(name, ringHeader(0), 4096);
+    CHECK_FALSE(PixelTileRing::attach(name, error));
+
+    makeSegment(name, ringHeader(4097), 4096);
+    CHECK_FALSE(PixelTileRing::attach(name, error));
+
+    makeSegment(name, ringHeader(~uint64_t(0)), 4096);
+    CHECK_FALSE(PixelTileRing::attach(name, error));
+
+    PixelTileRing::RingHeader h = ringHeader(4096);
+    h.magic = 0;
+    makeSegment(name, h, 4096);
+    CHECK_FALSE(PixelTileRing::attach(name, error));
+
+    shm_unlink(name.c_str());
+}
+
+TEST_CASE("ring ignores capacity changes after attach")
+{
+    const string name = ringName("grow");
+    string error;
+    PixelTileRing::RingHeader h = ringHeader(4096);
+    h.head = 4096;
+    makeSegment(name, h, 4096);
+
+    PixelTileRing* consumer = PixelTileRing::attach(name, error);
+    REQUIRE(consumer);
+
+    //
+    //  The client enlarges (or zeroes) the capacity behind our back
+    //
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    REQUIRE(fd >= 0);
+    PixelTileRing::RingHeader* shared =
+        (PixelTileRing::RingHeader*)mmap(0, PixelTileRing::DataOffset + 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    REQUIRE(shared != MAP_FAILED);
+
+    shared->capacity = uint64_t(1) << 40;
+    shared->head = uint64_t(1) << 39;
+    PixelTileBatch::RingSpan span = {0, uint64_t(1) << 30};
+    CHECK_FALSE(consumer->data(span));
+    CHECK_EQ(consumer->capacity(), 4096u);
+
+    shared->capacity = 0;
+    span.size = 100;
+    CHECK(consumer->data(span));
+
+    munmap(shared, PixelTileRing::DataOffset + 4096);
+    delete consumer;
+    shm_unlink(name.c_str());
+}
+
+TEST_CASE("ring goes stale when the producer closes or recreates it")
+{
+    const string name = ringName("stale");
+    string error;
+    shm_unlink(name.c_str());
+
+    PixelTileRing* producer = PixelTileRing::create(name, 4096, error);
+    REQUIRE(producer);
+    PixelTileRing* consumer = PixelTileRing::attach(name, error);
+    REQUIRE(consumer);
+    CHECK_FALSE(consumer->stale());
+
+    delete producer;
+    CHECK(consumer->stale());
+
+    producer = PixelTileRing::create(name, 4096, error);
+    REQUIRE(producer);
+    CHECK(consumer->stale());
+
+    PixelTileRing* again = PixelTileRing::attach(name, error);
+    REQUIRE(again);
+    CHECK_FALSE(again->stale());
+
+    delete again;
+    delete consumer;
+    delete producer;
+}
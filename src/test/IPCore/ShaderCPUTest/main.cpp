@@ -0,0 +1,662 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+#include <IPCore/Application.h>
+#include <IPCore/IPGraph.h>
+#include <IPCore/IPImage.h>
+#include <IPCore/IPNode.h>
+#include <IPCore/NodeDefinition.h>
+#include <IPCore/ShaderCPU.h>
+#include <IPCore/ShaderCommon.h>
+#include <IPCore/ShaderFunction.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/SIMD.h>
+#include <TwkMath/Mat44.h>
+#include <TwkMath/MatrixColor.h>
+#include <TwkMath/Vec3.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+using namespace std;
+using namespace IPCore;
+using namespace TwkMath;
+using IPCore::Shader::Expression;
+using TwkFB::FrameBuffer;
+
+//
+//  evaluateOnCPU() has to give the same pixels as the GLSL functions it
+//  replaces. Each case runs a colour chain through it at every SIMD
+//  level and compares the result to a double precision transcription
+//  of the GLSL source (glsl/*.glsl). The image is wider than a strip
+//  and taller than a band, and its width isn't a multiple of four, so
+//  the partial vectors and the task pool are covered too.
+//
+
+namespace
+{
+    const int Width = 131;
+    const int Height = 71;
+
+    //
+    //  The kernels' pow, log and exp approximations are good to about
+    //  1e-6. Errors are relative to the value (absolute below 1).
+    //
+
+    const double Tolerance = 2e-5;
+
+    struct Pixel
+    {
+        double c[4];
+    };
+
+    typedef function<Expression*(IPImage*, Expression*)> Chain;
+    typedef function<void(Pixel&)> Reference;
+
+    //
+    //  Source expressions name their image's node in their hashes. The
+    //  graph's cache needs an Application.
+    //
+
+    struct TestGraph
+    {
+        TestGraph()
+            : app()
+            , graph(0)
+            , definition("CPUShaderTest", 1, false, "cpuShaderTest", newIPNode<IPNode>, "", "", NodeDefinition::ByteVector())
+            , node(new IPNode("cpuShaderTest", &definition, &graph))
+        {
+        }
+
+        ~TestGraph() { delete node; }
+
+        Application app;
+        IPGraph graph;
+        NodeDefinition definition;
+        IPNode* node;
+    };
+
+    const IPNode* testNode()
+    {
+        static TestGraph g;
+        return g.node;
+    }
+
+    float inputValue(int x, int y, int c)
+    {
+        //
+        //  Deterministic noise. RGB in [-0.1, 1.3], alpha in [0.05, 1]
+        //  or exactly 0 on every seventh pixel.
+        //
+
+        unsigned int h = unsigned(x) * 73856093u ^ unsigned(y) * 19349663u ^ unsigned(c) * 83492791u;
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+        const float u = float(h & 0xffff) / 65535.0f;
+
+        if (c < 3)
+            return u * 1.4f - 0.1f;
+        return (x + y * Width) % 7 == 0 ? 0.0f : 0.05f + u * 0.95f;
+    }
+
+    double clamp01(double x) { return std::min(std::max(x, 0.0), 1.0); }
+
+    //
+    //  M * (r, g, b, w) as in the GLSL: a Mat44f is row major and
+    //  uploaded so that M * v is the same product in the shader.
+    //
+
+    void multiply(const Mat44f& M, Pixel& p, bool fourD)
+    {
+        const double v[4] = {p.c[0], p.c[1], p.c[2], fourD ? p.c[3] : 1.0};
+        double r[4];
+
+        for (int i = 0; i < 4; i++)
+        {
+            r[i] = M(i, 0) * v[0] + M(i, 1) * v[1] + M(i, 2) * v[2] + M(i, 3) * v[3];
+        }
+
+        for (int i = 0; i < (fourD ? 4 : 3); i++)
+            p.c[i] = r[i];
+    }
+
+    //
+    //  ColorSRGBLinear, ColorLinearSRGB, ColorRec709Linear and
+    //  ColorLinearRec709
+    //
+
+    double toLinear(double c, double a, double b, double p, double g)
+    {
+        c = std::max(c, 0.0);
+        return c <= p ? c / b : pow((c + a) / (1.0 + a), g);
+    }
+
+    double fromLinear(double c, double a, double b, double q, double g)
+    {
+        c = std::max(c, 0.0);
+        return c <= q ? c * b : (1.0 + a) * pow(c, g) - a;
+    }
+
+    //
+    //  ColorCDL_SAT: the saturation matrix is built from the Rec.709
+    //  luma weights
+    //
+
+    void cdlSat(Pixel& p, const Vec3f& slope, const Vec3f& offset, const Vec3f& power, double s)
+    {
+        const Mat44f Y = Rec709FullRangeRGBToYUV8<float>();
+        double c[3];
+
+        for (int i = 0; i < 3; i++)
+            c[i] = pow(clamp01(p.c[i] * slope[i] + offset[i]), double(power[i]));
+
+        const double luma = Y.m00 * c[0] + Y.m01 * c[1] + Y.m02 * c[2];
+
+        for (int i = 0; i < 3; i++)
+            p.c[i] = clamp01((1.0 - s) * luma + s * c[i]);
+    }
+
+    //
+    //  Runs chain on the CPU at the current SIMD level and returns the
+    //  largest error against reference
+    //
+
+    double evaluate(const Chain& chain, const Reference& reference)
+    {
+        FrameBuffer* fb = new FrameBuffer(Width, Height, 4, FrameBuffer::FLOAT);
+
+        for (int y = 0; y < Height; y++)
+        {
+            float* p = fb->scanline<float>(y);
+            for (int x = 0; x < Width; x++)
+                for (int c = 0; c < 4; c++)
+                    p[x * 4 + c] = inputValue(x, y, c);
+        }
+
+        IPImage* image = new IPImage(testNode(), IPImage::BlendRenderType, Width, Height);
+        image->fb = fb;
+        image->shaderExpr = chain(image, Shader::newSourceRGBA(image));
+
+        vector<FrameBuffer*> cachedFBs;
+        REQUIRE(Shader::evaluateOnCPU(image, cachedFBs) == 1);
+        CHECK(cachedFBs.empty());
+
+        //
+        //  The whole chain is supported so only a source of the result
+        //  is left for the GPU
+        //
+
+        CHECK(image->shaderExpr->function()->name() == "SourceRGBA");
+        REQUIRE(image->fb != fb);
+        REQUIRE(image->fb->dataType() == FrameBuffer::FLOAT);
+        REQUIRE(image->fb->numChannels() == 4);
+
+        double worst = 0.0;
+
+        for (int y = 0; y < Height; y++)
+        {
+            const float* p = image->fb->scanline<float>(y);
+
+            for (int x = 0; x < Width; x++)
+            {
+                Pixel expected;
+                for (int c = 0; c < 4; c++)
+                    expected.c[c] = inputValue(x, y, c);
+                reference(expected);
+
+                for (int c = 0; c < 4; c++)
+                {
+                    const double e = fabs(double(p[x * 4 + c]) - expected.c[c]) / std::max(1.0, fabs(expected.c[c]));
+                    worst = std::max(worst, e);
+                }
+            }
+        }
+
+        delete image;
+        return worst;
+    }
+
+    //
+    //  Checks chain at the scalar level and the widest the host has
+    //
+
+    void check(const Chain& chain, const Reference& reference)
+    {
+        //
+        //  There's no GL context to ask for the version when the
+        //  Functions are created
+        //
+
+        Shader::Function::useShadingLanguageVersion("1.50");
+
+        const TwkFB::SIMDLevel previous = TwkFB::simdLevel();
+        vector<TwkFB::SIMDLevel> levels(1, TwkFB::SIMDScalar);
+
+        if (TwkFB::detectedSIMDLevel() != TwkFB::SIMDScalar)
+            levels.push_back(TwkFB::detectedSIMDLevel());
+
+        for (size_t i = 0; i < levels.size(); i++)
+        {
+            TwkFB::setSIMDLevel(levels[i]);
+            const double e = evaluate(chain, reference);
+            MESSAGE(TwkFB::simdLevelName(levels[i]) << ": max error " << e);
+            CHECK(e <= Tolerance);
+        }
+
+        TwkFB::setSIMDLevel(previous);
+    }
+
+} // namespace
+
+TEST_CASE("matrix, CDL with saturation and linear to sRGB")
+{
+    const Mat44f M(0.9f, 0.08f, 0.02f, 0.01f, 0.05f, 1.1f, -0.05f, 0.0f, 0.01f, 0.02f, 0.95f, -0.02f, 0.0f, 0.0f, 0.0f, 1.0f);
+    const Vec3f slope(1.1f, 0.95f, 1.2f);
+    const Vec3f offset(0.02f, -0.01f, 0.0f);
+    const Vec3f power(0.8f, 1.0f, 1.3f);
+    const float sat = 0.75f;
+
+    check(
+        [&](IPImage*, Expression* e)
+        {
+            e = Shader::newColorMatrix(e, M);
+            e = Shader::newColorCDL(e, slope, offset, power, sat, false);
+            return Shader::newColorLinearToSRGB(e);
+        },
+        [&](Pixel& p)
+        {
+            multiply(M, p, false);
+            cdlSat(p, slope, offset, power, sat);
+            for (int c = 0; c < 3; c++)
+                p.c[c] = fromLinear(p.c[c], 0.055, 12.92, 0.0031308, 1.0 / 2.4);
+        });
+}
+
+TEST_CASE("sRGB to linear, gamma and linear to Rec.709")
+{
+    const Vec3f gamma(1.2f, 0.9f, 1.05f);
+
+    check(
+        [&](IPImage*, Expression* e)
+        {
+            e = Shader::newColorSRGBToLinear(e);
+            e = Shader::newColorGamma(e, gamma);
+            return Shader::newColorLinearToRec709(e);
+        },
+        [&](Pixel& p)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                p.c[c] = toLinear(p.c[c], 0.055, 12.92, 0.04045, 2.4);
+                p.c[c] = pow(std::max(p.c[c], 0.0), double(gamma[c]));
+                p.c[c] = fromLinear(p.c[c], 0.099, 4.5, 0.018, 0.45);
+            }
+        });
+}
+
+TEST_CASE("Rec.709 to linear, unpremult, 4D matrix, premult, clamp and opacity")
+{
+    const Mat44f M(1.05f, 0.0f, 0.0f, 0.0f, 0.0f, 0.9f, 0.1f, 0.0f, 0.0f, 0.05f, 1.0f, 0.0f, 0.0f, 0.0f, 0.1f, 0.9f);
+    const float opacity = 0.7f;
+
+    check(
+        [&](IPImage* image, Expression* e)
+        {
+            e = Shader::newColorRec709ToLinear(e);
+            e = Shader::newColorUnpremult(e);
+            e = Shader::newColorMatrix4D(e, M);
+            e = Shader::newColorPremult(e);
+            e = Shader::newColorClamp(e, 0.0f, 1.0f);
+            return Shader::newOpacity(image, e, opacity);
+        },
+        [&](Pixel& p)
+        {
+            for (int c = 0; c < 3; c++)
+                p.c[c] = toLinear(p.c[c], 0.099, 4.5, 0.081, 1.0 / 0.45);
+
+            if (p.c[3] > 0.0)
+            {
+                for (int c = 0; c < 3; c++)
+                    p.c[c] /= p.c[3];
+            }
+
+            multiply(M, p, true);
+
+            for (int c = 0; c < 3; c++)
+                p.c[c] *= p.c[3];
+
+            for (int c = 0; c < 4; c++)
+                p.c[c] = clamp01(p.c[c]) * opacity;
+        });
+}
+
+TEST_CASE("Cineon log to linear and back")
+{
+    const double refBlack = 95.0;
+    const double refWhite = 685.0;
+    const double tf = 0.002 / 0.6;
+    const double black = pow(10.0, refBlack * tf);
+    const double diff = pow(10.0, refWhite * tf) - black;
+    const double gain = 1.0 - pow(10.0, (refBlack - refWhite) * 0.003333333333);
+    const Mat44f M(0.9f, 0, 0, 0, 0, 0.9f, 0, 0, 0, 0, 0.9f, 0, 0, 0, 0, 1);
+
+    check(
+        [&](IPImage*, Expression* e)
+        {
+            e = Shader::newColorCineonLogToLinear(e, refBlack, refWhite, 0.0);
+            e = Shader::newColorMatrix(e, M);
+            return Shader::newColorLinearToCineonLog(e, refBlack, refWhite);
+        },
+        [&](Pixel& p)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                const double x = std::max(pow(10.0, std::min(p.c[c], 1.0) * 1023.0 * tf) - black, 0.0) / diff * 0.9;
+                p.c[c] = refWhite / 1023.0 + log((x - 1.0) * gain + 1.0) / 7.85181516711;
+            }
+        });
+}
+
+//
+//  The LUT functions are scalar gathers rather than SIMD kernels, so
+//  they're checked against a double precision lookup of the same
+//  table. The 3D LUT has a different size on each axis so a mixed up
+//  axis or stride shows.
+//
+
+namespace
+{
+    const int LUTWidth = 17;
+    const int LUTHeight = 13;
+    const int LUTDepth = 9;
+    const int ChannelLUTSize = 200;
+
+    float latticeValue(double r, double g, double b, int c)
+    {
+        switch (c)
+        {
+        case 0:
+            return float(r * r * 0.8 + g * b * 0.2);
+        case 1:
+            return float(sqrt(g) * 0.9 + r * 0.1);
+        default:
+            return float(b * (1.0 - 0.3 * r) + 0.05);
+        }
+    }
+
+    //
+    //  The 3D LUT fb belongs to the expression; evaluateOnCPU() deletes
+    //  it along with the function it replaces.
+    //
+
+    FrameBuffer* new3DLUT()
+    {
+        FrameBuffer* fb = new FrameBuffer(FrameBuffer::NormalizedCoordinates, LUTWidth, LUTHeight, LUTDepth, 3, FrameBuffer::FLOAT,
+                                          NULL, NULL, FrameBuffer::BOTTOMLEFT, true);
+        float* p = fb->pixels<float>();
+
+        for (int z = 0; z < LUTDepth; z++)
+            for (int y = 0; y < LUTHeight; y++)
+                for (int x = 0; x < LUTWidth; x++)
+                    for (int c = 0; c < 3; c++)
+                        *p++ = latticeValue(double(x) / (LUTWidth - 1), double(y) / (LUTHeight - 1), double(z) / (LUTDepth - 1), c);
+
+        return fb;
+    }
+
+    //
+    //  Trilinear between the lattice points around the clamped colour
+    //  (Color3DLUT.glsl)
+    //
+
+    void lookup3DLUT(Pixel& p, const Vec3f& outScale, const Vec3f& outOffset)
+    {
+        const int size[3] = {LUTWidth, LUTHeight, LUTDepth};
+        int i0[3];
+        double u[3];
+
+        for (int c = 0; c < 3; c++)
+        {
+            const double x = clamp01(p.c[c]) * (size[c] - 1);
+            i0[c] = std::min(int(floor(x)), size[c] - 2);
+            u[c] = x - i0[c];
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            double v = 0.0;
+
+            for (int corner = 0; corner < 8; corner++)
+            {
+                double w = 1.0;
+                double q[3];
+
+                for (int a = 0; a < 3; a++)
+                {
+                    const int o = (corner >> a) & 1;
+                    w *= o ? u[a] : 1.0 - u[a];
+                    q[a] = double(i0[a] + o) / (size[a] - 1);
+                }
+
+                v += w * latticeValue(q[0], q[1], q[2], c);
+            }
+
+            p.c[c] = v * outScale[c] + outOffset[c];
+        }
+    }
+
+    unsigned short channelLUTValue(int i, int c)
+    {
+        const double x = double(i) / (ChannelLUTSize - 1);
+        return (unsigned short)(65535.0 * pow(x, 1.0 / (1.5 + c)) + 0.5);
+    }
+
+    FrameBuffer* newChannelLUT()
+    {
+        FrameBuffer* fb = new FrameBuffer(ChannelLUTSize, 1, 3, FrameBuffer::USHORT);
+        unsigned short* p = fb->pixels<unsigned short>();
+
+        for (int i = 0; i < ChannelLUTSize; i++)
+            for (int c = 0; c < 3; c++)
+                *p++ = channelLUTValue(i, c);
+
+        return fb;
+    }
+
+    //
+    //  Linear between the entries around each channel, clamped to the
+    //  ends (ColorChannelLUT.glsl sampling texel centers)
+    //
+
+    void lookupChannelLUT(Pixel& p, const Vec3f& outScale, const Vec3f& outOffset)
+    {
+        for (int c = 0; c < 3; c++)
+        {
+            const double x = std::min(std::max(p.c[c], 0.0), 1.0) * (ChannelLUTSize - 1);
+            const int x0 = std::min(int(x), ChannelLUTSize - 2);
+            const double f = x - x0;
+            const double v = (channelLUTValue(x0, c) * (1.0 - f) + channelLUTValue(x0 + 1, c) * f) / 65535.0;
+            p.c[c] = v * outScale[c] + outOffset[c];
+        }
+    }
+
+} // namespace
+
+TEST_CASE("3D LUT")
+{
+    const Vec3f outScale(1.5f, 1.0f, 0.8f);
+    const Vec3f outOffset(0.02f, 0.0f, -0.01f);
+
+    check([&](IPImage*, Expression* e) { return Shader::newColor3DLUT(e, new3DLUT(), outScale, outOffset); },
+          [&](Pixel& p) { lookup3DLUT(p, outScale, outOffset); });
+}
+
+TEST_CASE("3D LUT with GL sampling")
+{
+    //
+    //  With these the texture coordinates land on the lattice points'
+    //  texel centers, which is the lookup Color3DLUT does
+    //
+
+    const Vec3f size(LUTWidth, LUTHeight, LUTDepth);
+    const Vec3f grid = Vec3f(1.0f) / size;
+    const Vec3f outScale(0.9f, 1.2f, 1.0f);
+    const Vec3f outOffset(0.0f, -0.05f, 0.03f);
+
+    check(
+        [&](IPImage*, Expression* e)
+        {
+            e = Shader::newColorMatrix(e, Mat44f(0.95f, 0.05f, 0, 0, 0, 1, 0, 0, 0.02f, 0, 0.98f, 0, 0, 0, 0, 1));
+            return Shader::newColor3DLUTGLSampling(e, new3DLUT(), Vec3f(1.0f) - grid, grid / 2.0f, outScale, outOffset);
+        },
+        [&](Pixel& p)
+        {
+            multiply(Mat44f(0.95f, 0.05f, 0, 0, 0, 1, 0, 0, 0.02f, 0, 0.98f, 0, 0, 0, 0, 1), p, false);
+            lookup3DLUT(p, outScale, outOffset);
+        });
+}
+
+TEST_CASE("16 bit channel LUT and gamma")
+{
+    const Vec3f outScale(2.0f, 1.0f, 0.5f);
+    const Vec3f outOffset(0.0f, 0.1f, 0.0f);
+    const Vec3f gamma(1.1f, 0.95f, 1.0f);
+
+    check(
+        [&](IPImage*, Expression* e)
+        {
+            e = Shader::newColorChannelLUT(e, newChannelLUT(), outScale, outOffset);
+            return Shader::newColorGamma(e, gamma);
+        },
+        [&](Pixel& p)
+        {
+            lookupChannelLUT(p, outScale, outOffset);
+            for (int c = 0; c < 3; c++)
+                p.c[c] = pow(std::max(p.c[c], 0.0), double(gamma[c]));
+        });
+}
+
+//
+//  bakeColorChains() has to give what the chain it replaces gives. A
+//  non-linear run over a float source is baked through the log shaper,
+//  which only covers [0, 16]: the run is baked when the source's pixels
+//  are in range and left alone when one of them isn't.
+//
+
+namespace
+{
+    //
+    //  The shaper and 3D LUT are interpolated, so the bake is only an
+    //  approximation. The worst of it is just above black, where the
+    //  sRGB curve is steepest between the first two lattice points.
+    //
+
+    const double BakeTolerance = 1e-1;
+    const double MeanBakeTolerance = 3e-3;
+
+    vector<float> evaluateBaked(const Chain& chain, float brightest, bool bake, size_t& baked)
+    {
+        FrameBuffer* fb = new FrameBuffer(Width, Height, 4, FrameBuffer::FLOAT);
+
+        for (int y = 0; y < Height; y++)
+        {
+            float* p = fb->scanline<float>(y);
+            for (int x = 0; x < Width; x++)
+                for (int c = 0; c < 4; c++)
+                    p[x * 4 + c] = c < 3 ? (inputValue(x, y, c) + 0.1f) * 3.0f : inputValue(x, y, c);
+        }
+
+        fb->scanline<float>(Height / 2)[(Width / 2) * 4] = brightest;
+
+        IPImage* image = new IPImage(testNode(), IPImage::BlendRenderType, Width, Height);
+        image->fb = fb;
+        image->shaderExpr = chain(image, Shader::newSourceRGBA(image));
+
+        vector<FrameBuffer*> cachedFBs;
+        baked = bake ? Shader::bakeColorChains(image, cachedFBs) : 0;
+        REQUIRE(Shader::evaluateOnCPU(image, cachedFBs) == 1);
+        CHECK(cachedFBs.empty());
+        REQUIRE(image->fb->dataType() == FrameBuffer::FLOAT);
+        REQUIRE(image->fb->numChannels() == 4);
+
+        vector<float> out;
+
+        for (int y = 0; y < Height; y++)
+        {
+            const float* p = image->fb->scanline<float>(y);
+            out.insert(out.end(), p, p + Width * 4);
+        }
+
+        delete image;
+        return out;
+    }
+
+    //
+    //  Largest and mean error of a against b
+    //
+
+    double compare(const vector<float>& a, const vector<float>& b, double& mean)
+    {
+        double worst = 0.0;
+        mean = 0.0;
+
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            const double e = fabs(double(a[i]) - double(b[i])) / std::max(1.0, fabs(double(b[i])));
+            worst = std::max(worst, e);
+            mean += e;
+        }
+
+        mean /= double(std::max(a.size(), size_t(1)));
+        return worst;
+    }
+
+    Expression* bakeableChain(IPImage*, Expression* e)
+    {
+        const Mat44f M(0.9f, 0.08f, 0.02f, 0.0f, 0.05f, 1.1f, -0.05f, 0.0f, 0.01f, 0.02f, 0.95f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+        const Mat44f N(1.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.95f, 0.05f, 0.0f, 0.0f, 0.0f, 1.05f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f);
+
+        e = Shader::newColorMatrix(e, M);
+        e = Shader::newColorGamma(e, Vec3f(1.2f, 0.9f, 1.05f));
+        e = Shader::newColorLinearToSRGB(e);
+        return Shader::newColorMatrix(e, N);
+    }
+
+} // namespace
+
+TEST_CASE("baked colour chain over a float source in the shaper's range")
+{
+    Shader::Function::useShadingLanguageVersion("1.50");
+
+    size_t baked = 0;
+    const vector<float> reference = evaluateBaked(bakeableChain, 12.0f, false, baked);
+    const vector<float> result = evaluateBaked(bakeableChain, 12.0f, true, baked);
+
+    CHECK(baked == 1);
+    double mean;
+    const double e = compare(result, reference, mean);
+    MESSAGE("max error " << e << ", mean error " << mean);
+    CHECK(e <= BakeTolerance);
+    CHECK(mean <= MeanBakeTolerance);
+}
+
+TEST_CASE("colour chain over a float source outside the shaper's range isn't baked")
+{
+    Shader::Function::useShadingLanguageVersion("1.50");
+
+    size_t baked = 0;
+    const vector<float> reference = evaluateBaked(bakeableChain, 40.0f, false, baked);
+    const vector<float> result = evaluateBaked(bakeableChain, 40.0f, true, baked);
+
+    CHECK(baked == 0);
+    double mean;
+    CHECK(compare(result, reference, mean) == 0.0);
+}
@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  PropertyHandle<T> has to notice when the property it resolved is
+//  removed or re-created, and concurrent get() calls have to agree on
+//  the property while the structure generation keeps moving.
+//
+
+#include <TwkContainer/Properties.h>
+#include <TwkContainer/PropertyContainer.h>
+#include <TwkContainer/PropertyHandle.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace TwkContainer;
+using namespace std;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool b, const char* what)
+    {
+        if (!b)
+        {
+            printf("FAIL: %s\n", what);
+            failures++;
+        }
+    }
+
+    void testRecreate()
+    {
+        PropertyContainer pc;
+        FloatProperty* p = pc.declareProperty<FloatProperty>("color.gain", 2.0f);
+        PropertyHandle<FloatProperty> h(&pc, PropertyName("color.gain"));
+
+        check(h.get() == p, "handle resolves the property");
+        check(h.value(0.0f) == 2.0f, "handle reads the value");
+
+        pc.removeProperty<FloatProperty>("color.gain");
+        check(h.get() == 0, "handle sees the property removed");
+        check(h.value(-1.0f) == -1.0f, "removed property gives the default");
+
+        FloatProperty* q = pc.declareProperty<FloatProperty>("color.gain", 3.0f);
+        check(h.get() == q, "handle resolves the re-created property");
+        check(h.value(0.0f) == 3.0f, "handle reads the re-created value");
+
+        pc.removeProperty<FloatProperty>("color.gain");
+        pc.declareProperty<IntProperty>("color.gain", 4);
+        check(h.get() == 0, "handle rejects a property of another type");
+
+        PropertyHandle<FloatProperty> unbound;
+        check(unbound.get() == 0, "unbound handle is null");
+    }
+
+    void testConcurrentGet()
+    {
+        PropertyContainer pc;
+        FloatProperty* p = pc.declareProperty<FloatProperty>("color.gain", 1.0f);
+        PropertyHandle<FloatProperty> h(&pc, PropertyName("color.gain"));
+        atomic<bool> done(false);
+        atomic<int> wrong(0);
+        vector<thread> readers;
+
+        for (int i = 0; i < 4; i++)
+        {
+            readers.push_back(thread(
+                [&]()
+                {
+                    while (!done)
+                    {
+                        if (h.get() != p)
+                            wrong++;
+                    }
+                }));
+        }
+
+        //
+        //  Force the readers to keep resolving again
+        //
+
+        for (int i = 0; i < 200000; i++)
+            PropertyContainer::structureChanged();
+
+        done = true;
+
+        for (size_t i = 0; i < readers.size(); i++)
+            readers[i].join();
+
+        check(wrong == 0, "concurrent get() always returns the property");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    testRecreate();
+    testConcurrentGet();
+
+    if (failures == 0)
+        printf("PropertyHandleTest passed\n");
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  SequenceIndex against sequencesInFileList()
+//
+//  Each case groups a list of file names with both and fails if the
+//  sequence names or their order differ. The lists are a handful of
+//  hand written ones (padding, negative frames, several numbers in one
+//  name, frames between dots, paths) and random ones built from a small
+//  vocabulary so the names collide often. Every list is tried with each
+//  combination of includeNonMatching, frameRanges and a few minimum
+//  sequence sizes.
+//
+//  The vocabulary leaves out names the two are known to disagree on
+//  (see SequenceIndex.h), e.g. "shot.1.exr" next to "shot_2.exr".
+//
+//  usage: SequenceIndexTest [random lists] [seed]
+//
+
+#include <TwkUtil/FrameUtils.h>
+#include <TwkUtil/SequenceIndex.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace TwkUtil;
+using namespace std;
+
+namespace
+{
+    typedef vector<FileNameList> Lists;
+
+    FileNameList frames(const string& prefix, int first, int last, int pad, const string& suffix, int step = 1)
+    {
+        FileNameList files;
+
+        for (int f = first; f <= last; f += step)
+        {
+            char num[32];
+            snprintf(num, sizeof(num), "%0*d", pad, f);
+            files.push_back(prefix + num + suffix);
+        }
+
+        return files;
+    }
+
+    void append(FileNameList& files, const FileNameList& more) { files.insert(files.end(), more.begin(), more.end()); }
+
+    Lists handWrittenLists()
+    {
+        Lists lists;
+        FileNameList files;
+
+        append(files, frames("shot.", 1, 100, 4, ".exr"));
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("shot.", 1, 20, 4, ".exr"));
+        append(files, frames("shot.", 40, 60, 4, ".exr"));
+        append(files, frames("shot.", 100, 200, 4, ".exr", 10));
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("render_v002.", 990, 1010, 0, ".dpx"));
+        append(files, frames("render_v003.", 1, 10, 4, ".dpx"));
+        files.push_back("render_v002.mov");
+        files.push_back("notes.txt");
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("neg.", -10, 10, 0, ".tif"));
+        append(files, frames("negpad.", -5, 5, 3, ".tif"));
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("a", 1, 12, 0, "b"));
+        append(files, frames("plate_", 1, 9, 2, ""));
+        append(files, frames("", 1, 30, 5, ".jpg"));
+        files.push_back("single.0001.exr");
+        files.push_back("single.exr");
+        lists.push_back(files);
+
+        files.clear();
+        for (int v = 1; v <= 6; v++)
+        {
+            char prefix[32];
+            snprintf(prefix, sizeof(prefix), "comp.v%d.", v);
+            append(files, frames(prefix, 1001, 1010, 0, ".exr"));
+        }
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("/show/seq/shot/img.", 1, 8, 4, ".exr"));
+        append(files, frames("/show/seq/other/img.", 1, 8, 4, ".exr"));
+        append(files, frames("/show/seq/shot/img.", 10, 25, 4, ".exr"));
+        lists.push_back(files);
+
+        files.clear();
+        append(files, frames("big.", 123456780, 123456790, 0, ".exr"));
+        append(files, frames("mixed.", 8, 12, 0, ".exr"));
+        append(files, frames("mixed.", 8, 12, 2, ".exr"));
+        lists.push_back(files);
+
+        lists.push_back(FileNameList());
+        lists.push_back(FileNameList(1, "only.0001.exr"));
+
+        return lists;
+    }
+
+    FileNameList randomList(mt19937& rng)
+    {
+        static const char* prefixes[] = {"shot.", "take_", "plate", "a.b.", "v2_render.", "", "x-", "comp.v1."};
+        static const char* suffixes[] = {".exr", ".dpx", ".tif", "", "_matte.exr", ".0001.exr", "b"};
+
+        FileNameList files;
+        const int groups = 1 + rng() % 6;
+
+        for (int g = 0; g < groups; g++)
+        {
+            const string prefix = prefixes[rng() % (sizeof(prefixes) / sizeof(prefixes[0]))];
+            const string suffix = suffixes[rng() % (sizeof(suffixes) / sizeof(suffixes[0]))];
+            const int pad = int(rng() % 6);
+            const int first = int(rng() % 2000) - (rng() % 8 == 0 ? 1000 : 0);
+            const int count = 1 + rng() % 40;
+            const int step = 1 + (rng() % 4 == 0 ? rng() % 5 : 0);
+
+            FileNameList group = frames(prefix, first, first + (count - 1) * step, pad, suffix, step);
+
+            //
+            //  Drop a few frames to make holes
+            //
+
+            for (size_t i = 0; i < group.size(); i++)
+            {
+                if (rng() % 10 != 0)
+                    files.push_back(group[i]);
+            }
+        }
+
+        for (int i = rng() % 4; i > 0; i--)
+            files.push_back(string("loose") + char('a' + rng() % 3) + ".txt");
+
+        shuffle(files.begin(), files.end(), rng);
+        return files;
+    }
+
+    bool check(const FileNameList& files, const char* label)
+    {
+        static const int minSizes[] = {1, 2, 5};
+        bool ok = true;
+
+        for (int nm = 0; nm < 2; nm++)
+        {
+            for (int fr = 0; fr < 2; fr++)
+            {
+                for (size_t m = 0; m < sizeof(minSizes) / sizeof(minSizes[0]); m++)
+                {
+                    const SequenceNameList expected = sequencesInFileList(files, NULL, nm != 0, fr != 0, minSizes[m]);
+
+                    SequenceIndex index(NULL, nm != 0, fr != 0, minSizes[m]);
+                    index.add(files);
+                    const SequenceNameList actual = index.sequenceNames();
+
+                    if (actual == expected)
+                        continue;
+
+                    ok = false;
+                    printf("FAIL %s (includeNonMatching %d, frameRanges %d, minSequenceSize %d)\n", label, nm, fr, minSizes[m]);
+
+                    for (size_t i = 0; i < max(expected.size(), actual.size()); i++)
+                    {
+                        printf("    %-40s %s\n", i < expected.size() ? expected[i].c_str() : "-",
+                               i < actual.size() ? actual[i].c_str() : "-");
+                    }
+                }
+            }
+        }
+
+        return ok;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const int numRandom = argc > 1 ? atoi(argv[1]) : 300;
+    const unsigned int seed = argc > 2 ? unsigned(atoi(argv[2])) : 1234u;
+
+    const Lists lists = handWrittenLists();
+    mt19937 rng(seed);
+    int failures = 0;
+    int cases = 0;
+
+    for (size_t i = 0; i < lists.size(); i++, cases++)
+    {
+        char label[64];
+        snprintf(label, sizeof(label), "hand written list %d", int(i));
+        if (!check(lists[i], label))
+            failures++;
+    }
+
+    for (int i = 0; i < numRandom; i++, cases++)
+    {
+        char label[64];
+        snprintf(label, sizeof(label), "random list %d (seed %u)", i, seed);
+        if (!check(randomList(rng), label))
+            failures++;
+    }
+
+    printf("%d of %d lists differ\n", failures, cases);
+    return failures == 0 ? 0 : 1;
+}
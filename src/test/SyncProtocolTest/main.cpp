@@ -0,0 +1,525 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  Loopback harness for batched session sync
+//
+//  Simulates a presenter and N-1 viewers on a virtual clock and plays the
+//  same scripted review (scrubbing, dragging an exposure slider with the
+//  pointer over the image, then playback) through both the text EVENT
+//  messages and SyncChannel batches. Each link has a one way delay with
+//  some jitter and every client's clock has its own offset. Prints the
+//  messages, bytes and latency of each protocol and how well the
+//  receivers' clock estimates match the real latency. It also checks
+//  that two channels which lost a batch each way get back in step.
+//
+//  usage: SyncProtocolTest [clients [delay-ms [tick-ms]]]
+//
+
+#include <TwkQtChat/SyncBatch.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace TwkQtChat;
+using namespace std;
+
+namespace
+{
+    const char* Session = "sessionA";
+
+    struct ScriptEvent
+    {
+        uint64_t time; // virtual usec
+        string name;
+        string contents;
+    };
+
+    typedef vector<ScriptEvent> Script;
+
+    string withSession(const string& contents) { return contents + "|" + Session + "|"; }
+
+    void add(Script& script, uint64_t t, const char* name, const string& contents)
+    {
+        ScriptEvent e;
+        e.time = t;
+        e.name = name;
+        e.contents = withSession(contents);
+        script.push_back(e);
+    }
+
+    //
+    //  Two seconds of scrubbing at mouse rate, a second of slider drag
+    //  with pointer moves, then three seconds of playback.
+    //
+
+    Script makeScript(uint64_t start)
+    {
+        Script script;
+        char buf[256];
+        uint64_t t = start;
+        int frame = 1;
+
+        for (int i = 0; i < 240; i++, t += 8333)
+        {
+            snprintf(buf, sizeof(buf), "%d;;scrubbed", frame += (i % 3 == 0) ? 2 : 1);
+            add(script, t, "remote-sync-frame-changed", buf);
+        }
+
+        for (int i = 0; i < 60; i++, t += 16666)
+        {
+            snprintf(buf, sizeof(buf),
+                     "sourceGroup000000_RVColor.color.exposure/#RVColor.color.exposure/"
+                     "setFloatProperty(\"sourceGroup000000_RVColor.color.exposure\", float[] {%f,%f,%f}, true)",
+                     i * 0.05, i * 0.05, i * 0.05);
+            add(script, t, "remote-sync-graph-state", buf);
+
+            snprintf(buf, sizeof(buf), "sourceGroup000000_source;%f;%f", 0.25 + i * 0.004, 0.5 - i * 0.002);
+            add(script, t + 4000, "remote-sync-pointer", buf);
+        }
+
+        snprintf(buf, sizeof(buf), "%d", frame);
+        add(script, t, "remote-sync-play-start", buf);
+
+        for (int s = 1; s <= 3; s++)
+        {
+            snprintf(buf, sizeof(buf), "%d", frame + s * 24);
+            add(script, t + s * 1000000, "remote-sync-play-clock", buf);
+        }
+
+        t += 3500000;
+        snprintf(buf, sizeof(buf), "%d", frame + 84);
+        add(script, t, "remote-sync-play-stop", buf);
+
+        return script;
+    }
+
+    struct Packet
+    {
+        uint64_t sent;
+        uint64_t arrives;
+        string data;
+    };
+
+    //
+    //  An ordered (TCP-like) link with a jittered one way delay
+    //
+
+    struct Link
+    {
+        Link()
+            : delay(0)
+            , seed(1)
+            , last(0)
+            , messages(0)
+            , bytes(0)
+        {
+        }
+
+        void send(uint64_t now, const string& data, size_t framing)
+        {
+            seed = seed * 1103515245 + 12345;
+            const uint64_t jitter = (seed >> 16) % 4000;
+
+            Packet p;
+            p.sent = now;
+            p.arrives = max(last, now + delay + jitter);
+            p.data = data;
+            last = p.arrives;
+            packets.push_back(p);
+            messages++;
+            bytes += data.size() + framing;
+        }
+
+        uint64_t delay;
+        unsigned int seed;
+        uint64_t last;
+        size_t messages;
+        size_t bytes;
+        deque<Packet> packets;
+    };
+
+    struct Latency
+    {
+        Latency()
+            : n(0)
+            , sum(0)
+            , max(0)
+        {
+        }
+
+        void add(double v)
+        {
+            n++;
+            sum += v;
+            if (v > max)
+                max = v;
+        }
+
+        double mean() const { return n ? sum / n : 0; }
+
+        size_t n;
+        double sum;
+        double max;
+    };
+
+    //
+    //  What a viewer ends up with: the last contents per event/key and the
+    //  order of the events which can't be coalesced.
+    //
+
+    struct ViewerState
+    {
+        map<string, string> state;
+        vector<string> ordered;
+
+        void apply(const string& name, const string& contents)
+        {
+            bool coalesce;
+            const string key = SyncBatch::coalesceKey(name, contents, coalesce);
+            if (coalesce)
+                state[name + "/" + key] = contents;
+            else
+                ordered.push_back(name + " " + contents);
+        }
+
+        bool operator==(const ViewerState& o) const { return state == o.state && ordered == o.ordered; }
+    };
+
+    //
+    //  Connection puts "<type> <size> " in front of each message
+    //
+
+    size_t framing(const char* type, const string& data)
+    {
+        char buf[32];
+        return strlen(type) + snprintf(buf, sizeof(buf), " %zu ", data.size());
+    }
+
+    //
+    //  Text protocol: one message per event to each viewer
+    //
+
+    void runText(const Script& script, size_t clients, uint64_t delay, vector<Link>& links, vector<ViewerState>& viewers,
+                 Latency& latency)
+    {
+        links.assign(clients, Link());
+        viewers.assign(clients, ViewerState());
+
+        for (size_t v = 1; v < clients; v++)
+        {
+            links[v].delay = delay;
+            links[v].seed = unsigned(v);
+
+            for (size_t i = 0; i < script.size(); i++)
+            {
+                const ScriptEvent& e = script[i];
+                const string message = "EVENT " + e.name + " " + Session + " " + e.contents;
+                links[v].send(e.time, message, framing("MESSAGE", message));
+            }
+
+            for (size_t i = 0; i < links[v].packets.size(); i++)
+            {
+                const Packet& p = links[v].packets[i];
+                const string& m = p.data;
+                const size_t a = m.find(' ', 6), b = m.find(' ', a + 1);
+                viewers[v].apply(m.substr(6, a - 6), m.substr(b + 1));
+                latency.add((p.arrives - p.sent) / 1000.0);
+            }
+        }
+    }
+
+    //
+    //  Batched protocol: each presenter/viewer pair has a SyncChannel at
+    //  both ends; everybody flushes once per tick.
+    //
+
+    struct Pair
+    {
+        SyncChannel presenter;
+        SyncChannel viewer;
+        Link down;
+        Link up;
+        int64_t skew; // viewer clock - presenter clock
+    };
+
+    bool runBatched(const Script& script, size_t clients, uint64_t delay, uint64_t tick, vector<Link>& links,
+                    vector<ViewerState>& viewers, Latency& latency, Latency& clockError)
+    {
+        vector<Pair> pairs(clients);
+        viewers.assign(clients, ViewerState());
+        bool ok = true;
+
+        for (size_t v = 1; v < clients; v++)
+        {
+            Pair& p = pairs[v];
+            p.presenter.setPeerVersion(SyncBatch::Version);
+            p.viewer.setPeerVersion(SyncBatch::Version);
+            p.down.delay = p.up.delay = delay;
+            p.down.seed = unsigned(v);
+            p.up.seed = unsigned(v * 7);
+            p.skew = (int64_t(v) * 37 - 150) * 1000 + int64_t(v) * 1234567890;
+        }
+
+        //
+        //  Start a while before the script so the clocks have been probed
+        //  a couple of times, the way a session is connected before the
+        //  review starts.
+        //
+
+        const uint64_t start = script.front().time - 3000000;
+        const uint64_t end = script.back().time + 2000000;
+        size_t next = 0;
+
+        for (uint64_t now = start; now <= end; now += 1000)
+        {
+            while (next < script.size() && script[next].time <= now)
+            {
+                const ScriptEvent& e = script[next++];
+
+                for (size_t v = 1; v < clients; v++)
+                    pairs[v].presenter.queue(e.name, Session, e.contents, now);
+            }
+
+            const bool ticks = (now - start) % tick == 0;
+
+            for (size_t v = 1; v < clients; v++)
+            {
+                Pair& p = pairs[v];
+                const uint64_t viewerNow = now + p.skew;
+
+                if (ticks && p.presenter.wantsFlush(now))
+                {
+                    string batch;
+                    p.presenter.flush(now, batch);
+                    p.down.send(now, batch, framing("SYNCBATCH(v=1)", batch));
+                }
+
+                if (ticks && p.viewer.wantsFlush(viewerNow))
+                {
+                    string batch;
+                    p.viewer.flush(viewerNow, batch);
+                    p.up.send(now, batch, framing("SYNCBATCH(v=1)", batch));
+                }
+
+                while (!p.down.packets.empty() && p.down.packets.front().arrives <= now)
+                {
+                    const Packet packet = p.down.packets.front();
+                    p.down.packets.pop_front();
+
+                    if (!p.viewer.receive(packet.data.data(), packet.data.size(), viewerNow))
+                    {
+                        printf("ERROR: viewer %zu: %s\n", v, p.viewer.error().c_str());
+                        ok = false;
+                        continue;
+                    }
+
+                    const SyncBatch::Events& events = p.viewer.events();
+
+                    for (size_t i = 0; i < events.size(); i++)
+                    {
+                        const SyncBatch::Event& e = events[i];
+                        const double real = (now - (packet.sent - e.age)) / 1000.0;
+
+                        viewers[v].apply(e.name, e.contents);
+                        latency.add(real);
+
+                        if (e.name == "remote-sync-play-start" || e.name == "remote-sync-play-clock")
+                        {
+                            clockError.add(fabs(p.viewer.latency(e, viewerNow) * 1000.0 - real));
+                        }
+                    }
+                }
+
+                while (!p.up.packets.empty() && p.up.packets.front().arrives <= now)
+                {
+                    const Packet packet = p.up.packets.front();
+                    p.up.packets.pop_front();
+
+                    if (!p.presenter.receive(packet.data.data(), packet.data.size(), now))
+                    {
+                        printf("ERROR: presenter from %zu: %s\n", v, p.presenter.error().c_str());
+                        ok = false;
+                    }
+                }
+            }
+        }
+
+        links.assign(clients, Link());
+
+        for (size_t v = 1; v < clients; v++)
+        {
+            links[v].messages = pairs[v].down.messages + pairs[v].up.messages;
+            links[v].bytes = pairs[v].down.bytes + pairs[v].up.bytes;
+        }
+
+        return ok;
+    }
+
+    //
+    //  Passes from's next batch to to and checks it's decoded (or
+    //  dropped) as expected. If contents isn't empty the batch has to
+    //  hold one event with those contents.
+    //
+
+    bool deliver(SyncChannel& from, SyncChannel& to, uint64_t now, bool decoded, const string& contents, const char* label)
+    {
+        if (!from.wantsFlush(now))
+        {
+            printf("ERROR: resync %s: nothing to send\n", label);
+            return false;
+        }
+
+        string batch;
+        from.flush(now, batch);
+
+        if (to.receive(batch.data(), batch.size(), now) != decoded)
+        {
+            printf("ERROR: resync %s: batch %s (%s)\n", label, decoded ? "dropped" : "decoded", to.error().c_str());
+            return false;
+        }
+
+        if (!contents.empty() && (to.events().size() != 1 || to.events()[0].contents != contents))
+        {
+            printf("ERROR: resync %s: wrong events\n", label);
+            return false;
+        }
+
+        return true;
+    }
+
+    //
+    //  Each end loses one batch (e.g. one the link dropped while a
+    //  connection was restored). Both then drop what the other sends
+    //  until they've asked for and received a table reset, and the
+    //  deltas that follow decode against the reset tables.
+    //
+
+    bool checkResync()
+    {
+        SyncChannel a;
+        SyncChannel b;
+        a.setPeerVersion(SyncBatch::Version);
+        b.setPeerVersion(SyncBatch::Version);
+
+        const string prop = "sourceGroup000000_RVColor.color.exposure/#RVColor.color.exposure/setFloatProperty";
+        const string edit1 = withSession(prop + "(1.0)");
+        const string edit2 = withSession(prop + "(2.0)");
+        const string edit3 = withSession(prop + "(3.0)");
+        uint64_t now = 1000000;
+        string lost;
+        bool ok = true;
+
+        a.queue("remote-sync-graph-state", Session, edit1, now);
+        b.queue("remote-sync-graph-state", Session, edit1, now);
+        ok = deliver(a, b, now, true, edit1, "a to b") && ok;
+        ok = deliver(b, a, now, true, edit1, "b to a") && ok;
+
+        now += 16000;
+        a.queue("remote-sync-graph-state", Session, edit2, now);
+        b.queue("remote-sync-graph-state", Session, edit2, now);
+        a.flush(now, lost);
+        b.flush(now, lost);
+
+        now += 16000;
+        a.queue("remote-sync-graph-state", Session, edit3, now);
+        b.queue("remote-sync-graph-state", Session, edit3, now);
+        ok = deliver(a, b, now, false, "", "a to b after a gap") && ok;
+        ok = deliver(b, a, now, false, "", "b to a after a gap") && ok;
+
+        //
+        //  Each one has asked the other for a reset, so the next
+        //  batches are resets
+        //
+
+        now += 16000;
+        a.queue("remote-sync-graph-state", Session, edit1, now);
+        b.queue("remote-sync-graph-state", Session, edit1, now);
+        ok = deliver(a, b, now, true, edit1, "a to b reset") && ok;
+        ok = deliver(b, a, now, true, edit1, "b to a reset") && ok;
+
+        now += 16000;
+        a.queue("remote-sync-graph-state", Session, edit2, now);
+        b.queue("remote-sync-graph-state", Session, edit2, now);
+        ok = deliver(a, b, now, true, edit2, "a to b delta") && ok;
+        ok = deliver(b, a, now, true, edit2, "b to a delta") && ok;
+
+        return ok;
+    }
+
+    void totals(const vector<Link>& links, size_t& messages, size_t& bytes)
+    {
+        messages = 0;
+        bytes = 0;
+
+        for (size_t i = 0; i < links.size(); i++)
+        {
+            messages += links[i].messages;
+            bytes += links[i].bytes;
+        }
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const size_t clients = argc > 1 ? max(atoi(argv[1]), 2) : 8;
+    const uint64_t delay = uint64_t(argc > 2 ? atoi(argv[2]) : 20) * 1000;
+    const uint64_t tick = uint64_t(max(argc > 3 ? atoi(argv[3]) : 16, 1)) * 1000;
+
+    const Script script = makeScript(10000000);
+    const double seconds = (script.back().time - script.front().time) / 1e6;
+
+    vector<Link> textLinks, batchLinks;
+    vector<ViewerState> textViewers, batchViewers;
+    Latency textLatency, batchLatency, clockError;
+
+    runText(script, clients, delay, textLinks, textViewers, textLatency);
+    bool ok = runBatched(script, clients, delay, tick, batchLinks, batchViewers, batchLatency, clockError);
+    ok = checkResync() && ok;
+
+    size_t textMessages, textBytes, batchMessages, batchBytes;
+    totals(textLinks, textMessages, textBytes);
+    totals(batchLinks, batchMessages, batchBytes);
+
+    printf("%zu clients, %zu events over %.1fs, %.0fms delay, %.0fms tick\n", clients, script.size(), seconds,
+           delay / 1000.0, tick / 1000.0);
+    printf("%-8s %10s %12s %12s %12s %12s\n", "protocol", "messages", "bytes", "KB/s/viewer", "latency ms", "max ms");
+    printf("%-8s %10zu %12zu %12.2f %12.2f %12.2f\n", "text", textMessages, textBytes,
+           textBytes / 1024.0 / seconds / (clients - 1), textLatency.mean(), textLatency.max);
+    printf("%-8s %10zu %12zu %12.2f %12.2f %12.2f\n", "batched", batchMessages, batchBytes,
+           batchBytes / 1024.0 / seconds / (clients - 1), batchLatency.mean(), batchLatency.max);
+    printf("playback latency estimate error: mean %.3fms, max %.3fms\n", clockError.mean(), clockError.max);
+
+    for (size_t v = 1; v < clients; v++)
+    {
+        if (!(textViewers[v] == batchViewers[v]))
+        {
+            printf("ERROR: viewer %zu ends up in a different state with batches\n", v);
+            ok = false;
+        }
+    }
+
+    if (batchBytes >= textBytes || batchMessages >= textMessages)
+    {
+        printf("ERROR: batches are not smaller than text messages\n");
+        ok = false;
+    }
+
+    if (clockError.n == 0 || clockError.max > 5.0)
+    {
+        printf("ERROR: clock estimate is off\n");
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,404 @@
+//
+// Copyright (C) 2026  Autodesk, Inc. All Rights Reserved.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+
+//
+//  IOtiff's parallel strip and tile decoding
+//
+//  Each case writes a small TIFF with libtiff (strips or tiles,
+//  contiguous or separate, 8/16/32 bit, top down or bottom up) whose
+//  pixels are a function of their position, then reads it with IOtiff:
+//  whole, and in regions which start and end inside blocks, on block
+//  boundaries, in the last partial block and past the edge of the
+//  image. Every pixel read has to be the one written, the data window
+//  has to be the requested region and the orientation has to be the
+//  one getImageInfo() reported.
+//
+//  Image sizes aren't multiples of the strip or tile size so the
+//  partial blocks at the right and bottom edges are covered.
+//
+//  usage: TiffBlockReadTest [directory]
+//
+
+#include <IOtiff/IOtiff.h>
+#include <TwkFB/FrameBuffer.h>
+#include <TwkFB/TwkFBThreadPool.h>
+#include <tiffio.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace TwkFB;
+using namespace std;
+
+namespace
+{
+    struct Case
+    {
+        const char* name;
+        int width;
+        int height;
+        int channels;
+        int bits;        // 8, 16 or 32 (float)
+        bool isSigned;   // 16 bit signed ints go through the row readers
+        bool separate;   // PLANARCONFIG_SEPARATE
+        bool bottomUp;   // ORIENTATION_BOTLEFT
+        int rowsPerStrip; // strips if not 0
+        int tileWidth;   // tiles if not 0
+        int tileHeight;
+    };
+
+    struct Region
+    {
+        int x0, y0, x1, y1; // from the top left, inclusive
+    };
+
+    //
+    //  The sample at x, y (from the top left) of channel c
+    //
+
+    double sampleValue(const Case& t, int x, int y, int c)
+    {
+        switch (t.bits)
+        {
+        case 8:
+            return double((x * 7 + y * 13 + c * 61) & 0xff);
+        case 16:
+            return t.isSigned ? double(((x * 37 + y * 101 + c * 1000) & 0x3fff) - 0x2000) : double((x * 257 + y * 131 + c * 1000) & 0xffff);
+        default:
+            return double(float(x) + float(y) * 1000.0f + float(c) * 0.25f);
+        }
+    }
+
+    void putSample(const Case& t, unsigned char* row, size_t index, double v)
+    {
+        switch (t.bits)
+        {
+        case 8:
+            row[index] = (unsigned char)v;
+            break;
+        case 16:
+            if (t.isSigned)
+                ((short*)row)[index] = (short)v;
+            else
+                ((unsigned short*)row)[index] = (unsigned short)v;
+            break;
+        default:
+            ((float*)row)[index] = float(v);
+            break;
+        }
+    }
+
+    //
+    //  The samples of file row y (or of a tile's rows) for one plane
+    //  (separate) or all channels (contiguous)
+    //
+
+    void fillRow(const Case& t, int fileRow, int x0, int n, int plane, unsigned char* out)
+    {
+        const int y = t.bottomUp ? t.height - 1 - fileRow : fileRow;
+        const int spp = t.separate ? 1 : t.channels;
+
+        for (int i = 0; i < n; i++)
+        {
+            //
+            //  Tiles are padded past the image edge
+            //
+
+            const int x = min(x0 + i, t.width - 1);
+
+            for (int c = 0; c < spp; c++)
+            {
+                putSample(t, out, size_t(i) * spp + c, sampleValue(t, x, min(y, t.height - 1), t.separate ? plane : c));
+            }
+        }
+    }
+
+    bool writeTIFF(const Case& t, const string& filename)
+    {
+        TIFF* tif = TIFFOpen(filename.c_str(), "w");
+
+        if (!tif)
+            return false;
+
+        TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, uint32(t.width));
+        TIFFSetField(tif, TIFFTAG_IMAGELENGTH, uint32(t.height));
+        TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, uint16(t.channels));
+        TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, uint16(t.bits));
+        TIFFSetField(tif, TIFFTAG_SAMPLEFORMAT,
+                     uint16(t.bits == 32 ? SAMPLEFORMAT_IEEEFP : t.isSigned ? SAMPLEFORMAT_INT : SAMPLEFORMAT_UINT));
+        TIFFSetField(tif, TIFFTAG_PLANARCONFIG, uint16(t.separate ? PLANARCONFIG_SEPARATE : PLANARCONFIG_CONTIG));
+        TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, uint16(t.channels >= 3 ? PHOTOMETRIC_RGB : PHOTOMETRIC_MINISBLACK));
+        TIFFSetField(tif, TIFFTAG_ORIENTATION, uint16(t.bottomUp ? ORIENTATION_BOTLEFT : ORIENTATION_TOPLEFT));
+        TIFFSetField(tif, TIFFTAG_COMPRESSION, uint16(COMPRESSION_NONE));
+
+        if (t.channels == 4)
+        {
+            uint16 extra = EXTRASAMPLE_ASSOCALPHA;
+            TIFFSetField(tif, TIFFTAG_EXTRASAMPLES, uint16(1), &extra);
+        }
+
+        const int planes = t.separate ? t.channels : 1;
+        const size_t pixelBytes = size_t(t.bits / 8) * (t.separate ? 1 : t.channels);
+        bool ok = true;
+
+        if (t.tileWidth)
+        {
+            TIFFSetField(tif, TIFFTAG_TILEWIDTH, uint32(t.tileWidth));
+            TIFFSetField(tif, TIFFTAG_TILELENGTH, uint32(t.tileHeight));
+
+            vector<unsigned char> tile(pixelBytes * t.tileWidth * t.tileHeight);
+
+            for (int p = 0; p < planes; p++)
+            {
+                for (int ty = 0; ty < t.height; ty += t.tileHeight)
+                {
+                    for (int tx = 0; tx < t.width; tx += t.tileWidth)
+                    {
+                        for (int r = 0; r < t.tileHeight; r++)
+                        {
+                            fillRow(t, ty + r, tx, t.tileWidth, p, &tile[pixelBytes * t.tileWidth * r]);
+                        }
+
+                        const ttile_t index = TIFFComputeTile(tif, tx, ty, 0, p);
+                        ok = ok && TIFFWriteEncodedTile(tif, index, &tile[0], tmsize_t(tile.size())) >= 0;
+                    }
+                }
+            }
+        }
+        else
+        {
+            TIFFSetField(tif, TIFFTAG_ROWSPERSTRIP, uint32(t.rowsPerStrip));
+
+            vector<unsigned char> row(pixelBytes * t.width);
+
+            for (int p = 0; p < planes; p++)
+            {
+                for (int y = 0; y < t.height; y++)
+                {
+                    fillRow(t, y, 0, t.width, p, &row[0]);
+                    ok = ok && TIFFWriteScanline(tif, &row[0], uint32(y), uint16(p)) >= 0;
+                }
+            }
+        }
+
+        TIFFClose(tif);
+        return ok;
+    }
+
+    //
+    //  The value IOtiff gives a sample: signed ints are normalized to
+    //  float
+    //
+
+    double readValue(const Case& t, const FrameBuffer* fb, int x, int y, int c)
+    {
+        const int i = fb->isPlanar() ? 0 : c;
+
+        switch (fb->dataType())
+        {
+        case FrameBuffer::UCHAR:
+            return (&fb->pixel<unsigned char>(x, y))[i];
+        case FrameBuffer::USHORT:
+            return (&fb->pixel<unsigned short>(x, y))[i];
+        case FrameBuffer::FLOAT:
+            return double((&fb->pixel<float>(x, y))[i]) * (t.isSigned ? 32767.0 : 1.0);
+        default:
+            return -1.0;
+        }
+    }
+
+    bool checkRead(const IOtiff& io, const Case& t, const string& filename, const Region* region)
+    {
+        FrameBufferIO::ReadRequest request;
+
+        if (region)
+        {
+            request.x0 = region->x0;
+            request.y0 = region->y0;
+            request.x1 = region->x1;
+            request.y1 = region->y1;
+        }
+
+        FBInfo info;
+        io.getImageInfo(filename, info);
+
+        FrameBuffer fb;
+        io.readImage(fb, filename, request);
+
+        char label[128];
+
+        if (region)
+            snprintf(label, sizeof(label), "%s region %d %d %d %d", t.name, region->x0, region->y0, region->x1, region->y1);
+        else
+            snprintf(label, sizeof(label), "%s", t.name);
+
+        //
+        //  What has to come back: the region clipped to the image, or all
+        //  of it. Signed files are always read whole.
+        //
+
+        int x0 = 0, y0 = 0, x1 = t.width - 1, y1 = t.height - 1;
+
+        if (region && !t.isSigned)
+        {
+            x0 = min(region->x0, t.width - 1);
+            y0 = min(region->y0, t.height - 1);
+            x1 = min(region->x1, t.width - 1);
+            y1 = min(region->y1, t.height - 1);
+        }
+
+        const int width = x1 - x0 + 1;
+        const int height = y1 - y0 + 1;
+
+        if (fb.width() != width || fb.height() != height)
+        {
+            printf("FAIL %s: read %dx%d, expected %dx%d\n", label, fb.width(), fb.height(), width, height);
+            return false;
+        }
+
+        if (fb.orientation() != info.orientation)
+        {
+            printf("FAIL %s: orientation %d, getImageInfo() said %d\n", label, int(fb.orientation()), int(info.orientation));
+            return false;
+        }
+
+        const bool topDown = fb.orientation() == FrameBuffer::TOPLEFT;
+
+        if (width != t.width || height != t.height)
+        {
+            //
+            //  The data window is in the FrameBuffer's rows
+            //
+
+            const int ux = fb.uncropX();
+            const int uy = fb.uncropY();
+            const int expectedY = topDown ? y0 : t.height - 1 - y1;
+
+            if (!fb.uncrop() || fb.uncropWidth() != t.width || fb.uncropHeight() != t.height || ux != x0 || uy != expectedY)
+            {
+                printf("FAIL %s: data window %d %d in %dx%d, expected %d %d in %dx%d\n", label, ux, uy, fb.uncropWidth(), fb.uncropHeight(),
+                       x0, expectedY, t.width, t.height);
+                return false;
+            }
+        }
+
+        for (int c = 0; c < t.channels; c++)
+        {
+            const FrameBuffer* plane = &fb;
+
+            if (fb.isPlanar())
+            {
+                for (int p = 0; p < c && plane; p++)
+                    plane = plane->nextPlane();
+
+                if (!plane)
+                {
+                    printf("FAIL %s: no plane for channel %d\n", label, c);
+                    return false;
+                }
+            }
+
+            for (int y = 0; y < height; y++)
+            {
+                for (int x = 0; x < width; x++)
+                {
+                    const int ix = x0 + x;
+                    const int iy = topDown ? y0 + y : y1 - y;
+                    const double expected = sampleValue(t, ix, iy, c);
+                    const double actual = readValue(t, plane, x, y, c);
+
+                    if (fabs(actual - expected) > 1e-3 * max(1.0, fabs(expected)))
+                    {
+                        printf("FAIL %s: channel %d at %d, %d is %g, expected %g\n", label, c, ix, iy, actual, expected);
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    const string dir = argc > 1 ? argv[1] : ".";
+
+    TIFFSetWarningHandler(0);
+    ThreadPool::initialize();
+
+    const Case cases[] = {
+        {"strips rgb8", 101, 53, 3, 8, false, false, false, 7, 0, 0},
+        {"strips rgba16 planar", 67, 41, 4, 16, false, false, false, 5, 0, 0},
+        {"strips separate float", 45, 38, 3, 32, false, true, false, 4, 0, 0},
+        {"one strip gray8", 33, 29, 1, 8, false, false, false, 29, 0, 0},
+        {"strips bottom up rgb8", 50, 37, 3, 8, false, false, true, 6, 0, 0},
+        {"tiles rgb8", 101, 53, 3, 8, false, false, false, 0, 16, 16},
+        {"tiles separate float", 75, 49, 4, 32, false, true, false, 0, 32, 16},
+        {"tiles bottom up rgba16", 40, 35, 4, 16, false, false, true, 0, 16, 16},
+        {"strips signed16", 31, 17, 3, 16, true, false, false, 4, 0, 0},
+    };
+
+    int failures = 0;
+    int checks = 0;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const Case& t = cases[i];
+        const string filename = dir + "/TiffBlockReadTest." + to_string(i) + ".tif";
+
+        if (!writeTIFF(t, filename))
+        {
+            printf("FAIL %s: couldn't write %s\n", t.name, filename.c_str());
+            failures++;
+            continue;
+        }
+
+        const int bw = t.tileWidth ? t.tileWidth : t.width;
+        const int bh = t.tileWidth ? t.tileHeight : t.rowsPerStrip;
+
+        const Region regions[] = {
+            {1, 1, 1, 1},                                 // one pixel
+            {3, 2, t.width / 2, t.height / 2},            // inside, across blocks
+            {bw, bh, 2 * bw - 1, 2 * bh - 1},             // exactly one block
+            {bw - 1, bh - 1, bw, bh},                     // the corner of four blocks
+            {t.width - 3, t.height - 2, t.width - 1, t.height - 1}, // last partial block
+            {t.width / 3, 0, t.width + 20, t.height + 20}, // past the edge
+            {0, 0, t.width - 1, t.height - 1},            // all of it
+        };
+
+        IOtiff io;
+
+        checks++;
+        if (!checkRead(io, t, filename, 0))
+            failures++;
+
+        for (size_t r = 0; r < sizeof(regions) / sizeof(regions[0]); r++)
+        {
+            const Region& region = regions[r];
+
+            //
+            //  A block can be bigger than the image
+            //
+
+            if (region.x0 > region.x1 || region.y0 > region.y1 || region.x0 >= t.width || region.y0 >= t.height)
+                continue;
+
+            checks++;
+            if (!checkRead(io, t, filename, &region))
+                failures++;
+        }
+
+        remove(filename.c_str());
+    }
+
+    printf("%d of %d reads failed\n", failures, checks);
+    return failures == 0 ? 0 : 1;
+}